@@ -0,0 +1,155 @@
+/*
+ * Channel export latency benchmark - MegaTunix Redux
+ *
+ * Forks a writer process that publishes frames into the shared-memory
+ * channel export at a fixed rate while the parent reads them back through
+ * the reader library, and reports publish-to-read latency.
+ *
+ *   channel_export_latency [--rate HZ] [--channels N] [--seconds S] [--poll-us US]
+ */
+
+#include "core/channel_export.h"
+#include "core/channel_export_reader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t deadline) {
+    struct timespec ts;
+    ts.tv_sec = deadline / 1000000000ull;
+    ts.tv_nsec = deadline % 1000000000ull;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static int run_writer(const char* name, int rate, int channels, int seconds, int ready_fd) {
+    ChannelExport* exporter = channel_export_create(name, CHANNEL_EXPORT_DEFAULT_SLOTS);
+    if (!exporter) return 1;
+
+    std::vector<ChannelExportDescriptor> table(channels);
+    for (int i = 0; i < channels; i++) {
+        memset(&table[i], 0, sizeof(table[i]));
+        snprintf(table[i].name, sizeof(table[i].name), "ch%d", i);
+        snprintf(table[i].unit, sizeof(table[i].unit), "raw");
+        table[i].scale = 1.0f;
+    }
+    channel_export_set_channels(exporter, "bench", table.data(), channels);
+
+    char ready = 1;
+    if (write(ready_fd, &ready, 1) != 1) return 1;
+    close(ready_fd);
+
+    // Give the reader a moment to map the segment before the clock starts
+    usleep(100000);
+
+    std::vector<float> values(channels);
+    uint64_t period = 1000000000ull / rate;
+    uint64_t next = now_ns();
+    uint64_t frames = (uint64_t)rate * seconds;
+    for (uint64_t frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < channels; i++) values[i] = (float)(frame + i);
+        channel_export_publish(exporter, next / 1000, (uint32_t)frame + 1, values.data(), channels);
+        next += period;
+        sleep_until_ns(next);
+    }
+
+    // Let the reader drain before the segment goes away
+    usleep(200000);
+    channel_export_destroy(exporter);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int rate = 1000;
+    int channels = 64;
+    int seconds = 5;
+    int poll_us = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "/megatunix-bench-%d", (int)getpid());
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--rate") == 0) rate = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--channels") == 0) channels = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seconds") == 0) seconds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--poll-us") == 0) poll_us = atoi(argv[i + 1]);
+    }
+    if (rate <= 0 || seconds <= 0 || channels <= 0 || channels > CHANNEL_EXPORT_MAX_CHANNELS) {
+        fprintf(stderr, "usage: %s [--rate HZ] [--channels 1-%d] [--seconds S] [--poll-us US]\n",
+                argv[0], CHANNEL_EXPORT_MAX_CHANNELS);
+        return 2;
+    }
+
+    int ready_pipe[2];
+    if (pipe(ready_pipe) != 0) return 1;
+    pid_t writer = fork();
+    if (writer < 0) return 1;
+    if (writer == 0) {
+        close(ready_pipe[0]);
+        _exit(run_writer(name, rate, channels, seconds, ready_pipe[1]));
+    }
+    close(ready_pipe[1]);
+
+    char ready = 0;
+    ChannelExportReader reader;
+    if (read(ready_pipe[0], &ready, 1) != 1 || !channel_reader_open(&reader, name)) {
+        fprintf(stderr, "Failed to open %s\n", name);
+        kill(writer, SIGTERM);
+        waitpid(writer, NULL, 0);
+        return 1;
+    }
+    close(ready_pipe[0]);
+    channel_reader_channels(&reader, NULL, 0, NULL, 0);
+
+    uint64_t expected = (uint64_t)rate * seconds;
+    std::vector<uint32_t> latency_ns;
+    latency_ns.reserve(expected);
+    std::vector<float> values(CHANNEL_EXPORT_MAX_CHANNELS);
+    uint64_t empty_polls = 0;
+    uint64_t read_ns = 0;
+    uint64_t deadline = now_ns() + (uint64_t)(seconds + 1) * 1000000000ull;
+
+    while (latency_ns.size() + reader.frames_lost < expected && now_ns() < deadline) {
+        ChannelExportFrame frame;
+        uint64_t start = now_ns();
+        int result = channel_reader_next(&reader, &frame, values.data(), (int)values.size());
+        uint64_t end = now_ns();
+        if (result == CHANNEL_READER_EMPTY) {
+            empty_polls++;
+            if (poll_us > 0) usleep(poll_us);
+            continue;
+        }
+        read_ns += end - start;
+        latency_ns.push_back((uint32_t)std::min<uint64_t>(end - frame.publish_ns, UINT32_MAX));
+    }
+
+    uint64_t lost = reader.frames_lost;
+    channel_reader_close(&reader);
+    waitpid(writer, NULL, 0);
+
+    if (latency_ns.empty()) {
+        fprintf(stderr, "No frames received\n");
+        return 1;
+    }
+
+    std::sort(latency_ns.begin(), latency_ns.end());
+    size_t n = latency_ns.size();
+    auto pct = [&](double p) { return latency_ns[std::min(n - 1, (size_t)(p * n))]; };
+    printf("frames %zu/%llu  lost %llu  channels %d  rate %d Hz  empty polls %llu\n",
+           n, (unsigned long long)expected, (unsigned long long)lost, channels, rate,
+           (unsigned long long)empty_polls);
+    printf("publish->read latency ns: p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n",
+           pct(0.50), pct(0.90), pct(0.99), pct(0.999), latency_ns[n - 1]);
+    printf("reader cost per frame: %.0f ns\n", (double)read_ns / n);
+    return 0;
+}
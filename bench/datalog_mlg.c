@@ -0,0 +1,173 @@
+/*
+ * MLG vs CSV datalog benchmark - MegaTunix Redux
+ *
+ * Writes the same synthetic session as CSV (the key=value lines
+ * datalog_manager produces) and as MLVLG v2 with INI-style raw types, then
+ * loads both back into per-channel float arrays. Reports write throughput,
+ * file size and load time, and checks the MLG values against the source
+ * within each field's scale.
+ *
+ *   datalog_mlg [--rows N] [--directory DIR]
+ */
+
+#include "data/datalog_mlg.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHANNELS 32
+
+static double now_s(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long file_size(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	long size;
+
+	if (!f)
+		return -1;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fclose(f);
+	return size;
+}
+
+/* A Speeduino-like channel mix: bytes with offsets, words, a few scaled */
+static void make_fields(MlgField *fields, char names[][32])
+{
+	static const struct { const char *type; float scale; float translate; const char *units; } kinds[] = {
+		{ "U08", 1.0f, 0.0f, "%" }, { "U08", 1.0f, -40.0f, "C" }, { "U08", 0.1f, 0.0f, "AFR" },
+		{ "U16", 1.0f, 0.0f, "RPM" }, { "S16", 0.1f, 0.0f, "deg" }, { "U16", 0.001f, 0.0f, "ms" },
+	};
+	for (int c = 0; c < CHANNELS; c++) {
+		INIField ini;
+		int k = c % (int)(sizeof(kinds) / sizeof(kinds[0]));
+		memset(&ini, 0, sizeof(ini));
+		snprintf(names[c], 32, "channel%02d", c);
+		snprintf(ini.name, sizeof(ini.name), "%s", names[c]);
+		snprintf(ini.type, sizeof(ini.type), "%s", kinds[k].type);
+		snprintf(ini.units, sizeof(ini.units), "%s", kinds[k].units);
+		ini.scale = kinds[k].scale;
+		ini.translate = kinds[k].translate;
+		mlg_field_from_ini(&fields[c], &ini);
+	}
+}
+
+/* Values that stay inside every field's range, kinds as in make_fields() */
+static float sample(int row, int c)
+{
+	static const float base[] = { 50.0f, 85.0f, 14.7f, 3000.0f, 15.0f, 8.0f };
+	static const float swing[] = { 45.0f, 40.0f, 5.0f, 2500.0f, 30.0f, 6.0f };
+	return base[c % 6] + swing[c % 6] * (float)sin(row * 0.01 + c);
+}
+
+int main(int argc, char **argv)
+{
+	int rows = 200000;
+	const char *directory = "/tmp";
+	char csv_path[512], mlg_path[512], names[CHANNELS][32], line[4096];
+	MlgField fields[CHANNELS];
+	float values[CHANNELS + 1];
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+			rows = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--directory") == 0 && i + 1 < argc)
+			directory = argv[++i];
+	}
+	snprintf(csv_path, sizeof(csv_path), "%s/datalog_mlg_bench.csv", directory);
+	snprintf(mlg_path, sizeof(mlg_path), "%s/datalog_mlg_bench.mlg", directory);
+	make_fields(fields, names);
+
+	/* Write */
+	double start = now_s();
+	FILE *csv = fopen(csv_path, "w");
+	if (!csv) {
+		perror(csv_path);
+		return 1;
+	}
+	fprintf(csv, "timestamp_ms\n");
+	for (int r = 0; r < rows; r++) {
+		fprintf(csv, "%ld", 1700000000000L + r * 10L);
+		for (int c = 0; c < CHANNELS; c++)
+			fprintf(csv, ",%s=%.6f", names[c], sample(r, c));
+		fprintf(csv, "\n");
+	}
+	fclose(csv);
+	double csv_write = now_s() - start;
+
+	start = now_s();
+	FILE *mlg = fopen(mlg_path, "wb");
+	MlgEncoder *encoder = mlg_encoder_new(2, fields, CHANNELS, "datalog_mlg benchmark");
+	const uint8_t *bytes;
+	size_t size = mlg_encoder_header(encoder, &bytes);
+	fwrite(bytes, 1, size, mlg);
+	for (int r = 0; r < rows; r++) {
+		for (int c = 0; c < CHANNELS; c++)
+			values[c] = sample(r, c);
+		size = mlg_encoder_row(encoder, (int64_t)r * 10000, values, &bytes);
+		fwrite(bytes, 1, size, mlg);
+	}
+	fclose(mlg);
+	mlg_encoder_free(encoder);
+	double mlg_write = now_s() - start;
+
+	/* Load into columns */
+	float *columns = malloc((size_t)rows * CHANNELS * sizeof(float));
+	start = now_s();
+	csv = fopen(csv_path, "r");
+	int loaded_csv = 0;
+	if (!fgets(line, sizeof(line), csv))
+		return 1;
+	while (fgets(line, sizeof(line), csv) && loaded_csv < rows) {
+		char *field = strchr(line, ',');
+		for (int c = 0; c < CHANNELS && field; c++) {
+			char *equals = strchr(field, '=');
+			if (!equals)
+				break;
+			columns[(size_t)c * rows + loaded_csv] = strtof(equals + 1, &field);
+		}
+		loaded_csv++;
+	}
+	fclose(csv);
+	double csv_load = now_s() - start;
+
+	start = now_s();
+	MlgReader *reader = mlg_reader_open(mlg_path);
+	int loaded_mlg = 0, mismatched = 0;
+	int64_t time_us;
+	while (reader && loaded_mlg < rows && mlg_reader_next(reader, &time_us, values, NULL) == MLG_RECORD_DATA) {
+		for (int c = 0; c < CHANNELS; c++)
+			columns[(size_t)c * rows + loaded_mlg] = values[c + 1];
+		loaded_mlg++;
+	}
+	double mlg_load = now_s() - start;
+	mlg_reader_close(reader);
+
+	for (int r = 0; r < loaded_mlg; r++)
+		for (int c = 0; c < CHANNELS; c++)
+			if (fabsf(columns[(size_t)c * rows + r] - sample(r, c)) > fields[c].scale * 0.5f + 1e-3f)
+				mismatched++;
+
+	long csv_bytes = file_size(csv_path), mlg_bytes = file_size(mlg_path);
+	printf("%d rows x %d channels\n", rows, CHANNELS);
+	printf("CSV  write %7.3f s (%9.0f rows/s)  size %10ld bytes  load %7.3f s (%d rows)\n",
+	       csv_write, rows / csv_write, csv_bytes, csv_load, loaded_csv);
+	printf("MLG  write %7.3f s (%9.0f rows/s)  size %10ld bytes  load %7.3f s (%d rows)\n",
+	       mlg_write, rows / mlg_write, mlg_bytes, mlg_load, loaded_mlg);
+	printf("MLG is %.1fx smaller, writes %.1fx faster, loads %.1fx faster; %d values outside scale\n",
+	       (double)csv_bytes / mlg_bytes, csv_write / mlg_write, csv_load / mlg_load, mismatched);
+
+	free(columns);
+	unlink(csv_path);
+	unlink(mlg_path);
+	return mismatched || loaded_mlg != rows;
+}
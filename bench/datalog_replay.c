@@ -0,0 +1,243 @@
+/*
+ * Datalog replay benchmark - MegaTunix Redux
+ *
+ * Writes the same synthetic session as a key=value CSV, a tab separated
+ * CSV with a units line, a binary log and an MLG log, replays each as fast
+ * as possible into an ECUContext and checks that the sample listener sees
+ * every row with its values and recorded spacing. Reports listener
+ * throughput, then replays a slice at 4x and reports how far the pacing
+ * drifted from the recorded schedule.
+ *
+ *   datalog_replay [--rows N]
+ */
+
+#include "data/datalog_binary.h"
+#include "data/datalog_mlg.h"
+#include "data/datalog_replay.h"
+#include "ecu/ecu_channels.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define INTERVAL_US 10000
+
+typedef struct {
+	uint64_t samples;
+	uint64_t errors;
+	uint64_t last_timestamp_us;
+} Counter;
+
+static float rpm_at(uint64_t row)
+{
+	return (float)(800 + row % 6000);
+}
+
+/* MAP is only logged on even rows; odd rows hold the previous value */
+static float map_at(uint64_t row)
+{
+	return (float)(20 + (row & ~1ull) % 80);
+}
+
+static void count_sample(const ECUData *data, uint64_t timestamp_us, void *user_data)
+{
+	Counter *counter = user_data;
+	uint64_t row = counter->samples++;
+
+	if (data->rpm != rpm_at(row) || data->map != map_at(row) || data->engine_running != (row % 100 < 50))
+		counter->errors++;
+	if (row > 0 && timestamp_us - counter->last_timestamp_us != INTERVAL_US)
+		counter->errors++;
+	counter->last_timestamp_us = timestamp_us;
+}
+
+static int write_kv_csv(const char *path, uint64_t rows)
+{
+	FILE *file = fopen(path, "w");
+	if (!file)
+		return 0;
+	fprintf(file, "timestamp_ms\n");
+	for (uint64_t r = 0; r < rows; r++) {
+		fprintf(file, "%llu,rpm=%.0f", (unsigned long long)(r * INTERVAL_US / 1000), rpm_at(r));
+		if (r % 2 == 0)
+			fprintf(file, ",map=%.0f", map_at(r));
+		fprintf(file, ",engine_running=%d,unknown_channel=1\n", r % 100 < 50);
+		if (r % 1000 == 999)
+			fprintf(file, "%llu,marker=\"lap\"\n", (unsigned long long)(r * INTERVAL_US / 1000));
+	}
+	return fclose(file) == 0;
+}
+
+static int write_tab_csv(const char *path, uint64_t rows)
+{
+	FILE *file = fopen(path, "w");
+	if (!file)
+		return 0;
+	fprintf(file, "Time\tRPM\tMAP\tEngine Running\nsec\trpm\tkPa\t\n");
+	for (uint64_t r = 0; r < rows; r++) {
+		fprintf(file, "%.3f\t%.0f\t", r * INTERVAL_US / 1e6, rpm_at(r));
+		if (r % 2 == 0)
+			fprintf(file, "%.0f", map_at(r));
+		fprintf(file, "\t%d\n", r % 100 < 50);
+	}
+	return fclose(file) == 0;
+}
+
+static int write_binary(const char *path, uint64_t rows)
+{
+	DatalogBinaryChannel channels[3] = { { "rpm", "RPM" }, { "map", "kPa" }, { "engine_running", "" } };
+	DatalogBinaryWriter *writer = datalog_binary_create(path, "bench", channels, 3, 1024);
+	if (!writer)
+		return 0;
+	for (uint64_t r = 0; r < rows; r++) {
+		float values[3] = { rpm_at(r), r % 2 == 0 ? map_at(r) : NAN, r % 100 < 50 };
+		if (!datalog_binary_append(writer, (int64_t)(1700000000000000ll + r * INTERVAL_US), values))
+			return 0;
+	}
+	return datalog_binary_close(writer);
+}
+
+static int write_mlg(const char *path, uint64_t rows)
+{
+	MlgField fields[3];
+	const uint8_t *bytes;
+	size_t size;
+	FILE *file = fopen(path, "wb");
+	if (!file)
+		return 0;
+
+	mlg_field_init(&fields[0], "RPM", "rpm", MLG_TYPE_U16, 1.0f, 0.0f, 0);
+	mlg_field_init(&fields[1], "MAP", "kPa", MLG_TYPE_F32, 1.0f, 0.0f, 1);
+	mlg_field_init(&fields[2], "Engine Running", "", MLG_TYPE_U08, 1.0f, 0.0f, 0);
+	MlgEncoder *encoder = mlg_encoder_new(2, fields, 3, "datalog_replay benchmark");
+	size = mlg_encoder_header(encoder, &bytes);
+	fwrite(bytes, 1, size, file);
+	for (uint64_t r = 0; r < rows; r++) {
+		/* MLG has no gaps; repeat the held value */
+		float values[3] = { rpm_at(r), map_at(r), r % 100 < 50 };
+		size = mlg_encoder_row(encoder, (int64_t)(r * INTERVAL_US), values, &bytes);
+		fwrite(bytes, 1, size, file);
+	}
+	mlg_encoder_free(encoder);
+	return fclose(file) == 0;
+}
+
+static int replay_fast(const char *name, const char *path, uint64_t rows)
+{
+	DatalogReplayConfig config = { DATALOG_REPLAY_AS_FAST_AS_POSSIBLE, false };
+	DatalogReplayStats stats;
+	Counter counter = { 0, 0, 0 };
+	ECUContext *ctx = ecu_init();
+	DatalogReplay *replay = datalog_replay_open(path);
+	int ok;
+
+	if (!replay) {
+		fprintf(stderr, "%s: could not load %s\n", name, path);
+		ecu_cleanup(ctx);
+		return 0;
+	}
+	ecu_add_sample_listener(ctx, count_sample, &counter);
+	datalog_replay_start(replay, ctx, &config);
+	datalog_replay_wait(replay);
+	datalog_replay_get_stats(replay, &stats);
+
+	ok = counter.samples == rows && counter.errors == 0 && stats.finished &&
+	     datalog_replay_rows(replay) == rows && datalog_replay_channel_count(replay) == 3;
+	printf("%-10s %9llu samples %2d channels %7.1f ms  %10.0f samples/s  publish mean %u us max %u us  %s\n",
+	       name, (unsigned long long)counter.samples, datalog_replay_channel_count(replay),
+	       stats.elapsed_s * 1e3, stats.samples_per_s, stats.publish_mean_us, stats.publish_max_us,
+	       ok ? "ok" : "MISMATCH");
+	if (!ok)
+		fprintf(stderr, "%s: %llu of %llu samples, %llu bad\n", name, (unsigned long long)counter.samples,
+		        (unsigned long long)rows, (unsigned long long)counter.errors);
+	datalog_replay_close(replay);
+	ecu_cleanup(ctx);
+	return ok;
+}
+
+/* 2 s of log at 4x, then a stop in the middle of a looping replay */
+static int replay_paced(const char *path)
+{
+	DatalogReplayConfig config = { 4.0, false };
+	DatalogReplayStats stats;
+	Counter counter = { 0, 0, 0 };
+	ECUContext *ctx = ecu_init();
+	DatalogReplay *replay = datalog_replay_open(path);
+	int ok;
+
+	if (!replay) {
+		ecu_cleanup(ctx);
+		return 0;
+	}
+	ecu_add_sample_listener(ctx, count_sample, &counter);
+	datalog_replay_start(replay, ctx, &config);
+	datalog_replay_wait(replay);
+	datalog_replay_get_stats(replay, &stats);
+	ok = counter.samples == datalog_replay_rows(replay) && counter.errors == 0 &&
+	     fabs(stats.elapsed_s - datalog_replay_duration(replay) / 4.0) < 0.05;
+	printf("4x         %9llu samples in %.3f s for %.3f s of log  late mean %u us max %u us  %s\n",
+	       (unsigned long long)counter.samples, stats.elapsed_s, stats.log_s,
+	       stats.late_mean_us, stats.late_max_us, ok ? "ok" : "OFF SCHEDULE");
+
+	ecu_remove_sample_listener(ctx, count_sample, &counter);
+	config.loop = true;
+	datalog_replay_start(replay, ctx, &config);
+	usleep(100000);
+	datalog_replay_set_speed(replay, DATALOG_REPLAY_AS_FAST_AS_POSSIBLE);
+	usleep(100000);
+	datalog_replay_stop(replay);
+	datalog_replay_get_stats(replay, &stats);
+	if (stats.running || stats.finished || stats.samples <= datalog_replay_rows(replay)) {
+		fprintf(stderr, "looping replay: running %d finished %d after %llu samples\n",
+		        stats.running, stats.finished, (unsigned long long)stats.samples);
+		ok = 0;
+	}
+	datalog_replay_close(replay);
+	ecu_cleanup(ctx);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t rows = 1000000;
+	char dir[] = "/tmp/datalog_replay.XXXXXX";
+	char path[4][64];
+	int ok = 1;
+
+	for (int i = 1; i < argc; i++)
+		if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+			rows = strtoull(argv[++i], NULL, 10);
+	if (rows < 2)
+		rows = 2;
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	snprintf(path[0], sizeof(path[0]), "%s/kv.csv", dir);
+	snprintf(path[1], sizeof(path[1]), "%s/tab.csv", dir);
+	snprintf(path[2], sizeof(path[2]), "%s/log.bin", dir);
+	snprintf(path[3], sizeof(path[3]), "%s/log.mlg", dir);
+
+	if (!write_kv_csv(path[0], rows) || !write_tab_csv(path[1], rows) ||
+	    !write_binary(path[2], rows) || !write_mlg(path[3], rows)) {
+		fprintf(stderr, "could not write the logs in %s\n", dir);
+		return 1;
+	}
+	ok &= replay_fast("key=value", path[0], rows);
+	ok &= replay_fast("tab", path[1], rows);
+	ok &= replay_fast("binary", path[2], rows);
+	ok &= replay_fast("mlg", path[3], rows);
+
+	/* A 200 row slice for the paced run */
+	char slice[64];
+	snprintf(slice, sizeof(slice), "%s/slice.csv", dir);
+	ok &= write_kv_csv(slice, 200) && replay_paced(slice);
+
+	for (int i = 0; i < 4; i++)
+		unlink(path[i]);
+	unlink(slice);
+	rmdir(dir);
+	printf("%llu rows, replay %s\n", (unsigned long long)rows, ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+/*
+ * Async datalog writer under a slow sink - MegaTunix Redux
+ *
+ * Logs CSV-style lines at a fixed rate through datalog_writer while the sink
+ * sleeps on every write, the way an SD card or NFS home stalls. Reports the
+ * time the logging thread spends per sample (which must stay in the
+ * microseconds whatever the sink does), checks that the file is
+ * byte-for-byte what was logged, then repeats with a ring too small for the
+ * load to show that overflow is dropped and counted instead of blocking.
+ *
+ *   datalog_slow_sink [--samples N] [--rate HZ] [--stall-ms MS]
+ */
+
+#include "data/datalog_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+	unsigned stall_ms;
+	unsigned writes;
+} SlowSink;
+
+static double now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void sleep_us(double us)
+{
+	struct timespec ts = { (time_t)(us / 1e6), (long)((us - (time_t)(us / 1e6) * 1e6) * 1e3) };
+	nanosleep(&ts, NULL);
+}
+
+static ssize_t slow_write(int fd, const void *data, size_t size, void *user_data)
+{
+	SlowSink *sink = user_data;
+	sink->writes++;
+	sleep_us(sink->stall_ms * 1000.0);
+	return write(fd, data, size);
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return x < y ? -1 : x > y;
+}
+
+static int format_line(char *line, size_t size, int n)
+{
+	return snprintf(line, size, "%d,rpm=%.6f,map=%.6f,clt=%.6f,afr=%.6f\n",
+	                n, 800.0 + n % 6000, 30.0 + n % 70, 85.0, 14.7 - (n % 30) * 0.1);
+}
+
+static int run(const char *label, int samples, double rate, unsigned stall_ms, uint32_t ring_bytes, int verify)
+{
+	char path[] = "/tmp/datalog_slow_sinkXXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) {
+		perror("mkstemp");
+		return 1;
+	}
+	unlink(path);
+
+	SlowSink sink = { stall_ms, 0 };
+	DatalogWriterConfig config = { ring_bytes, 0, 250, slow_write, &sink, NULL };
+	DatalogWriter *writer = datalog_writer_start(fd, NULL, &config);
+	if (!writer) {
+		fprintf(stderr, "datalog_writer_start failed\n");
+		return 1;
+	}
+
+	double *cost = malloc(samples * sizeof(double));
+	char *queued = calloc(samples, 1);
+	char line[256];
+	double period = 1e6 / rate;
+	double next = now_us();
+	for (int n = 0; n < samples; n++) {
+		int len = format_line(line, sizeof(line), n);
+		double start = now_us();
+		queued[n] = datalog_writer_write(writer, line, len);
+		cost[n] = now_us() - start;
+		next += period;
+		double wait = next - now_us();
+		if (wait > 0)
+			sleep_us(wait);
+	}
+	DatalogWriterStats stats;
+	datalog_writer_get_stats(writer, &stats);
+	double stop_start = now_us();
+	datalog_writer_stop(writer);
+	double drain_ms = (now_us() - stop_start) / 1e3;
+
+	qsort(cost, samples, sizeof(double), compare_doubles);
+	printf("%-10s ring %7u  enqueue p50 %5.2f us  p99 %5.2f us  max %7.2f us  "
+	       "high water %7u  dropped %6llu  sink writes %4u  drain %6.1f ms\n",
+	       label, ring_bytes, cost[samples / 2], cost[samples * 99 / 100], cost[samples - 1],
+	       stats.queue_high_water, (unsigned long long)stats.records_dropped, sink.writes, drain_ms);
+
+	int failed = 0;
+	if (verify) {
+		// Every queued line must be in the file, in order
+		off_t size = lseek(fd, 0, SEEK_END);
+		char *contents = malloc(size + 1);
+		pread(fd, contents, size, 0);
+		off_t offset = 0;
+		for (int n = 0; n < samples && !failed; n++) {
+			if (!queued[n])
+				continue;
+			int len = format_line(line, sizeof(line), n);
+			if (offset + len > size || memcmp(contents + offset, line, len) != 0)
+				failed = 1;
+			offset += len;
+		}
+		if (offset != size)
+			failed = 1;
+		printf("%-10s file %s (%lld bytes)\n", label, failed ? "MISMATCH" : "matches", (long long)size);
+		free(contents);
+	}
+
+	free(cost);
+	free(queued);
+	close(fd);
+	return failed;
+}
+
+int main(int argc, char **argv)
+{
+	int samples = 5000;
+	double rate = 1000.0;
+	unsigned stall_ms = 50;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+			samples = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+			rate = atof(argv[++i]);
+		else if (strcmp(argv[i], "--stall-ms") == 0 && i + 1 < argc)
+			stall_ms = (unsigned)atoi(argv[++i]);
+	}
+
+	printf("%d samples at %.0f Hz, sink stalls %u ms per write\n", samples, rate, stall_ms);
+	int failed = run("default", samples, rate, stall_ms, DATALOG_WRITER_RING_BYTES, 1);
+	// The smallest ring the writer accepts, fed faster than the sink drains it
+	failed |= run("small", samples * 4, rate * 20, stall_ms * 4, 262144, 1);
+	return failed;
+}
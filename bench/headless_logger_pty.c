@@ -0,0 +1,393 @@
+/*
+ * Headless logger benchmark - MegaTunix Redux
+ *
+ * Runs megatunix-logger against a Speeduino simulator on a pseudo-terminal
+ * for a few seconds while it records the port traffic, and checks that the
+ * binary log holds the simulator's frames in order. Then runs the logger
+ * again on a replay of that capture, with no simulator, and checks that it
+ * logs the same frames. Last it logs MLG from a Speeduino INI and checks
+ * that the INI's OutputChannels set each field's raw type and scaling. The
+ * logger's own stats lines show the sample rate and request latency the
+ * Speeduino driver reaches.
+ *
+ *   headless_logger_pty [--logger path] [--seconds N]
+ */
+
+#define _GNU_SOURCE	/* ptsname_r */
+
+#include "data/datalog_binary.h"
+#include "data/datalog_mlg.h"
+#include <dirent.h>
+#include <math.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#ifndef HEADLESS_LOGGER_PATH
+#define HEADLESS_LOGGER_PATH "./megatunix-logger"
+#endif
+
+#define FRAME 130
+#define START_BYTE 0x72
+#define STOP_BYTE 0x03
+#define CMD_GET_DATA 0x41
+
+typedef struct {
+	int master;
+	int slave;			/* Held open so the pty keeps its settings */
+	char port[64];
+	volatile int stop;
+	unsigned served;		/* Realtime frames sent */
+	unsigned requests;
+	pthread_t thread;
+} Simulator;
+
+static unsigned rpm_at(unsigned frame)
+{
+	return 1000 + frame % 5000;
+}
+
+static void build_frame(uint8_t *frame, unsigned n)
+{
+	unsigned rpm = rpm_at(n);
+	memset(frame, 0, FRAME);
+	frame[2] = 0x01;		/* Engine running */
+	frame[4] = 100;			/* MAP kPa */
+	frame[7] = 90;			/* Coolant */
+	frame[9] = 138;			/* 13.8 V */
+	frame[10] = 147;		/* AFR 14.7 */
+	frame[14] = rpm & 0xff;
+	frame[15] = rpm >> 8;
+	frame[24] = 20;			/* Advance */
+	frame[25] = 40;			/* TPS 20% */
+}
+
+/* Answers every CRC envelope with a realtime frame, like a Speeduino that
+ * only knows 'A' */
+static void *simulate(void *arg)
+{
+	Simulator *sim = arg;
+	uint8_t input[256], frame[FRAME];
+	size_t have = 0;
+
+	while (!sim->stop) {
+		struct pollfd pfd = { sim->master, POLLIN, 0 };
+		if (poll(&pfd, 1, 50) <= 0)
+			continue;
+		ssize_t n = read(sim->master, input + have, sizeof(input) - have);
+		if (n <= 0)
+			continue;
+		have += (size_t)n;
+		for (;;) {
+			uint8_t *start = memchr(input, START_BYTE, have);
+			if (!start) {
+				have = 0;
+				break;
+			}
+			have -= (size_t)(start - input);
+			memmove(input, start, have);
+			if (have < 6)
+				break;
+			size_t length = 6 + input[2];
+			if (have < length)
+				break;
+			if (input[length - 1] == STOP_BYTE) {
+				build_frame(frame, sim->served);
+				if (write(sim->master, frame, FRAME) == FRAME && input[1] == CMD_GET_DATA)
+					sim->served++;
+				sim->requests++;
+			}
+			have -= length;
+			memmove(input, input + length, have);
+		}
+	}
+	return NULL;
+}
+
+static int simulator_start(Simulator *sim)
+{
+	struct termios tty;
+
+	memset(sim, 0, sizeof(*sim));
+	sim->master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (sim->master < 0 || grantpt(sim->master) || unlockpt(sim->master) ||
+	    ptsname_r(sim->master, sim->port, sizeof(sim->port)))
+		return 0;
+	/* Raw before the logger opens it, like serial_replay does */
+	sim->slave = open(sim->port, O_RDWR | O_NOCTTY);
+	if (sim->slave < 0)
+		return 0;
+	tcgetattr(sim->slave, &tty);
+	cfmakeraw(&tty);
+	tcsetattr(sim->slave, TCSANOW, &tty);
+	return pthread_create(&sim->thread, NULL, simulate, sim) == 0;
+}
+
+static void simulator_stop(Simulator *sim)
+{
+	sim->stop = 1;
+	pthread_join(sim->thread, NULL);
+	close(sim->slave);
+	close(sim->master);
+}
+
+static int run_logger(const char *logger, char *const args[])
+{
+	char *argv[32];
+	int argc = 0, status;
+	pid_t pid;
+
+	argv[argc++] = (char *)logger;
+	while (*args && argc < 31)
+		argv[argc++] = *args++;
+	argv[argc] = NULL;
+	pid = fork();
+	if (pid == 0) {
+		execv(logger, argv);
+		perror(logger);
+		_exit(127);
+	}
+	if (pid < 0 || waitpid(pid, &status, 0) != pid)
+		return -1;
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* RPM column of the one binary log in dir; returns the sample count or -1 */
+static long read_rpm(const char *dir, float **rpm)
+{
+	char path[512] = "";
+	struct dirent *entry;
+	DIR *d = opendir(dir);
+	if (!d)
+		return -1;
+	while ((entry = readdir(d))) {
+		size_t length = strlen(entry->d_name);
+		if (length > 4 && strcmp(entry->d_name + length - 4, ".bin") == 0)
+			snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+	}
+	closedir(d);
+
+	DatalogBinaryReader *reader = path[0] ? datalog_binary_open(path) : NULL;
+	if (!reader)
+		return -1;
+	int channel = datalog_binary_find_channel(reader, "rpm");
+	uint64_t count = datalog_binary_sample_count(reader);
+	long got = 0;
+	*rpm = malloc((count + 1) * sizeof(float));
+	for (int b = 0; channel >= 0 && b < datalog_binary_block_count(reader); b++) {
+		int n = datalog_binary_read_block(reader, b, &channel, 1, NULL, *rpm + got);
+		if (n < 0)
+			break;
+		got += n;
+	}
+	datalog_binary_close_reader(reader);
+	return channel >= 0 && (uint64_t)got == count ? got : -1;
+}
+
+/* Enough of a Speeduino INI for ecu_connect_with_ini(); offsets match build_frame() */
+static const char ini_text[] =
+	"[MegaTune]\n"
+	"   queryCommand = \"Speeduino 202310\"\n"
+	"\n"
+	"[OutputChannels]\n"
+	"   ochBlockSize = 130\n"
+	"   map            = scalar, U16,  4, \"kpa\",   1.000, 0.000\n"
+	"   coolant        = scalar, U08,  7, \"C\",     1.000, -40.000\n"
+	"   batteryVoltage = scalar, U08,  9, \"V\",     0.100, 0.000\n"
+	"   afr            = scalar, U08, 10, \"O2\",    0.100, 0.000\n"
+	"   rpm            = scalar, U16, 14, \"rpm\",   1.000, 0.000\n"
+	"   tps            = scalar, U08, 25, \"%\",     0.500, 0.000\n";
+
+static const struct {
+	const char *name;
+	MlgType type;
+	float scale;
+	float transform;
+} ini_fields[] = {
+	{ "rpm", MLG_TYPE_U16, 1.0f, 0.0f },
+	{ "map", MLG_TYPE_U16, 1.0f, 0.0f },
+	{ "coolant_temp", MLG_TYPE_U08, 1.0f, -40.0f },
+	{ "battery_voltage", MLG_TYPE_U08, 0.1f, 0.0f },
+	{ "afr", MLG_TYPE_U08, 0.1f, 0.0f },
+	{ "tps", MLG_TYPE_U08, 0.5f, 0.0f },
+	{ "oil_pressure", MLG_TYPE_F32, 1.0f, 0.0f },	/* Not in the INI */
+};
+
+/* Checks the field table of the one MLG log in dir and reads its RPM column;
+ * returns the sample count or -1 */
+static long read_mlg_rpm(const char *dir, float **rpm)
+{
+	char path[512] = "";
+	struct dirent *entry;
+	DIR *d = opendir(dir);
+	if (!d)
+		return -1;
+	while ((entry = readdir(d))) {
+		size_t length = strlen(entry->d_name);
+		if (length > 4 && strcmp(entry->d_name + length - 4, ".mlg") == 0)
+			snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+	}
+	closedir(d);
+
+	MlgReader *reader = path[0] ? mlg_reader_open(path) : NULL;
+	if (!reader)
+		return -1;
+	const MlgField *fields = mlg_reader_fields(reader);
+	int ok = 1;
+	for (size_t i = 0; i < sizeof(ini_fields) / sizeof(ini_fields[0]); i++) {
+		int f = mlg_reader_find_field(reader, ini_fields[i].name);
+		if (f < 0 || fields[f].type != ini_fields[i].type ||
+		    fabsf(fields[f].scale - ini_fields[i].scale) > 1e-6f ||
+		    fabsf(fields[f].transform - ini_fields[i].transform) > 1e-6f) {
+			printf("field %-16s %s\n", ini_fields[i].name, f < 0 ? "missing" : "type or scaling differs from the INI");
+			ok = 0;
+		}
+	}
+
+	int rpm_field = mlg_reader_find_field(reader, "rpm");
+	int volts_field = mlg_reader_find_field(reader, "battery_voltage");
+	int clt_field = mlg_reader_find_field(reader, "coolant_temp");
+	float *values = malloc((size_t)mlg_reader_field_count(reader) * sizeof(float));
+	char message[MLG_MARKER_LEN + 1];
+	int64_t time_us;
+	long got = 0, size = 0;
+	MlgRecordKind kind;
+	*rpm = NULL;
+	while (ok && values && (kind = mlg_reader_next(reader, &time_us, values, message)) > MLG_RECORD_END) {
+		if (kind != MLG_RECORD_DATA)
+			continue;
+		/* Raw U08 columns still come back as the simulator's 13.8 V and 90 C */
+		if (fabsf(values[volts_field] - 13.8f) > 0.05f || values[clt_field] != 90.0f)
+			ok = 0;
+		if (got == size) {
+			size = size ? size * 2 : 1024;
+			*rpm = realloc(*rpm, (size_t)size * sizeof(float));
+		}
+		(*rpm)[got++] = values[rpm_field];
+	}
+	if (mlg_reader_crc_errors(reader))
+		ok = 0;
+	free(values);
+	mlg_reader_close(reader);
+	return ok ? got : -1;
+}
+
+/* Consecutive frames from rpm_at(0) on; returns how many are in order */
+static long in_order(const float *rpm, long count)
+{
+	long n = 0;
+	while (n < count && rpm[n] == (float)rpm_at((unsigned)n))
+		n++;
+	return n;
+}
+
+static void remove_dir(const char *dir)
+{
+	char path[512];
+	struct dirent *entry;
+	DIR *d = opendir(dir);
+	while (d && (entry = readdir(d))) {
+		if (entry->d_name[0] == '.')
+			continue;
+		snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+		unlink(path);
+	}
+	if (d)
+		closedir(d);
+	rmdir(dir);
+}
+
+int main(int argc, char **argv)
+{
+	const char *logger = HEADLESS_LOGGER_PATH;
+	const char *seconds = "3";
+	char dir[] = "/tmp/headless_logger.XXXXXX";
+	char live[64], replayed[64], capture[64], ini_dir[64], ini_path[64];
+	float *live_rpm = NULL, *replay_rpm = NULL, *ini_rpm = NULL;
+	Simulator sim;
+	int ok = 1;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--logger") == 0 && i + 1 < argc)
+			logger = argv[++i];
+		else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+			seconds = argv[++i];
+	}
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	snprintf(live, sizeof(live), "%s/live", dir);
+	snprintf(replayed, sizeof(replayed), "%s/replay", dir);
+	snprintf(capture, sizeof(capture), "%s/session.cap", dir);
+	snprintf(ini_dir, sizeof(ini_dir), "%s/ini", dir);
+	snprintf(ini_path, sizeof(ini_path), "%s/speeduino.ini", dir);
+
+	if (!simulator_start(&sim)) {
+		fprintf(stderr, "could not start the simulator pty\n");
+		return 1;
+	}
+	char *live_args[] = { "--port", sim.port, "--format", "binary", "--output", live,
+			      "--duration", (char *)seconds, "--capture-serial", capture, NULL };
+	int status = run_logger(logger, live_args);
+	simulator_stop(&sim);
+	long live_count = read_rpm(live, &live_rpm);
+	long live_ordered = live_count > 0 ? in_order(live_rpm, live_count) : 0;
+	/* The frame in flight when the logger stopped may be missing */
+	int live_ok = status == 0 && live_count > 0 && live_ordered == live_count &&
+		      live_count <= (long)sim.served && live_count + 1 >= (long)sim.served;
+	printf("live       exit %d  %u frames served, %ld logged, %ld in order  %s\n",
+	       status, sim.served, live_count, live_ordered, live_ok ? "ok" : "MISMATCH");
+	ok &= live_ok;
+
+	char *replay_args[] = { "--replay-serial", capture, "--replay-serial-speed", "0", "--format", "binary",
+				"--output", replayed, "--duration", (char *)seconds, NULL };
+	status = run_logger(logger, replay_args);
+	long replay_count = read_rpm(replayed, &replay_rpm);
+	long replay_ordered = replay_count > 0 ? in_order(replay_rpm, replay_count) : 0;
+	/* Replay ends where the capture does, so it can log the live run's frames at most */
+	int replay_ok = status == 0 && replay_count > 0 && replay_ordered == replay_count &&
+			replay_count <= (long)sim.served && replay_count * 10 >= live_count * 9;
+	printf("replay     exit %d  %ld logged, %ld in order  %s\n",
+	       status, replay_count, replay_ordered, replay_ok ? "ok" : "MISMATCH");
+	ok &= replay_ok;
+
+	FILE *ini = fopen(ini_path, "w");
+	if (ini) {
+		fputs(ini_text, ini);
+		fclose(ini);
+	}
+	if (!simulator_start(&sim)) {
+		fprintf(stderr, "could not start the simulator pty\n");
+		return 1;
+	}
+	char *ini_args[] = { "--port", sim.port, "--ini", ini_path, "--format", "mlg", "--output", ini_dir,
+			     "--duration", (char *)seconds, NULL };
+	status = run_logger(logger, ini_args);
+	simulator_stop(&sim);
+	long ini_count = read_mlg_rpm(ini_dir, &ini_rpm);
+	long ini_ordered = ini_count > 0 ? in_order(ini_rpm, ini_count) : 0;
+	int ini_ok = status == 0 && ini_count > 0 && ini_ordered == ini_count &&
+		     ini_count <= (long)sim.served && ini_count + 1 >= (long)sim.served;
+	printf("ini mlg    exit %d  %u frames served, %ld logged, %ld in order  %s\n",
+	       status, sim.served, ini_count, ini_ordered, ini_ok ? "ok" : "MISMATCH");
+	ok &= ini_ok;
+
+	free(live_rpm);
+	free(replay_rpm);
+	free(ini_rpm);
+	remove_dir(live);
+	remove_dir(replayed);
+	remove_dir(ini_dir);
+	unlink(capture);
+	unlink(ini_path);
+	rmdir(dir);
+	printf("headless logger %s\n", ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/*
+ * Datalog parser throughput benchmark - MegaTunix Redux
+ *
+ * Writes a synthetic MegaTunix datalog (signature line, header, numeric
+ * rows with the odd MARK and malformed line), then loads it with a
+ * line-by-line split + strtod loop equivalent to the old read_log_data()
+ * and with log_parse_file() at one thread and at one thread per CPU.
+ * Values must match the line-by-line loader exactly.
+ *
+ *   log_parser_throughput [--megabytes N] [--file PATH]
+ */
+
+#include "log_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FIELDS 40
+
+typedef struct {
+	float *data;
+	size_t len;
+	size_t allocated;
+} Array;
+
+static double now_s(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void append(Array *array, float value)
+{
+	if (array->len == array->allocated) {
+		array->allocated = array->allocated ? array->allocated * 2 : 4096;
+		array->data = realloc(array->data, array->allocated * sizeof(float));
+	}
+	array->data[array->len++] = value;
+}
+
+static void write_log(const char *path, long bytes)
+{
+	FILE *f = fopen(path, "w");
+	long row = 0;
+
+	fprintf(f, "\"MS2Extra comms342h2\"\n");
+	for (int i = 0; i < FIELDS; i++)
+		fprintf(f, "%sField%02d", i ? "," : "", i);
+	fprintf(f, "\n");
+	while (ftell(f) < bytes) {
+		if (row % 50000 == 25000)
+			fprintf(f, "MARK %ld\n", row);
+		if (row % 70000 == 35000)
+			fprintf(f, "1.0,2.0\n");
+		fprintf(f, "%.3f", row * 0.01);
+		for (int i = 1; i < FIELDS; i++)
+			fprintf(f, ",%.*f", i % 4, (double)((row * (i + 7)) % 100000) / (i % 3 + 1) - 500.0);
+		fprintf(f, "\n");
+		row++;
+	}
+	fclose(f);
+}
+
+/* The old read_log_data(): one line at a time, split, strtod, append */
+static size_t load_lines(const char *path, Array *arrays)
+{
+	FILE *f = fopen(path, "r");
+	char *line = NULL;
+	size_t size = 0;
+	size_t rows = 0;
+	float values[FIELDS];
+
+	while (getline(&line, &size, f) > 0) {
+		int count = 0;
+		char *save = NULL;
+
+		if (line[0] == '"' || strncmp(line, "Field", 5) == 0 || strstr(line, "MARK"))
+			continue;
+		for (char *tok = strtok_r(line, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+			if (count < FIELDS)
+				values[count] = (float)strtod(tok, NULL);
+			count++;
+		}
+		if (count != FIELDS)
+			continue;
+		for (int i = 0; i < FIELDS; i++)
+			append(&arrays[i], values[i]);
+		rows++;
+	}
+	free(line);
+	fclose(f);
+	return rows;
+}
+
+static void progress(double fraction, void *data)
+{
+	(void)fraction;
+	(*(int *)data)++;
+}
+
+int main(int argc, char **argv)
+{
+	long megabytes = 200;
+	char path[512] = "";
+	Array arrays[FIELDS];
+	int owned = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--megabytes") == 0 && i + 1 < argc)
+			megabytes = atol(argv[++i]);
+		else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc)
+			snprintf(path, sizeof(path), "%s", argv[++i]);
+	}
+	if (!path[0]) {
+		snprintf(path, sizeof(path), "/tmp/log_parser_bench_%d.log", (int)getpid());
+		write_log(path, megabytes * 1024 * 1024);
+		owned = 1;
+	}
+
+	memset(arrays, 0, sizeof(arrays));
+	double start = now_s();
+	size_t rows = load_lines(path, arrays);
+	double line_time = now_s() - start;
+	printf("line by line   %8.3f s  %7.1f MB/s  %zu rows\n", line_time, megabytes / line_time, rows);
+
+	int threads[] = { 1, 0 };
+	int failed = 0;
+	for (int t = 0; t < 2; t++) {
+		int progress_calls = 0;
+		start = now_s();
+		LogParse *parse = log_parse_file(path, threads[t], progress, &progress_calls);
+		double elapsed = now_s() - start;
+		if (!parse) {
+			fprintf(stderr, "log_parse_file failed\n");
+			return 1;
+		}
+		size_t mismatches = 0;
+		for (int i = 0; i < FIELDS && parse->field_count == FIELDS && parse->rows == rows; i++)
+			for (size_t r = 0; r < rows; r++)
+				if (parse->columns[i][r] != arrays[i].data[r])
+					mismatches++;
+		if (parse->field_count != FIELDS || parse->rows != rows || mismatches)
+			failed = 1;
+		printf("mmap %2s thread%s %8.3f s  %7.1f MB/s  %zu rows, %zu marks, %zu skipped, %d progress calls, "
+		       "%.1fx, %zu mismatches\n",
+		       threads[t] ? "1" : "N", threads[t] == 1 ? " " : "s", elapsed, megabytes / elapsed, parse->rows,
+		       parse->markers, parse->skipped, progress_calls, line_time / elapsed, mismatches);
+		log_parse_free(parse);
+	}
+
+	for (int i = 0; i < FIELDS; i++)
+		free(arrays[i].data);
+	if (owned)
+		unlink(path);
+	return failed;
+}
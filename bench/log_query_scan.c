@@ -0,0 +1,149 @@
+/*
+ * Log event search benchmark - MegaTunix Redux
+ *
+ * Fills a synthetic log, runs a set of queries through the compiled
+ * block scanner and through a per-sample scalar evaluation, checks both
+ * find the same runs, and times the scanner on the whole log.
+ *
+ *   log_query_scan [--rows N]
+ */
+
+#include "log_query.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum { TIME, RPM, MAP, TPS, KNOCK, AFR, AFR_TARGET, FIELDS };
+
+static const char *names[FIELDS] = { "Time", "RPM", "MAP", "TPS%", "Knock", "AFR", "AFR Target" };
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* The same queries written out by hand, one sample at a time */
+static int scalar(int q, const float **c, size_t i)
+{
+	switch (q) {
+	case 0: return c[KNOCK][i] > 0 && c[RPM][i] > 5000;
+	case 1: return c[RPM][i] >= 3000 && !(c[MAP][i] < 60 || c[TPS][i] <= 20);
+	case 2: return c[AFR][i] > c[AFR_TARGET][i] && c[TPS][i] > 90;
+	case 3: return 7000 < c[RPM][i] || c[KNOCK][i] != 0;
+	case 4: return c[MAP][i] == 100;
+	}
+	return 0;
+}
+
+static const char *queries[] = {
+	"knock > 0 while rpm > 5000",
+	"RPM >= 3000 and not (map < 60 || \"TPS%\" <= 20)",
+	"AFR > 'AFR Target' && TPS% > 90",
+	"7000 < rpm or knock",
+	"map = 100",
+};
+
+static size_t scalar_runs(int q, const float **columns, size_t rows, LogQueryMatch **out)
+{
+	size_t count = 0, size = 0;
+	LogQueryMatch *runs = NULL;
+	int in_run = 0;
+
+	for (size_t i = 0; i <= rows; i++) {
+		int hit = i < rows && scalar(q, columns, i);
+		if (hit && !in_run) {
+			if (count == size) {
+				size = size ? size * 2 : 64;
+				runs = realloc(runs, size * sizeof(*runs));
+			}
+			runs[count].first = i;
+			in_run = 1;
+		} else if (!hit && in_run) {
+			runs[count++].last = i - 1;
+			in_run = 0;
+		}
+	}
+	*out = runs;
+	return count;
+}
+
+int main(int argc, char **argv)
+{
+	size_t rows = 10000000;
+	float *columns[FIELDS];
+	int failures = 0;
+	char *error = NULL;
+
+	for (int i = 1; i < argc; i++)
+		if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+			rows = strtoul(argv[++i], NULL, 10);
+	if (rows == 0)
+		rows = 1;
+
+	for (int f = 0; f < FIELDS; f++)
+		columns[f] = malloc(rows * sizeof(float));
+	srand(1);
+	for (size_t i = 0; i < rows; i++) {
+		double t = i / 100.0;
+		columns[TIME][i] = (float)t;
+		columns[RPM][i] = (float)(4000 + 3500 * sin(t / 7.0) + rand() % 200);
+		columns[MAP][i] = (float)(int)(70 + 40 * sin(t / 5.0));
+		columns[TPS][i] = (float)(50 + 50 * sin(t / 3.0));
+		columns[KNOCK][i] = rand() % 500 == 0 ? (float)(rand() % 4) : 0.0f;
+		columns[AFR][i] = (float)(13.0 + (rand() % 300) / 100.0);
+		columns[AFR_TARGET][i] = 14.0f;
+	}
+
+	for (int q = 0; q < (int)(sizeof(queries) / sizeof(queries[0])); q++) {
+		LogQuery *query = log_query_compile(queries[q], names, FIELDS, &error);
+		LogQueryMatch *fast = NULL, *slow = NULL;
+		size_t fast_count, slow_count;
+		double start, fast_ms, slow_ms;
+
+		if (!query) {
+			fprintf(stderr, "\"%s\": %s\n", queries[q], error);
+			free(error);
+			failures++;
+			continue;
+		}
+		start = now_ms();
+		fast_count = log_query_run(query, (const float **)columns, rows, &fast);
+		fast_ms = now_ms() - start;
+		start = now_ms();
+		slow_count = scalar_runs(q, (const float **)columns, rows, &slow);
+		slow_ms = now_ms() - start;
+
+		if (fast_count != slow_count ||
+		    (fast_count && memcmp(fast, slow, fast_count * sizeof(*fast)) != 0)) {
+			fprintf(stderr, "\"%s\": %zu runs, scalar found %zu\n", queries[q], fast_count, slow_count);
+			failures++;
+		}
+		printf("%-50s %8zu runs  %7.1f ms  (scalar %7.1f ms)\n", queries[q], fast_count, fast_ms, slow_ms);
+		free(fast);
+		free(slow);
+		log_query_free(query);
+	}
+
+	/* Queries that must not compile */
+	const char *bad[] = { "rpm >", "boost > 5", "(rpm > 1", "1 < 2", "rpm > 1 rpm" };
+	for (int b = 0; b < (int)(sizeof(bad) / sizeof(bad[0])); b++) {
+		LogQuery *query = log_query_compile(bad[b], names, FIELDS, &error);
+		if (query) {
+			fprintf(stderr, "\"%s\" compiled\n", bad[b]);
+			log_query_free(query);
+			failures++;
+		} else {
+			printf("%-50s rejected: %s\n", bad[b], error);
+			free(error);
+		}
+	}
+
+	for (int f = 0; f < FIELDS; f++)
+		free(columns[f]);
+	printf("%zu samples, results %s\n", rows, failures ? "DIFFER" : "match");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Log viewer zoom benchmark - MegaTunix Redux
+ *
+ * Fills a synthetic log, builds the min/max/mean summary with one thread
+ * and with all of them, checks random spans against a plain walk of the
+ * samples, then times drawing a screen of pixel columns at several zoom
+ * levels both ways, and the cache save and reload.
+ *
+ *   log_summary_zoom [--rows N] [--fields N] [--width N]
+ */
+
+#include "log_summary.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void walk(const float *samples, size_t rows, size_t first, size_t count, LogSummaryRange *range)
+{
+	double sum = 0;
+	size_t end = first + count < rows ? first + count : rows;
+
+	range->min = range->max = samples[first];
+	for (size_t i = first; i < end; i++) {
+		if (samples[i] < range->min)
+			range->min = samples[i];
+		if (samples[i] > range->max)
+			range->max = samples[i];
+		sum += samples[i];
+	}
+	range->samples = end - first;
+	range->mean = (float)(sum / range->samples);
+}
+
+int main(int argc, char **argv)
+{
+	size_t rows = 4000000;
+	int fields = 32;
+	int width = 1000;
+	int failures = 0;
+	float **columns;
+	char log_path[] = "/tmp/log_summary_zoomXXXXXX";
+	char *cache_path;
+	LogSummary *summary;
+	double start, single_ms, parallel_ms;
+	int fd, i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+			rows = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--fields") == 0 && i + 1 < argc)
+			fields = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+			width = atoi(argv[++i]);
+	}
+	if (rows == 0)
+		rows = 1;
+
+	srand(1);
+	columns = malloc(fields * sizeof(float *));
+	for (i = 0; i < fields; i++) {
+		columns[i] = malloc(rows * sizeof(float));
+		for (size_t r = 0; r < rows; r++)
+			columns[i][r] = 1000.0f * sinf(r * 0.0001f * (i + 1)) + (rand() % 100);
+	}
+	/* The cache is keyed on a log file, any file will do */
+	fd = mkstemp(log_path);
+	if (fd < 0 || write(fd, "bench\n", 6) != 6) {
+		fprintf(stderr, "Cannot create %s\n", log_path);
+		return 2;
+	}
+	close(fd);
+
+	start = now_ms();
+	summary = log_summary_build((const float **)columns, fields, rows, 1);
+	single_ms = now_ms() - start;
+	log_summary_free(summary);
+	start = now_ms();
+	summary = log_summary_build((const float **)columns, fields, rows, 0);
+	parallel_ms = now_ms() - start;
+	printf("%zu rows x %d fields, %d levels\n", rows, fields, log_summary_levels(summary));
+	printf("build: 1 thread %.1f ms, %ld threads %.1f ms\n", single_ms, sysconf(_SC_NPROCESSORS_ONLN), parallel_ms);
+
+	for (i = 0; i < 20000; i++) {
+		int field = rand() % fields;
+		size_t first = ((size_t)rand() * RAND_MAX + rand()) % rows;
+		size_t count = 1 + ((size_t)rand() * RAND_MAX + rand()) % (rows / (1 + rand() % 64) + 1);
+		LogSummaryRange want, got;
+
+		walk(columns[field], rows, first, count, &want);
+		log_summary_query(log_summary_channel(summary, field), first, count, &got);
+		if (want.min != got.min || want.max != got.max || want.samples != got.samples ||
+		    fabsf(want.mean - got.mean) > 1e-3f * (1.0f + fabsf(want.mean))) {
+			if (failures++ < 5)
+				fprintf(stderr, "field %d [%zu,+%zu): walk %g/%g/%g query %g/%g/%g\n", field, first, count,
+					want.min, want.max, want.mean, got.min, got.max, got.mean);
+		}
+	}
+
+	printf("%14s %6s %12s %12s %8s\n", "samples/pixel", "level", "walk ms", "summary ms", "speedup");
+	for (size_t span = 1; span * width <= rows; span *= 4) {
+		const LogSummaryChannel *channel = log_summary_channel(summary, 0);
+		volatile float sink = 0;
+		LogSummaryRange range;
+		size_t end = rows;
+		double walk_ms, query_ms;
+
+		start = now_ms();
+		for (int x = 0; x < width; x++) {
+			walk(columns[0], rows, end - (x + 1) * span, span, &range);
+			sink += range.mean;
+		}
+		walk_ms = now_ms() - start;
+		start = now_ms();
+		for (int x = 0; x < width; x++) {
+			log_summary_query(channel, end - (x + 1) * span, span, &range);
+			sink += range.mean;
+		}
+		query_ms = now_ms() - start;
+		printf("%14zu %6d %12.3f %12.3f %7.0fx\n", span, log_summary_level_for(summary, span),
+		       walk_ms, query_ms, walk_ms / query_ms);
+	}
+
+	cache_path = log_summary_cache_path(log_path);
+	start = now_ms();
+	if (log_summary_save(summary, cache_path, log_path) != 0) {
+		fprintf(stderr, "Cannot save %s\n", cache_path);
+		failures++;
+	}
+	printf("cache: save %.1f ms", now_ms() - start);
+	log_summary_free(summary);
+	start = now_ms();
+	summary = log_summary_load(cache_path, log_path, (const float **)columns, fields, rows);
+	printf(", load %.1f ms\n", now_ms() - start);
+	if (!summary) {
+		fprintf(stderr, "Cache did not load back\n");
+		failures++;
+	}
+	log_summary_free(summary);
+	/* A changed log must not reuse the cache */
+	fd = open(log_path, O_WRONLY | O_APPEND);
+	if (fd >= 0) {
+		if (write(fd, "more\n", 5) != 5)
+			failures++;
+		close(fd);
+	}
+	summary = log_summary_load(cache_path, log_path, (const float **)columns, fields, rows);
+	if (summary) {
+		fprintf(stderr, "Stale cache was accepted\n");
+		log_summary_free(summary);
+		failures++;
+	}
+	unlink(cache_path);
+	unlink(log_path);
+	free(cache_path);
+
+	printf("results %s\n", failures ? "DIFFER" : "match");
+	for (i = 0; i < fields; i++)
+		free(columns[i]);
+	free(columns);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Lookuptable reverse lookup benchmark - MegaTunix Redux
+ *
+ * Loads every .inc file in LookupTables/ the way load_table() does, builds the
+ * precomputed inverse, checks it against the weighted scan for every value
+ * from just below the table's range to just above it, then times both.
+ *
+ *   lookuptable_inverse [directory] [--rounds N]
+ */
+
+#include "lookuptable_inverse.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef LOOKUPTABLE_DIR
+#define LOOKUPTABLE_DIR "LookupTables"
+#endif
+
+#define MAX_ENTRIES 2048
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Same parsing as load_table(): every "DB <n>T" line is one entry */
+static int load_inc(const char *path, int *array)
+{
+	char line[512];
+	int count = 0;
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+		return -1;
+	while (fgets(line, sizeof(line), f) && count < MAX_ENTRIES) {
+		char *str = line;
+		while (*str == ' ' || *str == '\t')
+			str++;
+		if (strncmp(str, "DB", 2) == 0)
+			array[count++] = atoi(str + 2);
+	}
+	fclose(f);
+	return count;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+	return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+int main(int argc, char **argv)
+{
+	const char *directory = LOOKUPTABLE_DIR;
+	int rounds = 2000;
+	char *names[256];
+	int name_count = 0;
+	int failures = 0;
+	double scan_total = 0, inverse_total = 0;
+	long lookups_total = 0;
+	struct dirent *entry;
+	DIR *dir;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+			rounds = atoi(argv[++i]);
+		else
+			directory = argv[i];
+	}
+
+	dir = opendir(directory);
+	if (!dir) {
+		fprintf(stderr, "Cannot open %s\n", directory);
+		return 2;
+	}
+	while ((entry = readdir(dir)) && name_count < 256) {
+		size_t len = strlen(entry->d_name);
+		if (len > 4 && strcmp(entry->d_name + len - 4, ".inc") == 0)
+			names[name_count++] = strdup(entry->d_name);
+	}
+	closedir(dir);
+	qsort(names, name_count, sizeof(char *), compare_names);
+
+	printf("%-24s %7s %7s %10s %10s %8s\n", "table", "entries", "span", "scan ns", "inverse", "speedup");
+	for (i = 0; i < name_count; i++) {
+		char path[1024];
+		int array[MAX_ENTRIES];
+		int count, len, lo, hi, v, r;
+		volatile int sink = 0;
+		LookupInverse *inverse;
+
+		snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+		count = load_inc(path, array);
+		if (count <= 0)
+			continue;
+		len = count < LOOKUP_REVERSE_LEN ? count : LOOKUP_REVERSE_LEN;
+		inverse = lookup_inverse_build(array, len);
+		if (!inverse) {
+			printf("%-24s %7d %7s (scan only)\n", names[i], count, "-");
+			continue;
+		}
+		lo = inverse->base - 2;
+		hi = inverse->base + inverse->span + 2;
+
+		for (v = lo; v < hi; v++) {
+			int expected = lookup_reverse_scan(array, len, v);
+			int got = lookup_inverse_find(inverse, v);
+			if (expected != got) {
+				fprintf(stderr, "%s: value %d scan %d inverse %d\n", names[i], v, expected, got);
+				failures++;
+			}
+		}
+
+		double start = now_ns();
+		for (r = 0; r < rounds; r++)
+			for (v = lo; v < hi; v++)
+				sink += lookup_reverse_scan(array, len, v);
+		double scan_ns = now_ns() - start;
+
+		start = now_ns();
+		for (r = 0; r < rounds; r++)
+			for (v = lo; v < hi; v++)
+				sink += lookup_inverse_find(inverse, v);
+		double inverse_ns = now_ns() - start;
+
+		long lookups = (long)rounds * (hi - lo);
+		printf("%-24s %7d %7d %10.1f %10.2f %7.0fx\n", names[i], count, inverse->span,
+		       scan_ns / lookups, inverse_ns / lookups, scan_ns / inverse_ns);
+		scan_total += scan_ns;
+		inverse_total += inverse_ns;
+		lookups_total += lookups;
+		lookup_inverse_free(inverse);
+	}
+	if (lookups_total)
+		printf("%-24s %7s %7s %10.1f %10.2f %7.0fx\n", "all tables", "", "",
+		       scan_total / lookups_total, inverse_total / lookups_total, scan_total / inverse_total);
+	printf("results %s\n", failures ? "DIFFER" : "match");
+
+	for (i = 0; i < name_count; i++)
+		free(names[i]);
+	return failures ? 1 : 0;
+}
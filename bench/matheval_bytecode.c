@@ -0,0 +1,128 @@
+/*
+ * mtxmatheval bytecode benchmark - MegaTunix Redux
+ *
+ * Evaluates typical realtime conversion expressions with the tree walker
+ * (evaluator_evaluate, as rtv_processor.c calls it), the compiled bytecode
+ * one sample at a time, and evaluator_evaluate_n over a batch, checking
+ * that all three agree.
+ *
+ *   matheval_bytecode [--samples N] [--rounds R]
+ */
+
+#include "mtxmatheval.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+	const char *expression;
+	int count;
+	char *names[2];
+} BenchExpression;
+
+static const BenchExpression expressions[] = {
+	{"x*0.1-40", 1, {"x"}},
+	{"(x-32)*5/9", 1, {"x"}},
+	{"x/10", 1, {"x"}},
+	{"x*x*0.0001+x*0.5+2", 1, {"x"}},
+	{"100*(1-exp(-x/50))", 1, {"x"}},
+	{"(x*256+y)/100", 2, {"x", "y"}},
+	{"x*14.7/(y+1)", 2, {"x", "y"}},
+};
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int same(double a, double b)
+{
+	if (isnan(a) || isnan(b))
+		return isnan(a) && isnan(b);
+	return a == b || fabs(a - b) <= 1e-12 * fabs(a);
+}
+
+int main(int argc, char **argv)
+{
+	int samples = 4096;
+	int rounds = 200;
+	int failures = 0;
+	size_t e;
+	int i, r;
+
+	for (i = 1; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "--samples") == 0)
+			samples = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--rounds") == 0)
+			rounds = atoi(argv[i + 1]);
+	}
+	if (samples <= 0 || rounds <= 0) {
+		fprintf(stderr, "usage: %s [--samples N] [--rounds R]\n", argv[0]);
+		return 2;
+	}
+
+	double *inputs = malloc(sizeof(double) * samples * 2);
+	double *tree = malloc(sizeof(double) * samples);
+	double *single = malloc(sizeof(double) * samples);
+	double *batch = malloc(sizeof(double) * samples);
+	for (i = 0; i < samples * 2; i++)
+		inputs[i] = (double)((i * 37) % 256);
+
+	printf("%-22s %10s %10s %10s %8s\n", "expression", "tree ns", "compiled", "batch", "speedup");
+	for (e = 0; e < sizeof(expressions) / sizeof(expressions[0]); e++) {
+		const BenchExpression *b = &expressions[e];
+		void *evaluator = evaluator_create((char *)b->expression);
+		void *compiled = evaluator ? evaluator_compile(evaluator, b->count, (char **)b->names) : NULL;
+		if (!compiled) {
+			fprintf(stderr, "Failed to compile %s\n", b->expression);
+			failures++;
+			if (evaluator)
+				evaluator_destroy(evaluator);
+			continue;
+		}
+
+		double start = now_ns();
+		for (r = 0; r < rounds; r++)
+			for (i = 0; i < samples; i++)
+				tree[i] = evaluator_evaluate(evaluator, b->count, (char **)b->names,
+							     &inputs[i * b->count]);
+		double tree_ns = now_ns() - start;
+
+		start = now_ns();
+		for (r = 0; r < rounds; r++)
+			for (i = 0; i < samples; i++)
+				single[i] = evaluator_compiled_evaluate(compiled, &inputs[i * b->count]);
+		double single_ns = now_ns() - start;
+
+		start = now_ns();
+		for (r = 0; r < rounds; r++)
+			evaluator_evaluate_n(compiled, inputs, batch, samples);
+		double batch_ns = now_ns() - start;
+
+		for (i = 0; i < samples; i++) {
+			if (!same(tree[i], single[i]) || !same(tree[i], batch[i])) {
+				fprintf(stderr, "%s: sample %d differs (%.17g %.17g %.17g)\n",
+					b->expression, i, tree[i], single[i], batch[i]);
+				failures++;
+				break;
+			}
+		}
+
+		double total = (double)samples * rounds;
+		printf("%-22s %10.2f %10.2f %10.2f %7.1fx\n", b->expression,
+		       tree_ns / total, single_ns / total, batch_ns / total, tree_ns / batch_ns);
+
+		evaluator_compiled_destroy(compiled);
+		evaluator_destroy(evaluator);
+	}
+
+	free(inputs);
+	free(tree);
+	free(single);
+	free(batch);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,338 @@
+/*
+ * Realtime variable conversion benchmark - MegaTunix Redux
+ *
+ * Builds a synthetic realtime map (200 derived variables by default) with
+ * the datasets rtv_map_loader gives real maps, and converts the same raw
+ * blocks two ways:
+ *   - the way process_rt_vars() used to: offset hash -> GList walked with
+ *     g_list_nth_data(), string-keyed GData lookups per variable, and
+ *     g_strdup'd symbol names per complex expression
+ *   - through an Rtv_Plan compiled with rtv_plan_add_object(), the way
+ *     compile_rtv_plan() does, into spilling Rtv_History buffers, as
+ *     process_rt_vars() does now
+ * and checks that both produce the same values. The mix includes
+ * lookuptables with and without mult/add (like MS1 cltdeg and afr1),
+ * specials, and temperature dependent variables of every kind.
+ *
+ *   rtv_plan_decode [--vars N] [--samples N]
+ */
+
+#include "enums.h"
+#include "mtxmatheval.h"
+#include "rtv_plan.h"
+#include <glib.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DATA_GET(dataset, name) g_dataset_get_data(dataset,name)
+#define DATA_SET(dataset, name, data) g_dataset_set_data(dataset,name,data)
+
+#define BLOCK_SIZE 256
+
+typedef struct {
+	DataSize size;
+	int width;
+	gboolean is_signed;
+} BenchSize;
+
+static const BenchSize sizes[] = {{MTX_U08, 1, FALSE}, {MTX_S08, 1, TRUE}, {MTX_U16, 2, FALSE}, {MTX_S16, 2, TRUE}};
+static const gchar *expressions[] = {"x*0.1-40", "(x-32)*5/9", "x*x*0.0001+x*0.5"};
+static gint lookup_table[256];
+
+/* Per-variable data kept the legacy way, one GData dataset per variable */
+typedef struct {
+	int key;
+} BenchObject;
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Stands in for temp_to_host() with a Fahrenheit ECU and Celsius display */
+static gdouble bench_temp_to_host(gdouble value)
+{
+	return (value - 32.0) * 5.0 / 9.0;
+}
+
+/* Stands in for handle_special(), which never looks at the raw block */
+static gfloat bench_special(BenchObject *object)
+{
+	return object->key * 0.5f;
+}
+
+static gint legacy_sized_data(guchar *raw, gint offset, DataSize size)
+{
+	Rtv_Field field;
+	gint i = 0;
+
+	while (sizes[i].size != size)
+		i++;
+	rtv_field_init(&field, offset, sizes[i].width, sizes[i].is_signed, 0);
+	return rtv_field_decode(&field, raw, FALSE);
+}
+
+static gfloat legacy_complex(BenchObject *object, guchar *raw)
+{
+	gchar **symbols = (gchar **)DATA_GET(object, "expr_symbols");
+	gint total = GPOINTER_TO_INT(DATA_GET(object, "total_symbols"));
+	gchar **names = g_new0(gchar *, total);
+	gdouble *values = g_new0(gdouble, total);
+	gchar *tmpbuf = NULL;
+	gdouble result = 0.0;
+	gint i = 0;
+
+	for (i = 0; i < total; i++) {
+		tmpbuf = g_strdup_printf("%s_offset", symbols[i]);
+		gint offset = GPOINTER_TO_INT(DATA_GET(object, tmpbuf));
+		g_free(tmpbuf);
+		tmpbuf = g_strdup_printf("%s_size", symbols[i]);
+		DataSize size = (DataSize)GPOINTER_TO_INT(DATA_GET(object, tmpbuf));
+		g_free(tmpbuf);
+		names[i] = g_strdup(symbols[i]);
+		values[i] = legacy_sized_data(raw, offset, size);
+	}
+	result = evaluator_evaluate(DATA_GET(object, "ul_evaluator"), total, names, values);
+	for (i = 0; i < total; i++)
+		g_free(names[i]);
+	g_free(names);
+	g_free(values);
+	return result;
+}
+
+/* The pre-plan process_rt_vars() loop, store_it and all */
+static void legacy_process(GHashTable *offset_hash, guchar *raw)
+{
+	GList *list = NULL;
+	gfloat *multiplier = NULL;
+	gfloat *adder = NULL;
+	gboolean temp_dep = FALSE;
+	gfloat x = 0, tmpf = 0, result = 0;
+	guint i = 0, j = 0;
+
+	for (i = 0; i < BLOCK_SIZE; i++) {
+		list = (GList *)g_hash_table_lookup(offset_hash, GINT_TO_POINTER(i));
+		if (!list)
+			continue;
+		list = g_list_first(list);
+		for (j = 0; j < g_list_length(list); j++) {
+			BenchObject *object = (BenchObject *)g_list_nth_data(list, j);
+			temp_dep = FALSE;
+			if (DATA_GET(object, "special")) {
+				tmpf = bench_special(object);
+				goto store_it;
+			}
+			temp_dep = GPOINTER_TO_INT(DATA_GET(object, "temp_dep"));
+			gint offset = GPOINTER_TO_INT(DATA_GET(object, "offset"));
+			DataSize size = (DataSize)GPOINTER_TO_INT(DATA_GET(object, "size"));
+			if (DATA_GET(object, "fromecu_complex")) {
+				tmpf = legacy_complex(object, raw);
+				goto store_it;
+			}
+			if (DATA_GET(object, "lookuptable"))
+				x = lookup_table[raw[offset]];
+			else
+				x = legacy_sized_data(raw, offset, size);
+			multiplier = (gfloat *)DATA_GET(object, "fromecu_mult");
+			adder = (gfloat *)DATA_GET(object, "fromecu_add");
+			if ((multiplier) && (adder))
+				tmpf = (x + (*adder)) * (*multiplier);
+			else if (multiplier)
+				tmpf = x * (*multiplier);
+			else
+				tmpf = x;
+store_it:
+			if (temp_dep)
+				result = bench_temp_to_host(tmpf);
+			else
+				result = tmpf;
+			g_array_append_val((GArray *)DATA_GET(object, "legacy_history"), result);
+		}
+	}
+}
+
+/* convert_rtv_step() for the kinds the bench map has */
+static gfloat plan_callback(Rtv_Step *step, guchar *raw, gpointer data)
+{
+	BenchObject *object = (BenchObject *)step->object;
+
+	if (DATA_GET(object, "special"))
+		return bench_special(object);
+	if (DATA_GET(object, "fromecu_complex"))
+		return legacy_complex(object, raw);
+	return lookup_table[raw[step->field.offset]];
+}
+
+int main(int argc, char **argv)
+{
+	static gchar *symbol_x[] = {"x"};
+	int vars = 200;
+	int samples = 20000;
+	int failures = 0;
+	int i, s;
+
+	for (i = 1; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "--vars") == 0)
+			vars = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--samples") == 0)
+			samples = atoi(argv[i + 1]);
+	}
+	if (vars <= 0 || samples <= 0) {
+		fprintf(stderr, "usage: %s [--vars N] [--samples N]\n", argv[0]);
+		return 2;
+	}
+
+	for (i = 0; i < 256; i++)
+		lookup_table[i] = i * 3 - 100;
+
+	GHashTable *offset_hash = g_hash_table_new(g_direct_hash, g_direct_equal);
+	BenchObject *objects = g_new0(BenchObject, vars);
+	GArray **legacy_history = g_new0(GArray *, vars);
+	Rtv_History **plan_history = g_new0(Rtv_History *, vars);
+	GMutex rtv_mutex;
+	Rtv_Spill *spill = NULL;
+	gfloat *multipliers = g_new0(gfloat, vars);
+	gfloat *adders = g_new0(gfloat, vars);
+	void *evaluators[G_N_ELEMENTS(expressions)];
+	static gint symbol_types[] = {RAW_VAR};
+	Rtv_Plan *plan = rtv_plan_new(FALSE);
+	int counts[6] = {0};
+
+	for (i = 0; i < (int)G_N_ELEMENTS(expressions); i++)
+		evaluators[i] = evaluator_create((gchar *)expressions[i]);
+	g_mutex_init(&rtv_mutex);
+	spill = rtv_spill_new(&rtv_mutex);
+	plan->temp_to_host = bench_temp_to_host;
+
+	/* A mix resembling real maps: mostly scaled fields, some complex
+	 * expressions, lookuptables (half of them scaled) and specials */
+	for (i = 0; i < vars; i++) {
+		BenchObject *object = &objects[i];
+		gint offset = (i * 7) % (BLOCK_SIZE - 4);
+		gint size = i % G_N_ELEMENTS(sizes);
+
+		object->key = i;
+		legacy_history[i] = g_array_sized_new(FALSE, TRUE, sizeof(gfloat), samples);
+		plan_history[i] = rtv_history_new(spill);
+		DATA_SET(object, "index", GINT_TO_POINTER(i));
+		DATA_SET(object, "offset", GINT_TO_POINTER(offset));
+		DATA_SET(object, "size", GINT_TO_POINTER(sizes[size].size));
+		DATA_SET(object, "history", plan_history[i]);
+		DATA_SET(object, "legacy_history", legacy_history[i]);
+		if (i % 7 == 0)
+			DATA_SET(object, "temp_dep", GINT_TO_POINTER(TRUE));
+		GList *list = g_hash_table_lookup(offset_hash, GINT_TO_POINTER(offset));
+		g_hash_table_insert(offset_hash, GINT_TO_POINTER(offset), g_list_append(list, object));
+		multipliers[i] = 0.1f * (1 + i % 5);
+		adders[i] = -(gfloat)(i % 40);
+
+		switch (i % 10) {
+		case 0:
+		case 1:
+		case 2: {
+			int e = i % G_N_ELEMENTS(expressions);
+			DATA_SET(object, "fromecu_complex", GINT_TO_POINTER(TRUE));
+			DATA_SET(object, "expr_symbols", symbol_x);
+			DATA_SET(object, "expr_types", symbol_types);
+			DATA_SET(object, "total_symbols", GINT_TO_POINTER(1));
+			DATA_SET(object, "x_offset", GINT_TO_POINTER(offset));
+			DATA_SET(object, "x_size", GINT_TO_POINTER(sizes[size].size));
+			DATA_SET(object, "ul_evaluator", evaluators[e]);
+			counts[2]++;
+			break;
+		}
+		case 3:
+			DATA_SET(object, "lookuptable", "bench");
+			counts[3]++;
+			break;
+		case 4:
+			/* cltdeg/matdeg: table then add -40; afr1: table then mult */
+			DATA_SET(object, "lookuptable", "bench");
+			DATA_SET(object, "fromecu_mult", &multipliers[i]);
+			if (i % 20 == 4)
+				DATA_SET(object, "fromecu_add", &adders[i]);
+			counts[4]++;
+			break;
+		case 5:
+			DATA_SET(object, "fromecu_mult", &multipliers[i]);
+			DATA_SET(object, "fromecu_add", &adders[i]);
+			counts[1]++;
+			break;
+		case 6:
+			/* temp_dep is set on specials too and must be ignored */
+			DATA_SET(object, "special", "bench");
+			DATA_SET(object, "temp_dep", GINT_TO_POINTER(TRUE));
+			counts[5]++;
+			break;
+		default:
+			DATA_SET(object, "fromecu_mult", &multipliers[i]);
+			counts[0]++;
+			break;
+		}
+	}
+
+	/* Same walk as compile_rtv_plan() */
+	for (i = 0; i < BLOCK_SIZE; i++) {
+		GList *list = g_hash_table_lookup(offset_hash, GINT_TO_POINTER(i));
+		for (list = g_list_first(list); list; list = list->next)
+			rtv_plan_add_object(plan, (gconstpointer *)list->data);
+	}
+	rtv_plan_finish(plan);
+
+	guchar *blocks = g_new(guchar, (gsize)64 * BLOCK_SIZE);
+	srand(1);
+	for (i = 0; i < 64 * BLOCK_SIZE; i++)
+		blocks[i] = rand() & 0xff;
+	gfloat *values = g_new0(gfloat, vars);
+
+	double start = now_ns();
+	for (s = 0; s < samples; s++)
+		legacy_process(offset_hash, &blocks[(s % 64) * BLOCK_SIZE]);
+	double legacy_ns = now_ns() - start;
+
+	start = now_ns();
+	for (s = 0; s < samples; s++) {
+		rtv_plan_execute(plan, &blocks[(s % 64) * BLOCK_SIZE], values, plan_callback, NULL);
+		g_mutex_lock(&rtv_mutex);
+		for (i = 0; i < (int)plan->count; i++)
+			rtv_history_append(plan->steps[i].history, values[plan->steps[i].slot]);
+		g_mutex_unlock(&rtv_mutex);
+	}
+	double plan_ns = now_ns() - start;
+
+	/* Older samples may have been spilled, those are read back */
+	g_mutex_lock(&rtv_mutex);
+	for (i = 0; i < vars && !failures; i++) {
+		/* Only compiled expressions may round differently from the tree walker */
+		gboolean exact = !DATA_GET(&objects[i], "fromecu_complex");
+		for (s = 0; s < samples; s++) {
+			gfloat a = g_array_index(legacy_history[i], gfloat, s);
+			gfloat b = rtv_history_get(plan_history[i], s);
+			if (a != b && (exact || fabsf(a - b) > 1e-5f * fabsf(a))) {
+				fprintf(stderr, "var %d sample %d: legacy %g plan %g\n", i, s, a, b);
+				failures++;
+				break;
+			}
+		}
+	}
+	g_mutex_unlock(&rtv_mutex);
+
+	printf("%d variables (%d scaled, %d add+scaled, %d expressions, %d lookuptables, %d scaled lookuptables, %d specials), %d samples\n",
+	       vars, counts[0], counts[1], counts[2], counts[3], counts[4], counts[5], samples);
+	printf("legacy walk:  %8.2f us/sample\n", legacy_ns / samples / 1000.0);
+	printf("rtv plan:     %8.2f us/sample  (%.1fx)\n", plan_ns / samples / 1000.0, legacy_ns / plan_ns);
+	printf("results %s\n", failures ? "DIFFER" : "match");
+
+	rtv_plan_free(plan);
+	rtv_spill_free(spill);
+	for (i = 0; i < vars; i++)
+		rtv_history_free(plan_history[i]);
+	for (i = 0; i < (int)G_N_ELEMENTS(expressions); i++)
+		evaluator_destroy(evaluators[i]);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * Serial capture benchmark - MegaTunix Redux
+ *
+ * Fills a small capture ring far past its capacity and checks that the
+ * reader gets back exactly the newest chunks, in order. Then records a
+ * request/response session with real gaps between the chunks, replays it
+ * on a pseudo-terminal at 1x and 4x with a host that talks to the port
+ * like an ECU poller, checks every response byte and reports how close the
+ * timing came. Finally serves a long session with no delays and reports
+ * round trips per second and raw stream throughput through the pty.
+ *
+ *   serial_capture_replay [--cycles N]
+ */
+
+#include "ecu/serial_capture.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FRAME 75
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void fill(uint8_t *bytes, size_t length, uint32_t seed)
+{
+	for (size_t i = 0; i < length; i++)
+		bytes[i] = (uint8_t)(seed * 31 + i * 7);
+}
+
+static int check_ring(const char *path)
+{
+	SerialCapture *capture = serial_capture_create(path, 64 << 10, "/dev/null", 115200);
+	uint8_t chunk[300];
+	uint32_t total = 20000, expected, seen = 0;
+	uint64_t chunk_count;
+	SerialCaptureChunk got;
+	int ok = 1;
+
+	for (uint32_t i = 0; i < total; i++) {
+		size_t length = 4 + i % 297;
+		fill(chunk, length, i);
+		memcpy(chunk, &i, 4);
+		serial_capture_record(capture, i % 2 ? SERIAL_CAPTURE_TX : SERIAL_CAPTURE_RX, chunk, length);
+	}
+	serial_capture_close(capture);
+
+	SerialCaptureReader *reader = serial_capture_open(path);
+	if (!reader)
+		return 0;
+	const SerialCaptureHeader *header = serial_capture_header(reader);
+	expected = (uint32_t)(header->chunk_count - header->dropped_chunks);
+	chunk_count = header->chunk_count;
+	while (serial_capture_next(reader, &got)) {
+		uint32_t index;
+		uint8_t want[300];
+		memcpy(&index, got.data, 4);
+		fill(want, got.length, index);
+		memcpy(want, &index, 4);
+		if (index != total - expected + seen || got.length != 4 + index % 297 ||
+		    got.direction != (index % 2 ? SERIAL_CAPTURE_TX : SERIAL_CAPTURE_RX) ||
+		    memcmp(want, got.data, got.length) != 0)
+			ok = 0;
+		seen++;
+	}
+	serial_capture_close_reader(reader);
+	ok = ok && seen == expected && chunk_count == total && expected > 100;
+	printf("ring       %u chunks recorded, newest %u read back in order  %s\n", total, seen, ok ? "ok" : "MISMATCH");
+	return ok;
+}
+
+/* Poller session: a 1 byte request, the frame back in two pieces */
+static void record_session(const char *path, int cycles, int gap_us)
+{
+	SerialCapture *capture = serial_capture_create(path, 0, "/dev/ttyACM0", 115200);
+	uint8_t frame[FRAME];
+
+	for (int c = 0; c < cycles; c++) {
+		fill(frame, FRAME, (uint32_t)c);
+		serial_capture_record(capture, SERIAL_CAPTURE_TX, "A", 1);
+		if (gap_us)
+			usleep(gap_us / 2);
+		serial_capture_record(capture, SERIAL_CAPTURE_RX, frame, 32);
+		if (gap_us)
+			usleep(gap_us / 2);
+		serial_capture_record(capture, SERIAL_CAPTURE_RX, frame + 32, FRAME - 32);
+	}
+	serial_capture_close(capture);
+}
+
+static int open_port(const char *port)
+{
+	int fd = open(port, O_RDWR | O_NOCTTY);
+	struct termios tty;
+	if (fd < 0)
+		return -1;
+	tcgetattr(fd, &tty);
+	cfmakeraw(&tty);
+	tcsetattr(fd, TCSANOW, &tty);
+	return fd;
+}
+
+static int read_frame(int fd, uint8_t *frame)
+{
+	int got = 0;
+	while (got < FRAME) {
+		struct pollfd pfd = { fd, POLLIN, 0 };
+		if (poll(&pfd, 1, 2000) <= 0)
+			return got;
+		ssize_t n = read(fd, frame + got, FRAME - got);
+		if (n <= 0)
+			return got;
+		got += (int)n;
+	}
+	return got;
+}
+
+/* Poll the replayed ECU for every recorded frame; returns elapsed ms or -1 */
+static double poll_session(const char *path, int cycles, double speed, SerialReplayStats *stats)
+{
+	SerialReplayConfig config = { speed, true, 0 };
+	SerialReplay *replay = serial_replay_start(path, &config);
+	uint8_t frame[FRAME], want[FRAME];
+	int fd, bad = 0;
+	double start;
+
+	if (!replay)
+		return -1;
+	fd = open_port(serial_replay_port(replay));
+	start = now_ms();
+	for (int c = 0; c < cycles && fd >= 0; c++) {
+		if (write(fd, "A", 1) != 1 || read_frame(fd, frame) != FRAME) {
+			bad++;
+			break;
+		}
+		fill(want, FRAME, (uint32_t)c);
+		bad += memcmp(frame, want, FRAME) != 0;
+	}
+	double elapsed = now_ms() - start;
+	/* The last frame can arrive before the replay marks itself finished */
+	for (int wait = 0; wait < 1000; wait++) {
+		serial_replay_get_stats(replay, stats);
+		if (!stats->running)
+			break;
+		usleep(1000);
+	}
+	if (fd >= 0)
+		close(fd);
+	serial_replay_stop(replay);
+	return fd < 0 || bad || stats->tx_mismatches || !stats->finished ? -1 : elapsed;
+}
+
+int main(int argc, char **argv)
+{
+	int cycles = 20000;
+	char dir[] = "/tmp/serial_capture.XXXXXX";
+	char ring[64], timed[64], fast[64];
+	SerialReplayStats stats;
+	int ok = 1;
+
+	for (int i = 1; i < argc; i++)
+		if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc)
+			cycles = atoi(argv[++i]);
+	if (cycles < 1)
+		cycles = 1;
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	snprintf(ring, sizeof(ring), "%s/ring.cap", dir);
+	snprintf(timed, sizeof(timed), "%s/timed.cap", dir);
+	snprintf(fast, sizeof(fast), "%s/fast.cap", dir);
+
+	ok &= check_ring(ring);
+
+	/* 100 polls 4 ms apart: 400 ms recorded */
+	record_session(timed, 100, 4000);
+	SerialCaptureReader *reader = serial_capture_open(timed);
+	SerialCaptureChunk chunk;
+	uint64_t first = 0, last = 0;
+	for (int n = 0; serial_capture_next(reader, &chunk); n++) {
+		if (n == 0)
+			first = chunk.timestamp_us;
+		last = chunk.timestamp_us;
+	}
+	serial_capture_close_reader(reader);
+	double recorded_ms = (last - first) / 1e3;
+	for (double speed = 1.0; speed <= 4.0; speed *= 4.0) {
+		double ms = poll_session(timed, 100, speed, &stats);
+		int on_time = ms >= 0 && ms > recorded_ms / speed * 0.9 && ms < recorded_ms / speed + 50.0;
+		printf("%.0fx         100 polls in %6.1f ms for %.1f ms recorded  late max %u us  %s\n",
+		       speed, ms, recorded_ms, stats.late_max_us, on_time ? "ok" : "OFF");
+		ok &= on_time;
+	}
+
+	record_session(fast, cycles, 0);
+	double ms = poll_session(fast, cycles, 0.0, &stats);
+	printf("no delays  %d polls in %6.1f ms  %8.0f round trips/s  %s\n",
+	       cycles, ms, ms > 0 ? cycles / (ms / 1e3) : 0.0, ms >= 0 ? "ok" : "MISMATCH");
+	ok &= ms >= 0;
+
+	/* Responses only, as fast as the host drains them */
+	SerialReplayConfig config = { 0.0, false, 0 };
+	SerialReplay *replay = serial_replay_start(fast, &config);
+	int fd = replay ? open_port(serial_replay_port(replay)) : -1;
+	uint8_t buffer[4096];
+	uint64_t total = 0, want = (uint64_t)cycles * FRAME;
+	double start = now_ms();
+	while (fd >= 0 && total < want) {
+		struct pollfd pfd = { fd, POLLIN, 0 };
+		if (poll(&pfd, 1, 2000) <= 0)
+			break;
+		ssize_t n = read(fd, buffer, sizeof(buffer));
+		if (n <= 0)
+			break;
+		total += (uint64_t)n;
+	}
+	ms = now_ms() - start;
+	printf("stream     %llu bytes in %6.1f ms  %6.1f MB/s  %s\n", (unsigned long long)total, ms,
+	       total / (ms / 1e3) / 1e6, total == want ? "ok" : "SHORT");
+	ok &= total == want;
+	if (fd >= 0)
+		close(fd);
+	serial_replay_stop(replay);
+
+	unlink(ring);
+	unlink(timed);
+	unlink(fast);
+	rmdir(dir);
+	printf("capture and replay %s\n", ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -1,11 +1,18 @@
 /*
- * Action Triggers - Foundation for conditional automation
+ * Action Triggers - Conditional automation on ECU channels
+ *
+ * Triggers are resolved to channel IDs when added and evaluated in batch
+ * for each sample frame. A trigger fires on the debounced rising and/or
+ * falling edge of its comparison and is rate-limited by min_interval_ms.
  */
 
 #ifndef ACTION_TRIGGERS_H
 #define ACTION_TRIGGERS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../ecu/ecu_communication.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,24 +27,64 @@ typedef enum {
 	TRIGGER_OP_NOT_EQUAL
 } TriggerComparison;
 
+typedef enum {
+	TRIGGER_EDGE_RISING,	// Comparison becomes true
+	TRIGGER_EDGE_FALLING,	// Comparison becomes false
+	TRIGGER_EDGE_BOTH
+} TriggerEdge;
+
+typedef enum {
+	TRIGGER_ACTION_NONE,
+	TRIGGER_ACTION_START_DATALOG,	// action_arg: optional session name
+	TRIGGER_ACTION_STOP_DATALOG,
+	TRIGGER_ACTION_LOG_MARKER,	// action_arg: marker text
+	TRIGGER_ACTION_RUN_MACRO,	// action_arg: macro name
+	TRIGGER_ACTION_PUBLISH_EVENT	// action_arg: plugin event name
+} TriggerActionType;
+
 typedef struct {
 	char signal_name[64];
 	TriggerComparison comparison;
 	double threshold_value;
-	char action_name[64];
+	TriggerEdge edge;
+	uint32_t debounce_ms;		// Comparison must hold this long before an edge counts
+	uint32_t min_interval_ms;	// Minimum time between two firings
+	TriggerActionType action;
+	char action_arg[64];
 } ActionTrigger;
 
+// Payload published with TRIGGER_ACTION_PUBLISH_EVENT
+typedef struct {
+	int trigger_id;
+	int channel;
+	float value;
+	bool rising;
+	uint64_t timestamp_us;
+} ActionTriggerEvent;
+
+typedef bool (*TriggerEventPublisher)(const char* event_name, const void* data, size_t size);
+
 bool action_triggers_init(void);
 void action_triggers_shutdown(void);
 
-bool action_triggers_add(const ActionTrigger* trigger);
+int action_triggers_add(const ActionTrigger* trigger);
+bool action_triggers_remove(int trigger_id);
 void action_triggers_clear(void);
+
+// Plugin events are routed through the host, which owns the event bus
+void action_triggers_set_event_publisher(TriggerEventPublisher publisher);
+
+// Evaluate all triggers against a full channel frame (indexed by ECUChannelId)
+void action_triggers_process_frame(const float* channels, uint64_t timestamp_us);
 void action_triggers_process_sample(const char* signal, double value);
 
+// ECU sample listener
+void action_triggers_on_sample(const ECUData* data, uint64_t timestamp_us, void* user_data);
+
+uint32_t action_triggers_get_fire_count(int trigger_id);
+
 #ifdef __cplusplus
 }
 #endif
 
 #endif // ACTION_TRIGGERS_H
-
-
@@ -0,0 +1,61 @@
+/*
+ * Alert Rules - Compiled alert conditions over ECU channels
+ *
+ * Conditions are parsed once into small predicate programs and evaluated
+ * on every ECU sample, so short excursions are caught regardless of the
+ * UI frame rate.
+ *
+ * Condition grammar (case-insensitive):
+ *   expr       := term { ("or" | "||") term }
+ *   term       := factor { ("and" | "&&") factor }
+ *   factor     := "(" expr ")" | ("not" | "!") factor | comparison
+ *   comparison := channel op number [unit] [for N (us|ms|s)] [hyst N]
+ *   channel    := name | "rate(" name ")"      (rate is units per second)
+ *   op         := > | >= | < | <= | == | !=
+ *
+ * Examples: "Boost > 25 PSI", "Coolant Temp > 110 hyst 3",
+ *           "RPM > 6500 and TPS < 20 for 500 ms", "rate(RPM) > 4000"
+ */
+
+#ifndef ALERT_RULES_H
+#define ALERT_RULES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../ecu/ecu_communication.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALERT_RULES_MAX 32
+
+typedef struct {
+	bool active;
+	uint32_t trigger_count;
+	uint64_t last_trigger_us;
+	uint64_t last_clear_us;
+} AlertRuleState;
+
+bool alert_rules_init(void);
+void alert_rules_shutdown(void);
+
+int alert_rules_add(const char* condition, char* error, size_t error_size);
+bool alert_rules_update(int rule_id, const char* condition, char* error, size_t error_size);
+void alert_rules_remove(int rule_id);
+void alert_rules_clear(void);
+
+void alert_rules_set_enabled(int rule_id, bool enabled);
+bool alert_rules_set_threshold(int rule_id, float threshold);
+bool alert_rules_get_threshold(int rule_id, float* threshold);
+bool alert_rules_get_state(int rule_id, AlertRuleState* state);
+
+void alert_rules_process_frame(const float* channels, uint64_t timestamp_us);
+void alert_rules_on_sample(const ECUData* data, uint64_t timestamp_us, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALERT_RULES_H
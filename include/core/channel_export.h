@@ -0,0 +1,81 @@
+#ifndef CHANNEL_EXPORT_H
+#define CHANNEL_EXPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shared-memory realtime channel export.
+//
+// The segment is a header (channel descriptor table) followed by a ring of
+// fixed-size sample slots. There is one writer (the host's data bridge) and
+// any number of local readers, which map the segment read-only and never
+// make a syscall per sample.
+//
+// Slot protocol: the writer zeroes slot.sequence, fills the slot, stores
+// sequence = frame index + 1, then advances write_index. A reader that finds
+// a different sequence before or after copying has been lapped by the writer.
+// The descriptor table is guarded by layout_seq (odd while being rewritten);
+// every slot records the layout it was written under.
+//
+// All shared fields are accessed with __atomic builtins, 32 or 64 bits wide.
+
+#define CHANNEL_EXPORT_MAGIC 0x4D545843u            // "MTXC"
+#define CHANNEL_EXPORT_VERSION 1
+#define CHANNEL_EXPORT_DEFAULT_NAME "/megatunix-channels"
+#define CHANNEL_EXPORT_DEFAULT_SLOTS 1024           // Power of two
+#define CHANNEL_EXPORT_MAX_CHANNELS 128
+
+typedef struct {
+    char name[32];
+    char unit[16];
+    float scale;
+    float offset;
+} ChannelExportDescriptor;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;       // Offset of the first slot
+    uint32_t slot_size;
+    uint32_t slot_count;
+    uint32_t writer_pid;
+    uint64_t write_index;       // Frames published; the next goes to slot write_index % slot_count
+
+    uint32_t layout_seq;        // Odd while the descriptor table is being rewritten
+    uint32_t channel_count;
+    char source[64];            // ECU plugin name
+    ChannelExportDescriptor channels[CHANNEL_EXPORT_MAX_CHANNELS];
+} ChannelExportHeader;
+
+typedef struct {
+    uint64_t sequence;          // Frame index + 1 once complete, 0 while being written
+    uint64_t timestamp_us;      // Sample time reported by the ECU plugin
+    uint64_t publish_ns;        // CLOCK_MONOTONIC when the writer published the slot
+    uint32_t frame_id;          // Plugin frame id
+    uint32_t layout;            // layout_seq the values follow
+    uint32_t channel_count;
+    uint32_t reserved;
+    float values[CHANNEL_EXPORT_MAX_CHANNELS];
+} ChannelExportSlot;
+
+// Writer (host side)
+typedef struct ChannelExport ChannelExport;
+
+ChannelExport* channel_export_create(const char* name, uint32_t slot_count);
+void channel_export_destroy(ChannelExport* exporter);
+const char* channel_export_name(const ChannelExport* exporter);
+void channel_export_set_channels(ChannelExport* exporter, const char* source,
+                                 const ChannelExportDescriptor* channels, int count);
+void channel_export_publish(ChannelExport* exporter, uint64_t timestamp_us, uint32_t frame_id,
+                            const float* values, int count);
+uint64_t channel_export_frames(const ChannelExport* exporter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHANNEL_EXPORT_H
@@ -0,0 +1,57 @@
+#ifndef CHANNEL_EXPORT_READER_H
+#define CHANNEL_EXPORT_READER_H
+
+#include "channel_export.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reader side of the shared-memory channel export. Plain C with no
+// dependencies beyond librt so dyno/DAQ tools can link it directly.
+// Only open/close make syscalls; reads are loads from the mapped ring.
+
+typedef struct {
+    const ChannelExportHeader* header;
+    const ChannelExportSlot* slots;
+    size_t size;
+    uint32_t slot_mask;
+    uint64_t cursor;            // Next frame index to read
+    uint32_t layout;            // layout_seq of the last descriptor snapshot
+    uint64_t frames_lost;       // Frames overwritten before this reader got to them
+} ChannelExportReader;
+
+typedef struct {
+    uint64_t index;             // Position in the export stream
+    uint64_t timestamp_us;
+    uint64_t publish_ns;        // CLOCK_MONOTONIC, comparable across processes
+    uint32_t frame_id;
+    uint32_t channel_count;     // Values written to the caller's buffer
+} ChannelExportFrame;
+
+#define CHANNEL_READER_OK 1
+#define CHANNEL_READER_EMPTY 0
+#define CHANNEL_READER_LAYOUT_CHANGED -1    // Frame is valid but follows a newer table; call channel_reader_channels()
+
+bool channel_reader_open(ChannelExportReader* reader, const char* name);
+void channel_reader_close(ChannelExportReader* reader);
+
+// Snapshot the descriptor table; returns the channel count or -1 while the writer is mid-update
+int channel_reader_channels(ChannelExportReader* reader, ChannelExportDescriptor* channels,
+                            int max_channels, char* source, size_t source_size);
+int channel_reader_find(ChannelExportReader* reader, const char* name);
+
+// Next unread frame, oldest first; lapped frames are skipped and counted in frames_lost
+int channel_reader_next(ChannelExportReader* reader, ChannelExportFrame* frame,
+                        float* values, int max_values);
+// Newest unread frame, moving the cursor past everything older
+int channel_reader_latest(ChannelExportReader* reader, ChannelExportFrame* frame,
+                          float* values, int max_values);
+uint64_t channel_reader_available(const ChannelExportReader* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHANNEL_EXPORT_READER_H
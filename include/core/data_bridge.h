@@ -2,6 +2,8 @@
 #define DATA_BRIDGE_H
 
 #include "../plugin/plugin_interface.h"
+#include "ecu_source.h"
+#include "channel_export.h"
 #include <pthread.h>
 #include <map>
 #include <vector>
@@ -21,13 +23,34 @@ typedef struct {
     bool active;
     float update_rate;
     uint64_t last_update;
+    
+    // Resolved at creation (and again when plugins register)
+    PluginInterface* ecu_plugin;
+    PluginInterface* viz_plugin;
+    int source_index;           // Index into DataBridge::sources
+    int channel_index;          // Index into the source's channel descriptor table
+    int series_handle;          // Visualization series handle, -1 if unsupported
 } DataConnection;
 
+// Per-ECU sample source; one realtime read is fanned out to all its connections
+typedef struct {
+    PluginInterface* plugin;
+    ECUSource ecu;              // Channel table (native v2 or adapted v1)
+    bool event_driven;          // Plugin notifies via set_sample_callback
+    bool pending;               // New sample announced, not yet fanned out
+    uint64_t last_poll;         // Last read for polled (non event-driven) sources
+    uint32_t last_frame_id;     // Plugin frame id at the last read (if the plugin reports one)
+    ChannelExport* exporter;    // Shared-memory export of every frame read, or NULL
+} DataBridgeSource;
+
 typedef struct {
     std::map<std::string, DataConnection> connections;
     std::vector<PluginInterface*> ecu_plugins;
     std::vector<PluginInterface*> visualization_plugins;
+    std::vector<DataBridgeSource> sources;
     pthread_mutex_t bridge_mutex;
+    pthread_cond_t bridge_cond;
+    uint64_t generation;        // Bumped whenever connections are added/removed
     bool initialized;
     pthread_t bridge_thread;
     bool thread_running;
@@ -52,8 +75,17 @@ bool data_bridge_remove_connection(const char* connection_id);
 bool data_bridge_start_connection(const char* connection_id);
 bool data_bridge_stop_connection(const char* connection_id);
 void data_bridge_update(void);
+
+// Hold off plugin calls while a plugin is swapped, then re-resolve its tables
+void data_bridge_suspend(void);
+void data_bridge_resume(void);
 const char* data_bridge_get_status(void);
 
+// Publish every frame of an ECU plugin to a shared-memory ring (see channel_export.h)
+bool data_bridge_export_channels(const char* ecu_plugin_name, const char* shm_name);
+void data_bridge_stop_export(const char* ecu_plugin_name);
+bool data_bridge_is_exporting(const char* ecu_plugin_name);
+
 // ECU data extraction functions
 bool extract_ecu_data_point(PluginInterface* ecu_plugin, const char* data_source, float* value);
 bool extract_ecu_realtime_data(PluginInterface* ecu_plugin, ECURealtimeData* data);
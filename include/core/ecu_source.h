@@ -0,0 +1,27 @@
+#ifndef ECU_SOURCE_H
+#define ECU_SOURCE_H
+
+#include "../plugin/plugin_interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Host-side view of an ECU plugin's channels. ABI v2 plugins are used
+// directly; v1 plugins are adapted from the fixed ECURealtimeData layout.
+typedef struct {
+    PluginInterface* plugin;
+    int abi_version;                        // Effective ABI (ECU_PLUGIN_ABI_V1 when adapted)
+    const ECUChannelDescriptor* channels;
+    int channel_count;
+} ECUSource;
+
+bool ecu_source_attach(ECUSource* source, PluginInterface* plugin);
+int ecu_source_find_channel(const ECUSource* source, const char* name);
+bool ecu_source_read(const ECUSource* source, ECUSampleHeader* header, float* values, int max_values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_SOURCE_H
@@ -0,0 +1,127 @@
+/*
+ * Binary Datalog Format - MegaTunix Redux
+ *
+ * Columnar, block-compressed datalog files with a seek index.
+ *
+ * Layout (all integers little-endian):
+ *   DatalogBinaryHeader
+ *   DatalogBinaryChannel[channel_count]
+ *   blocks:  DatalogBinaryBlockHeader
+ *            uint32_t column_size[channel_count + 1]
+ *            zlib column: timestamps (int64 us, first absolute then deltas)
+ *            zlib column per channel (float[sample_count])
+ *   DatalogBinaryIndexEntry[block_count]
+ *   DatalogBinaryMarker[marker_count]
+ *   DatalogBinaryFooter
+ *
+ * Readers find a time with a binary search over the index and inflate only
+ * the channel columns they ask for. A file without a footer (writer
+ * crashed) is still readable: the blocks are found by walking them.
+ */
+
+#ifndef DATALOG_BINARY_H
+#define DATALOG_BINARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DATALOG_BINARY_MAGIC 0x474C584Du        // "MXLG"
+#define DATALOG_BINARY_BLOCK_MAGIC 0x4B4C4258u  // "XBLK"
+#define DATALOG_BINARY_FOOTER_MAGIC 0x444E4558u // "XEND"
+#define DATALOG_BINARY_VERSION 1
+#define DATALOG_BINARY_BLOCK_SAMPLES 1024       // Default samples per block
+#define DATALOG_BINARY_MAX_CHANNELS 1024
+
+typedef struct {
+	char name[32];
+	char unit[16];
+} DatalogBinaryChannel;
+
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t header_size;       // sizeof(DatalogBinaryHeader)
+	uint32_t channel_count;
+	uint32_t block_samples;     // Samples per full block
+	int64_t start_time_us;      // Wall clock at session start
+	char session[64];
+} DatalogBinaryHeader;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t sample_count;
+	int64_t first_time_us;
+	int64_t last_time_us;
+} DatalogBinaryBlockHeader;
+
+typedef struct {
+	uint64_t offset;            // File offset of the block header
+	int64_t first_time_us;
+	int64_t last_time_us;
+	uint32_t sample_count;
+	uint32_t reserved;
+} DatalogBinaryIndexEntry;
+
+typedef struct {
+	int64_t time_us;
+	char label[56];
+} DatalogBinaryMarker;
+
+typedef struct {
+	uint64_t index_offset;
+	uint64_t sample_count;
+	uint32_t block_count;
+	uint32_t marker_count;
+	uint32_t reserved;
+	uint32_t magic;
+} DatalogBinaryFooter;
+
+// Writer
+typedef struct DatalogBinaryWriter DatalogBinaryWriter;
+
+DatalogBinaryWriter* datalog_binary_create(const char* path, const char* session,
+                                           const DatalogBinaryChannel* channels, int channel_count,
+                                           uint32_t block_samples);
+bool datalog_binary_append(DatalogBinaryWriter* writer, int64_t time_us, const float* values);
+bool datalog_binary_add_marker(DatalogBinaryWriter* writer, int64_t time_us, const char* label);
+bool datalog_binary_flush(DatalogBinaryWriter* writer);
+// Make the blocks written so far durable; the partial block stays buffered
+bool datalog_binary_sync(DatalogBinaryWriter* writer);
+bool datalog_binary_close(DatalogBinaryWriter* writer);
+uint64_t datalog_binary_bytes_written(const DatalogBinaryWriter* writer);
+
+// Reader
+typedef struct DatalogBinaryReader DatalogBinaryReader;
+
+DatalogBinaryReader* datalog_binary_open(const char* path);
+void datalog_binary_close_reader(DatalogBinaryReader* reader);
+const DatalogBinaryHeader* datalog_binary_header(const DatalogBinaryReader* reader);
+const DatalogBinaryChannel* datalog_binary_channels(const DatalogBinaryReader* reader);
+int datalog_binary_find_channel(const DatalogBinaryReader* reader, const char* name);
+int datalog_binary_block_count(const DatalogBinaryReader* reader);
+const DatalogBinaryIndexEntry* datalog_binary_block(const DatalogBinaryReader* reader, int block);
+uint64_t datalog_binary_sample_count(const DatalogBinaryReader* reader);
+int datalog_binary_marker_count(const DatalogBinaryReader* reader);
+const DatalogBinaryMarker* datalog_binary_marker(const DatalogBinaryReader* reader, int marker);
+bool datalog_binary_recovered(const DatalogBinaryReader* reader);
+
+// First block whose last sample is at or after time_us (block_count if none)
+int datalog_binary_find_block(const DatalogBinaryReader* reader, int64_t time_us);
+
+// Inflate one block. timestamps (may be NULL) receives sample_count entries;
+// values receives channel_count columns of sample_count floats each, in the
+// order of the channels array. Returns the block's sample count, -1 on error.
+int datalog_binary_read_block(DatalogBinaryReader* reader, int block,
+                              const int* channels, int channel_count,
+                              int64_t* timestamps, float* values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DATALOG_BINARY_H
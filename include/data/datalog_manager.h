@@ -12,6 +12,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "datalog_writer.h"
+#include "../ecu/ecu_ini_parser.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -19,7 +22,8 @@ extern "C" {
 typedef enum {
 	DATALOG_FORMAT_CSV = 0,
 	DATALOG_FORMAT_JSON = 1,
-	DATALOG_FORMAT_BINARY = 2
+	DATALOG_FORMAT_BINARY = 2,
+	DATALOG_FORMAT_MLG = 3          // MegaLogViewer MLVLG v2
 } DatalogFormat;
 
 typedef struct {
@@ -28,7 +32,10 @@ typedef struct {
 	DatalogFormat format;
 	int interval_ms;
 	bool include_timestamps;
-	int max_file_size_mb;
+	int max_file_size_mb;           // Segment size limit when auto_rotate, 0 = none
+	int sync_interval_ms;           // fdatasync period, 0 = leave it to the kernel
+	bool auto_rotate;               // CSV: write checksummed segments with a manifest
+	int max_segment_seconds;        // Segment age limit when auto_rotate, 0 = none
 } DatalogSettings;
 
 // Lifecycle
@@ -39,15 +46,31 @@ void datalog_manager_shutdown(void);
 void datalog_manager_set_settings(const DatalogSettings* settings);
 void datalog_manager_get_settings(DatalogSettings* out_settings);
 
+// Channel set for binary sessions. Optional: without it the keys of the
+// first datalog_manager_log_multiple() call become the columns.
+bool datalog_manager_set_channels(const char** names, const char** units, size_t count);
+// Same, from [OutputChannels] scalars; MLG sessions then store each channel
+// in its raw INI type and scaling instead of F32
+bool datalog_manager_set_ini_channels(const INIField* channels, size_t count);
+
 // Session control
 bool datalog_manager_start_session(const char* optional_session_name);
 void datalog_manager_stop_session(void);
 bool datalog_manager_is_active(void);
+// Queue depth, throughput and drop counters of the session's writer thread
+bool datalog_manager_get_writer_stats(DatalogWriterStats* out_stats);
+// Data file of the session, or its segment manifest when auto_rotate
+const char* datalog_manager_current_path(void);
+// Cut the segments of a crashed session back to their last good block
+int datalog_manager_recover_session(const char* manifest_path);
 
 // Sample writing (generic key/value for foundation; specialized APIs can be added later)
 bool datalog_manager_log_scalar(const char* key, double value);
 bool datalog_manager_log_multiple(const char** keys, const double* values, size_t count);
 
+// Annotate the active session (e.g. from an action trigger)
+bool datalog_manager_log_marker(const char* label);
+
 #ifdef __cplusplus
 }
 #endif
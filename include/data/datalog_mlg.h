@@ -0,0 +1,105 @@
+/*
+ * MegaLogViewer Log Format - MegaTunix Redux
+ *
+ * Writes and reads MLVLG binary logs (format versions 1 and 2), the native
+ * format of MegaLogViewer. All integers are big-endian.
+ *
+ *   header      "MLVLG\0", version, unix time, info offset, data offset,
+ *               record length, field count (22 bytes in v1, 24 in v2)
+ *   fields      type, name[34], units[10], display style, scale, transform,
+ *               digits (55 bytes), plus category[34] in v2 (89 bytes)
+ *   info        NUL-terminated text
+ *   blocks      type (0 data, 1 marker), rolling counter, 16-bit timestamp
+ *               in 10 us ticks, then the record and a byte-sum CRC, or a
+ *               50-byte marker message
+ *
+ * Displayed value = (raw + transform) * scale, the same rule as
+ * TunerStudio's OutputChannels, so INI scalars map onto fields directly.
+ */
+
+#ifndef DATALOG_MLG_H
+#define DATALOG_MLG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../ecu/ecu_ini_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MLG_FIELD_NAME_LEN 34
+#define MLG_FIELD_UNITS_LEN 10
+#define MLG_MARKER_LEN 50
+#define MLG_MAX_FIELDS 1024
+
+typedef enum {
+	MLG_TYPE_U08 = 0,
+	MLG_TYPE_S08 = 1,
+	MLG_TYPE_U16 = 2,
+	MLG_TYPE_S16 = 3,
+	MLG_TYPE_U32 = 4,
+	MLG_TYPE_S32 = 5,
+	MLG_TYPE_S64 = 6,
+	MLG_TYPE_F32 = 7
+} MlgType;
+
+typedef struct {
+	char name[MLG_FIELD_NAME_LEN];
+	char units[MLG_FIELD_UNITS_LEN];
+	char category[MLG_FIELD_NAME_LEN];  // v2 only
+	uint8_t type;                       // MlgType
+	uint8_t display_style;              // 0 = float
+	int8_t digits;
+	float scale;
+	float transform;
+} MlgField;
+
+void mlg_field_init(MlgField* field, const char* name, const char* units,
+                    MlgType type, float scale, float transform, int digits);
+// Raw type and scaling of an [OutputChannels] scalar; false for types MLG cannot hold
+bool mlg_field_from_ini(MlgField* field, const INIField* ini);
+
+// Encoder: builds the byte stream, leaving I/O to the caller. Every log
+// starts with a "Time" field (seconds) ahead of the caller's fields.
+typedef struct MlgEncoder MlgEncoder;
+
+MlgEncoder* mlg_encoder_new(int version, const MlgField* fields, int count, const char* info);
+void mlg_encoder_free(MlgEncoder* encoder);
+// Returned buffers belong to the encoder and are valid until the next call
+size_t mlg_encoder_header(MlgEncoder* encoder, const uint8_t** out);
+size_t mlg_encoder_row(MlgEncoder* encoder, int64_t time_us, const float* values, const uint8_t** out);
+size_t mlg_encoder_marker(MlgEncoder* encoder, int64_t time_us, const char* message, const uint8_t** out);
+
+// Streaming reader
+typedef enum {
+	MLG_RECORD_ERROR = -1,
+	MLG_RECORD_END = 0,
+	MLG_RECORD_DATA = 1,
+	MLG_RECORD_MARKER = 2
+} MlgRecordKind;
+
+typedef struct MlgReader MlgReader;
+
+MlgReader* mlg_reader_open(const char* path);
+void mlg_reader_close(MlgReader* reader);
+int mlg_reader_version(const MlgReader* reader);
+uint32_t mlg_reader_timestamp(const MlgReader* reader);
+const char* mlg_reader_info(const MlgReader* reader);
+int mlg_reader_field_count(const MlgReader* reader);
+const MlgField* mlg_reader_fields(const MlgReader* reader);
+int mlg_reader_find_field(const MlgReader* reader, const char* name);
+uint64_t mlg_reader_crc_errors(const MlgReader* reader);
+
+// Next block. Data fills values[field_count]; a marker fills
+// message[MLG_MARKER_LEN + 1]. time_us is rebuilt from the block timestamps
+// and starts at 0.
+MlgRecordKind mlg_reader_next(MlgReader* reader, int64_t* time_us, float* values, char* message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DATALOG_MLG_H
@@ -0,0 +1,91 @@
+/*
+ * Datalog Replay - MegaTunix Redux
+ *
+ * Plays a recorded log back through the path live ECU data takes, so a
+ * customer's log exercises the same alerts, triggers, loggers and charts
+ * their car did:
+ *
+ *   - every row becomes an ECUData sample published with
+ *     ecu_inject_sample() (frame seqlock, on_data_update, sample listeners)
+ *   - datalog_replay_plugin() is an ECU plugin over the replayed frames for
+ *     the data bridge and the charts behind it
+ *
+ * Reads CSV (a column header line, or the key=value rows and segment
+ * manifests of datalog_manager), the binary format and MLG. Columns are
+ * matched to ECU channels by name; rows without a value for a channel keep
+ * its last value.
+ *
+ * Rows are paced against their recorded timestamps at any speed, and
+ * listeners receive the recorded timeline, so "for 500 ms" in an alert
+ * means 500 ms of log. Speed 0 publishes as fast as the pipeline accepts
+ * samples, which makes a replay a throughput benchmark of that pipeline.
+ */
+
+#ifndef DATALOG_REPLAY_H
+#define DATALOG_REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../ecu/ecu_communication.h"
+#include "../plugin/plugin_interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DATALOG_REPLAY_AS_FAST_AS_POSSIBLE 0.0
+#define DATALOG_REPLAY_DEFAULT_INTERVAL_US 10000   // Row spacing of logs without a time column
+
+typedef struct {
+	double speed;                   // 1.0 = recorded rate, N = N times faster, 0 = as fast as possible
+	bool loop;                      // Start over after the last row
+} DatalogReplayConfig;
+
+typedef struct {
+	bool running;
+	bool finished;                  // Reached the end (never set when looping)
+	uint64_t rows;
+	uint64_t position;              // Next row to publish
+	uint64_t samples;               // Published, over all loops
+	double elapsed_s;               // Wall time since start
+	double log_s;                   // Recorded time published
+	double samples_per_s;
+	uint32_t late_mean_us;          // Publish time behind the recorded schedule (paced speeds)
+	uint32_t late_max_us;
+	uint32_t publish_mean_us;       // Time spent in the pipeline per sample
+	uint32_t publish_max_us;
+} DatalogReplayStats;
+
+typedef struct DatalogReplay DatalogReplay;
+
+// Loads the whole log; NULL if it can't be read or matches no ECU channel
+DatalogReplay* datalog_replay_open(const char* path);
+// Stops a running replay first
+void datalog_replay_close(DatalogReplay* replay);
+
+uint64_t datalog_replay_rows(const DatalogReplay* replay);
+double datalog_replay_duration(const DatalogReplay* replay);
+// ECU channels the log has values for
+int datalog_replay_channel_count(const DatalogReplay* replay);
+int datalog_replay_channel(const DatalogReplay* replay, int index);
+
+// Publishes into ctx from a thread of its own. ctx must not be connected.
+bool datalog_replay_start(DatalogReplay* replay, ECUContext* ctx, const DatalogReplayConfig* config);
+void datalog_replay_stop(DatalogReplay* replay);
+// Blocks until a replay that doesn't loop has published its last row
+void datalog_replay_wait(DatalogReplay* replay);
+// Takes effect from the next row without a jump in the schedule
+void datalog_replay_set_speed(DatalogReplay* replay, double speed);
+void datalog_replay_get_stats(const DatalogReplay* replay, DatalogReplayStats* out);
+
+// ECU plugin (ABI v2, every ECU channel) fed by the replay started last;
+// register it with data_bridge_register_ecu_plugin()
+PluginInterface* datalog_replay_plugin(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DATALOG_REPLAY_H
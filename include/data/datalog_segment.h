@@ -0,0 +1,83 @@
+/*
+ * Segmented Datalog Sessions - MegaTunix Redux
+ *
+ * Splits a text session into segment files that roll over by size or age,
+ * each readable as plain CSV apart from '#' lines:
+ *
+ *   #MTXSEG 1 session=<name> segment=<n> start_us=<t>
+ *   <preamble, e.g. the column line>
+ *   #BLK <seq> <bytes> <crc32>       seals everything since the last seal
+ *   <data lines>
+ *   #BLK ...
+ *
+ * A crashed segment is repaired by truncating it after the last seal whose
+ * length and CRC check out. A manifest (<base>.manifest) lists the segments
+ * of the session in order.
+ *
+ * The segmenter is the sink of a datalog_writer thread. Rotation on that
+ * thread is a file descriptor swap: the next segment file is created ahead
+ * of time, and syncing, closing and manifest updates for the old one run on
+ * the segmenter's own thread.
+ */
+
+#ifndef DATALOG_SEGMENT_H
+#define DATALOG_SEGMENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DATALOG_SEGMENT_VERSION 1
+#define DATALOG_SEGMENT_BLOCK_BYTES 16384       // Seal after this much unsealed data
+
+typedef struct {
+	const char* directory;
+	const char* base;               // Segment files are <base>.<nnn>.<extension>
+	const char* extension;
+	const char* session;
+	uint64_t max_bytes;             // 0 = no size limit
+	uint32_t max_seconds;           // 0 = no age limit
+	const char* preamble;           // Repeated at the top of every segment, may be NULL
+} DatalogSegmentConfig;
+
+typedef struct {
+	uint64_t file_bytes;
+	uint64_t valid_bytes;           // Up to the end of the last good seal
+	uint32_t blocks;                // Good seals
+	bool truncated;                 // The file was cut back to valid_bytes
+} DatalogSegmentRecovery;
+
+typedef struct DatalogSegmenter DatalogSegmenter;
+
+DatalogSegmenter* datalog_segment_open(const DatalogSegmentConfig* config);
+// Seals and closes the last segment and finishes the manifest
+void datalog_segment_close(DatalogSegmenter* segments);
+
+// Writer thread side: data must be whole lines
+bool datalog_segment_write(DatalogSegmenter* segments, const void* data, size_t size);
+// Seal what was written and fdatasync() the current segment
+bool datalog_segment_sync(DatalogSegmenter* segments);
+
+const char* datalog_segment_manifest_path(const DatalogSegmenter* segments);
+uint32_t datalog_segment_count(const DatalogSegmenter* segments);
+
+// DatalogWriterConfig sink and sync hooks; user_data is the segmenter
+ssize_t datalog_segment_sink(int fd, const void* data, size_t size, void* user_data);
+void datalog_segment_sink_sync(int fd, void* user_data);
+
+// Cut a segment back to its last good seal. False if it isn't a segment.
+bool datalog_segment_recover(const char* path, DatalogSegmentRecovery* out);
+// Repair every segment of a session that was never closed, and any segment
+// file past the last one listed. Returns segments repaired, -1 on error.
+int datalog_segment_recover_session(const char* manifest_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DATALOG_SEGMENT_H
@@ -0,0 +1,75 @@
+/*
+ * Asynchronous Datalog Writer - MegaTunix Redux
+ *
+ * Moves datalog I/O off the acquisition thread. The logging thread packs
+ * each sample into a single-producer/single-consumer byte ring and never
+ * blocks; a writer thread drains the ring, batches text into large write()
+ * calls, feeds binary rows to the columnar writer and runs fdatasync() at a
+ * fixed interval. When the ring is full the sample is dropped and counted.
+ */
+
+#ifndef DATALOG_WRITER_H
+#define DATALOG_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "datalog_binary.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DATALOG_WRITER_RING_BYTES 1048576     // Power of two
+#define DATALOG_WRITER_BATCH_BYTES 65536
+#define DATALOG_WRITER_SYNC_MS 1000
+
+// Sink used for text batches; returns bytes written or -1 like write(2)
+typedef ssize_t (*DatalogSinkWrite)(int fd, const void* data, size_t size, void* user_data);
+// Makes what the sink wrote durable
+typedef void (*DatalogSinkSync)(int fd, void* user_data);
+
+typedef struct {
+	uint32_t ring_bytes;            // 0 = DATALOG_WRITER_RING_BYTES
+	uint32_t batch_bytes;           // 0 = DATALOG_WRITER_BATCH_BYTES
+	uint32_t sync_interval_ms;      // 0 = never fdatasync
+	DatalogSinkWrite sink;          // NULL = write(2)
+	void* sink_data;
+	DatalogSinkSync sync;           // NULL = fdatasync(2)
+} DatalogWriterConfig;
+
+typedef struct {
+	uint32_t queue_depth;           // Bytes waiting in the ring
+	uint32_t queue_high_water;
+	uint32_t queue_capacity;
+	uint64_t records_queued;
+	uint64_t records_dropped;       // Rejected because the ring was full
+	uint64_t bytes_written;         // Text handed to the sink, or binary file size
+	uint64_t bytes_per_second;      // Over the last full second
+	uint64_t write_errors;
+	uint64_t syncs;
+	uint32_t max_write_us;          // Slowest single sink write or block flush
+} DatalogWriterStats;
+
+typedef struct DatalogWriter DatalogWriter;
+
+// Either fd (text) or binary may be unused (-1 / NULL). Neither is closed
+// by the writer; stop it before closing them.
+DatalogWriter* datalog_writer_start(int fd, DatalogBinaryWriter* binary, const DatalogWriterConfig* config);
+// Drains everything queued, syncs and joins the thread
+void datalog_writer_stop(DatalogWriter* writer);
+
+// Producer side: one thread only, never blocks
+bool datalog_writer_write(DatalogWriter* writer, const void* text, size_t size);
+bool datalog_writer_row(DatalogWriter* writer, int64_t time_us, const float* values, uint32_t count);
+bool datalog_writer_marker(DatalogWriter* writer, int64_t time_us, const char* label);
+
+void datalog_writer_get_stats(const DatalogWriter* writer, DatalogWriterStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DATALOG_WRITER_H
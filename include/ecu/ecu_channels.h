@@ -0,0 +1,88 @@
+/*
+ * ECU Channels - Indexed access to realtime ECU data
+ * 
+ * Copyright (C) 2025 Pat Burke
+ * 
+ * Gives every ECUData field a stable channel ID so consumers (alerts,
+ * triggers, loggers) can resolve names once and read values by index.
+ */
+
+#ifndef ECU_CHANNELS_H
+#define ECU_CHANNELS_H
+
+#include "ecu_communication.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Channel IDs (order matches the channel table in ecu_channels.c)
+typedef enum {
+    ECU_CHANNEL_RPM = 0,
+    ECU_CHANNEL_MAP,
+    ECU_CHANNEL_TPS,
+    ECU_CHANNEL_COOLANT_TEMP,
+    ECU_CHANNEL_INTAKE_TEMP,
+    ECU_CHANNEL_BATTERY_VOLTAGE,
+    ECU_CHANNEL_AFR,
+    ECU_CHANNEL_AFR_TARGET,
+    ECU_CHANNEL_TIMING,
+    ECU_CHANNEL_FUEL_PRESSURE,
+    ECU_CHANNEL_OIL_PRESSURE,
+    ECU_CHANNEL_OIL_TEMP,
+    ECU_CHANNEL_BOOST,
+    ECU_CHANNEL_BOOST_TARGET,
+    ECU_CHANNEL_WASTEGATE_DUTY,
+    ECU_CHANNEL_FUEL_PW1,
+    ECU_CHANNEL_FUEL_PW2,
+    ECU_CHANNEL_FUEL_DUTY,
+    ECU_CHANNEL_INJECTOR_DUTY,
+    ECU_CHANNEL_DWELL,
+    ECU_CHANNEL_SPARK_ADVANCE,
+    ECU_CHANNEL_KNOCK_COUNT,
+    ECU_CHANNEL_KNOCK_RETARD,
+    ECU_CHANNEL_ENGINE_RUNNING,
+    ECU_CHANNEL_ENGINE_CRANKING,
+    ECU_CHANNEL_BOOST_CONTROL_ACTIVE,
+    ECU_CHANNEL_KNOCK_DETECTED,
+    ECU_CHANNEL_CHECK_ENGINE_LIGHT,
+    ECU_CHANNEL_COUNT
+} ECUChannelId;
+
+// Channel storage type inside ECUData
+typedef enum {
+    ECU_CHANNEL_TYPE_FLOAT,
+    ECU_CHANNEL_TYPE_BOOL
+} ECUChannelType;
+
+// Channel descriptor
+typedef struct {
+    const char* name;       // Canonical name (matches the ECUData field)
+    const char* label;      // Display label
+    const char* unit;
+    ECUChannelType type;
+    size_t offset;          // Offset of the field in ECUData
+} ECUChannelInfo;
+
+// Channel lookup (case, space and underscore insensitive; -1 if unknown)
+int ecu_channel_lookup(const char* name);
+const ECUChannelInfo* ecu_channel_info(int channel);
+
+// Channel values
+float ecu_channel_value(const ECUData* data, int channel);
+void ecu_channels_snapshot(const ECUData* data, float* values);
+// Same, widened for datalog_manager_log_multiple()
+void ecu_channels_snapshot_double(const ECUData* data, double* values);
+
+// Datalog columns for every channel (ECU_CHANNEL_COUNT entries, channel names), typed
+// and scaled like the INI [OutputChannels] scalar that resolves to each one; channels
+// the INI does not carry stay F32. Returns how many channels came from the INI.
+int ecu_channels_ini_fields(const INIConfig* ini, INIField* fields);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_CHANNELS_H
@@ -13,6 +13,8 @@
 #include <stdbool.h>
 #include <SDL2/SDL.h>
 #include "ecu_ini_parser.h"
+#include "ecu_seqlock.h"
+#include "serial_capture.h"
 
 // ECU Protocol Types
 typedef enum {
@@ -89,6 +91,16 @@ typedef struct {
     int reconnect_interval;
 } ECUConfig;
 
+// Per-sample listener, fired on the acquisition path after every good update
+typedef void (*ECUSampleListener)(const ECUData* data, uint64_t timestamp_us, void* user_data);
+
+#define ECU_MAX_SAMPLE_LISTENERS 8
+
+typedef struct {
+    ECUSampleListener callback;
+    void* user_data;
+} ECUSampleListenerEntry;
+
 // ECU Communication Context
 typedef struct {
     ECUProtocol protocol;
@@ -135,12 +147,23 @@ typedef struct {
     void (*on_connection_change)(ECUConnectionState state);
     void (*on_error)(const char* error);
     
+    // Latest complete frame, readable from any thread via ecu_read_frame()
+    ECUSeqlock frame_lock;
+    ECUData frame;
+    
+    // Sample listeners (alerts, triggers, loggers)
+    ECUSampleListenerEntry sample_listeners[ECU_MAX_SAMPLE_LISTENERS];
+    int sample_listener_count;
+    
     // INI Configuration (for INI-based connections)
     INIConfig* ini_config;
     
     // Demo mode support
     bool demo_mode;
     INIConfig* demo_ini_config;
+    
+    // Raw port traffic recorder (not owned)
+    SerialCapture* capture;
 } ECUContext;
 
 // Function declarations
@@ -164,8 +187,21 @@ void ecu_disconnect(ECUContext* ctx);
 bool ecu_is_connected(ECUContext* ctx);
 ECUConnectionState ecu_get_state(ECUContext* ctx);
 const ECUData* ecu_get_data(ECUContext* ctx);
+uint32_t ecu_get_frame_id(const ECUContext* ctx);
+uint32_t ecu_read_frame(const ECUContext* ctx, ECUData* out);
 bool ecu_update(ECUContext* ctx);
+// Publish a sample that didn't come from the ECU (datalog replay) through the
+// same path as a good ecu_update(). Refused while a live connection is up.
+bool ecu_inject_sample(ECUContext* ctx, const ECUData* data, uint64_t timestamp_us);
 bool ecu_send_command(ECUContext* ctx, const char* command);
+
+// Sample listeners
+bool ecu_add_sample_listener(ECUContext* ctx, ECUSampleListener callback, void* user_data);
+void ecu_remove_sample_listener(ECUContext* ctx, ECUSampleListener callback, void* user_data);
+
+// Record every chunk read from or written to the port (NULL stops recording)
+void ecu_set_capture(ECUContext* ctx, SerialCapture* capture);
+uint64_t ecu_get_timestamp_us(void);
 const char* ecu_get_protocol_name(ECUProtocol protocol);
 ECUProtocol ecu_parse_protocol_name(const char* name);
 const char* ecu_get_state_name(ECUConnectionState state);
@@ -80,6 +80,11 @@ typedef struct {
     int table_count;
     int table_capacity;
     
+    // [OutputChannels] scalars (realtime data layout)
+    INIField* output_channels;
+    int output_channel_count;
+    int och_block_size;
+    
     // TunerStudio specific fields
     char ini_version[16];
     char author[64];
@@ -124,6 +129,8 @@ bool ecu_parse_ini_section(const char* content, const char* section_name, INICon
 bool ecu_parse_tunerstudio_section(const char* content, INIConfig* config);
 bool ecu_parse_constants_section(const char* content, INIConfig* config);
 bool ecu_parse_megatune_section(const char* content, INIConfig* config);
+bool ecu_parse_output_channels_section(const char* content, INIConfig* config);
+const INIField* ecu_find_output_channel(const INIConfig* config, const char* name);
 
 // Table parsing functions
 bool ecu_parse_table_dimensions(const char* content, INIConfig* config);
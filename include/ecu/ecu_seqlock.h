@@ -0,0 +1,80 @@
+/*
+ * ECU Seqlock - Single-writer latest-frame publication
+ * 
+ * Copyright (C) 2025 Pat Burke
+ * 
+ * A writer publishes a complete frame without ever blocking; readers on
+ * any thread copy it out and retry if a write overlapped the copy. The
+ * sequence doubles as a frame counter so readers can skip unchanged data.
+ * 
+ * Writers must be serialized by the caller. Frames are copied in 32-bit
+ * words with relaxed atomics, so frame types must be 4-byte aligned and
+ * a multiple of 4 bytes in size (true for ECUData/ECURealtimeData).
+ */
+
+#ifndef ECU_SEQLOCK_H
+#define ECU_SEQLOCK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t sequence;  // Odd while a write is in progress
+} ECUSeqlock;
+
+static inline void ecu_seqlock_init(ECUSeqlock* lock) {
+    __atomic_store_n(&lock->sequence, 0, __ATOMIC_RELAXED);
+}
+
+// Publish a frame of `size` bytes from src into the shared dst
+static inline void ecu_seqlock_publish(ECUSeqlock* lock, void* dst, const void* src, size_t size) {
+    uint32_t seq = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&lock->sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    
+    uint32_t* out = (uint32_t*)dst;
+    const uint32_t* in = (const uint32_t*)src;
+    for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+        __atomic_store_n(&out[i], in[i], __ATOMIC_RELAXED);
+    }
+    
+    __atomic_store_n(&lock->sequence, seq + 2, __ATOMIC_RELEASE);
+}
+
+// Copy the latest frame out of src; returns its frame id (0 = nothing published yet)
+static inline uint32_t ecu_seqlock_read(const ECUSeqlock* lock, void* dst, const void* src, size_t size) {
+    uint32_t* out = (uint32_t*)dst;
+    const uint32_t* in = (const uint32_t*)src;
+    
+    for (;;) {
+        uint32_t start = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+        if (start & 1) {
+            continue;
+        }
+        
+        for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+            out[i] = __atomic_load_n(&in[i], __ATOMIC_RELAXED);
+        }
+        
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) == start) {
+            return start / 2;
+        }
+    }
+}
+
+// Number of frames published so far; cheap enough to poll every frame
+static inline uint32_t ecu_seqlock_frame_id(const ECUSeqlock* lock) {
+    return __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE) / 2;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECU_SEQLOCK_H
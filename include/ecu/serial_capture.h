@@ -0,0 +1,126 @@
+/*
+ * Serial Capture - Raw ECU traffic recording and replay
+ *
+ * Copyright (C) 2025 Pat Burke
+ *
+ * A capture records every chunk read from or written to the ECU port, with
+ * its direction and a microsecond timestamp, into a memory-mapped ring
+ * file. The newest chunks overwrite the oldest once the ring is full, and
+ * since the ring lives in a shared mapping a crash loses at most the chunk
+ * being written.
+ *
+ *   header      SerialCaptureHeader, SERIAL_CAPTURE_HEADER_SIZE bytes
+ *   ring        capacity bytes of records: SerialCaptureRecord + data,
+ *               8-byte aligned; a record never wraps, the space it would
+ *               not fit in holds a pad record
+ *
+ * A replay serves a capture on a pseudo-terminal: open its port like a
+ * serial port and the recorded ECU responses come back with their original
+ * timing, compressed timing or none, each one held until the host has sent
+ * the request that preceded it in the capture.
+ */
+
+#ifndef SERIAL_CAPTURE_H
+#define SERIAL_CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SERIAL_CAPTURE_MAGIC 0x5041434Du        // "MCAP"
+#define SERIAL_CAPTURE_VERSION 1
+#define SERIAL_CAPTURE_HEADER_SIZE 4096
+#define SERIAL_CAPTURE_DEFAULT_CAPACITY (16u << 20)
+#define SERIAL_CAPTURE_MAX_CHUNK 4096           // Longer reads and writes are split
+
+typedef enum {
+    SERIAL_CAPTURE_RX = 0,      // ECU to host
+    SERIAL_CAPTURE_TX = 1,      // Host to ECU
+    SERIAL_CAPTURE_PAD = 2      // Unused space at the end of the ring
+} SerialCaptureDirection;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;       // SERIAL_CAPTURE_HEADER_SIZE
+    uint64_t capacity;          // Ring bytes after the header
+    uint64_t head;              // Ring position past the newest complete record
+    uint64_t tail;              // Ring position of the oldest record kept
+    uint64_t chunk_count;       // Recorded, including overwritten ones
+    uint64_t dropped_chunks;    // Overwritten by newer ones
+    int64_t start_time_us;      // Wall clock at creation
+    int32_t baud_rate;
+    uint32_t reserved;
+    char port[64];
+} SerialCaptureHeader;
+
+typedef struct {
+    uint64_t timestamp_us;      // Since start_time_us
+    uint32_t length;
+    uint8_t direction;          // SerialCaptureDirection
+    uint8_t reserved[3];
+} SerialCaptureRecord;
+
+// Recording
+typedef struct SerialCapture SerialCapture;
+
+// capacity 0 = SERIAL_CAPTURE_DEFAULT_CAPACITY
+SerialCapture* serial_capture_create(const char* path, size_t capacity, const char* port, int baud_rate);
+void serial_capture_record(SerialCapture* capture, SerialCaptureDirection direction, const void* data, size_t length);
+bool serial_capture_sync(SerialCapture* capture);
+void serial_capture_close(SerialCapture* capture);
+uint64_t serial_capture_chunk_count(const SerialCapture* capture);
+uint64_t serial_capture_bytes(const SerialCapture* capture);
+
+// Reading
+typedef struct {
+    uint64_t timestamp_us;
+    SerialCaptureDirection direction;
+    uint32_t length;
+    const uint8_t* data;        // Valid until the reader is closed
+} SerialCaptureChunk;
+
+typedef struct SerialCaptureReader SerialCaptureReader;
+
+SerialCaptureReader* serial_capture_open(const char* path);
+void serial_capture_close_reader(SerialCaptureReader* reader);
+const SerialCaptureHeader* serial_capture_header(const SerialCaptureReader* reader);
+// Oldest chunk first; false at the end
+bool serial_capture_next(SerialCaptureReader* reader, SerialCaptureChunk* chunk);
+void serial_capture_rewind(SerialCaptureReader* reader);
+
+// Replay
+typedef struct {
+    double speed;               // 1.0 = recorded timing, N = N times faster, 0 = no delays
+    bool wait_for_tx;           // Hold responses until the host sends the recorded request
+    uint32_t tx_timeout_ms;     // How long to wait for a request (0 = 2000)
+} SerialReplayConfig;
+
+typedef struct {
+    bool running;
+    bool finished;              // Served the whole capture
+    uint64_t chunks;
+    uint64_t rx_bytes;          // Sent to the host
+    uint64_t tx_bytes;          // Received from the host
+    uint64_t tx_mismatches;     // Requests that differ from the capture
+    uint64_t tx_timeouts;       // Requests that never came
+    uint32_t late_max_us;       // Worst response delay past its schedule
+} SerialReplayStats;
+
+typedef struct SerialReplay SerialReplay;
+
+SerialReplay* serial_replay_start(const char* capture_path, const SerialReplayConfig* config);
+// Pseudo-terminal to connect to in place of the ECU port
+const char* serial_replay_port(const SerialReplay* replay);
+void serial_replay_get_stats(const SerialReplay* replay, SerialReplayStats* stats);
+void serial_replay_stop(SerialReplay* replay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERIAL_CAPTURE_H
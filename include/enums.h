@@ -65,7 +65,8 @@ typedef enum
 	GRATICULE,
 	HIGHLIGHT,
 	TTM_AXIS,
-	TTM_TRACE
+	TTM_TRACE,
+	EVENT_MARK
 }GcType;
 
 typedef enum
@@ -104,6 +104,7 @@ typedef enum
 	VE3D_FPS,
 	SET_SER_PORT,
 	LOGVIEW_ZOOM,
+	LOGVIEW_SPAN,
 	BAUD_CHANGE,
 	DEBUG_LEVEL,
 	GENERIC,
@@ -0,0 +1,58 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute, etc. this as long as all the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file include/log_parser.h
+  \ingroup Headers
+  \brief Header for the mmap based parallel datalog parser used by the
+  log viewer
+  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __LOG_PARSER_H__
+#define __LOG_PARSER_H__
+
+#include <stddef.h>
+
+typedef struct _LogParse LogParse;
+/*!
+ \brief _LogParse holds a delimited text datalog parsed into one float
+ array per field
+ */
+struct _LogParse
+{
+	char *signature;	/*!< Quoted ECU signature line, or NULL */
+	char delimiter;		/*!< ',' or '\t' */
+	int field_count;	/*!< Fields in the header line */
+	char **names;		/*!< Field names, trimmed */
+	int *precision;		/*!< Decimals of each field on the first data row */
+	float **columns;	/*!< field_count arrays of rows values */
+	size_t rows;		/*!< Data rows kept */
+	size_t markers;		/*!< MARK lines seen */
+	size_t skipped;		/*!< Non-numeric or malformed lines tossed */
+};
+
+/*!
+ \brief Progress callback, run on the calling thread with the fraction of
+ the file parsed so far
+ */
+typedef void (*LogParseProgress)(double fraction, void *data);
+
+/* Prototypes */
+LogParse *log_parse_file(const char *, int, LogParseProgress, void *);
+void log_parse_free(LogParse *);
+float *log_parse_take_column(LogParse *, int);
+/* Prototypes */
+
+#endif
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif
@@ -0,0 +1,46 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute, etc. this as long as all the source code
+ * is made available for FREE.
+ *
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file include/log_query.h
+  \ingroup Headers
+  \brief Header for the event search over loaded datalog fields
+  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __LOG_QUERY_H__
+#define __LOG_QUERY_H__
+
+#include <stddef.h>
+
+typedef struct _LogQuery LogQuery;
+typedef struct _LogQueryMatch LogQueryMatch;
+
+/*!
+ \brief _LogQueryMatch is one run of consecutive samples where the query
+ held
+ */
+struct _LogQueryMatch
+{
+	size_t first;		/*!< First matching sample */
+	size_t last;		/*!< Last matching sample */
+};
+
+/* Prototypes */
+LogQuery *log_query_compile(const char *, const char **, int, char **);
+void log_query_free(LogQuery *);
+size_t log_query_run(const LogQuery *, const float **, size_t, LogQueryMatch **);
+/* Prototypes */
+
+#endif
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif
@@ -0,0 +1,58 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute, etc. this as long as all the source code
+ * is made available for FREE.
+ *
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file include/log_summary.h
+  \ingroup Headers
+  \brief Header for the min/max/mean summary pyramid the log viewer draws
+  zoomed out traces from
+  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __LOG_SUMMARY_H__
+#define __LOG_SUMMARY_H__
+
+#include <stddef.h>
+
+#define LOG_SUMMARY_FANOUT 8	/*!< Samples per level 0 bucket, buckets per higher bucket */
+
+typedef struct _LogSummary LogSummary;
+typedef struct _LogSummaryChannel LogSummaryChannel;
+typedef struct _LogSummaryRange LogSummaryRange;
+
+/*!
+ \brief _LogSummaryRange is what a span of samples reduces to
+ */
+struct _LogSummaryRange
+{
+	float min;		/*!< Smallest sample */
+	float max;		/*!< Largest sample */
+	float mean;		/*!< Average of the samples */
+	size_t samples;		/*!< How many samples were covered */
+};
+
+/* Prototypes */
+LogSummary *log_summary_build(const float **, int, size_t, int);
+char *log_summary_cache_path(const char *);
+const LogSummaryChannel *log_summary_channel(const LogSummary *, int);
+void log_summary_free(LogSummary *);
+int log_summary_level_for(const LogSummary *, double);
+int log_summary_levels(const LogSummary *);
+LogSummary *log_summary_load(const char *, const char *, const float **, int, size_t);
+LogSummary *log_summary_open(const char *, const float **, int, size_t, int, int);
+size_t log_summary_query(const LogSummaryChannel *, size_t, size_t, LogSummaryRange *);
+int log_summary_save(const LogSummary *, const char *, const char *);
+/* Prototypes */
+
+#endif
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif
@@ -27,6 +27,8 @@ extern "C" {
 
 #include <defines.h>
 #include <gtk/gtk.h>
+#include <log_query.h>
+#include <log_summary.h>
 #include <watches.h>
 
 
@@ -44,6 +46,7 @@ typedef struct _Logview_Data Logview_Data;
 struct _Logview_Data
 {
 	GdkGC *highlight_gc;	/*!< GC used for the highlight */
+	GdkGC *event_gc;	/*!< GC used for event search marks */
 	GtkWidget *darea;	/*!< Trace drawing area... */
 	GdkPixmap *pixmap;	/*!< pointer to backing pixmap... */
 	GdkPixmap *pmap;	/*!< pointer to Win32 pixmap hack!!! */
@@ -68,15 +71,20 @@ struct _Log_Info
 	gchar *delimiter;	/*!< delimiter between fields for this logfile */
 	gchar *signature;	/*!< ECU signature of log */
 	GPtrArray *log_list;	/*!< List of objects */
+	LogSummary *summary;	/*!< Zoomed out min/max/mean of every field */
+	GArray *events;		/*!< LogQueryMatch runs of the last event search */
 };
 
 
 /* Prototypes */
 void allocate_buffers(Log_Info *);
+void attach_log_summary(Log_Info *, const gchar *);
 void create_stripchart(GtkWidget *);
 void free_log_info(Log_Info *);
 Log_Info * initialize_log_info(void);
 void load_logviewer_file(GIOChannel * );
+gboolean load_logviewer_mlg(const gchar *);
+gboolean load_logviewer_path(const gchar *);
 gboolean logviewer_scroll_speed_change(GtkWidget *, gpointer );
 void populate_limits(Log_Info *);
 void read_log_data(GIOChannel *, Log_Info * );
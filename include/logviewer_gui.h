@@ -30,6 +30,16 @@ extern "C" {
 #include <logviewer_core.h>
 #include <gtk/gtk.h>
 
+typedef enum
+{
+	COL_EVENT_NUMBER,
+	COL_EVENT_START,
+	COL_EVENT_LENGTH,
+	COL_EVENT_FIRST,
+	COL_EVENT_LAST,
+	EVENT_NUM_COLS
+}LvEventCols;
+
 typedef struct _Viewable_Value Viewable_Value;
 /*!
  \brief _Viewable_Value is the datastructure bound 
@@ -49,6 +59,7 @@ struct _Viewable_Value
 	gint last_y;			/*!< Last point on screen of trace */
 	gint last_index;		/*!< latest entryu into data array */
 	gchar *data_source;		/*!< Textual name of source */
+	gboolean live;			/*!< Source is the realtime history */
 	gfloat min;			/*!< for auto-scaling */
 	gfloat max;			/*!< for auto-scaling */
 	gfloat lower;			/*!< hard limits to use for scaling */
@@ -69,6 +80,7 @@ void finish_logviewer(void);
 GdkColor get_colors_from_hue(gfloat, gfloat, gfloat);
 GdkGC * initialize_gc(GdkDrawable *, GcType );
 gboolean logviewer_log_position_change(GtkWidget *, gpointer);
+gboolean logviewer_search_activate(GtkWidget *, gpointer);
 gboolean pb_update_logview_traces(gpointer);
 gboolean pb_update_logview_traces_wrapper(gpointer);
 void populate_viewer(void);
@@ -0,0 +1,48 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute, etc. this as long as all the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file include/lookuptable_inverse.h
+  \ingroup Headers
+  \brief Header for the precomputed lookuptable inverses used by the
+  reverse lookups
+  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __LOOKUPTABLE_INVERSE_H__
+#define __LOOKUPTABLE_INVERSE_H__
+
+#define LOOKUP_REVERSE_LEN 255		/* Entries the reverse lookups search */
+#define LOOKUP_INVERSE_MAX_SPAN 65536	/* Widest value range given a dense inverse */
+
+typedef struct _LookupInverse LookupInverse;
+/*!
+ \brief _LookupInverse maps every value between the smallest and largest
+ entry of a lookuptable to the index the reverse lookup scan would return
+ */
+struct _LookupInverse
+{
+	int base;		/*!< Smallest value in the table */
+	int span;		/*!< Number of values covered */
+	unsigned char *index;	/*!< Reverse lookup result per value */
+};
+
+/* Prototypes */
+LookupInverse *lookup_inverse_build(const int *, int);
+int lookup_inverse_find(const LookupInverse *, int);
+void lookup_inverse_free(LookupInverse *);
+int lookup_reverse_scan(const int *, int, int);
+/* Prototypes */
+
+#endif
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif
@@ -30,6 +30,7 @@ extern "C" {
 #define __LOOKUPTABLES_H__
 
 #include <enums.h>
+#include <lookuptable_inverse.h>
 
 
 typedef struct _LookupTable LookupTable;
@@ -40,6 +41,9 @@ typedef struct _LookupTable LookupTable;
 struct _LookupTable
 {
 	gint *array;		/*!< the table itself */
+	gint len;		/*!< entries in the table */
+	LookupInverse *inverse;	/*!< precomputed reverse lookups, NULL if
+				    the table must be scanned */
 	gchar *filename;	/*!< The relative filename where 
 				    this table came from */
 };
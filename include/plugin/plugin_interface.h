@@ -56,7 +56,8 @@ typedef enum {
     PLUGIN_STATUS_LOADED,      // Plugin loaded but not initialized
     PLUGIN_STATUS_INITIALIZED, // Plugin initialized and running
     PLUGIN_STATUS_ERROR,       // Plugin in error state
-    PLUGIN_STATUS_DISABLED     // Plugin disabled by user
+    PLUGIN_STATUS_DISABLED,    // Plugin disabled by user
+    PLUGIN_STATUS_INITIALIZING // init() running on a startup worker
 } PluginStatus;
 
 // ECU real-time data structure
@@ -88,6 +89,63 @@ typedef struct {
     uint64_t last_activity;
 } ECUConnectionStatus;
 
+// ECU plugin ABI versions (ECUPluginInterface.abi_version; 0 is treated as v1).
+// The layout up to each version is frozen: new members are only appended, each group
+// bumps the version, and hosts check abi_version before reading members past v2.
+#define ECU_PLUGIN_ABI_V1 1         // Fixed ECURealtimeData via read_realtime_data
+#define ECU_PLUGIN_ABI_V2 2         // Channel descriptor table + timestamped float frames
+#define ECU_PLUGIN_ABI_V3 3         // Hot reload session handoff
+#define ECU_PLUGIN_ABI_V4 4         // Realtime poll cadence
+#define ECU_PLUGIN_ABI_VERSION ECU_PLUGIN_ABI_V4
+
+// Channel storage on the ECU side (frame values are always floats)
+typedef enum {
+    ECU_CHANNEL_DATA_FLOAT,
+    ECU_CHANNEL_DATA_INT,
+    ECU_CHANNEL_DATA_BOOL
+} ECUChannelDataType;
+
+// ABI v2 channel descriptor; frame values are in engineering units,
+// scale/offset describe the raw ECU encoding (engineering = raw * scale + offset)
+typedef struct {
+    const char* name;           // Stable identifier, e.g. "rpm"
+    const char* unit;
+    float scale;
+    float offset;
+    ECUChannelDataType type;
+} ECUChannelDescriptor;
+
+// ABI v2 sample frame header; values follow descriptor order
+typedef struct {
+    uint64_t timestamp;         // Microseconds
+    uint32_t frame_id;          // Increments per published frame (0 = none yet)
+    uint32_t channel_count;     // Number of values written
+} ECUSampleHeader;
+
+// Open ECU session passed between plugin instances across a hot reload
+typedef struct {
+    int fd;                     // Open, configured transport; ownership moves with the handoff
+    char port[64];
+    int baud_rate;
+    char protocol[32];
+} ECUSessionHandoff;
+
+// Acquisition loop statistics for plugins that poll the ECU on a schedule
+typedef struct {
+    uint32_t target_hz;
+    float achieved_hz;          // Frames per second over the last stats window
+    uint32_t jitter_mean_us;    // Mean |sample interval - target period| over the last window
+    uint32_t jitter_max_us;
+    uint64_t frames;            // Valid frames decoded
+    uint64_t crc_errors;
+    uint64_t framing_errors;    // Bad start/stop byte, length or discarded bytes
+    uint64_t timeouts;          // Requests without a complete reply in time
+    uint64_t overruns;          // Poll deadlines missed because a poll ran long
+} ECUPollStats;
+
+// New sample notification (called from the plugin's acquisition thread)
+typedef void (*ECUSampleCallback)(void* user_data, uint64_t timestamp);
+
 // Enhanced ECU Plugin Interface for real hardware communication
 typedef struct {
     // Connection management
@@ -117,6 +175,26 @@ typedef struct {
     bool (*start_logging)(const char* log_path);
     bool (*stop_logging)(void);
     bool (*get_log_status)(char* status, int max_len);
+    
+    // Sample notification (optional - hosts poll read_realtime_data when NULL)
+    bool (*set_sample_callback)(ECUSampleCallback callback, void* user_data);
+    
+    // Latest-frame counter (optional) - unchanged id means read_realtime_data would return the same sample
+    uint32_t (*get_frame_id)(void);
+    
+    // ABI v2 - channel table is fixed between connect() calls; hosts re-query after connecting
+    int abi_version;
+    int (*get_channel_descriptors)(const ECUChannelDescriptor** descriptors);
+    bool (*read_sample_frame)(ECUSampleHeader* header, float* values, int max_values);
+    
+    // ABI v3 hot reload (optional) - the outgoing instance stops its I/O and hands over the open
+    // session without closing it; the replacement adopts it without a new handshake
+    bool (*detach_session)(ECUSessionHandoff* session);
+    bool (*attach_session)(const ECUSessionHandoff* session);
+    
+    // ABI v4 realtime poll cadence (optional)
+    bool (*set_poll_rate)(uint32_t rate_hz);
+    bool (*get_poll_stats)(ECUPollStats* stats);
 } ECUPluginInterface;
 
 // UI plugin interface
@@ -231,6 +309,10 @@ typedef struct {
     bool (*set_chart_style)(const char* chart_id, int style_preset);
     bool (*enable_animations)(const char* chart_id, bool enable);
     bool (*set_chart_theme)(const char* chart_id, const char* theme_name);
+    
+    // Pre-resolved series handles (optional - avoids per-point chart/series lookups)
+    int (*get_series_handle)(const char* chart_id, const char* series_name);
+    bool (*add_data_point_by_handle)(int series_handle, float x_value, float y_value);
 } DataVisualizationPluginInterface;
 
 // Chart types
@@ -323,6 +405,8 @@ typedef struct {
     void* data;
     size_t data_size;
     uint64_t timestamp;
+    int topic_id;               // Interned topic of event_name
+    void* payload;              // Owned copy of data (NULL when data is caller-owned)
 } PluginEvent;
 
 // Event callback function type
@@ -341,6 +425,15 @@ struct EventSystem {
     // Event handling
     void (*process_events)(void);
     void (*clear_events)(void);
+    
+    // Interned topics - publish_topic never takes a lock and may be called from any thread
+    int (*intern_topic)(const char* event_name);
+    bool (*subscribe_topic)(int topic_id, EventCallback callback);
+    bool (*publish_topic)(int topic_id, const void* data, size_t size);
+    
+    // Payload lifetime - keep event->data valid beyond the callback
+    void* (*retain_payload)(const PluginEvent* event);
+    void (*release_payload)(void* payload);
 };
 
 // Plugin manager interface
@@ -30,6 +30,76 @@ PluginInterface* get_plugin_by_index(int index);
 // Plugin system status
 bool is_plugin_system_initialized(void);
 
+// Event bus statistics
+typedef struct {
+    uint64_t published;         // Events accepted into the queue
+    uint64_t delivered;         // Callback invocations
+    uint64_t dropped;           // Events rejected because the queue was full
+    uint32_t queue_depth;       // Events currently queued
+    uint32_t queue_high_water;  // Deepest the queue has been
+    uint32_t queue_capacity;
+    int topic_count;
+} EventBusStats;
+
+typedef struct {
+    const char* name;
+    int topic_id;
+    int subscriber_count;
+    uint64_t published;
+    uint64_t dropped;
+} EventTopicStats;
+
+void get_event_bus_stats(EventBusStats* stats);
+int get_event_topic_stats(EventTopicStats* stats, int max_topics);
+
+// Plugin startup timing
+#define PLUGIN_INIT_TIMEOUT_MS_DEFAULT 5000
+
+typedef struct {
+    char name[64];
+    char path[256];
+    uint64_t scan_us;           // ELF check for get_plugin_interface
+    uint64_t load_us;           // dlopen + get_plugin_interface + validation
+    uint64_t init_us;           // init() wall time (so far, while pending)
+    bool init_pending;          // init() still running on a worker
+    bool init_failed;
+    bool init_timed_out;
+    uint32_t reload_count;      // Hot reloads since startup
+    uint64_t last_swap_us;      // Pause taken by the last hot reload
+} PluginStartupTiming;
+
+// Harvest finished init() jobs and enforce timeouts; call once per frame
+void plugin_system_poll(void);
+void plugin_system_set_init_timeout(uint32_t timeout_ms);
+bool plugin_system_startup_pending(void);
+int get_plugin_startup_report(PluginStartupTiming* report, int max_entries);
+
+// Hot reload: watch a plugin tree and swap changed libraries in place
+bool plugin_system_watch_directory(const char* directory);
+bool plugin_system_reload(const char* plugin_name);
+
+// Per-plugin update() timing and frame budget
+#define PLUGIN_UPDATE_BUDGET_US_DEFAULT 2000
+
+typedef struct {
+    char name[64];
+    uint64_t calls;
+    uint64_t skipped;           // Frames skipped by throttling or a busy worker
+    uint32_t mean_us;           // Over the recent window
+    uint32_t p99_us;            // Over the recent window
+    uint32_t max_us;            // Since load or the last reset
+    uint32_t last_us;
+    uint32_t over_budget;       // Calls that ran past the budget
+    int interval;               // update() runs every N frames
+    bool offloaded;             // update() runs on its own worker thread
+} PluginUpdateStats;
+
+void plugin_system_set_update_budget(uint32_t budget_us);
+uint32_t plugin_system_get_update_budget(void);
+int get_plugin_update_stats(PluginUpdateStats* stats, int max_entries);
+// Move a throttled or offloaded plugin back to every frame on the render thread
+bool plugin_system_reset_update_policy(const char* plugin_name);
+
 // Additional plugin functions
 bool is_plugin_system_initialized(void);
 int get_plugin_count(void);
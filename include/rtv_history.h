@@ -0,0 +1,75 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute, etc. this as long as all the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file include/rtv_history.h
+  \ingroup Headers
+  \brief Header for the bounded realtime variable history buffers
+  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __RTV_HISTORY_H__
+#define __RTV_HISTORY_H__
+
+#include <glib.h>
+
+#define RTV_HISTORY_BLOCK 1024		/* Samples per block */
+#define RTV_HISTORY_RESIDENT 8		/* Blocks kept in memory per variable */
+
+typedef struct _Rtv_Spill Rtv_Spill;
+typedef struct _Rtv_History Rtv_History;
+typedef struct _Rtv_History_Block Rtv_History_Block;
+
+/*!
+ \brief _Rtv_History_Block is one block of a history, either in memory or
+ compressed in the spill file
+ */
+struct _Rtv_History_Block
+{
+	gfloat *data;		/*!< Samples while in memory, NULL once spilled */
+	gboolean spilling;	/*!< Queued for the spill thread */
+	gint64 offset;		/*!< Compressed block offset in the spill file */
+	guint32 length;		/*!< Compressed size, 0 while in memory */
+};
+
+/*!
+ \brief _Rtv_History is the history of one derived variable. Indices are
+ absolute sample numbers since creation or the last clear, exactly as they
+ were with the old GArray; blocks older than the resident window are
+ compressed and read back on demand.
+ */
+struct _Rtv_History
+{
+	Rtv_Spill *spill;	/*!< Shared spill file and thread */
+	guint len;		/*!< Samples appended */
+	guint resident;		/*!< Blocks holding data in memory */
+	guint next_spill;	/*!< Oldest block not yet queued for spill */
+	guint generation;	/*!< Bumped on clear, stale spills are dropped */
+	GArray *blocks;		/*!< Rtv_History_Block per block */
+	gint cached_block;	/*!< Block held in cache, -1 for none */
+	gfloat *cache;		/*!< Last block read back from disk */
+};
+
+/* Prototypes */
+Rtv_Spill *rtv_spill_new(GMutex *);
+void rtv_spill_free(Rtv_Spill *);
+Rtv_History *rtv_history_new(Rtv_Spill *);
+void rtv_history_free(Rtv_History *);
+void rtv_history_append(Rtv_History *, gfloat);
+void rtv_history_clear(Rtv_History *);
+gfloat rtv_history_get(Rtv_History *, guint);
+gfloat rtv_history_last(Rtv_History *, guint);
+/* Prototypes */
+
+#endif
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif
@@ -29,14 +29,16 @@ extern "C" {
 #include <configfile.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <rtv_history.h>
+#include <rtv_plan.h>
 
 
 typedef struct _Rtv_Map Rtv_Map;
 
 /*!
  \brief _RtvMap is the RealTime Variables Map structure, containing fields to
- access the realtime derived data via a hashtable, and via raw index. Stores
- timestamps of each incoming data byte for advanced future use.
+ access the realtime derived data via a hashtable, and via raw index. Counts
+ the stored samples and keeps the first and latest timestamps.
  */
 
 
@@ -48,10 +50,15 @@ struct _Rtv_Map
 	gchar *applicable_signatures;/*!< Firmware revisions that use this map*/
 	GHashTable *offset_hash;/*!< Hashtable of rtv dervied values indexed by
 				  it's raw offset in the RTV block */
-	GArray *ts_array;	/*!< Timestamp array */
+	guint samples;		/*!< Samples stored since load or the last flush */
+	GTimeVal ts_first;	/*!< Timestamp of the first stored sample */
+	GTimeVal ts_last;	/*!< Timestamp of the latest sample */
 	GPtrArray *rtv_list;	/*!< List of derived vars IN ORDER */
 	GHashTable *rtv_hash;	/*!< Hashtable of rtv derived values indexed by
 				 * it's internal name */
+	Rtv_Spill *spill;	/*!< Spill file for old history blocks */
+	Rtv_Plan *plan;		/*!< Conversion plan, built on the first sample */
+	gfloat *values;		/*!< Latest values, indexed by derived var index */
 };
 
 
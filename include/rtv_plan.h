@@ -0,0 +1,112 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute, etc. this as long as all the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file include/rtv_plan.h
+  \ingroup Headers
+  \brief Header for the precompiled realtime variable conversion plan
+  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef __RTV_PLAN_H__
+#define __RTV_PLAN_H__
+
+#include <glib.h>
+#include <rtv_history.h>
+
+typedef struct _Rtv_Field Rtv_Field;
+typedef struct _Rtv_Step Rtv_Step;
+typedef struct _Rtv_Plan Rtv_Plan;
+
+/*!
+ \brief Rtv_Conv_Kind is how a step turns its raw field into a value. Every
+ kind but RTV_CONV_CALLBACK and RTV_CONV_LOOKUP runs entirely off the data
+ in the step.
+ */
+typedef enum
+{
+	RTV_CONV_RAW=0,		/*!< value = raw */
+	RTV_CONV_MULT,		/*!< value = raw * multiplier */
+	RTV_CONV_ADD_MULT,	/*!< value = (raw + adder) * multiplier */
+	RTV_CONV_EXPR,		/*!< compiled expression over raw fields */
+	RTV_CONV_CALLBACK,	/*!< specials, multi-expressions, ECU-var expressions */
+	RTV_CONV_LOOKUP		/*!< value = (callback + adder) * multiplier */
+}Rtv_Conv_Kind;
+
+/*!
+ \brief _Rtv_Field is one decoded location in the realtime block
+ */
+struct _Rtv_Field
+{
+	gint offset;		/*!< Byte offset in the realtime block */
+	guint8 width;		/*!< 1, 2 or 4 bytes */
+	gboolean is_signed;	/*!< Sign extend after assembling */
+	guint32 bitmask;	/*!< 0 for the whole field */
+	guint8 bitshift;	/*!< Applied after the mask */
+};
+
+/*!
+ \brief _Rtv_Step is one derived variable of the plan, in the order 
+ process_rt_vars() has always converted them
+ */
+struct _Rtv_Step
+{
+	Rtv_Conv_Kind kind;
+	Rtv_Field field;	/*!< Input for RAW/MULT/ADD_MULT, table index for LOOKUP */
+	gfloat multiplier;
+	gfloat adder;
+	void *compiled;		/*!< evaluator_compile() handle for EXPR */
+	gint symbol_count;	/*!< Expression inputs, in evaluator order */
+	Rtv_Field *symbols;
+	gdouble lower_limit;	/*!< Clamp for EXPR results */
+	gdouble upper_limit;
+	gboolean temp_dep;	/*!< Result is in ECU temperature units */
+	gint slot;		/*!< Destination index in the plan's value array */
+	gpointer object;	/*!< Owning derived variable object */
+	Rtv_History *history;	/*!< History buffer the value is appended to */
+};
+
+/*!
+ \brief _Rtv_Plan is the flattened conversion plan for a realtime map,
+ built once and then walked for every incoming sample
+ */
+struct _Rtv_Plan
+{
+	Rtv_Step *steps;	/*!< Conversion steps, in processing order */
+	guint count;		/*!< Steps in use */
+	guint allocated;	/*!< Steps allocated */
+	gboolean bigendian;	/*!< Byte order of the realtime block */
+	gdouble (*temp_to_host)(gdouble);/*!< Applied to temp_dep steps, may be NULL */
+	gint max_symbols;	/*!< Largest symbol_count, sizes the scratch */
+	gdouble *scratch;	/*!< Expression input values */
+};
+
+/*!
+ \brief Rtv_Plan_Callback converts a RTV_CONV_CALLBACK step the slow way, or
+ does the table lookup of a RTV_CONV_LOOKUP step
+ */
+typedef gfloat (*Rtv_Plan_Callback)(Rtv_Step *, guchar *, gpointer);
+
+/* Prototypes */
+Rtv_Plan *rtv_plan_new(gboolean);
+void rtv_plan_free(Rtv_Plan *);
+Rtv_Step *rtv_plan_add_step(Rtv_Plan *);
+gboolean rtv_plan_add_object(Rtv_Plan *, gconstpointer *);
+void rtv_plan_finish(Rtv_Plan *);
+void rtv_field_init(Rtv_Field *, gint, guint8, gboolean, guint32);
+gint rtv_field_decode(const Rtv_Field *, const guchar *, gboolean);
+void rtv_plan_execute(Rtv_Plan *, guchar *, gfloat *, Rtv_Plan_Callback, gpointer);
+/* Prototypes */
+
+#endif
+#ifdef __cplusplus
+} /* closing brace for extern "C" */
+#endif
@@ -29,6 +29,7 @@ extern "C" {
 #include <gtk/gtk.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <rtv_history.h>
 
 
 typedef struct _Rt_Slider Rt_Slider;
@@ -53,7 +54,7 @@ struct _Rt_Slider
 	gint lower;		/*!< Lower limit */
 	gint upper;		/*!< Upper limit */
 	gboolean temp_dep;	/*!< Temp dependancy flags to adjust upper/lower dynamically */
-	GArray *history;	/*!< where the data is from */
+	Rtv_History *history;	/*!< where the data is from */
 	gfloat last_percentage;	/*!< last percentage of on screen slider */
 	gconstpointer *object;		/*!< object of obsession.... */
 	gboolean enabled;	/*!< Pretty obvious */
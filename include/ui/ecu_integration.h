@@ -52,6 +52,8 @@ void cleanup_ecu_integration(void);
 // ECU communication management
 bool init_ecu_communication(void);
 void cleanup_ecu_communication(void);
+// Datalog column set for the current connection (INI field types when one is loaded)
+void configure_ecu_datalog_channels(ECUContext* ctx);
 
 // Speeduino protocol implementation
 void speeduino_init(void);
@@ -69,6 +71,7 @@ void speeduino_update_connection_status(void);
 // ECU data management
 void update_ecu_data(void);
 const ECUData* get_ecu_data(void);
+ECUContext* get_ecu_context(void);
 bool is_ecu_connected(void);
 const char* get_ecu_status(void);
 
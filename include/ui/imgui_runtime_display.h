@@ -69,6 +69,9 @@ typedef struct {
     uint32_t last_check;
     void* color;  // ImVec4* in C++ implementation
     int priority;  // 0=info, 1=warning, 2=danger, 3=critical
+    int rule_id;   // Compiled rule in the alert engine (-1 if condition is invalid)
+    uint32_t trigger_count;
+    char compile_error[96];
 } AlertConfig;
 
 // ImGui Runtime Display state
@@ -0,0 +1,401 @@
+/*
+ * This file is part of GNU libmatheval
+ *
+ * GNU libmatheval is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * GNU libmatheval is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU libmatheval.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+  \file mtxmatheval/bytecode.c
+  \ingroup MtxMatheval
+  \brief compiles function trees to flat bytecode and evaluates it
+  */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "common.h"
+#include "bytecode.h"
+
+/*!
+ \brief Compiler state.
+ */
+typedef struct {
+	Bytecode       *bytecode;	/*!< Program being built.  */
+	int             capacity;	/*!< Allocated instructions.  */
+	int             depth;	/*!< Stack depth at current point.  */
+	char          **names;	/*!< Variable names bound to slots.  */
+	int             ok;	/*!< Cleared on unresolved variable.  */
+} Compiler;
+
+/* Check whether subtree rooted at given node references any variable. */
+static int
+node_is_constant(Node * node)
+{
+	switch (node->type) {
+	case 'n':
+	case 'c':
+		return TRUE;
+
+	case 'v':
+		return FALSE;
+
+	case 'f':
+		return node_is_constant(node->data.function.child);
+
+	case 'u':
+		return node_is_constant(node->data.un_op.child);
+
+	case 'b':
+		return node_is_constant(node->data.bin_op.left)
+		    && node_is_constant(node->data.bin_op.right);
+	}
+
+	return FALSE;
+}
+
+/* Append instruction to program and track resulting stack depth. */
+static Instruction *
+emit(Compiler * compiler, Opcode op, int stack_change)
+{
+	Bytecode       *bytecode = compiler->bytecode;
+	Instruction    *instruction;
+
+	if (bytecode->length == compiler->capacity) {
+		compiler->capacity *= 2;
+		bytecode->code =
+		    XREALLOC(Instruction, bytecode->code,
+			     compiler->capacity);
+	}
+	instruction = &bytecode->code[bytecode->length++];
+	instruction->op = op;
+	instruction->arg.constant = 0;
+
+	compiler->depth += stack_change;
+	if (compiler->depth > bytecode->stack_depth)
+		bytecode->stack_depth = compiler->depth;
+	return instruction;
+}
+
+/* Map binary operation to its stack and constant operand forms. */
+static Opcode
+binary_opcode(char operation, int constant_right)
+{
+	switch (operation) {
+	case '+':
+		return constant_right ? OP_ADDK : OP_ADD;
+	case '-':
+		return constant_right ? OP_SUBK : OP_SUB;
+	case '*':
+		return constant_right ? OP_MULK : OP_MUL;
+	case '/':
+		return constant_right ? OP_DIVK : OP_DIV;
+	}
+	return constant_right ? OP_POWK : OP_POW;
+}
+
+/* Emit code leaving value of subtree rooted at given node on stack. */
+static void
+compile_node(Compiler * compiler, Node * node)
+{
+	Node           *left,
+	               *right;
+	char            operation;
+	int             i;
+
+	/* Fold subtrees without variables to single constant. */
+	if (node_is_constant(node)) {
+		emit(compiler, OP_CONST, 1)->arg.constant =
+		    node_evaluate(node);
+		return;
+	}
+
+	switch (node->type) {
+	case 'v':
+		for (i = 0; i < compiler->bytecode->count; i++)
+			if (!strcmp(compiler->names[i],
+				    node->data.variable->name))
+				break;
+		if (i == compiler->bytecode->count)
+			compiler->ok = FALSE;
+		emit(compiler, OP_VAR, 1)->arg.slot = i;
+		return;
+
+	case 'f':
+		compile_node(compiler, node->data.function.child);
+		emit(compiler, OP_CALL, 0)->arg.function =
+		    node->data.function.record->data.function;
+		return;
+
+	case 'u':
+		compile_node(compiler, node->data.un_op.child);
+		emit(compiler, OP_NEG, 0);
+		return;
+
+	case 'b':
+		left = node->data.bin_op.left;
+		right = node->data.bin_op.right;
+		operation = node->data.bin_op.operation;
+
+		/* Constant right operand is carried by instruction. */
+		if (node_is_constant(right)) {
+			compile_node(compiler, left);
+			emit(compiler, binary_opcode(operation, TRUE),
+			     0)->arg.constant = node_evaluate(right);
+			return;
+		}
+
+		/* Constant left operand likewise, swapping operands
+		 * where operation is not commutative. */
+		if (node_is_constant(left) && operation != '^') {
+			compile_node(compiler, right);
+			switch (operation) {
+			case '-':
+				emit(compiler, OP_RSUBK, 0)->arg.constant =
+				    node_evaluate(left);
+				return;
+			case '/':
+				emit(compiler, OP_RDIVK, 0)->arg.constant =
+				    node_evaluate(left);
+				return;
+			}
+			emit(compiler, binary_opcode(operation, TRUE),
+			     0)->arg.constant = node_evaluate(left);
+			return;
+		}
+
+		compile_node(compiler, left);
+		compile_node(compiler, right);
+		emit(compiler, binary_opcode(operation, FALSE), -1);
+		return;
+	}
+}
+
+Bytecode       *
+bytecode_compile(Node * node, int count, char **names)
+{
+	Compiler        compiler;	/* Compiler state.  */
+
+	compiler.bytecode = XMALLOC(Bytecode, 1);
+	compiler.bytecode->length = 0;
+	compiler.bytecode->stack_depth = 0;
+	compiler.bytecode->count = count;
+	compiler.capacity = 16;
+	compiler.bytecode->code = XMALLOC(Instruction, compiler.capacity);
+	compiler.depth = 0;
+	compiler.names = names;
+	compiler.ok = TRUE;
+
+	compile_node(&compiler, node);
+
+	if (!compiler.ok
+	    || compiler.bytecode->stack_depth > BYTECODE_MAX_STACK) {
+		bytecode_destroy(compiler.bytecode);
+		return NULL;
+	}
+	return compiler.bytecode;
+}
+
+void
+bytecode_destroy(Bytecode * bytecode)
+{
+	if (!bytecode)
+		return;
+	XFREE(bytecode->code);
+	XFREE(bytecode);
+}
+
+double
+bytecode_evaluate(Bytecode * bytecode, double *values)
+{
+	double          stack[BYTECODE_MAX_STACK];	/* Operand stack. */
+	Instruction    *instruction = bytecode->code;	/* Current
+							 * instruction. */
+	Instruction    *end = bytecode->code + bytecode->length;
+	int             top = -1;	/* Index of top of stack.  */
+
+	for (; instruction < end; instruction++) {
+		switch (instruction->op) {
+		case OP_CONST:
+			stack[++top] = instruction->arg.constant;
+			break;
+		case OP_VAR:
+			stack[++top] = values[instruction->arg.slot];
+			break;
+		case OP_ADD:
+			top--;
+			stack[top] += stack[top + 1];
+			break;
+		case OP_SUB:
+			top--;
+			stack[top] -= stack[top + 1];
+			break;
+		case OP_MUL:
+			top--;
+			stack[top] *= stack[top + 1];
+			break;
+		case OP_DIV:
+			top--;
+			stack[top] /= stack[top + 1];
+			break;
+		case OP_POW:
+			top--;
+			stack[top] = pow(stack[top], stack[top + 1]);
+			break;
+		case OP_NEG:
+			stack[top] = -stack[top];
+			break;
+		case OP_CALL:
+			stack[top] = (*instruction->arg.function) (stack[top]);
+			break;
+		case OP_ADDK:
+			stack[top] += instruction->arg.constant;
+			break;
+		case OP_SUBK:
+			stack[top] -= instruction->arg.constant;
+			break;
+		case OP_MULK:
+			stack[top] *= instruction->arg.constant;
+			break;
+		case OP_DIVK:
+			stack[top] /= instruction->arg.constant;
+			break;
+		case OP_POWK:
+			stack[top] = pow(stack[top], instruction->arg.constant);
+			break;
+		case OP_RSUBK:
+			stack[top] = instruction->arg.constant - stack[top];
+			break;
+		case OP_RDIVK:
+			stack[top] = instruction->arg.constant / stack[top];
+			break;
+		}
+	}
+
+	return stack[0];
+}
+
+void
+bytecode_evaluate_n(Bytecode * bytecode, double *inputs, double *outputs,
+		    int n)
+{
+	/* Stack of sample blocks; each instruction is applied to a whole
+	 * block so dispatch cost is paid once per BYTECODE_BLOCK samples. */
+	double          stack[BYTECODE_MAX_STACK][BYTECODE_BLOCK];
+	Instruction    *instruction;
+	Instruction    *end = bytecode->code + bytecode->length;
+	double         *a,
+	               *b;
+	double          k;
+	int             count = bytecode->count;
+	int             base,
+	                block,
+	                top,
+	                i;
+
+	for (base = 0; base < n; base += BYTECODE_BLOCK) {
+		block = n - base < BYTECODE_BLOCK ? n - base : BYTECODE_BLOCK;
+		top = -1;
+
+		for (instruction = bytecode->code; instruction < end;
+		     instruction++) {
+			a = stack[top > 0 ? top - 1 : 0];
+			b = stack[top >= 0 ? top : 0];
+			k = instruction->arg.constant;
+
+			switch (instruction->op) {
+			case OP_CONST:
+				b = stack[++top];
+				for (i = 0; i < block; i++)
+					b[i] = k;
+				break;
+			case OP_VAR:
+				b = stack[++top];
+				for (i = 0; i < block; i++)
+					b[i] =
+					    inputs[(base + i) * count +
+						   instruction->arg.slot];
+				break;
+			case OP_ADD:
+				for (i = 0; i < block; i++)
+					a[i] += b[i];
+				top--;
+				break;
+			case OP_SUB:
+				for (i = 0; i < block; i++)
+					a[i] -= b[i];
+				top--;
+				break;
+			case OP_MUL:
+				for (i = 0; i < block; i++)
+					a[i] *= b[i];
+				top--;
+				break;
+			case OP_DIV:
+				for (i = 0; i < block; i++)
+					a[i] /= b[i];
+				top--;
+				break;
+			case OP_POW:
+				for (i = 0; i < block; i++)
+					a[i] = pow(a[i], b[i]);
+				top--;
+				break;
+			case OP_NEG:
+				for (i = 0; i < block; i++)
+					b[i] = -b[i];
+				break;
+			case OP_CALL:
+				for (i = 0; i < block; i++)
+					b[i] =
+					    (*instruction->arg.
+					     function) (b[i]);
+				break;
+			case OP_ADDK:
+				for (i = 0; i < block; i++)
+					b[i] += k;
+				break;
+			case OP_SUBK:
+				for (i = 0; i < block; i++)
+					b[i] -= k;
+				break;
+			case OP_MULK:
+				for (i = 0; i < block; i++)
+					b[i] *= k;
+				break;
+			case OP_DIVK:
+				for (i = 0; i < block; i++)
+					b[i] /= k;
+				break;
+			case OP_POWK:
+				for (i = 0; i < block; i++)
+					b[i] = pow(b[i], k);
+				break;
+			case OP_RSUBK:
+				for (i = 0; i < block; i++)
+					b[i] = k - b[i];
+				break;
+			case OP_RDIVK:
+				for (i = 0; i < block; i++)
+					b[i] = k / b[i];
+				break;
+			}
+		}
+
+		memcpy(outputs + base, stack[0], block * sizeof(double));
+	}
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of GNU libmatheval
+ *
+ * GNU libmatheval is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * GNU libmatheval is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU libmatheval.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+  \file mtxmatheval/bytecode.h
+  \ingroup MtxMatheval
+  \brief flat bytecode form of function trees
+  */
+
+#ifndef BYTECODE_H
+#define BYTECODE_H 1
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "node.h"
+
+/* Deepest operand stack a program may use; deeper trees are not
+ * compiled and callers keep using the tree walker. */
+#define BYTECODE_MAX_STACK 16
+
+/* Samples evaluated per instruction by bytecode_evaluate_n(). */
+#define BYTECODE_BLOCK 64
+
+/*!
+ \brief Bytecode operations.  Operations ending in K take their right
+ operand from the instruction instead of the stack.
+ */
+typedef enum {
+	OP_CONST,		/*!< Push constant.  */
+	OP_VAR,			/*!< Push input slot.  */
+	OP_ADD,
+	OP_SUB,
+	OP_MUL,
+	OP_DIV,
+	OP_POW,
+	OP_NEG,
+	OP_CALL,		/*!< Replace top of stack with function of it.  */
+	OP_ADDK,
+	OP_SUBK,
+	OP_MULK,
+	OP_DIVK,
+	OP_POWK,
+	OP_RSUBK,		/*!< Top = constant - top.  */
+	OP_RDIVK		/*!< Top = constant / top.  */
+} Opcode;
+
+/*!
+ \brief Single bytecode instruction.
+ */
+typedef struct {
+	Opcode          op;	/*!< Operation.  */
+	union {
+		double          constant;	/*!< Constant operand.  */
+		int             slot;	/*!< Input slot for OP_VAR.  */
+		double          (*function) (double);	/*!< Function for
+							 * OP_CALL.  */
+	} arg;	/*!< Operand.  */
+} Instruction;
+
+/*!
+ \brief Compiled function: linear stack program over numbered input
+ slots, with constant subtrees folded.
+ */
+typedef struct {
+	Instruction    *code;	/*!< Program.  */
+	int             length;	/*!< Number of instructions.  */
+	int             stack_depth;	/*!< Deepest stack the program uses. */
+	int             count;	/*!< Input slots per sample.  */
+} Bytecode;
+
+/* Compile tree rooted at given node.  Variables are bound to slots by
+ * their position in names array (count elements).  Function returns null 
+ * pointer if tree references a variable not in names or needs a deeper
+ * stack than BYTECODE_MAX_STACK. */
+Bytecode       *bytecode_compile(Node * node, int count, char **names);
+
+/* Destroy compiled function.  */
+void            bytecode_destroy(Bytecode * bytecode);
+
+/* Evaluate compiled function for one sample (values has count elements). 
+ */
+double          bytecode_evaluate(Bytecode * bytecode, double *values);
+
+/* Evaluate compiled function for n samples.  Inputs are stored sample
+ * after sample, count values each; one output is written per sample. */
+void            bytecode_evaluate_n(Bytecode * bytecode, double *inputs,
+				    double *outputs, int n);
+
+#endif
@@ -33,6 +33,7 @@
 #include "gtk/gtk.h"
 #include "common.h"
 #include "node.h"
+#include "bytecode.h"
 #include <string.h>
 
 /* Minimal length of evaluator symbol table.  */
@@ -289,3 +290,30 @@ evaluator_derivative_z(void *evaluator)
 	/* Differentiate function using derivation variable "z". */
 	return evaluator_derivative(evaluator, "z");
 }
+
+G_MODULE_EXPORT void           *
+evaluator_compile(void *evaluator, int count, char **names)
+{
+	/* Compile tree representation of function to bytecode. */
+	return bytecode_compile(((Evaluator *) evaluator)->root, count,
+				names);
+}
+
+G_MODULE_EXPORT void
+evaluator_compiled_destroy(void *compiled)
+{
+	bytecode_destroy((Bytecode *) compiled);
+}
+
+G_MODULE_EXPORT double
+evaluator_compiled_evaluate(void *compiled, double *values)
+{
+	return bytecode_evaluate((Bytecode *) compiled, values);
+}
+
+G_MODULE_EXPORT void
+evaluator_evaluate_n(void *compiled, double *inputs, double *outputs,
+		     int n)
+{
+	bytecode_evaluate_n((Bytecode *) compiled, inputs, outputs, n);
+}
@@ -93,6 +93,30 @@ extern          "C" {
 	extern void    *evaluator_derivative_y(void *evaluator);
 	extern void    *evaluator_derivative_z(void *evaluator);
 
+	/* Compile function represented by evaluator to flat bytecode.
+	 * Variables are bound to input slots by their position in names
+	 * array (count elements) and constant subexpressions are folded.
+	 * Function returns null pointer if function references a variable
+	 * not in names or is too deeply nested to compile, in which case
+	 * evaluator_evaluate() should be used.  Compiled function does not
+	 * reference evaluator and must be destroyed separately. */
+	extern void    *evaluator_compile(void *evaluator, int count,
+					  char **names);
+
+	/* Destroy compiled function. */
+	extern void     evaluator_compiled_destroy(void *compiled);
+
+	/* Evaluate compiled function for one sample; values holds one
+	 * value per input slot. */
+	extern double   evaluator_compiled_evaluate(void *compiled,
+						    double *values);
+
+	/* Evaluate compiled function for n samples.  Inputs are stored
+	 * sample after sample, one value per input slot each; outputs
+	 * receives one value per sample. */
+	extern void     evaluator_evaluate_n(void *compiled, double *inputs,
+					     double *outputs, int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,10 +8,12 @@
 #include <errno.h>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/select.h>
 #include <pthread.h>
 // JSON support temporarily disabled - using simple string parsing instead
 
 #include "../../../include/plugin/plugin_interface.h"
+#include "../../../include/ecu/ecu_seqlock.h"
 
 // Speeduino-specific constants
 #define SPEEDUINO_BAUD_RATE 115200
@@ -30,6 +32,19 @@
 #define SPEEDUINO_CMD_BURN 'U'
 #define SPEEDUINO_CMD_GET_VERSION 'V'
 
+// Packet framing shared with the core (src/ecu/ecu_communication.c):
+// start, command, length, payload[length], CRC16 high, CRC16 low, stop
+#define SPEEDUINO_START_BYTE 0x72
+#define SPEEDUINO_STOP_BYTE 0x03
+#define SPEEDUINO_FRAME_OVERHEAD 6
+#define SPEEDUINO_RT_MIN_LENGTH 120         // Realtime payloads are 120 or 130 bytes
+
+// Realtime poll loop
+#define SPEEDUINO_POLL_RATE_HZ_DEFAULT 25
+#define SPEEDUINO_POLL_RATE_HZ_MAX 200
+#define SPEEDUINO_REPLY_TIMEOUT_US 100000   // Minimum wait for a reply, even at high poll rates
+#define SPEEDUINO_STATS_WINDOW_US 1000000
+
 // Speeduino communication states
 typedef enum {
     SPEEDUINO_STATE_DISCONNECTED,
@@ -38,6 +53,40 @@ typedef enum {
     SPEEDUINO_STATE_ERROR
 } SpeeduinoState;
 
+// Realtime channels published through the v2 frame interface
+typedef enum {
+    SPD_CH_RPM,
+    SPD_CH_MAP,
+    SPD_CH_COOLANT_TEMP,
+    SPD_CH_AIR_TEMP,
+    SPD_CH_THROTTLE,
+    SPD_CH_AFR,
+    SPD_CH_TIMING,
+    SPD_CH_FUEL_PRESSURE,
+    SPD_CH_OIL_PRESSURE,
+    SPD_CH_BATTERY_VOLTAGE,
+    SPD_CH_COUNT
+} SpeeduinoChannel;
+
+static const ECUChannelDescriptor g_speeduino_channels[SPD_CH_COUNT] = {
+    {"rpm",             "RPM", 1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"map",             "kPa", 1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"coolant_temp",    "°C",  1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"air_temp",        "°C",  1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"throttle",        "%",   0.5f,  0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"afr",             "AFR", 0.1f,  0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"timing",          "°",   1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"fuel_pressure",   "PSI", 1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"oil_pressure",    "PSI", 1.0f,  0.0f, ECU_CHANNEL_DATA_INT},
+    {"battery_voltage", "V",   0.1f,  0.0f, ECU_CHANNEL_DATA_FLOAT},
+};
+
+// One published sample: timestamp plus values in g_speeduino_channels order
+typedef struct {
+    uint64_t timestamp;
+    float values[SPD_CH_COUNT];
+} SpeeduinoFrame;
+
 // Speeduino plugin context
 typedef struct {
     SpeeduinoState state;
@@ -49,27 +98,39 @@ typedef struct {
     char log_path[256];
     FILE* log_file;
     
-    // Communication buffers
-    char tx_buffer[SPEEDUINO_BUFFER_SIZE];
-    char rx_buffer[SPEEDUINO_BUFFER_SIZE];
+    // Receive buffer for frame reassembly (comm thread only)
+    uint8_t rx_buffer[SPEEDUINO_BUFFER_SIZE];
     int rx_buffer_pos;
     
-    // Data cache
-    ECURealtimeData cached_data;
-    time_t last_data_update;
+    // Data cache (written under data_mutex, then published to frame)
+    SpeeduinoFrame cached_frame;
+    
+    // Latest published sample, read lock-free by the realtime readers
+    ECUSeqlock frame_lock;
+    SpeeduinoFrame frame;
     
     // Threading
     pthread_t comm_thread;
     bool thread_running;
-    pthread_mutex_t data_mutex;
+    pthread_mutex_t data_mutex;     // Serializes writers of cached_frame/frame
     
     // Configuration (simplified for now)
     char config_buffer[1024];
     bool config_loaded;
     
-    // Real-time data request interval
-    time_t last_data_request;
-    int data_request_interval_ms;
+    // Realtime poll cadence and statistics (stats written under data_mutex)
+    uint32_t poll_rate_hz;
+    ECUPollStats poll_stats;
+    uint64_t window_start_us;       // Monotonic start of the current stats window
+    uint64_t window_frames;
+    uint64_t window_intervals;      // Intervals measured in the window (jitter samples)
+    uint64_t window_jitter_sum_us;
+    uint32_t window_jitter_max_us;
+    uint64_t last_sample_us;        // Monotonic arrival of the previous frame
+    
+    // New sample notification (set by the host's data bridge)
+    ECUSampleCallback sample_callback;
+    void* sample_callback_data;
 } SpeeduinoContext;
 
 // Global plugin context
@@ -94,83 +155,301 @@ static bool speeduino_validate_connection(void);
 static bool speeduino_start_logging(const char* log_path);
 static bool speeduino_stop_logging(void);
 static bool speeduino_get_log_status(char* status, int max_len);
+static bool speeduino_set_sample_callback(ECUSampleCallback callback, void* user_data);
+static uint32_t speeduino_get_frame_id(void);
+static int speeduino_get_channel_descriptors(const ECUChannelDescriptor** descriptors);
+static bool speeduino_read_sample_frame(ECUSampleHeader* header, float* values, int max_values);
+static bool speeduino_detach_session(ECUSessionHandoff* session);
+static bool speeduino_attach_session(const ECUSessionHandoff* session);
+static bool speeduino_set_poll_rate(uint32_t rate_hz);
+static bool speeduino_get_poll_stats(ECUPollStats* stats);
+static uint16_t calculate_crc16(const uint8_t* data, size_t length);
+
+static_assert(sizeof(SpeeduinoFrame) % sizeof(uint32_t) == 0, "SpeeduinoFrame must be a whole number of words");
+
+static uint64_t speeduino_timestamp_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// Scheduling clock; unaffected by wall clock adjustments
+static uint64_t speeduino_monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void speeduino_sleep_until(uint64_t deadline_us) {
+    struct timespec ts;
+    ts.tv_sec = deadline_us / 1000000;
+    ts.tv_nsec = (deadline_us % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+// Stamp cached_frame and publish it to readers (call with data_mutex held)
+static void speeduino_publish_frame(SpeeduinoContext* ctx, uint64_t timestamp) {
+    ctx->cached_frame.timestamp = timestamp;
+    ecu_seqlock_publish(&ctx->frame_lock, &ctx->frame, &ctx->cached_frame, sizeof(SpeeduinoFrame));
+}
+
+// Notify the host that a new frame was published a new sample (call without data_mutex held)
+static void speeduino_notify_sample(SpeeduinoContext* ctx, uint64_t timestamp) {
+    ECUSampleCallback callback = ctx->sample_callback;
+    if (callback) {
+        callback(ctx->sample_callback_data, timestamp);
+    }
+}
+
+static bool speeduino_send_request(SpeeduinoContext* ctx, uint8_t command) {
+    uint8_t packet[SPEEDUINO_FRAME_OVERHEAD];
+    packet[0] = SPEEDUINO_START_BYTE;
+    packet[1] = command;
+    packet[2] = 0;
+    uint16_t crc = calculate_crc16(&packet[1], 2);
+    packet[3] = (crc >> 8) & 0xFF;
+    packet[4] = crc & 0xFF;
+    packet[5] = SPEEDUINO_STOP_BYTE;
+    return write(ctx->serial_fd, packet, sizeof(packet)) == (ssize_t)sizeof(packet);
+}
+
+// Drop the first count bytes of the receive buffer (comm thread only)
+static void speeduino_consume(SpeeduinoContext* ctx, int count) {
+    memmove(ctx->rx_buffer, ctx->rx_buffer + count, ctx->rx_buffer_pos - count);
+    ctx->rx_buffer_pos -= count;
+}
+
+// Frame reassembly results
+#define SPEEDUINO_FRAME_CORRUPT -1          // A whole frame arrived but failed its CRC
+#define SPEEDUINO_FRAME_INCOMPLETE 0
+#define SPEEDUINO_FRAME_OK 1
+
+// Pull one CRC-valid frame out of the receive buffer, resyncing past garbage.
+// Error counters are updated under data_mutex.
+static int speeduino_extract_frame(SpeeduinoContext* ctx, uint8_t* command, uint8_t* payload, int* length) {
+    for (;;) {
+        int start = 0;
+        while (start < ctx->rx_buffer_pos && ctx->rx_buffer[start] != SPEEDUINO_START_BYTE) {
+            start++;
+        }
+        if (start > 0) {
+            speeduino_consume(ctx, start);
+            pthread_mutex_lock(&ctx->data_mutex);
+            ctx->poll_stats.framing_errors++;
+            pthread_mutex_unlock(&ctx->data_mutex);
+        }
+        if (ctx->rx_buffer_pos < 3) {
+            return SPEEDUINO_FRAME_INCOMPLETE;
+        }
+        
+        int data_length = ctx->rx_buffer[2];
+        int total = data_length + SPEEDUINO_FRAME_OVERHEAD;
+        if (ctx->rx_buffer_pos < total) {
+            return SPEEDUINO_FRAME_INCOMPLETE;
+        }
+        
+        const uint8_t* frame = ctx->rx_buffer;
+        uint16_t received_crc = (frame[3 + data_length] << 8) | frame[4 + data_length];
+        bool framed = frame[5 + data_length] == SPEEDUINO_STOP_BYTE;
+        if (!framed) {
+            // Not a frame after all: skip this start byte and rescan
+            pthread_mutex_lock(&ctx->data_mutex);
+            ctx->poll_stats.framing_errors++;
+            pthread_mutex_unlock(&ctx->data_mutex);
+            speeduino_consume(ctx, 1);
+            continue;
+        }
+        
+        *command = frame[1];
+        *length = data_length;
+        if (calculate_crc16(&frame[1], 2 + data_length) != received_crc) {
+            pthread_mutex_lock(&ctx->data_mutex);
+            ctx->poll_stats.crc_errors++;
+            pthread_mutex_unlock(&ctx->data_mutex);
+            speeduino_consume(ctx, total);
+            return SPEEDUINO_FRAME_CORRUPT;
+        }
+        
+        memcpy(payload, &frame[3], data_length);
+        speeduino_consume(ctx, total);
+        return SPEEDUINO_FRAME_OK;
+    }
+}
 
-// Communication thread function
+// Read until a reply to command arrives or deadline_us (monotonic) passes.
+// Returns a SPEEDUINO_FRAME_* result; INCOMPLETE means the reply timed out.
+static int speeduino_receive_frame(SpeeduinoContext* ctx, uint8_t command, uint64_t deadline_us,
+                                   uint8_t* payload, int* length) {
+    for (;;) {
+        uint8_t frame_command;
+        int result;
+        while ((result = speeduino_extract_frame(ctx, &frame_command, payload, length)) != SPEEDUINO_FRAME_INCOMPLETE) {
+            if (frame_command == command) {
+                return result;
+            }
+        }
+        
+        uint64_t now = speeduino_monotonic_us();
+        if (now >= deadline_us || !ctx->thread_running) {
+            return SPEEDUINO_FRAME_INCOMPLETE;
+        }
+        
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(ctx->serial_fd, &read_fds);
+        struct timeval timeout;
+        timeout.tv_sec = (deadline_us - now) / 1000000;
+        timeout.tv_usec = (deadline_us - now) % 1000000;
+        int ready = select(ctx->serial_fd + 1, &read_fds, NULL, NULL, &timeout);
+        if (ready < 0 && errno != EINTR) {
+            return SPEEDUINO_FRAME_INCOMPLETE;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+        
+        if (ctx->rx_buffer_pos == SPEEDUINO_BUFFER_SIZE) {
+            // Full of bytes that never formed a frame
+            pthread_mutex_lock(&ctx->data_mutex);
+            ctx->poll_stats.framing_errors++;
+            pthread_mutex_unlock(&ctx->data_mutex);
+            ctx->rx_buffer_pos = 0;
+        }
+        ssize_t bytes_read = read(ctx->serial_fd, ctx->rx_buffer + ctx->rx_buffer_pos,
+                                  SPEEDUINO_BUFFER_SIZE - ctx->rx_buffer_pos);
+        if (bytes_read > 0) {
+            ctx->rx_buffer_pos += (int)bytes_read;
+        } else if (bytes_read < 0 && errno != EAGAIN && errno != EINTR) {
+            return SPEEDUINO_FRAME_INCOMPLETE;
+        }
+    }
+}
+
+// Decode a realtime payload using the same offsets as the core's speeduino_parse_response()
+static void speeduino_decode_realtime(SpeeduinoFrame* frame, const uint8_t* data) {
+    frame->values[SPD_CH_RPM] = data[14] | (data[15] << 8);
+    frame->values[SPD_CH_MAP] = data[4] | (data[5] << 8);
+    frame->values[SPD_CH_AIR_TEMP] = data[6];
+    frame->values[SPD_CH_COOLANT_TEMP] = data[7];
+    frame->values[SPD_CH_BATTERY_VOLTAGE] = data[9] * 0.1f;
+    frame->values[SPD_CH_AFR] = data[10] * 0.1f;
+    frame->values[SPD_CH_TIMING] = (int8_t)data[24];
+    frame->values[SPD_CH_THROTTLE] = data[25] * 0.5f;
+    frame->values[SPD_CH_FUEL_PRESSURE] = 0.0f;
+    frame->values[SPD_CH_OIL_PRESSURE] = 0.0f;
+}
+
+// Fold one sample arrival into the jitter window (call with data_mutex held)
+static void speeduino_record_sample(SpeeduinoContext* ctx, uint64_t now, uint64_t period_us) {
+    if (ctx->last_sample_us != 0) {
+        uint64_t interval = now - ctx->last_sample_us;
+        uint64_t jitter = interval > period_us ? interval - period_us : period_us - interval;
+        ctx->window_jitter_sum_us += jitter;
+        ctx->window_intervals++;
+        if (jitter > ctx->window_jitter_max_us) {
+            ctx->window_jitter_max_us = (uint32_t)(jitter < UINT32_MAX ? jitter : UINT32_MAX);
+        }
+    }
+    ctx->last_sample_us = now;
+    ctx->window_frames++;
+    ctx->poll_stats.frames++;
+}
+
+// Close the stats window once it spans SPEEDUINO_STATS_WINDOW_US (call with data_mutex held)
+static void speeduino_roll_stats_window(SpeeduinoContext* ctx, uint64_t now) {
+    uint64_t elapsed = now - ctx->window_start_us;
+    if (elapsed < SPEEDUINO_STATS_WINDOW_US) {
+        return;
+    }
+    
+    ctx->poll_stats.achieved_hz = (float)(ctx->window_frames * 1000000.0 / elapsed);
+    ctx->poll_stats.jitter_mean_us = ctx->window_intervals > 0 ?
+        (uint32_t)(ctx->window_jitter_sum_us / ctx->window_intervals) : 0;
+    ctx->poll_stats.jitter_max_us = ctx->window_jitter_max_us;
+    
+    ctx->window_start_us = now;
+    ctx->window_frames = 0;
+    ctx->window_intervals = 0;
+    ctx->window_jitter_sum_us = 0;
+    ctx->window_jitter_max_us = 0;
+}
+
+// Communication thread: request a realtime frame every 1/poll_rate_hz on the monotonic clock
 static void* speeduino_communication_thread(void* arg) {
     SpeeduinoContext* ctx = (SpeeduinoContext*)arg;
-    
+    uint8_t payload[256];
+    
+    pthread_mutex_lock(&ctx->data_mutex);
+    ctx->rx_buffer_pos = 0;
+    ctx->window_start_us = speeduino_monotonic_us();
+    ctx->window_frames = 0;
+    ctx->window_intervals = 0;
+    ctx->window_jitter_sum_us = 0;
+    ctx->window_jitter_max_us = 0;
+    ctx->last_sample_us = 0;
+    pthread_mutex_unlock(&ctx->data_mutex);
+    
+    uint64_t next_poll = speeduino_monotonic_us();
     while (ctx->thread_running) {
-        if (ctx->state == SPEEDUINO_STATE_CONNECTED) {
-            // Request real-time data every 100ms (10Hz)
-            time_t now = time(NULL);
-            if (now - ctx->last_data_request >= 1) { // 1 second interval
-                // Send real-time data request (Speeduino 'A' command)
-                char cmd[] = "A";
-                ssize_t written = write(ctx->serial_fd, cmd, 1);
-                if (written != 1) {
-                    // Handle write error silently for now
-                }
-                ctx->last_data_request = now;
-            }
-            
-            // Read available data from serial port
-            char buffer[256];
-            int bytes_read = read(ctx->serial_fd, buffer, sizeof(buffer) - 1);
+        uint32_t rate_hz = __atomic_load_n(&ctx->poll_rate_hz, __ATOMIC_RELAXED);
+        uint64_t period_us = 1000000 / rate_hz;
+        
+        uint64_t sent_at = speeduino_monotonic_us();
+        bool sent = speeduino_send_request(ctx, SPEEDUINO_CMD_GET_REALTIME);
+        
+        // Wait for the reply up to the next poll, but give slow links a fair chance
+        uint64_t reply_deadline = next_poll + period_us;
+        if (reply_deadline < sent_at + SPEEDUINO_REPLY_TIMEOUT_US) {
+            reply_deadline = sent_at + SPEEDUINO_REPLY_TIMEOUT_US;
+        }
+        int length = 0;
+        int received = sent ? speeduino_receive_frame(ctx, SPEEDUINO_CMD_GET_REALTIME, reply_deadline,
+                                                      payload, &length) : SPEEDUINO_FRAME_INCOMPLETE;
+        uint64_t received_at = speeduino_monotonic_us();
+        uint64_t timestamp = speeduino_timestamp_us();
+        
+        bool new_sample = false;
+        pthread_mutex_lock(&ctx->data_mutex);
+        if (received == SPEEDUINO_FRAME_OK && length >= SPEEDUINO_RT_MIN_LENGTH) {
+            speeduino_decode_realtime(&ctx->cached_frame, payload);
+            speeduino_publish_frame(ctx, timestamp);
+            speeduino_record_sample(ctx, received_at, period_us);
+            new_sample = true;
+        } else if (received == SPEEDUINO_FRAME_OK) {
+            ctx->poll_stats.framing_errors++;
+        } else if (received == SPEEDUINO_FRAME_INCOMPLETE) {
+            ctx->poll_stats.timeouts++;
+            // Drop any half-received reply so a late one can't be mistaken for the next
+            ctx->rx_buffer_pos = 0;
+            tcflush(ctx->serial_fd, TCIFLUSH);
+        }
+        speeduino_roll_stats_window(ctx, received_at);
+        pthread_mutex_unlock(&ctx->data_mutex);
+        
+        if (new_sample) {
+            speeduino_notify_sample(ctx, timestamp);
             
-            if (bytes_read > 0) {
-                buffer[bytes_read] = '\0';
-                
-                // Process incoming data
-                pthread_mutex_lock(&ctx->data_mutex);
-                
-                // Parse Speeduino real-time data response
-                if (buffer[0] == 'A' && bytes_read >= 32) {
-                    // Parse real-time data packet
-                    // Format: A + 32 bytes of data
-                    uint8_t* data = (uint8_t*)&buffer[1];
-                    
-                    // Update cached data (simplified parsing for now)
-                    ctx->cached_data.rpm = (data[0] << 8) | data[1];
-                    ctx->cached_data.map = (data[2] << 8) | data[3];
-                    ctx->cached_data.coolant_temp = data[4];
-                    ctx->cached_data.air_temp = data[5];
-                    ctx->cached_data.throttle = data[6];
-                    ctx->cached_data.afr = (data[7] << 8) | data[8];
-                    ctx->cached_data.timing = (int16_t)((data[9] << 8) | data[10]);
-                    ctx->cached_data.fuel_pressure = (data[11] << 8) | data[12];
-                    ctx->cached_data.oil_pressure = (data[13] << 8) | data[14];
-                    ctx->cached_data.battery_voltage = (data[15] << 8) | data[16];
-                    
-                    ctx->last_data_update = now;
-                    
-                    if (ctx->logging_enabled && ctx->log_file) {
-                        fprintf(ctx->log_file, "[%ld] RPM:%d MAP:%d TPS:%d AFR:%.1f\n", 
-                                now, (int)ctx->cached_data.rpm, (int)ctx->cached_data.map, 
-                                (int)ctx->cached_data.throttle, ctx->cached_data.afr);
-                        fflush(ctx->log_file);
-                    }
-                }
-                
-                // Add to receive buffer
-                if (ctx->rx_buffer_pos + bytes_read < SPEEDUINO_BUFFER_SIZE) {
-                    memcpy(ctx->rx_buffer + ctx->rx_buffer_pos, buffer, bytes_read);
-                    ctx->rx_buffer_pos += bytes_read;
-                }
-                
-                // Process complete messages
-                // TODO: Implement message parsing based on Speeduino protocol
-                
-                pthread_mutex_unlock(&ctx->data_mutex);
-                
-                // Log if enabled
-                if (ctx->logging_enabled && ctx->log_file) {
-                    fprintf(ctx->log_file, "[%ld] RX: %s\n", time(NULL), buffer);
-                    fflush(ctx->log_file);
-                }
+            if (ctx->logging_enabled && ctx->log_file) {
+                fprintf(ctx->log_file, "[%llu] RPM:%d MAP:%d TPS:%.1f AFR:%.1f\n",
+                        (unsigned long long)timestamp,
+                        (int)ctx->cached_frame.values[SPD_CH_RPM], (int)ctx->cached_frame.values[SPD_CH_MAP],
+                        ctx->cached_frame.values[SPD_CH_THROTTLE], ctx->cached_frame.values[SPD_CH_AFR]);
+                fflush(ctx->log_file);
             }
         }
         
-        usleep(10000); // 10ms delay
+        // Next deadline on the fixed grid; if this poll overran, restart the grid from now
+        next_poll += period_us;
+        uint64_t now = speeduino_monotonic_us();
+        if (now > next_poll) {
+            pthread_mutex_lock(&ctx->data_mutex);
+            ctx->poll_stats.overruns += (now - next_poll) / period_us + 1;
+            pthread_mutex_unlock(&ctx->data_mutex);
+            next_poll = now;
+        } else {
+            speeduino_sleep_until(next_poll);
+        }
     }
     
     return NULL;
@@ -297,6 +576,52 @@ static bool speeduino_disconnect(void) {
     return true;
 }
 
+// Hot reload: stop the reader but leave the port open for the replacement instance
+static bool speeduino_detach_session(ECUSessionHandoff* session) {
+    if (!session || g_speeduino_ctx.state != SPEEDUINO_STATE_CONNECTED) {
+        return false;
+    }
+    
+    g_speeduino_ctx.thread_running = false;
+    pthread_join(g_speeduino_ctx.comm_thread, NULL);
+    
+    session->fd = g_speeduino_ctx.serial_fd;
+    snprintf(session->port, sizeof(session->port), "%s", g_speeduino_ctx.port_name);
+    session->baud_rate = g_speeduino_ctx.baud_rate;
+    snprintf(session->protocol, sizeof(session->protocol), "%s", g_speeduino_ctx.protocol);
+    g_speeduino_ctx.serial_fd = -1;
+    
+    if (g_speeduino_ctx.log_file) {
+        fclose(g_speeduino_ctx.log_file);
+        g_speeduino_ctx.log_file = NULL;
+    }
+    
+    g_speeduino_ctx.state = SPEEDUINO_STATE_DISCONNECTED;
+    return true;
+}
+
+// Hot reload: adopt a port the previous instance already opened and configured
+static bool speeduino_attach_session(const ECUSessionHandoff* session) {
+    if (!session || session->fd < 0 || g_speeduino_ctx.state != SPEEDUINO_STATE_DISCONNECTED) {
+        return false;
+    }
+    
+    g_speeduino_ctx.serial_fd = session->fd;
+    snprintf(g_speeduino_ctx.port_name, sizeof(g_speeduino_ctx.port_name), "%s", session->port);
+    g_speeduino_ctx.baud_rate = session->baud_rate;
+    snprintf(g_speeduino_ctx.protocol, sizeof(g_speeduino_ctx.protocol), "%s", session->protocol);
+    
+    g_speeduino_ctx.thread_running = true;
+    if (pthread_create(&g_speeduino_ctx.comm_thread, NULL, speeduino_communication_thread, &g_speeduino_ctx) != 0) {
+        g_speeduino_ctx.thread_running = false;
+        g_speeduino_ctx.serial_fd = -1;
+        return false;
+    }
+    
+    g_speeduino_ctx.state = SPEEDUINO_STATE_CONNECTED;
+    return true;
+}
+
 static bool speeduino_is_connected(void) {
     return g_speeduino_ctx.state == SPEEDUINO_STATE_CONNECTED;
 }
@@ -345,25 +670,34 @@ static bool speeduino_read_realtime_data(ECURealtimeData* data) {
         return false;
     }
     
-    pthread_mutex_lock(&g_speeduino_ctx.data_mutex);
-    
-    // Copy cached data
-    *data = g_speeduino_ctx.cached_data;
+    // Copy the latest published frame without blocking the comm thread
+    SpeeduinoFrame frame;
+    ecu_seqlock_read(&g_speeduino_ctx.frame_lock, &frame, &g_speeduino_ctx.frame, sizeof(SpeeduinoFrame));
+    
+    // v1 layout
+    data->rpm = frame.values[SPD_CH_RPM];
+    data->map = frame.values[SPD_CH_MAP];
+    data->coolant_temp = frame.values[SPD_CH_COOLANT_TEMP];
+    data->air_temp = frame.values[SPD_CH_AIR_TEMP];
+    data->throttle = frame.values[SPD_CH_THROTTLE];
+    data->afr = frame.values[SPD_CH_AFR];
+    data->timing = frame.values[SPD_CH_TIMING];
+    data->fuel_pressure = frame.values[SPD_CH_FUEL_PRESSURE];
+    data->oil_pressure = frame.values[SPD_CH_OIL_PRESSURE];
+    data->battery_voltage = frame.values[SPD_CH_BATTERY_VOLTAGE];
+    data->timestamp = frame.timestamp;
     
     // Check if data is fresh (less than 5 seconds old)
-    time_t now = time(NULL);
-    bool data_fresh = (now - g_speeduino_ctx.last_data_update) < 5;
-    
-    pthread_mutex_unlock(&g_speeduino_ctx.data_mutex);
+    uint64_t age_us = speeduino_timestamp_us() - data->timestamp;
+    bool data_fresh = age_us < 5000000;
     
-    // Log data freshness for debugging (using printf for now)
-    if (data_fresh) {
-        printf("[INFO] Speeduino: Fresh data RPM:%.0f MAP:%.0f AFR:%.1f\n", 
-               data->rpm, data->map, data->afr);
-    } else {
+    // Report going stale once rather than on every poll
+    static bool was_fresh = true;
+    if (!data_fresh && was_fresh) {
         printf("[WARN] Speeduino: Stale data (%lds old)\n", 
-               now - g_speeduino_ctx.last_data_update);
+               (long)(age_us / 1000000));
     }
+    was_fresh = data_fresh;
     
     return data_fresh;
 }
@@ -428,6 +762,43 @@ static bool speeduino_set_protocol_settings(const char* settings_json) {
     // Simple string copy for now
     strncpy(g_speeduino_ctx.config_buffer, settings_json, sizeof(g_speeduino_ctx.config_buffer) - 1);
     g_speeduino_ctx.config_loaded = true;
+    
+    const char* rate = strstr(settings_json, "\"poll_rate_hz\":");
+    if (rate) {
+        speeduino_set_poll_rate((uint32_t)strtoul(rate + strlen("\"poll_rate_hz\":"), NULL, 10));
+    }
+    return true;
+}
+
+static bool speeduino_set_poll_rate(uint32_t rate_hz) {
+    if (rate_hz == 0) {
+        return false;
+    }
+    if (rate_hz > SPEEDUINO_POLL_RATE_HZ_MAX) {
+        rate_hz = SPEEDUINO_POLL_RATE_HZ_MAX;
+    }
+    
+    pthread_mutex_lock(&g_speeduino_ctx.data_mutex);
+    __atomic_store_n(&g_speeduino_ctx.poll_rate_hz, rate_hz, __ATOMIC_RELAXED);
+    g_speeduino_ctx.poll_stats.target_hz = rate_hz;
+    g_speeduino_ctx.window_start_us = speeduino_monotonic_us();
+    g_speeduino_ctx.window_frames = 0;
+    g_speeduino_ctx.window_intervals = 0;
+    g_speeduino_ctx.window_jitter_sum_us = 0;
+    g_speeduino_ctx.window_jitter_max_us = 0;
+    g_speeduino_ctx.last_sample_us = 0;
+    pthread_mutex_unlock(&g_speeduino_ctx.data_mutex);
+    return true;
+}
+
+static bool speeduino_get_poll_stats(ECUPollStats* stats) {
+    if (!stats) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&g_speeduino_ctx.data_mutex);
+    *stats = g_speeduino_ctx.poll_stats;
+    pthread_mutex_unlock(&g_speeduino_ctx.data_mutex);
     return true;
 }
 
@@ -475,6 +846,43 @@ static bool speeduino_stop_logging(void) {
     return true;
 }
 
+static bool speeduino_set_sample_callback(ECUSampleCallback callback, void* user_data) {
+    pthread_mutex_lock(&g_speeduino_ctx.data_mutex);
+    g_speeduino_ctx.sample_callback_data = user_data;
+    g_speeduino_ctx.sample_callback = callback;
+    pthread_mutex_unlock(&g_speeduino_ctx.data_mutex);
+    return true;
+}
+
+static uint32_t speeduino_get_frame_id(void) {
+    return ecu_seqlock_frame_id(&g_speeduino_ctx.frame_lock);
+}
+
+static int speeduino_get_channel_descriptors(const ECUChannelDescriptor** descriptors) {
+    if (!descriptors) {
+        return 0;
+    }
+    *descriptors = g_speeduino_channels;
+    return SPD_CH_COUNT;
+}
+
+static bool speeduino_read_sample_frame(ECUSampleHeader* header, float* values, int max_values) {
+    if (!header || !values || max_values <= 0 || g_speeduino_ctx.state != SPEEDUINO_STATE_CONNECTED) {
+        return false;
+    }
+    
+    SpeeduinoFrame frame;
+    uint32_t frame_id = ecu_seqlock_read(&g_speeduino_ctx.frame_lock, &frame, &g_speeduino_ctx.frame,
+                                         sizeof(SpeeduinoFrame));
+    
+    int count = max_values < SPD_CH_COUNT ? max_values : SPD_CH_COUNT;
+    memcpy(values, frame.values, count * sizeof(float));
+    header->timestamp = frame.timestamp;
+    header->frame_id = frame_id;
+    header->channel_count = (uint32_t)count;
+    return frame_id != 0;
+}
+
 static bool speeduino_get_log_status(char* status, int max_len) {
     if (g_speeduino_ctx.logging_enabled) {
         snprintf(status, max_len, "Logging to: %s", g_speeduino_ctx.log_path);
@@ -498,8 +906,9 @@ static bool speeduino_plugin_init(PluginContext* ctx) {
     memset(&g_speeduino_ctx, 0, sizeof(g_speeduino_ctx));
     g_speeduino_ctx.state = SPEEDUINO_STATE_DISCONNECTED;
     g_speeduino_ctx.serial_fd = -1;
-    g_speeduino_ctx.data_request_interval_ms = 100; // 10Hz data requests
-    g_speeduino_ctx.last_data_request = 0;
+    g_speeduino_ctx.poll_rate_hz = SPEEDUINO_POLL_RATE_HZ_DEFAULT;
+    g_speeduino_ctx.poll_stats.target_hz = SPEEDUINO_POLL_RATE_HZ_DEFAULT;
+    ecu_seqlock_init(&g_speeduino_ctx.frame_lock);
     
     // Initialize mutex
     if (pthread_mutex_init(&g_speeduino_ctx.data_mutex, NULL) != 0) {
@@ -508,8 +917,8 @@ static bool speeduino_plugin_init(PluginContext* ctx) {
     
     // Load default configuration
     snprintf(g_speeduino_ctx.config_buffer, sizeof(g_speeduino_ctx.config_buffer), 
-             "{\"baud_rate\":%d,\"timeout_ms\":%d,\"protocol\":\"CRC\",\"data_rate\":\"10Hz\"}", 
-             SPEEDUINO_BAUD_RATE, SPEEDUINO_TIMEOUT_MS);
+             "{\"baud_rate\":%d,\"timeout_ms\":%d,\"protocol\":\"CRC\",\"poll_rate_hz\":%d}", 
+             SPEEDUINO_BAUD_RATE, SPEEDUINO_TIMEOUT_MS, SPEEDUINO_POLL_RATE_HZ_DEFAULT);
     g_speeduino_ctx.config_loaded = true;
     
     return true;
@@ -521,27 +930,7 @@ static void speeduino_plugin_cleanup(void) {
 }
 
 static void speeduino_plugin_update(void) {
-    // Update real-time data if connected
-    if (g_speeduino_ctx.state == SPEEDUINO_STATE_CONNECTED) {
-        // TODO: Request real-time data from ECU
-        // For now, update cached data with dummy values
-        pthread_mutex_lock(&g_speeduino_ctx.data_mutex);
-        
-        g_speeduino_ctx.cached_data.rpm = 1500.0f + (rand() % 1000);
-        g_speeduino_ctx.cached_data.map = 100.0f + (rand() % 20);
-        g_speeduino_ctx.cached_data.coolant_temp = 85.0f + (rand() % 20);
-        g_speeduino_ctx.cached_data.air_temp = 25.0f + (rand() % 15);
-        g_speeduino_ctx.cached_data.throttle = (rand() % 100);
-        g_speeduino_ctx.cached_data.afr = 14.7f + (rand() % 2);
-        g_speeduino_ctx.cached_data.timing = 15.0f + (rand() % 10);
-        g_speeduino_ctx.cached_data.fuel_pressure = 3.0f + (rand() % 2);
-        g_speeduino_ctx.cached_data.oil_pressure = 4.0f + (rand() % 3);
-        g_speeduino_ctx.cached_data.battery_voltage = 13.8f + (rand() % 2);
-        
-        g_speeduino_ctx.last_data_update = time(NULL);
-        
-        pthread_mutex_unlock(&g_speeduino_ctx.data_mutex);
-    }
+    // Realtime frames are produced by the communication thread; nothing to do per UI frame
 }
 
 // Plugin interface structure
@@ -563,7 +952,16 @@ static ECUPluginInterface g_speeduino_interface = {
     .validate_connection = speeduino_validate_connection,
     .start_logging = speeduino_start_logging,
     .stop_logging = speeduino_stop_logging,
-    .get_log_status = speeduino_get_log_status
+    .get_log_status = speeduino_get_log_status,
+    .set_sample_callback = speeduino_set_sample_callback,
+    .get_frame_id = speeduino_get_frame_id,
+    .abi_version = ECU_PLUGIN_ABI_VERSION,
+    .get_channel_descriptors = speeduino_get_channel_descriptors,
+    .read_sample_frame = speeduino_read_sample_frame,
+    .detach_session = speeduino_detach_session,
+    .attach_session = speeduino_attach_session,
+    .set_poll_rate = speeduino_set_poll_rate,
+    .get_poll_stats = speeduino_get_poll_stats
 };
 
 // Plugin interface descriptor
@@ -56,8 +56,17 @@ typedef struct {
     std::vector<std::pair<std::pair<float, float>, std::string>> annotations;
 } Chart;
 
+// Pre-resolved series handle (Chart nodes in g_charts have stable addresses)
+#define CHART_MAX_SERIES_HANDLES 256
+typedef struct {
+    Chart* chart;
+    int series_index;
+} SeriesHandle;
+
 // Global plugin context
 static std::map<std::string, Chart> g_charts;
+static SeriesHandle g_series_handles[CHART_MAX_SERIES_HANDLES];
+static int g_series_handle_count = 0;
 static pthread_mutex_t g_charts_mutex;
 static bool g_plugin_initialized = false;
 static int g_next_chart_id = 1;
@@ -98,6 +107,8 @@ static bool chart_plugin_add_annotation(const char* chart_id, float x, float y,
 static bool chart_plugin_set_chart_style(const char* chart_id, int style_preset);
 static bool chart_plugin_enable_animations(const char* chart_id, bool enable);
 static bool chart_plugin_set_chart_theme(const char* chart_id, const char* theme_name);
+static int chart_plugin_get_series_handle(const char* chart_id, const char* series_name);
+static bool chart_plugin_add_data_point_by_handle(int series_handle, float x_value, float y_value);
 
 // Helper rendering functions
 static void draw_line_chart(Chart* chart, const ImVec2& pos, const ImVec2& size);
@@ -131,6 +142,39 @@ static Chart* find_chart(const char* chart_id) {
     return (it != g_charts.end()) ? &it->second : nullptr;
 }
 
+static DataSeries* add_series(Chart* chart, const char* series_name, const char* color) {
+    DataSeries series;
+    strncpy(series.name, series_name, sizeof(series.name) - 1);
+    strncpy(series.color, color ? color : "#FF0000", sizeof(series.color) - 1);
+    series.visible = true;
+    series.max_points = 1000;
+    chart->series.push_back(series);
+    return &chart->series.back();
+}
+
+// Caller holds chart->data_mutex
+static void append_data_point(Chart* chart, DataSeries* series, float x_value, float y_value) {
+    DataPoint point;
+    point.x = x_value;
+    point.y = y_value;
+    point.timestamp = time(NULL);
+    
+    series->points.push_back(point);
+    
+    // Limit data points for performance
+    if (series->points.size() > series->max_points) {
+        series->points.erase(series->points.begin());
+    }
+    
+    // Update chart bounds
+    if (x_value < chart->x_min) chart->x_min = x_value;
+    if (x_value > chart->x_max) chart->x_max = x_value;
+    if (y_value < chart->y_min) chart->y_min = y_value;
+    if (y_value > chart->y_max) chart->y_max = y_value;
+    
+    chart->last_update = point.timestamp;
+}
+
 static DataSeries* find_series(Chart* chart, const char* series_name) {
     if (!chart || !series_name) return nullptr;
     
@@ -200,6 +244,12 @@ static bool chart_plugin_destroy_chart(const char* chart_id) {
     
     auto it = g_charts.find(chart_id);
     if (it != g_charts.end()) {
+        // Invalidate handles that point into this chart
+        for (int i = 0; i < g_series_handle_count; i++) {
+            if (g_series_handles[i].chart == &it->second) {
+                g_series_handles[i].chart = nullptr;
+            }
+        }
         pthread_mutex_destroy(&it->second.data_mutex);
         g_charts.erase(it);
         pthread_mutex_unlock(&g_charts_mutex);
@@ -235,36 +285,61 @@ static bool chart_plugin_add_data_point(const char* chart_id, float x_value, flo
     DataSeries* series = find_series(chart, series_name);
     if (!series) {
         // Create new series with default color
-        DataSeries new_series;
-        strncpy(new_series.name, series_name, sizeof(new_series.name) - 1);
-        strncpy(new_series.color, "#FF0000", sizeof(new_series.color) - 1);
-        new_series.visible = true;
-        new_series.max_points = 1000;
-        chart->series.push_back(new_series);
-        series = &chart->series.back();
+        series = add_series(chart, series_name, "#FF0000");
     }
     
-    // Add data point
-    DataPoint point;
-    point.x = x_value;
-    point.y = y_value;
-    point.timestamp = time(NULL);
+    append_data_point(chart, series, x_value, y_value);
     
-    series->points.push_back(point);
+    pthread_mutex_unlock(&chart->data_mutex);
+    return true;
+}
+
+static int chart_plugin_get_series_handle(const char* chart_id, const char* series_name) {
+    if (!series_name) return -1;
     
-    // Limit data points for performance
-    if (series->points.size() > series->max_points) {
-        series->points.erase(series->points.begin());
+    pthread_mutex_lock(&g_charts_mutex);
+    
+    Chart* chart = find_chart(chart_id);
+    if (!chart || g_series_handle_count >= CHART_MAX_SERIES_HANDLES) {
+        pthread_mutex_unlock(&g_charts_mutex);
+        return -1;
     }
     
-    // Update chart bounds
-    if (x_value < chart->x_min) chart->x_min = x_value;
-    if (x_value > chart->x_max) chart->x_max = x_value;
-    if (y_value < chart->y_min) chart->y_min = y_value;
-    if (y_value > chart->y_max) chart->y_max = y_value;
+    pthread_mutex_lock(&chart->data_mutex);
+    DataSeries* series = find_series(chart, series_name);
+    if (!series) {
+        series = add_series(chart, series_name, "#FF0000");
+    }
+    int series_index = (int)(series - chart->series.data());
+    pthread_mutex_unlock(&chart->data_mutex);
     
-    chart->last_update = point.timestamp;
+    // Reuse an existing handle for the same series
+    int handle = -1;
+    for (int i = 0; i < g_series_handle_count; i++) {
+        if (g_series_handles[i].chart == chart && g_series_handles[i].series_index == series_index) {
+            handle = i;
+            break;
+        }
+    }
+    if (handle < 0) {
+        handle = g_series_handle_count;
+        g_series_handles[handle].chart = chart;
+        g_series_handles[handle].series_index = series_index;
+        g_series_handle_count++;
+    }
     
+    pthread_mutex_unlock(&g_charts_mutex);
+    return handle;
+}
+
+static bool chart_plugin_add_data_point_by_handle(int series_handle, float x_value, float y_value) {
+    if (series_handle < 0 || series_handle >= g_series_handle_count) return false;
+    
+    Chart* chart = g_series_handles[series_handle].chart;
+    if (!chart) return false;
+    
+    pthread_mutex_lock(&chart->data_mutex);
+    append_data_point(chart, &chart->series[g_series_handles[series_handle].series_index], x_value, y_value);
     pthread_mutex_unlock(&chart->data_mutex);
     return true;
 }
@@ -282,13 +357,7 @@ static bool chart_plugin_add_data_series(const char* chart_id, const char* serie
     }
     
     // Create new series
-    DataSeries series;
-    strncpy(series.name, series_name, sizeof(series.name) - 1);
-    strncpy(series.color, color ? color : "#FF0000", sizeof(series.color) - 1);
-    series.visible = true;
-    series.max_points = 1000;
-    
-    chart->series.push_back(series);
+    add_series(chart, series_name, color);
     
     pthread_mutex_unlock(&chart->data_mutex);
     return true;
@@ -638,6 +707,7 @@ static void chart_plugin_cleanup(void) {
         pthread_mutex_destroy(&pair.second.data_mutex);
     }
     g_charts.clear();
+    g_series_handle_count = 0;
     
     pthread_mutex_unlock(&g_charts_mutex);
     pthread_mutex_destroy(&g_charts_mutex);
@@ -881,7 +951,9 @@ static DataVisualizationPluginInterface g_chart_interface = {
     .add_annotation = chart_plugin_add_annotation,
     .set_chart_style = chart_plugin_set_chart_style,
     .enable_animations = chart_plugin_enable_animations,
-    .set_chart_theme = chart_plugin_set_chart_theme
+    .set_chart_theme = chart_plugin_set_chart_theme,
+    .get_series_handle = chart_plugin_get_series_handle,
+    .add_data_point_by_handle = chart_plugin_add_data_point_by_handle
 };
 
 // Plugin interface descriptor
@@ -1,35 +1,141 @@
 /*
- * Action Triggers - Stub implementation
+ * Action Triggers - Indexed, edge-triggered evaluation and action dispatch
  */
 
 #include "../../include/automation/action_triggers.h"
+#include "../../include/automation/macro_engine.h"
+#include "../../include/data/datalog_manager.h"
+#include "../../include/ecu/ecu_channels.h"
+#include <pthread.h>
 #include <string.h>
 
+#define TRIGGER_MAX 64
+
+typedef struct {
+	bool used;
+	ActionTrigger config;
+	int channel;
+
+	// Edge/debounce state
+	bool level;		// Debounced comparison result
+	bool candidate;		// Raw comparison result awaiting debounce
+	uint64_t candidate_since;
+	bool has_fired;
+	uint64_t last_fire;
+	uint32_t fire_count;
+} TriggerEntry;
+
 typedef struct {
-	ActionTrigger items[64];
-	unsigned int count;
+	TriggerEntry items[TRIGGER_MAX];
+
+	// Triggers grouped by channel: order[channel_start[c] .. channel_start[c + 1])
+	uint8_t order[TRIGGER_MAX];
+	int channel_start[ECU_CHANNEL_COUNT + 1];
+	int active_channels[ECU_CHANNEL_COUNT];
+	int active_channel_count;
 } TriggerStore;
 
+// Action captured under the lock and dispatched after it is released
+typedef struct {
+	TriggerActionType action;
+	char arg[64];
+	ActionTriggerEvent event;
+} PendingAction;
+
 static TriggerStore g_store = {0};
+static pthread_mutex_t g_store_mutex = PTHREAD_MUTEX_INITIALIZER;
+static TriggerEventPublisher g_event_publisher = NULL;
+
+// Caller holds g_store_mutex
+static void rebuild_index(void) {
+	int counts[ECU_CHANNEL_COUNT] = {0};
+
+	for (int i = 0; i < TRIGGER_MAX; ++i) {
+		if (g_store.items[i].used) counts[g_store.items[i].channel]++;
+	}
+
+	g_store.active_channel_count = 0;
+	g_store.channel_start[0] = 0;
+	for (int c = 0; c < ECU_CHANNEL_COUNT; ++c) {
+		g_store.channel_start[c + 1] = g_store.channel_start[c] + counts[c];
+		if (counts[c] > 0) g_store.active_channels[g_store.active_channel_count++] = c;
+	}
+
+	int fill[ECU_CHANNEL_COUNT];
+	memcpy(fill, g_store.channel_start, sizeof(fill));
+	for (int i = 0; i < TRIGGER_MAX; ++i) {
+		if (g_store.items[i].used) g_store.order[fill[g_store.items[i].channel]++] = (uint8_t)i;
+	}
+}
 
 bool action_triggers_init(void) {
+	pthread_mutex_lock(&g_store_mutex);
 	memset(&g_store, 0, sizeof(g_store));
+	pthread_mutex_unlock(&g_store_mutex);
 	return true;
 }
 
 void action_triggers_shutdown(void) {
-	memset(&g_store, 0, sizeof(g_store));
+	action_triggers_clear();
+	g_event_publisher = NULL;
 }
 
-bool action_triggers_add(const ActionTrigger* trigger) {
-	if (!trigger) return false;
-	if (g_store.count >= (sizeof(g_store.items)/sizeof(g_store.items[0]))) return false;
-	g_store.items[g_store.count++] = *trigger;
-	return true;
+int action_triggers_add(const ActionTrigger* trigger) {
+	if (!trigger) return -1;
+
+	int channel = ecu_channel_lookup(trigger->signal_name);
+	if (channel < 0) return -1;
+
+	pthread_mutex_lock(&g_store_mutex);
+	int id = -1;
+	for (int i = 0; i < TRIGGER_MAX; ++i) {
+		if (!g_store.items[i].used) {
+			id = i;
+			break;
+		}
+	}
+	if (id >= 0) {
+		TriggerEntry* e = &g_store.items[id];
+		memset(e, 0, sizeof(*e));
+		e->used = true;
+		e->config = *trigger;
+		e->channel = channel;
+		rebuild_index();
+	}
+	pthread_mutex_unlock(&g_store_mutex);
+	return id;
+}
+
+bool action_triggers_remove(int trigger_id) {
+	if (trigger_id < 0 || trigger_id >= TRIGGER_MAX) return false;
+
+	pthread_mutex_lock(&g_store_mutex);
+	bool ok = g_store.items[trigger_id].used;
+	if (ok) {
+		memset(&g_store.items[trigger_id], 0, sizeof(g_store.items[trigger_id]));
+		rebuild_index();
+	}
+	pthread_mutex_unlock(&g_store_mutex);
+	return ok;
 }
 
 void action_triggers_clear(void) {
-	g_store.count = 0;
+	pthread_mutex_lock(&g_store_mutex);
+	memset(&g_store, 0, sizeof(g_store));
+	pthread_mutex_unlock(&g_store_mutex);
+}
+
+void action_triggers_set_event_publisher(TriggerEventPublisher publisher) {
+	g_event_publisher = publisher;
+}
+
+uint32_t action_triggers_get_fire_count(int trigger_id) {
+	if (trigger_id < 0 || trigger_id >= TRIGGER_MAX) return 0;
+
+	pthread_mutex_lock(&g_store_mutex);
+	uint32_t count = g_store.items[trigger_id].used ? g_store.items[trigger_id].fire_count : 0;
+	pthread_mutex_unlock(&g_store_mutex);
+	return count;
 }
 
 static bool evaluate(TriggerComparison cmp, double a, double b) {
@@ -44,16 +150,122 @@ static bool evaluate(TriggerComparison cmp, double a, double b) {
 	return false;
 }
 
-void action_triggers_process_sample(const char* signal, double value) {
-	for (unsigned int i = 0; i < g_store.count; ++i) {
-		ActionTrigger* t = &g_store.items[i];
-		if (strcmp(t->signal_name, signal) == 0) {
-			if (evaluate(t->comparison, value, t->threshold_value)) {
-				// Placeholder: invoke named action via future dispatcher/hook system
-				// e.g., dispatch_action(t->action_name);
+// Returns true when the trigger fires; rising reports which edge it was
+static bool update_trigger(TriggerEntry* e, float value, uint64_t ts, bool* rising) {
+	bool raw = evaluate(e->config.comparison, value, e->config.threshold_value);
+	if (raw != e->candidate) {
+		e->candidate = raw;
+		e->candidate_since = ts;
+	}
+
+	if (e->candidate == e->level) return false;
+	if (ts - e->candidate_since < (uint64_t)e->config.debounce_ms * 1000) return false;
+
+	e->level = e->candidate;
+	*rising = e->level;
+
+	bool wanted = e->config.edge == TRIGGER_EDGE_BOTH ||
+	              (e->config.edge == TRIGGER_EDGE_RISING && *rising) ||
+	              (e->config.edge == TRIGGER_EDGE_FALLING && !*rising);
+	if (!wanted) return false;
+
+	if (e->has_fired && ts - e->last_fire < (uint64_t)e->config.min_interval_ms * 1000) return false;
+
+	e->has_fired = true;
+	e->last_fire = ts;
+	e->fire_count++;
+	return true;
+}
+
+// Caller holds g_store_mutex
+static int process_channel(int channel, float value, uint64_t ts, PendingAction* pending, int pending_count) {
+	for (int k = g_store.channel_start[channel]; k < g_store.channel_start[channel + 1]; ++k) {
+		int id = g_store.order[k];
+		TriggerEntry* e = &g_store.items[id];
+		bool rising = false;
+
+		if (!update_trigger(e, value, ts, &rising)) continue;
+		if (e->config.action == TRIGGER_ACTION_NONE || pending_count >= TRIGGER_MAX) continue;
+
+		PendingAction* p = &pending[pending_count++];
+		p->action = e->config.action;
+		memcpy(p->arg, e->config.action_arg, sizeof(p->arg));
+		p->arg[sizeof(p->arg) - 1] = '\0';
+		p->event.trigger_id = id;
+		p->event.channel = channel;
+		p->event.value = value;
+		p->event.rising = rising;
+		p->event.timestamp_us = ts;
+	}
+	return pending_count;
+}
+
+static void dispatch_action(const PendingAction* p) {
+	switch (p->action) {
+		case TRIGGER_ACTION_START_DATALOG:
+			if (!datalog_manager_is_active()) {
+				datalog_manager_start_session(p->arg[0] ? p->arg : NULL);
 			}
-		}
+			break;
+		case TRIGGER_ACTION_STOP_DATALOG:
+			datalog_manager_stop_session();
+			break;
+		case TRIGGER_ACTION_LOG_MARKER:
+			datalog_manager_log_marker(p->arg[0] ? p->arg : "trigger");
+			break;
+		case TRIGGER_ACTION_RUN_MACRO:
+			macro_play(p->arg);
+			break;
+		case TRIGGER_ACTION_PUBLISH_EVENT:
+			if (g_event_publisher) {
+				g_event_publisher(p->arg[0] ? p->arg : "action_trigger", &p->event, sizeof(p->event));
+			}
+			break;
+		case TRIGGER_ACTION_NONE:
+			break;
+	}
+}
+
+void action_triggers_process_frame(const float* channels, uint64_t timestamp_us) {
+	if (!channels) return;
+
+	PendingAction pending[TRIGGER_MAX];
+	int pending_count = 0;
+
+	pthread_mutex_lock(&g_store_mutex);
+	for (int i = 0; i < g_store.active_channel_count; ++i) {
+		int c = g_store.active_channels[i];
+		pending_count = process_channel(c, channels[c], timestamp_us, pending, pending_count);
+	}
+	pthread_mutex_unlock(&g_store_mutex);
+
+	// Actions may start/stop logging or call back into automation, so run them unlocked
+	for (int i = 0; i < pending_count; ++i) {
+		dispatch_action(&pending[i]);
 	}
 }
 
+void action_triggers_process_sample(const char* signal, double value) {
+	int channel = ecu_channel_lookup(signal);
+	if (channel < 0) return;
+
+	PendingAction pending[TRIGGER_MAX];
+	int pending_count;
+
+	pthread_mutex_lock(&g_store_mutex);
+	pending_count = process_channel(channel, (float)value, ecu_get_timestamp_us(), pending, 0);
+	pthread_mutex_unlock(&g_store_mutex);
+
+	for (int i = 0; i < pending_count; ++i) {
+		dispatch_action(&pending[i]);
+	}
+}
 
+void action_triggers_on_sample(const ECUData* data, uint64_t timestamp_us, void* user_data) {
+	(void)user_data;
+	if (!data || g_store.active_channel_count == 0) return;
+
+	float channels[ECU_CHANNEL_COUNT];
+	ecu_channels_snapshot(data, channels);
+	action_triggers_process_frame(channels, timestamp_us);
+}
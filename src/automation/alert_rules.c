@@ -0,0 +1,531 @@
+/*
+ * Alert Rules - Condition compiler and per-sample evaluator
+ */
+
+#include "../../include/automation/alert_rules.h"
+#include "../../include/automation/action_triggers.h"
+#include "../../include/ecu/ecu_channels.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define ALERT_MAX_LEAVES 16
+#define ALERT_MAX_INSTRUCTIONS 32
+
+typedef enum {
+	ALERT_INSTR_LEAF,
+	ALERT_INSTR_AND,
+	ALERT_INSTR_OR,
+	ALERT_INSTR_NOT
+} AlertInstrOp;
+
+typedef struct {
+	uint8_t op;
+	uint8_t leaf;
+} AlertInstr;
+
+typedef struct {
+	int channel;
+	bool rate;
+	TriggerComparison comparison;
+	float threshold;
+	float hysteresis;
+	uint64_t duration_us;
+
+	// Evaluation state
+	bool raw_state;
+	uint64_t true_since;
+	bool has_prev;
+	float prev_value;
+	uint64_t prev_timestamp;
+} AlertLeaf;
+
+typedef struct {
+	AlertInstr code[ALERT_MAX_INSTRUCTIONS];
+	int code_count;
+	AlertLeaf leaves[ALERT_MAX_LEAVES];
+	int leaf_count;
+} AlertProgram;
+
+typedef struct {
+	bool used;
+	bool enabled;
+	AlertProgram program;
+	AlertRuleState state;
+} AlertRule;
+
+typedef struct {
+	const char* p;
+	AlertProgram* prog;
+	char* error;
+	size_t error_size;
+	bool failed;
+} AlertParser;
+
+static AlertRule g_rules[ALERT_RULES_MAX];
+static pthread_mutex_t g_rules_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* ------------------------------------------------------------------------- */
+/* Parser                                                                    */
+/* ------------------------------------------------------------------------- */
+
+static bool parse_expr(AlertParser* ps);
+
+static void parse_fail(AlertParser* ps, const char* fmt, ...) {
+	if (ps->failed) return;
+	ps->failed = true;
+	if (ps->error && ps->error_size > 0) {
+		va_list args;
+		va_start(args, fmt);
+		vsnprintf(ps->error, ps->error_size, fmt, args);
+		va_end(args);
+	}
+}
+
+static void skip_ws(AlertParser* ps) {
+	while (*ps->p && isspace((unsigned char)*ps->p)) ps->p++;
+}
+
+static bool is_word_end(char c) {
+	return c == '\0' || isspace((unsigned char)c) || c == '(' || c == ')' ||
+	       c == '&' || c == '|';
+}
+
+// Match a case-insensitive keyword followed by a word boundary
+static bool match_keyword(AlertParser* ps, const char* keyword) {
+	size_t len = strlen(keyword);
+	if (strncasecmp(ps->p, keyword, len) != 0) return false;
+	if (!is_word_end(ps->p[len])) return false;
+	ps->p += len;
+	return true;
+}
+
+// True if the len-character word at p is a whole condition keyword
+static bool is_keyword(const char* p, size_t len) {
+	static const char* keywords[] = { "and", "or", "for", "hyst", "not" };
+	for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+		if (len == strlen(keywords[i]) && strncasecmp(p, keywords[i], len) == 0) return true;
+	}
+	return false;
+}
+
+static bool emit(AlertParser* ps, AlertInstrOp op, int leaf) {
+	if (ps->prog->code_count >= ALERT_MAX_INSTRUCTIONS) {
+		parse_fail(ps, "Condition is too complex");
+		return false;
+	}
+	ps->prog->code[ps->prog->code_count].op = (uint8_t)op;
+	ps->prog->code[ps->prog->code_count].leaf = (uint8_t)leaf;
+	ps->prog->code_count++;
+	return true;
+}
+
+static bool parse_channel(AlertParser* ps, AlertLeaf* leaf) {
+	char name[64];
+	size_t n = 0;
+
+	skip_ws(ps);
+	leaf->rate = false;
+	if (strncasecmp(ps->p, "rate", 4) == 0) {
+		const char* q = ps->p + 4;
+		while (*q && isspace((unsigned char)*q)) q++;
+		if (*q == '(') {
+			leaf->rate = true;
+			ps->p = q + 1;
+		}
+	}
+
+	while (*ps->p && !strchr("<>=!()&|", *ps->p)) {
+		if (n < sizeof(name) - 1) name[n++] = *ps->p;
+		ps->p++;
+	}
+	while (n > 0 && isspace((unsigned char)name[n - 1])) n--;
+	name[n] = '\0';
+
+	if (leaf->rate) {
+		skip_ws(ps);
+		if (*ps->p != ')') {
+			parse_fail(ps, "Expected ')' after rate(%s", name);
+			return false;
+		}
+		ps->p++;
+	}
+
+	if (n == 0) {
+		parse_fail(ps, "Expected channel name");
+		return false;
+	}
+
+	leaf->channel = ecu_channel_lookup(name);
+	if (leaf->channel < 0) {
+		parse_fail(ps, "Unknown channel '%s'", name);
+		return false;
+	}
+	return true;
+}
+
+static bool parse_operator(AlertParser* ps, TriggerComparison* cmp) {
+	skip_ws(ps);
+	const char* p = ps->p;
+	if (p[0] == '>' && p[1] == '=') { *cmp = TRIGGER_OP_GREATER_EQUAL; ps->p += 2; }
+	else if (p[0] == '<' && p[1] == '=') { *cmp = TRIGGER_OP_LESS_EQUAL; ps->p += 2; }
+	else if (p[0] == '=' && p[1] == '=') { *cmp = TRIGGER_OP_EQUAL; ps->p += 2; }
+	else if (p[0] == '!' && p[1] == '=') { *cmp = TRIGGER_OP_NOT_EQUAL; ps->p += 2; }
+	else if (p[0] == '>') { *cmp = TRIGGER_OP_GREATER; ps->p++; }
+	else if (p[0] == '<') { *cmp = TRIGGER_OP_LESS; ps->p++; }
+	else if (p[0] == '=') { *cmp = TRIGGER_OP_EQUAL; ps->p++; }
+	else {
+		parse_fail(ps, "Expected comparison operator");
+		return false;
+	}
+	return true;
+}
+
+static bool parse_number(AlertParser* ps, float* out, const char* what) {
+	skip_ws(ps);
+	char* end = NULL;
+	double v = strtod(ps->p, &end);
+	if (end == ps->p) {
+		parse_fail(ps, "Expected number for %s", what);
+		return false;
+	}
+	ps->p = end;
+	*out = (float)v;
+	return true;
+}
+
+// Read the next bare word (unit or keyword) without consuming it
+static size_t peek_word(AlertParser* ps) {
+	size_t n = 0;
+	while (!is_word_end(ps->p[n])) n++;
+	return n;
+}
+
+static bool parse_duration(AlertParser* ps, uint64_t* out) {
+	float amount;
+	if (!parse_number(ps, &amount, "'for'")) return false;
+	if (amount < 0.0f) {
+		parse_fail(ps, "Duration must not be negative");
+		return false;
+	}
+
+	double scale = 1000.0; // milliseconds by default
+	skip_ws(ps);
+	if (match_keyword(ps, "us")) scale = 1.0;
+	else if (match_keyword(ps, "ms")) scale = 1000.0;
+	else if (match_keyword(ps, "s") || match_keyword(ps, "sec")) scale = 1000000.0;
+
+	*out = (uint64_t)(amount * scale);
+	return true;
+}
+
+static bool parse_comparison(AlertParser* ps) {
+	if (ps->prog->leaf_count >= ALERT_MAX_LEAVES) {
+		parse_fail(ps, "Too many comparisons (max %d)", ALERT_MAX_LEAVES);
+		return false;
+	}
+
+	AlertLeaf* leaf = &ps->prog->leaves[ps->prog->leaf_count];
+	memset(leaf, 0, sizeof(*leaf));
+
+	if (!parse_channel(ps, leaf)) return false;
+	if (!parse_operator(ps, &leaf->comparison)) return false;
+	if (!parse_number(ps, &leaf->threshold, "threshold")) return false;
+
+	// Optional unit directly after the number ("110°C", "25 PSI", "90%")
+	skip_ws(ps);
+	size_t len = peek_word(ps);
+	if (len > 0 && !isdigit((unsigned char)ps->p[0]) && !strchr("<>=!", ps->p[0]) && !is_keyword(ps->p, len)) {
+		ps->p += len;
+	}
+
+	// Modifiers
+	for (;;) {
+		skip_ws(ps);
+		if (match_keyword(ps, "for")) {
+			if (!parse_duration(ps, &leaf->duration_us)) return false;
+		} else if (match_keyword(ps, "hyst")) {
+			if (!parse_number(ps, &leaf->hysteresis, "'hyst'")) return false;
+			if (leaf->hysteresis < 0.0f) leaf->hysteresis = -leaf->hysteresis;
+		} else {
+			break;
+		}
+	}
+
+	return emit(ps, ALERT_INSTR_LEAF, ps->prog->leaf_count++);
+}
+
+static bool parse_factor(AlertParser* ps) {
+	skip_ws(ps);
+	if (*ps->p == '(') {
+		ps->p++;
+		if (!parse_expr(ps)) return false;
+		skip_ws(ps);
+		if (*ps->p != ')') {
+			parse_fail(ps, "Expected ')'");
+			return false;
+		}
+		ps->p++;
+		return true;
+	}
+	if ((ps->p[0] == '!' && ps->p[1] != '=') || match_keyword(ps, "not")) {
+		if (ps->p[0] == '!') ps->p++;
+		if (!parse_factor(ps)) return false;
+		return emit(ps, ALERT_INSTR_NOT, 0);
+	}
+	return parse_comparison(ps);
+}
+
+static bool parse_term(AlertParser* ps) {
+	if (!parse_factor(ps)) return false;
+	for (;;) {
+		skip_ws(ps);
+		if (ps->p[0] == '&' && ps->p[1] == '&') ps->p += 2;
+		else if (!match_keyword(ps, "and")) break;
+		if (!parse_factor(ps)) return false;
+		if (!emit(ps, ALERT_INSTR_AND, 0)) return false;
+	}
+	return true;
+}
+
+static bool parse_expr(AlertParser* ps) {
+	if (!parse_term(ps)) return false;
+	for (;;) {
+		skip_ws(ps);
+		if (ps->p[0] == '|' && ps->p[1] == '|') ps->p += 2;
+		else if (!match_keyword(ps, "or")) break;
+		if (!parse_term(ps)) return false;
+		if (!emit(ps, ALERT_INSTR_OR, 0)) return false;
+	}
+	return true;
+}
+
+static bool compile_condition(const char* condition, AlertProgram* prog, char* error, size_t error_size) {
+	AlertParser ps;
+	memset(prog, 0, sizeof(*prog));
+	ps.p = condition ? condition : "";
+	ps.prog = prog;
+	ps.error = error;
+	ps.error_size = error_size;
+	ps.failed = false;
+
+	if (parse_expr(&ps)) {
+		skip_ws(&ps);
+		if (*ps.p) parse_fail(&ps, "Unexpected '%s'", ps.p);
+	}
+	if (!ps.failed && error && error_size > 0) error[0] = '\0';
+	return !ps.failed;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Evaluation                                                                */
+/* ------------------------------------------------------------------------- */
+
+static bool compare(TriggerComparison cmp, float a, float b) {
+	switch (cmp) {
+		case TRIGGER_OP_GREATER: return a > b;
+		case TRIGGER_OP_GREATER_EQUAL: return a >= b;
+		case TRIGGER_OP_LESS: return a < b;
+		case TRIGGER_OP_LESS_EQUAL: return a <= b;
+		case TRIGGER_OP_EQUAL: return a == b;
+		case TRIGGER_OP_NOT_EQUAL: return a != b;
+	}
+	return false;
+}
+
+static bool evaluate_leaf(AlertLeaf* leaf, const float* channels, uint64_t ts) {
+	float value = channels[leaf->channel];
+
+	if (leaf->rate) {
+		float raw = value;
+		value = 0.0f;
+		if (leaf->has_prev && ts > leaf->prev_timestamp) {
+			value = (raw - leaf->prev_value) * 1000000.0f / (float)(ts - leaf->prev_timestamp);
+		}
+		leaf->prev_value = raw;
+		leaf->prev_timestamp = ts;
+		leaf->has_prev = true;
+	}
+
+	// Once latched, a condition only releases after crossing back past the hysteresis band
+	float threshold = leaf->threshold;
+	if (leaf->raw_state && leaf->hysteresis > 0.0f) {
+		if (leaf->comparison == TRIGGER_OP_GREATER || leaf->comparison == TRIGGER_OP_GREATER_EQUAL) {
+			threshold -= leaf->hysteresis;
+		} else if (leaf->comparison == TRIGGER_OP_LESS || leaf->comparison == TRIGGER_OP_LESS_EQUAL) {
+			threshold += leaf->hysteresis;
+		}
+	}
+
+	bool raw = compare(leaf->comparison, value, threshold);
+	if (raw && !leaf->raw_state) leaf->true_since = ts;
+	leaf->raw_state = raw;
+
+	return raw && (ts - leaf->true_since) >= leaf->duration_us;
+}
+
+// Every leaf is evaluated on every frame so rate and duration state stay current
+static bool evaluate_program(AlertProgram* prog, const float* channels, uint64_t ts) {
+	bool stack[ALERT_MAX_INSTRUCTIONS];
+	int sp = 0;
+
+	for (int i = 0; i < prog->code_count; i++) {
+		const AlertInstr* in = &prog->code[i];
+		switch (in->op) {
+			case ALERT_INSTR_LEAF:
+				stack[sp++] = evaluate_leaf(&prog->leaves[in->leaf], channels, ts);
+				break;
+			case ALERT_INSTR_AND:
+				sp--;
+				stack[sp - 1] = stack[sp - 1] && stack[sp];
+				break;
+			case ALERT_INSTR_OR:
+				sp--;
+				stack[sp - 1] = stack[sp - 1] || stack[sp];
+				break;
+			case ALERT_INSTR_NOT:
+				stack[sp - 1] = !stack[sp - 1];
+				break;
+		}
+	}
+
+	return sp > 0 && stack[sp - 1];
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+static bool valid_rule(int rule_id) {
+	return rule_id >= 0 && rule_id < ALERT_RULES_MAX && g_rules[rule_id].used;
+}
+
+bool alert_rules_init(void) {
+	pthread_mutex_lock(&g_rules_mutex);
+	memset(g_rules, 0, sizeof(g_rules));
+	pthread_mutex_unlock(&g_rules_mutex);
+	return true;
+}
+
+void alert_rules_shutdown(void) {
+	alert_rules_clear();
+}
+
+int alert_rules_add(const char* condition, char* error, size_t error_size) {
+	AlertProgram prog;
+	if (!compile_condition(condition, &prog, error, error_size)) return -1;
+
+	pthread_mutex_lock(&g_rules_mutex);
+	int id = -1;
+	for (int i = 0; i < ALERT_RULES_MAX; i++) {
+		if (!g_rules[i].used) {
+			id = i;
+			break;
+		}
+	}
+	if (id >= 0) {
+		memset(&g_rules[id], 0, sizeof(g_rules[id]));
+		g_rules[id].used = true;
+		g_rules[id].enabled = true;
+		g_rules[id].program = prog;
+	} else if (error && error_size > 0) {
+		snprintf(error, error_size, "Too many alert rules (max %d)", ALERT_RULES_MAX);
+	}
+	pthread_mutex_unlock(&g_rules_mutex);
+	return id;
+}
+
+bool alert_rules_update(int rule_id, const char* condition, char* error, size_t error_size) {
+	AlertProgram prog;
+	if (!compile_condition(condition, &prog, error, error_size)) return false;
+
+	pthread_mutex_lock(&g_rules_mutex);
+	bool ok = valid_rule(rule_id);
+	if (ok) {
+		g_rules[rule_id].program = prog;
+		memset(&g_rules[rule_id].state, 0, sizeof(g_rules[rule_id].state));
+	}
+	pthread_mutex_unlock(&g_rules_mutex);
+	return ok;
+}
+
+void alert_rules_remove(int rule_id) {
+	pthread_mutex_lock(&g_rules_mutex);
+	if (valid_rule(rule_id)) memset(&g_rules[rule_id], 0, sizeof(g_rules[rule_id]));
+	pthread_mutex_unlock(&g_rules_mutex);
+}
+
+void alert_rules_clear(void) {
+	pthread_mutex_lock(&g_rules_mutex);
+	memset(g_rules, 0, sizeof(g_rules));
+	pthread_mutex_unlock(&g_rules_mutex);
+}
+
+void alert_rules_set_enabled(int rule_id, bool enabled) {
+	pthread_mutex_lock(&g_rules_mutex);
+	if (valid_rule(rule_id)) {
+		g_rules[rule_id].enabled = enabled;
+		if (!enabled) g_rules[rule_id].state.active = false;
+	}
+	pthread_mutex_unlock(&g_rules_mutex);
+}
+
+// Adjusts the first comparison of the rule (the one the UI threshold maps to)
+bool alert_rules_set_threshold(int rule_id, float threshold) {
+	pthread_mutex_lock(&g_rules_mutex);
+	bool ok = valid_rule(rule_id) && g_rules[rule_id].program.leaf_count > 0;
+	if (ok) g_rules[rule_id].program.leaves[0].threshold = threshold;
+	pthread_mutex_unlock(&g_rules_mutex);
+	return ok;
+}
+
+bool alert_rules_get_threshold(int rule_id, float* threshold) {
+	if (!threshold) return false;
+	pthread_mutex_lock(&g_rules_mutex);
+	bool ok = valid_rule(rule_id) && g_rules[rule_id].program.leaf_count > 0;
+	if (ok) *threshold = g_rules[rule_id].program.leaves[0].threshold;
+	pthread_mutex_unlock(&g_rules_mutex);
+	return ok;
+}
+
+bool alert_rules_get_state(int rule_id, AlertRuleState* state) {
+	if (!state) return false;
+	pthread_mutex_lock(&g_rules_mutex);
+	bool ok = valid_rule(rule_id);
+	if (ok) *state = g_rules[rule_id].state;
+	pthread_mutex_unlock(&g_rules_mutex);
+	return ok;
+}
+
+void alert_rules_process_frame(const float* channels, uint64_t timestamp_us) {
+	if (!channels) return;
+
+	pthread_mutex_lock(&g_rules_mutex);
+	for (int i = 0; i < ALERT_RULES_MAX; i++) {
+		AlertRule* rule = &g_rules[i];
+		if (!rule->used || !rule->enabled) continue;
+
+		bool active = evaluate_program(&rule->program, channels, timestamp_us);
+		if (active && !rule->state.active) {
+			rule->state.trigger_count++;
+			rule->state.last_trigger_us = timestamp_us;
+		} else if (!active && rule->state.active) {
+			rule->state.last_clear_us = timestamp_us;
+		}
+		rule->state.active = active;
+	}
+	pthread_mutex_unlock(&g_rules_mutex);
+}
+
+void alert_rules_on_sample(const ECUData* data, uint64_t timestamp_us, void* user_data) {
+	(void)user_data;
+	if (!data) return;
+
+	float channels[ECU_CHANNEL_COUNT];
+	ecu_channels_snapshot(data, channels);
+	alert_rules_process_frame(channels, timestamp_us);
+}
@@ -0,0 +1,145 @@
+#include "../../include/core/channel_export.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct ChannelExport {
+    char name[64];
+    int fd;
+    size_t size;
+    ChannelExportHeader* header;
+    ChannelExportSlot* slots;
+    uint32_t slot_mask;
+    uint64_t write_index;       // Writer's copy; the shared one is only ever stored
+};
+
+static uint64_t get_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void store_words(void* dst, const void* src, size_t size) {
+    uint32_t* out = (uint32_t*)dst;
+    const uint32_t* in = (const uint32_t*)src;
+    for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+        __atomic_store_n(&out[i], in[i], __ATOMIC_RELAXED);
+    }
+}
+
+ChannelExport* channel_export_create(const char* name, uint32_t slot_count) {
+    if (!name || name[0] != '/' || slot_count == 0 || (slot_count & (slot_count - 1)) != 0) {
+        return nullptr;
+    }
+
+    ChannelExport* exporter = (ChannelExport*)calloc(1, sizeof(ChannelExport));
+    if (!exporter) return nullptr;
+    snprintf(exporter->name, sizeof(exporter->name), "%s", name);
+
+    // Start from a fresh segment; readers still mapping a previous one keep their copy
+    shm_unlink(name);
+    exporter->fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (exporter->fd < 0) {
+        printf("[ChannelExport] shm_open(%s) failed\n", name);
+        free(exporter);
+        return nullptr;
+    }
+
+    size_t header_size = (sizeof(ChannelExportHeader) + 63) & ~(size_t)63;
+    exporter->size = header_size + (size_t)slot_count * sizeof(ChannelExportSlot);
+    void* map = MAP_FAILED;
+    if (ftruncate(exporter->fd, (off_t)exporter->size) == 0) {
+        map = mmap(nullptr, exporter->size, PROT_READ | PROT_WRITE, MAP_SHARED, exporter->fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        printf("[ChannelExport] Failed to size/map %s\n", name);
+        close(exporter->fd);
+        shm_unlink(name);
+        free(exporter);
+        return nullptr;
+    }
+
+    exporter->header = (ChannelExportHeader*)map;
+    exporter->slots = (ChannelExportSlot*)((char*)map + header_size);
+    exporter->slot_mask = slot_count - 1;
+
+    ChannelExportHeader* header = exporter->header;
+    header->version = CHANNEL_EXPORT_VERSION;
+    header->header_size = (uint32_t)header_size;
+    header->slot_size = sizeof(ChannelExportSlot);
+    header->slot_count = slot_count;
+    header->writer_pid = (uint32_t)getpid();
+
+    // Magic last so readers never accept a half-initialized header
+    __atomic_store_n(&header->magic, CHANNEL_EXPORT_MAGIC, __ATOMIC_RELEASE);
+
+    printf("[ChannelExport] Exporting channels at %s (%u slots, %zu bytes)\n", name, slot_count, exporter->size);
+    return exporter;
+}
+
+void channel_export_destroy(ChannelExport* exporter) {
+    if (!exporter) return;
+
+    munmap(exporter->header, exporter->size);
+    close(exporter->fd);
+    shm_unlink(exporter->name);
+    printf("[ChannelExport] Stopped exporting %s\n", exporter->name);
+    free(exporter);
+}
+
+const char* channel_export_name(const ChannelExport* exporter) {
+    return exporter ? exporter->name : "";
+}
+
+void channel_export_set_channels(ChannelExport* exporter, const char* source,
+                                 const ChannelExportDescriptor* channels, int count) {
+    if (!exporter) return;
+    if (count < 0) count = 0;
+    if (count > CHANNEL_EXPORT_MAX_CHANNELS) count = CHANNEL_EXPORT_MAX_CHANNELS;
+
+    ChannelExportHeader* header = exporter->header;
+    uint32_t seq = __atomic_load_n(&header->layout_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&header->layout_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    char name[sizeof(header->source)] = {0};
+    snprintf(name, sizeof(name), "%s", source ? source : "");
+    store_words(header->source, name, sizeof(name));
+    store_words(header->channels, channels, (size_t)count * sizeof(ChannelExportDescriptor));
+    __atomic_store_n(&header->channel_count, (uint32_t)count, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&header->layout_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+void channel_export_publish(ChannelExport* exporter, uint64_t timestamp_us, uint32_t frame_id,
+                            const float* values, int count) {
+    if (!exporter || !values) return;
+    if (count < 0) count = 0;
+    if (count > CHANNEL_EXPORT_MAX_CHANNELS) count = CHANNEL_EXPORT_MAX_CHANNELS;
+
+    uint64_t index = exporter->write_index;
+    ChannelExportSlot* slot = &exporter->slots[index & exporter->slot_mask];
+
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&slot->timestamp_us, timestamp_us, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->frame_id, frame_id, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->layout, __atomic_load_n(&exporter->header->layout_seq, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->channel_count, (uint32_t)count, __ATOMIC_RELAXED);
+    store_words(slot->values, values, (size_t)count * sizeof(float));
+    __atomic_store_n(&slot->publish_ns, get_monotonic_ns(), __ATOMIC_RELAXED);
+
+    __atomic_store_n(&slot->sequence, index + 1, __ATOMIC_RELEASE);
+    exporter->write_index = index + 1;
+    __atomic_store_n(&exporter->header->write_index, index + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t channel_export_frames(const ChannelExport* exporter) {
+    return exporter ? exporter->write_index : 0;
+}
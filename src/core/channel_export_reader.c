@@ -0,0 +1,168 @@
+#include "../../include/core/channel_export_reader.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static void load_words(void* dst, const void* src, size_t size) {
+    uint32_t* out = (uint32_t*)dst;
+    const uint32_t* in = (const uint32_t*)src;
+    for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+        out[i] = __atomic_load_n(&in[i], __ATOMIC_RELAXED);
+    }
+}
+
+bool channel_reader_open(ChannelExportReader* reader, const char* name) {
+    if (!reader) return false;
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = shm_open(name ? name : CHANNEL_EXPORT_DEFAULT_NAME, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ChannelExportHeader)) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const ChannelExportHeader* header = (const ChannelExportHeader*)map;
+    size_t size = (size_t)st.st_size;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != CHANNEL_EXPORT_MAGIC ||
+        header->version != CHANNEL_EXPORT_VERSION ||
+        header->slot_size != sizeof(ChannelExportSlot) ||
+        header->slot_count == 0 || (header->slot_count & (header->slot_count - 1)) != 0 ||
+        header->header_size < sizeof(ChannelExportHeader) ||
+        header->header_size + (size_t)header->slot_count * header->slot_size > size) {
+        munmap(map, size);
+        return false;
+    }
+
+    reader->header = header;
+    reader->slots = (const ChannelExportSlot*)((const char*)map + header->header_size);
+    reader->size = size;
+    reader->slot_mask = header->slot_count - 1;
+    reader->cursor = __atomic_load_n(&header->write_index, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+void channel_reader_close(ChannelExportReader* reader) {
+    if (!reader || !reader->header) return;
+
+    munmap((void*)reader->header, reader->size);
+    memset(reader, 0, sizeof(*reader));
+}
+
+int channel_reader_channels(ChannelExportReader* reader, ChannelExportDescriptor* channels,
+                            int max_channels, char* source, size_t source_size) {
+    if (!reader || !reader->header) return -1;
+    const ChannelExportHeader* header = reader->header;
+
+    for (int attempt = 0; attempt < 64; attempt++) {
+        uint32_t seq = __atomic_load_n(&header->layout_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) continue;
+
+        uint32_t count = __atomic_load_n(&header->channel_count, __ATOMIC_RELAXED);
+        if (count > CHANNEL_EXPORT_MAX_CHANNELS) count = CHANNEL_EXPORT_MAX_CHANNELS;
+        int copied = channels ? ((int)count < max_channels ? (int)count : max_channels) : 0;
+        if (copied > 0) {
+            load_words(channels, header->channels, (size_t)copied * sizeof(ChannelExportDescriptor));
+        }
+        char name[sizeof(header->source)];
+        load_words(name, header->source, sizeof(name));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&header->layout_seq, __ATOMIC_RELAXED) != seq) continue;
+
+        for (int i = 0; i < copied; i++) {
+            channels[i].name[sizeof(channels[i].name) - 1] = '\0';
+            channels[i].unit[sizeof(channels[i].unit) - 1] = '\0';
+        }
+        if (source && source_size > 0) {
+            name[sizeof(name) - 1] = '\0';
+            strncpy(source, name, source_size - 1);
+            source[source_size - 1] = '\0';
+        }
+        reader->layout = seq;
+        return (int)count;
+    }
+    return -1;
+}
+
+int channel_reader_find(ChannelExportReader* reader, const char* name) {
+    ChannelExportDescriptor channels[CHANNEL_EXPORT_MAX_CHANNELS];
+    int count = channel_reader_channels(reader, channels, CHANNEL_EXPORT_MAX_CHANNELS, NULL, 0);
+    if (!name) return -1;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(channels[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+uint64_t channel_reader_available(const ChannelExportReader* reader) {
+    if (!reader || !reader->header) return 0;
+    uint64_t written = __atomic_load_n(&reader->header->write_index, __ATOMIC_ACQUIRE);
+    return written > reader->cursor ? written - reader->cursor : 0;
+}
+
+int channel_reader_next(ChannelExportReader* reader, ChannelExportFrame* frame,
+                        float* values, int max_values) {
+    if (!reader || !reader->header) return CHANNEL_READER_EMPTY;
+    uint32_t slot_count = reader->slot_mask + 1;
+
+    for (;;) {
+        uint64_t written = __atomic_load_n(&reader->header->write_index, __ATOMIC_ACQUIRE);
+        if (reader->cursor >= written) return CHANNEL_READER_EMPTY;
+
+        // Fallen more than a ring behind: jump to the oldest frame that can still be intact
+        if (written - reader->cursor > slot_count) {
+            reader->frames_lost += written - reader->cursor - slot_count;
+            reader->cursor = written - slot_count;
+        }
+
+        const ChannelExportSlot* slot = &reader->slots[reader->cursor & reader->slot_mask];
+        uint64_t expected = reader->cursor + 1;
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != expected) {
+            reader->frames_lost++;
+            reader->cursor++;
+            continue;
+        }
+
+        uint32_t layout = __atomic_load_n(&slot->layout, __ATOMIC_RELAXED);
+        uint32_t count = __atomic_load_n(&slot->channel_count, __ATOMIC_RELAXED);
+        if (count > CHANNEL_EXPORT_MAX_CHANNELS) count = CHANNEL_EXPORT_MAX_CHANNELS;
+        uint32_t copied = values ? (count < (uint32_t)max_values ? count : (uint32_t)max_values) : 0;
+
+        ChannelExportFrame result;
+        result.index = reader->cursor;
+        result.timestamp_us = __atomic_load_n(&slot->timestamp_us, __ATOMIC_RELAXED);
+        result.publish_ns = __atomic_load_n(&slot->publish_ns, __ATOMIC_RELAXED);
+        result.frame_id = __atomic_load_n(&slot->frame_id, __ATOMIC_RELAXED);
+        result.channel_count = copied;
+        load_words(values, slot->values, copied * sizeof(float));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != expected) {
+            reader->frames_lost++;
+            reader->cursor++;
+            continue;
+        }
+
+        reader->cursor++;
+        if (frame) *frame = result;
+        return layout == reader->layout ? CHANNEL_READER_OK : CHANNEL_READER_LAYOUT_CHANGED;
+    }
+}
+
+int channel_reader_latest(ChannelExportReader* reader, ChannelExportFrame* frame,
+                          float* values, int max_values) {
+    if (!reader || !reader->header) return CHANNEL_READER_EMPTY;
+
+    uint64_t written = __atomic_load_n(&reader->header->write_index, __ATOMIC_ACQUIRE);
+    if (written == 0) return CHANNEL_READER_EMPTY;
+    if (written - 1 > reader->cursor) reader->cursor = written - 1;
+
+    return channel_reader_next(reader, frame, values, max_values);
+}
@@ -6,17 +6,56 @@
 #include <time.h>
 #include <sys/time.h>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 // Global data bridge instance
 DataBridge g_data_bridge;
 
+// Poll interval for ECU plugins without sample notifications (100Hz)
+#define DATA_BRIDGE_POLL_INTERVAL_US 10000
+
+// Connection snapshot taken under the lock and processed outside it
+typedef struct {
+    DataConnection* conn;       // Only dereferenced under the lock with matching generation
+    PluginInterface* viz_plugin;
+    int channel_index;
+    int series_handle;
+    // Copied: the connection may be erased while the item is in use
+    char chart_id[sizeof(DataConnection::chart_id)];
+    char series_name[sizeof(DataConnection::series_name)];
+    uint64_t interval_us;
+    uint64_t last_update;
+    bool sent;
+} DataBridgeWorkItem;
+
+typedef struct {
+    ECUSource ecu;
+    ChannelExport* exporter;
+    size_t first_item;
+    size_t item_count;
+} DataBridgeWorkSource;
+
 // Performance statistics
 static DataBridgePerformance g_performance_stats;
 
+// Held while the bridge thread calls into plugins; a plugin hot reload takes it to quiesce the bridge
+static pthread_mutex_t g_plugin_call_gate = PTHREAD_MUTEX_INITIALIZER;
+
 // Forward declarations
 static void* data_bridge_thread_func(void* arg);
 static uint64_t get_timestamp_us(void);
+static uint64_t get_monotonic_us(void);
 static void update_performance_stats(uint64_t start_time, bool success);
+static int find_or_add_source(PluginInterface* plugin);
+static void compile_connection(DataConnection* conn);
+static void recompile_connections(void);
+static void on_ecu_sample(void* user_data, uint64_t timestamp);
+static void update_sources(void);
+static bool start_bridge_thread(void);
+static void hook_sample_callback(int source_index);
+static void export_channel_table(const DataBridgeSource& source);
+static int find_ecu_source(const char* ecu_plugin_name);
 
 bool data_bridge_init(void) {
     if (g_data_bridge.initialized) return false;
@@ -24,6 +63,10 @@ bool data_bridge_init(void) {
     if (pthread_mutex_init(&g_data_bridge.bridge_mutex, NULL) != 0) {
         return false;
     }
+    if (pthread_cond_init(&g_data_bridge.bridge_cond, NULL) != 0) {
+        pthread_mutex_destroy(&g_data_bridge.bridge_mutex);
+        return false;
+    }
     
     g_data_bridge.initialized = true;
     g_data_bridge.thread_running = false;
@@ -39,19 +82,38 @@ void data_bridge_cleanup(void) {
     if (!g_data_bridge.initialized) return;
     
     // Stop bridge thread
-    if (g_data_bridge.thread_running) {
-        g_data_bridge.thread_running = false;
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    bool was_running = g_data_bridge.thread_running;
+    g_data_bridge.thread_running = false;
+    pthread_cond_signal(&g_data_bridge.bridge_cond);
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    if (was_running) {
         pthread_join(g_data_bridge.bridge_thread, NULL);
     }
     
+    // data_bridge_update() callers may still be mid-publish; wait for them at the gate
+    pthread_mutex_lock(&g_plugin_call_gate);
+    
+    // Detach sample notifications before the sources go away
+    for (const auto& source : g_data_bridge.sources) {
+        if (source.event_driven && source.plugin->interface.ecu.set_sample_callback) {
+            source.plugin->interface.ecu.set_sample_callback(NULL, NULL);
+        }
+        channel_export_destroy(source.exporter);
+    }
+    
     pthread_mutex_lock(&g_data_bridge.bridge_mutex);
     
     // Clear all connections
     g_data_bridge.connections.clear();
     g_data_bridge.ecu_plugins.clear();
     g_data_bridge.visualization_plugins.clear();
+    g_data_bridge.sources.clear();
+    g_data_bridge.generation++;
     
     pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    pthread_mutex_unlock(&g_plugin_call_gate);
+    pthread_cond_destroy(&g_data_bridge.bridge_cond);
     pthread_mutex_destroy(&g_data_bridge.bridge_mutex);
     
     g_data_bridge.initialized = false;
@@ -72,6 +134,8 @@ bool data_bridge_register_ecu_plugin(PluginInterface* plugin) {
     }
     
     g_data_bridge.ecu_plugins.push_back(plugin);
+    find_or_add_source(plugin);
+    recompile_connections();
     pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
     
     printf("[DataBridge] Registered ECU plugin: %s\n", plugin->name);
@@ -92,6 +156,7 @@ bool data_bridge_register_visualization_plugin(PluginInterface* plugin) {
     }
     
     g_data_bridge.visualization_plugins.push_back(plugin);
+    recompile_connections();
     pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
     
     printf("[DataBridge] Registered visualization plugin: %s\n", plugin->name);
@@ -128,6 +193,13 @@ bool data_bridge_create_connection(const char* connection_id,
     conn.active = false;
     conn.update_rate = update_rate;
     conn.last_update = 0;
+    compile_connection(&conn);
+    g_data_bridge.generation++;
+    
+    if (conn.ecu_plugin && conn.channel_index < 0) {
+        printf("[DataBridge] Warning: unknown data source '%s' for connection %s\n",
+               data_source, connection_id);
+    }
     
     pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
     
@@ -139,17 +211,22 @@ bool data_bridge_create_connection(const char* connection_id,
 bool data_bridge_remove_connection(const char* connection_id) {
     if (!connection_id) return false;
     
+    // Like data_bridge_stop_export: don't pull a connection out from under an update in flight
+    pthread_mutex_lock(&g_plugin_call_gate);
     pthread_mutex_lock(&g_data_bridge.bridge_mutex);
     
     auto it = g_data_bridge.connections.find(connection_id);
     if (it != g_data_bridge.connections.end()) {
         g_data_bridge.connections.erase(it);
+        g_data_bridge.generation++;
         pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+        pthread_mutex_unlock(&g_plugin_call_gate);
         printf("[DataBridge] Removed connection: %s\n", connection_id);
         return true;
     }
     
     pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    pthread_mutex_unlock(&g_plugin_call_gate);
     return false;
 }
 
@@ -160,19 +237,29 @@ bool data_bridge_start_connection(const char* connection_id) {
     
     auto it = g_data_bridge.connections.find(connection_id);
     if (it != g_data_bridge.connections.end()) {
-        it->second.active = true;
+        DataConnection& conn = it->second;
+        conn.active = true;
         
-        // Start bridge thread if not running
-        if (!g_data_bridge.thread_running) {
-            g_data_bridge.thread_running = true;
-            if (pthread_create(&g_data_bridge.bridge_thread, NULL, data_bridge_thread_func, NULL) != 0) {
-                g_data_bridge.thread_running = false;
-                pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
-                return false;
-            }
+        // The ECU's channel table may have changed since it connected
+        int source_index = conn.source_index;
+        if (source_index >= 0) {
+            DataBridgeSource& source = g_data_bridge.sources[source_index];
+            ecu_source_attach(&source.ecu, source.plugin);
+            export_channel_table(source);
+            recompile_connections();
         }
         
+        if (!start_bridge_thread()) {
+            pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+            return false;
+        }
+        
+        pthread_cond_signal(&g_data_bridge.bridge_cond);
         pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+        
+        // Hook the ECU's sample notifications the first time it gets an active connection
+        hook_sample_callback(source_index);
+        
         printf("[DataBridge] Started connection: %s\n", connection_id);
         return true;
     }
@@ -201,55 +288,214 @@ bool data_bridge_stop_connection(const char* connection_id) {
 void data_bridge_update(void) {
     if (!g_data_bridge.initialized) return;
     
-    uint64_t current_time = get_timestamp_us();
+    pthread_mutex_lock(&g_plugin_call_gate);
+    update_sources();
+    pthread_mutex_unlock(&g_plugin_call_gate);
+}
+
+void data_bridge_suspend(void) {
+    pthread_mutex_lock(&g_plugin_call_gate);
+}
+
+void data_bridge_resume(void) {
+    if (g_data_bridge.initialized) {
+        std::vector<std::pair<PluginInterface*, int>> hooks;
+        
+        // Swapped plugins may report different channel tables and series handles
+        pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+        for (size_t i = 0; i < g_data_bridge.sources.size(); i++) {
+            DataBridgeSource& source = g_data_bridge.sources[i];
+            ecu_source_attach(&source.ecu, source.plugin);
+            export_channel_table(source);
+            source.last_frame_id = 0;
+            source.pending = true;
+            if (source.event_driven && source.plugin->interface.ecu.set_sample_callback) {
+                hooks.push_back(std::make_pair(source.plugin, (int)i));
+            }
+        }
+        recompile_connections();
+        pthread_cond_signal(&g_data_bridge.bridge_cond);
+        pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+        
+        // A reloaded ECU plugin starts without our sample callback
+        for (const auto& hook : hooks) {
+            hook.first->interface.ecu.set_sample_callback(on_ecu_sample, (void*)(intptr_t)hook.second);
+        }
+    }
+    
+    pthread_mutex_unlock(&g_plugin_call_gate);
+}
+
+bool data_bridge_export_channels(const char* ecu_plugin_name, const char* shm_name) {
+    if (!g_data_bridge.initialized || !ecu_plugin_name) return false;
     
     pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    int source_index = find_ecu_source(ecu_plugin_name);
+    bool exporting = source_index >= 0 && g_data_bridge.sources[source_index].exporter;
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    if (source_index < 0 || exporting) return false;
     
-    for (auto& pair : g_data_bridge.connections) {
-        DataConnection& conn = pair.second;
-        
-        if (!conn.active) continue;
-        
-        // Check if it's time to update
-        uint64_t interval_us = (uint64_t)(1000000.0f / conn.update_rate);
-        if (current_time - conn.last_update < interval_us) continue;
+    ChannelExport* exporter = channel_export_create(shm_name ? shm_name : CHANNEL_EXPORT_DEFAULT_NAME,
+                                                    CHANNEL_EXPORT_DEFAULT_SLOTS);
+    if (!exporter) return false;
+    
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    DataBridgeSource& source = g_data_bridge.sources[source_index];
+    source.exporter = exporter;
+    ecu_source_attach(&source.ecu, source.plugin);
+    export_channel_table(source);
+    recompile_connections();
+    source.pending = true;
+    bool started = start_bridge_thread();
+    pthread_cond_signal(&g_data_bridge.bridge_cond);
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    
+    if (!started) {
+        data_bridge_stop_export(ecu_plugin_name);
+        return false;
+    }
+    
+    hook_sample_callback(source_index);
+    printf("[DataBridge] Exporting %s channels to %s\n", ecu_plugin_name, channel_export_name(exporter));
+    return true;
+}
+
+void data_bridge_stop_export(const char* ecu_plugin_name) {
+    if (!g_data_bridge.initialized || !ecu_plugin_name) return;
+    
+    // The bridge thread publishes outside bridge_mutex, so wait for it at the gate
+    pthread_mutex_lock(&g_plugin_call_gate);
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    ChannelExport* exporter = nullptr;
+    int source_index = find_ecu_source(ecu_plugin_name);
+    if (source_index >= 0) {
+        exporter = g_data_bridge.sources[source_index].exporter;
+        g_data_bridge.sources[source_index].exporter = nullptr;
+    }
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    pthread_mutex_unlock(&g_plugin_call_gate);
+    
+    channel_export_destroy(exporter);
+}
+
+bool data_bridge_is_exporting(const char* ecu_plugin_name) {
+    if (!g_data_bridge.initialized || !ecu_plugin_name) return false;
+    
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    int source_index = find_ecu_source(ecu_plugin_name);
+    bool exporting = source_index >= 0 && g_data_bridge.sources[source_index].exporter;
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    return exporting;
+}
+
+// Read due sources and fan samples out to their connections (caller holds g_plugin_call_gate)
+static void update_sources(void) {
+    // Scratch buffers reused across updates (only the bridge thread calls this)
+    static std::vector<DataBridgeWorkItem> items;
+    static std::vector<DataBridgeWorkSource> work;
+    items.clear();
+    work.clear();
+    
+    uint64_t now_mono = get_monotonic_us();
+    
+    // Collect due sources and their connections under the lock
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    
+    uint64_t generation = g_data_bridge.generation;
+    for (size_t s = 0; s < g_data_bridge.sources.size(); s++) {
+        DataBridgeSource& source = g_data_bridge.sources[s];
+        bool due = source.pending ||
+                   (!source.event_driven && now_mono - source.last_poll >= DATA_BRIDGE_POLL_INTERVAL_US);
+        if (!due) continue;
         
-        // Find ECU plugin
-        PluginInterface* ecu_plugin = nullptr;
-        for (auto* plugin : g_data_bridge.ecu_plugins) {
-            if (strcmp(plugin->name, conn.ecu_plugin_name) == 0) {
-                ecu_plugin = plugin;
-                break;
+        // Skip the read entirely when the plugin has not published a new frame
+        uint32_t (*get_frame_id)(void) = source.plugin->interface.ecu.get_frame_id;
+        if (get_frame_id) {
+            uint32_t frame_id = get_frame_id();
+            if (frame_id == source.last_frame_id) {
+                source.pending = false;
+                source.last_poll = now_mono;
+                continue;
             }
+            source.last_frame_id = frame_id;
         }
         
-        // Find visualization plugin
-        PluginInterface* viz_plugin = nullptr;
-        for (auto* plugin : g_data_bridge.visualization_plugins) {
-            if (strcmp(plugin->name, conn.chart_plugin_name) == 0) {
-                viz_plugin = plugin;
-                break;
+        DataBridgeWorkSource ws = { source.ecu, source.exporter, items.size(), 0 };
+        for (auto& pair : g_data_bridge.connections) {
+            DataConnection& conn = pair.second;
+            if (!conn.active || conn.source_index != (int)s || !conn.viz_plugin || conn.channel_index < 0) {
+                continue;
             }
+            
+            DataBridgeWorkItem item;
+            item.conn = &conn;
+            item.viz_plugin = conn.viz_plugin;
+            item.channel_index = conn.channel_index;
+            item.series_handle = conn.series_handle;
+            memcpy(item.chart_id, conn.chart_id, sizeof(item.chart_id));
+            memcpy(item.series_name, conn.series_name, sizeof(item.series_name));
+            item.interval_us = conn.update_rate > 0.0f ? (uint64_t)(1000000.0f / conn.update_rate) : 0;
+            item.last_update = conn.last_update;
+            item.sent = false;
+            items.push_back(item);
         }
+        ws.item_count = items.size() - ws.first_item;
         
-        if (!ecu_plugin || !viz_plugin) continue;
-        
+        source.pending = false;
+        source.last_poll = now_mono;
+        if (ws.item_count > 0 || ws.exporter) {
+            work.push_back(ws);
+        }
+    }
+    
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    
+    if (work.empty()) return;
+    
+    // One frame read per ECU, fanned out to its connections without holding the lock
+    static std::vector<float> values;
+    uint64_t current_time = get_timestamp_us();
+    float x_value = current_time / 1000000.0f; // Convert to seconds
+    for (const auto& ws : work) {
         uint64_t start_time = get_timestamp_us();
         
-        // Extract data from ECU plugin
-        float value;
-        bool success = extract_ecu_data_point(ecu_plugin, conn.data_source, &value);
-        
-        if (success) {
-            // Inject data into visualization plugin
-            float x_value = current_time / 1000000.0f; // Convert to seconds
-            success = inject_chart_data_point(viz_plugin, conn.chart_id, x_value, value, conn.series_name);
+        if ((int)values.size() < ws.ecu.channel_count) {
+            values.resize(ws.ecu.channel_count);
+        }
+        ECUSampleHeader header;
+        bool have_data = ecu_source_read(&ws.ecu, &header, values.data(), ws.ecu.channel_count);
+        if (have_data && ws.exporter) {
+            channel_export_publish(ws.exporter, header.timestamp, header.frame_id,
+                                   values.data(), (int)header.channel_count);
         }
         
-        conn.last_update = current_time;
-        update_performance_stats(start_time, success);
+        for (size_t i = ws.first_item; i < ws.first_item + ws.item_count; i++) {
+            DataBridgeWorkItem& item = items[i];
+            if (now_mono - item.last_update < item.interval_us) continue;
+            
+            bool success = have_data && item.channel_index < (int)header.channel_count;
+            if (success) {
+                float value = values[item.channel_index];
+                const DataVisualizationPluginInterface& viz = item.viz_plugin->interface.visualization;
+                if (item.series_handle >= 0) {
+                    success = viz.add_data_point_by_handle(item.series_handle, x_value, value);
+                } else {
+                    success = inject_chart_data_point(item.viz_plugin, item.chart_id, x_value, value, item.series_name);
+                }
+            }
+            
+            item.sent = true;
+            update_performance_stats(start_time, success);
+        }
     }
     
+    // Write back rate-limit state unless connections changed meanwhile
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    if (g_data_bridge.generation == generation) {
+        for (const auto& item : items) {
+            if (item.sent) item.conn->last_update = now_mono;
+        }
+    }
     pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
 }
 
@@ -290,28 +536,21 @@ const char* data_bridge_get_status(void) {
 bool extract_ecu_data_point(PluginInterface* ecu_plugin, const char* data_source, float* value) {
     if (!ecu_plugin || !data_source || !value) return false;
     
-    // Get real-time data from ECU plugin
-    ECURealtimeData ecu_data;
-    if (!ecu_plugin->interface.ecu.read_realtime_data || 
-        !ecu_plugin->interface.ecu.read_realtime_data(&ecu_data)) {
-        return false;
-    }
+    ECUSource source;
+    if (!ecu_source_attach(&source, ecu_plugin)) return false;
     
-    // Extract specific data source
-    if (strcmp(data_source, "rpm") == 0) {
-        *value = ecu_data.rpm;
-    } else if (strcmp(data_source, "map") == 0) {
-        *value = ecu_data.map;
-    } else if (strcmp(data_source, "air_temp") == 0) {
-        *value = ecu_data.air_temp;
-    } else if (strcmp(data_source, "timing") == 0) {
-        *value = ecu_data.timing;
-    } else if (strcmp(data_source, "battery_voltage") == 0) {
-        *value = ecu_data.battery_voltage;
-    } else {
-        return false; // Unknown data source
+    int channel_index = ecu_source_find_channel(&source, data_source);
+    if (channel_index < 0) return false; // Unknown data source
+    
+    // Get the latest frame from the ECU plugin
+    std::vector<float> values(source.channel_count);
+    ECUSampleHeader header;
+    if (!ecu_source_read(&source, &header, values.data(), source.channel_count) ||
+        channel_index >= (int)header.channel_count) {
+        return false;
     }
     
+    *value = values[channel_index];
     return true;
 }
 
@@ -346,21 +585,188 @@ static void* data_bridge_thread_func(void* arg) {
     
     printf("[DataBridge] Bridge thread started\n");
     
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
     while (g_data_bridge.thread_running) {
+        // Sleep until a source announces a sample; polled sources bound the wait
+        bool any_pending = false;
+        bool any_polled = false;
+        for (const auto& source : g_data_bridge.sources) {
+            any_pending |= source.pending;
+            any_polled |= !source.event_driven;
+        }
+        
+        if (!any_pending) {
+            if (any_polled) {
+                struct timespec deadline;
+                clock_gettime(CLOCK_REALTIME, &deadline);
+                deadline.tv_nsec += DATA_BRIDGE_POLL_INTERVAL_US * 1000L;
+                if (deadline.tv_nsec >= 1000000000L) {
+                    deadline.tv_sec++;
+                    deadline.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&g_data_bridge.bridge_cond, &g_data_bridge.bridge_mutex, &deadline);
+            } else {
+                pthread_cond_wait(&g_data_bridge.bridge_cond, &g_data_bridge.bridge_mutex);
+            }
+            if (!g_data_bridge.thread_running) break;
+        }
+        
+        pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
         data_bridge_update();
-        usleep(10000); // 10ms sleep for 100Hz update rate
+        pthread_mutex_lock(&g_data_bridge.bridge_mutex);
     }
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
     
     printf("[DataBridge] Bridge thread stopped\n");
     return NULL;
 }
 
+// Sample notification from an ECU plugin's acquisition thread
+static void on_ecu_sample(void* user_data, uint64_t timestamp) {
+    (void)timestamp;
+    size_t index = (size_t)(intptr_t)user_data;
+    
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    if (index < g_data_bridge.sources.size()) {
+        g_data_bridge.sources[index].pending = true;
+        pthread_cond_signal(&g_data_bridge.bridge_cond);
+    }
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+}
+
+// Caller holds bridge_mutex
+static int find_or_add_source(PluginInterface* plugin) {
+    for (size_t i = 0; i < g_data_bridge.sources.size(); i++) {
+        if (g_data_bridge.sources[i].plugin == plugin) return (int)i;
+    }
+    
+    DataBridgeSource source;
+    source.plugin = plugin;
+    ecu_source_attach(&source.ecu, plugin);
+    source.event_driven = false;
+    source.pending = false;
+    source.last_poll = 0;
+    source.last_frame_id = 0;
+    source.exporter = nullptr;
+    g_data_bridge.sources.push_back(source);
+    return (int)g_data_bridge.sources.size() - 1;
+}
+
+// Caller holds bridge_mutex
+static int find_ecu_source(const char* ecu_plugin_name) {
+    for (auto* plugin : g_data_bridge.ecu_plugins) {
+        if (strcmp(plugin->name, ecu_plugin_name) == 0) {
+            return find_or_add_source(plugin);
+        }
+    }
+    return -1;
+}
+
+// Caller holds bridge_mutex
+static bool start_bridge_thread(void) {
+    if (g_data_bridge.thread_running) return true;
+    
+    g_data_bridge.thread_running = true;
+    if (pthread_create(&g_data_bridge.bridge_thread, NULL, data_bridge_thread_func, NULL) != 0) {
+        g_data_bridge.thread_running = false;
+        return false;
+    }
+    return true;
+}
+
+// Switch a polled source to sample notifications if its plugin offers them. Called without bridge_mutex.
+static void hook_sample_callback(int source_index) {
+    if (source_index < 0) return;
+    
+    pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+    PluginInterface* plugin = nullptr;
+    if (source_index < (int)g_data_bridge.sources.size()) {
+        DataBridgeSource& source = g_data_bridge.sources[source_index];
+        if (!source.event_driven && source.plugin->interface.ecu.set_sample_callback) {
+            plugin = source.plugin;
+        }
+    }
+    pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+    
+    if (plugin && plugin->interface.ecu.set_sample_callback(on_ecu_sample, (void*)(intptr_t)source_index)) {
+        pthread_mutex_lock(&g_data_bridge.bridge_mutex);
+        g_data_bridge.sources[source_index].event_driven = true;
+        pthread_mutex_unlock(&g_data_bridge.bridge_mutex);
+        printf("[DataBridge] %s delivers sample notifications\n", plugin->name);
+    }
+}
+
+// Mirror a source's channel table into its export segment. Caller holds bridge_mutex.
+static void export_channel_table(const DataBridgeSource& source) {
+    if (!source.exporter) return;
+    
+    ChannelExportDescriptor channels[CHANNEL_EXPORT_MAX_CHANNELS];
+    int count = source.ecu.channel_count < CHANNEL_EXPORT_MAX_CHANNELS ?
+                source.ecu.channel_count : CHANNEL_EXPORT_MAX_CHANNELS;
+    memset(channels, 0, sizeof(channels));
+    for (int i = 0; i < count; i++) {
+        const ECUChannelDescriptor& desc = source.ecu.channels[i];
+        snprintf(channels[i].name, sizeof(channels[i].name), "%s", desc.name ? desc.name : "");
+        snprintf(channels[i].unit, sizeof(channels[i].unit), "%s", desc.unit ? desc.unit : "");
+        channels[i].scale = desc.scale;
+        channels[i].offset = desc.offset;
+    }
+    channel_export_set_channels(source.exporter, source.plugin->name, channels, count);
+}
+
+// Resolve plugin names, channel and series handle once. Caller holds bridge_mutex.
+static void compile_connection(DataConnection* conn) {
+    conn->ecu_plugin = nullptr;
+    conn->viz_plugin = nullptr;
+    conn->source_index = -1;
+    conn->series_handle = -1;
+    conn->channel_index = -1;
+    
+    for (auto* plugin : g_data_bridge.ecu_plugins) {
+        if (strcmp(plugin->name, conn->ecu_plugin_name) == 0) {
+            conn->ecu_plugin = plugin;
+            conn->source_index = find_or_add_source(plugin);
+            conn->channel_index = ecu_source_find_channel(&g_data_bridge.sources[conn->source_index].ecu,
+                                                          conn->data_source);
+            break;
+        }
+    }
+    
+    for (auto* plugin : g_data_bridge.visualization_plugins) {
+        if (strcmp(plugin->name, conn->chart_plugin_name) == 0) {
+            conn->viz_plugin = plugin;
+            break;
+        }
+    }
+    
+    if (conn->viz_plugin &&
+        conn->viz_plugin->interface.visualization.get_series_handle &&
+        conn->viz_plugin->interface.visualization.add_data_point_by_handle) {
+        conn->series_handle = conn->viz_plugin->interface.visualization.get_series_handle(conn->chart_id,
+                                                                                          conn->series_name);
+    }
+}
+
+// Caller holds bridge_mutex
+static void recompile_connections(void) {
+    for (auto& pair : g_data_bridge.connections) {
+        compile_connection(&pair.second);
+    }
+    g_data_bridge.generation++;
+}
+
 static uint64_t get_timestamp_us(void) {
     struct timeval tv;
     gettimeofday(&tv, NULL);
     return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
 }
 
+static uint64_t get_monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 static void update_performance_stats(uint64_t start_time, bool success) {
     uint64_t end_time = get_timestamp_us();
     float transfer_time = (end_time - start_time) / 1000.0f; // Convert to milliseconds
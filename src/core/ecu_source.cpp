@@ -0,0 +1,89 @@
+#include "../../include/core/ecu_source.h"
+#include <cstring>
+#include <cstddef>
+
+// v1 adapter: descriptor table over ECURealtimeData (index == value position)
+static const ECUChannelDescriptor g_v1_channels[] = {
+    {"rpm",             "RPM", 1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"map",             "kPa", 1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"coolant_temp",    "°C",  1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"air_temp",        "°C",  1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"throttle",        "%",   1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"afr",             "AFR", 1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"timing",          "°",   1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"fuel_pressure",   "PSI", 1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"oil_pressure",    "PSI", 1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+    {"battery_voltage", "V",   1.0f, 0.0f, ECU_CHANNEL_DATA_FLOAT},
+};
+static const size_t g_v1_offsets[] = {
+    offsetof(ECURealtimeData, rpm),
+    offsetof(ECURealtimeData, map),
+    offsetof(ECURealtimeData, coolant_temp),
+    offsetof(ECURealtimeData, air_temp),
+    offsetof(ECURealtimeData, throttle),
+    offsetof(ECURealtimeData, afr),
+    offsetof(ECURealtimeData, timing),
+    offsetof(ECURealtimeData, fuel_pressure),
+    offsetof(ECURealtimeData, oil_pressure),
+    offsetof(ECURealtimeData, battery_voltage),
+};
+static const int g_v1_channel_count = sizeof(g_v1_channels) / sizeof(g_v1_channels[0]);
+
+static_assert(sizeof(g_v1_offsets) / sizeof(g_v1_offsets[0]) == sizeof(g_v1_channels) / sizeof(g_v1_channels[0]),
+              "v1 channel table and offsets must match");
+
+bool ecu_source_attach(ECUSource* source, PluginInterface* plugin) {
+    if (!source || !plugin || plugin->type != PLUGIN_TYPE_ECU) return false;
+    
+    const ECUPluginInterface& ecu = plugin->interface.ecu;
+    source->plugin = plugin;
+    
+    if (ecu.abi_version >= ECU_PLUGIN_ABI_V2 && ecu.get_channel_descriptors && ecu.read_sample_frame) {
+        const ECUChannelDescriptor* channels = nullptr;
+        int count = ecu.get_channel_descriptors(&channels);
+        if (channels && count > 0) {
+            source->abi_version = ECU_PLUGIN_ABI_V2;
+            source->channels = channels;
+            source->channel_count = count;
+            return true;
+        }
+    }
+    
+    source->abi_version = ECU_PLUGIN_ABI_V1;
+    source->channels = g_v1_channels;
+    source->channel_count = g_v1_channel_count;
+    return ecu.read_realtime_data != nullptr;
+}
+
+int ecu_source_find_channel(const ECUSource* source, const char* name) {
+    if (!source || !source->channels || !name) return -1;
+    
+    for (int i = 0; i < source->channel_count; i++) {
+        if (source->channels[i].name && strcmp(source->channels[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ecu_source_read(const ECUSource* source, ECUSampleHeader* header, float* values, int max_values) {
+    if (!source || !source->plugin || !header || !values || max_values <= 0) return false;
+    
+    const ECUPluginInterface& ecu = source->plugin->interface.ecu;
+    if (source->abi_version >= ECU_PLUGIN_ABI_V2) {
+        return ecu.read_sample_frame(header, values, max_values);
+    }
+    
+    // v1 adapter
+    ECURealtimeData data;
+    if (!ecu.read_realtime_data || !ecu.read_realtime_data(&data)) return false;
+    
+    int count = g_v1_channel_count < max_values ? g_v1_channel_count : max_values;
+    for (int i = 0; i < count; i++) {
+        memcpy(&values[i], (const char*)&data + g_v1_offsets[i], sizeof(float));
+    }
+    header->timestamp = data.timestamp;
+    header->frame_id = ecu.get_frame_id ? ecu.get_frame_id() : 0;
+    header->channel_count = (uint32_t)count;
+    return true;
+}
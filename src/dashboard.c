@@ -437,7 +437,7 @@ G_MODULE_EXPORT void update_dash_gauge(gpointer key, gpointer value, gpointer us
 {
 	Dash_Gauge *d_gauge = (Dash_Gauge *)value;
 	static GMutex *rtv_mutex = NULL;;
-	GArray *history;
+	Rtv_History *history;
 	gfloat current = 0.0;
 	gfloat previous = 0.0;
 	GtkWidget *gauge = NULL;
@@ -452,11 +452,11 @@ G_MODULE_EXPORT void update_dash_gauge(gpointer key, gpointer value, gpointer us
 	if (!d_gauge->object)
 		return;
 
-	history = (GArray *)DATA_GET(d_gauge->object,"history");
+	history = (Rtv_History *)DATA_GET(d_gauge->object,"history");
 	if ((GINT)history->len-1 <= 0)
 		return;
 	g_mutex_lock(rtv_mutex);
-	current = g_array_index(history, gfloat, history->len-1);
+	current = rtv_history_get(history,history->len-1);
 	g_mutex_unlock(rtv_mutex);
 
 	mtx_gauge_face_get_value(MTX_GAUGE_FACE(gauge),&previous);
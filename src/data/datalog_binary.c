@@ -0,0 +1,488 @@
+/*
+ * Binary Datalog Format - MegaTunix Redux
+ *
+ * Writer buffers block_samples rows column-wise, then deflates the timestamp
+ * column and each channel column separately and appends them as one block.
+ * The index and markers are written once at close, followed by a fixed-size
+ * footer, so the reader can locate everything from the end of the file.
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include "../../include/data/datalog_binary.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+struct DatalogBinaryWriter {
+	FILE* file;
+	uint32_t channel_count;
+	uint32_t block_samples;
+	uint32_t pending;               // Rows buffered for the current block
+	int64_t* times;                 // [block_samples]
+	float* columns;                 // [channel_count][block_samples]
+	uint32_t* sizes;                // [channel_count + 1] compressed column sizes
+	Bytef* deflated;                // Compressed block payload
+	size_t deflated_size;
+	uint64_t offset;                // Bytes written so far
+	uint64_t sample_count;
+	DatalogBinaryIndexEntry* index;
+	uint32_t block_count;
+	uint32_t index_allocated;
+	DatalogBinaryMarker* markers;
+	uint32_t marker_count;
+	uint32_t marker_allocated;
+	bool failed;
+};
+
+struct DatalogBinaryReader {
+	int fd;
+	DatalogBinaryHeader header;
+	DatalogBinaryChannel* channels;
+	DatalogBinaryIndexEntry* index;
+	uint32_t block_count;
+	DatalogBinaryMarker* markers;
+	uint32_t marker_count;
+	uint64_t sample_count;
+	bool recovered;                 // No footer; blocks found by walking the file
+	uint32_t* sizes;                // [channel_count + 1] for the block being read
+	Bytef* scratch;                 // Compressed column being read
+	size_t scratch_size;
+};
+
+static bool grow(void** array, uint32_t* allocated, uint32_t needed, size_t element) {
+	if (needed <= *allocated) return true;
+	uint32_t count = *allocated ? *allocated * 2 : 64;
+	while (count < needed) count *= 2;
+	void* grown = realloc(*array, (size_t)count * element);
+	if (!grown) return false;
+	*array = grown;
+	*allocated = count;
+	return true;
+}
+
+static bool write_bytes(DatalogBinaryWriter* writer, const void* data, size_t size) {
+	if (writer->failed) return false;
+	if (size && fwrite(data, 1, size, writer->file) != size) {
+		writer->failed = true;
+		return false;
+	}
+	writer->offset += size;
+	return true;
+}
+
+DatalogBinaryWriter* datalog_binary_create(const char* path, const char* session,
+                                           const DatalogBinaryChannel* channels, int channel_count,
+                                           uint32_t block_samples) {
+	if (!path || !channels || channel_count <= 0 || channel_count > DATALOG_BINARY_MAX_CHANNELS) return NULL;
+	if (block_samples == 0) block_samples = DATALOG_BINARY_BLOCK_SAMPLES;
+
+	DatalogBinaryWriter* writer = calloc(1, sizeof(DatalogBinaryWriter));
+	if (!writer) return NULL;
+	writer->channel_count = (uint32_t)channel_count;
+	writer->block_samples = block_samples;
+	writer->times = malloc(block_samples * sizeof(int64_t));
+	writer->columns = malloc((size_t)channel_count * block_samples * sizeof(float));
+	writer->sizes = malloc((channel_count + 1) * sizeof(uint32_t));
+	writer->deflated_size = compressBound(block_samples * sizeof(int64_t))
+	                        + (size_t)channel_count * compressBound(block_samples * sizeof(float));
+	writer->deflated = malloc(writer->deflated_size);
+	writer->file = fopen(path, "wb");
+	if (!writer->times || !writer->columns || !writer->sizes || !writer->deflated || !writer->file) {
+		if (writer->file) fclose(writer->file);
+		free(writer->times);
+		free(writer->columns);
+		free(writer->sizes);
+		free(writer->deflated);
+		free(writer);
+		return NULL;
+	}
+
+	DatalogBinaryHeader header = {0};
+	header.magic = DATALOG_BINARY_MAGIC;
+	header.version = DATALOG_BINARY_VERSION;
+	header.header_size = sizeof(DatalogBinaryHeader);
+	header.channel_count = writer->channel_count;
+	header.block_samples = block_samples;
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	header.start_time_us = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+	snprintf(header.session, sizeof(header.session), "%s", session ? session : "");
+
+	write_bytes(writer, &header, sizeof(header));
+	for (int i = 0; i < channel_count; i++) {
+		// Copy through a zeroed entry so unterminated names never leak past their field
+		DatalogBinaryChannel channel = {0};
+		memcpy(channel.name, channels[i].name, sizeof(channel.name) - 1);
+		memcpy(channel.unit, channels[i].unit, sizeof(channel.unit) - 1);
+		write_bytes(writer, &channel, sizeof(channel));
+	}
+	return writer;
+}
+
+static bool deflate_column(DatalogBinaryWriter* writer, size_t* used, const void* data, size_t size, uint32_t* out_size) {
+	uLongf length = (uLongf)(writer->deflated_size - *used);
+	if (compress2(writer->deflated + *used, &length, data, size, Z_BEST_SPEED) != Z_OK) return false;
+	*out_size = (uint32_t)length;
+	*used += length;
+	return true;
+}
+
+// A block that cannot be written leaves the writer failed: its rows (and
+// their timestamps, already turned into deltas) cannot be retried
+static bool write_block(DatalogBinaryWriter* writer) {
+	uint32_t count = writer->pending;
+	if (writer->failed) return false;
+	if (count == 0) return true;
+	if (!grow((void**)&writer->index, &writer->index_allocated, writer->block_count + 1, sizeof(DatalogBinaryIndexEntry))) {
+		writer->failed = true;
+		return false;
+	}
+
+	DatalogBinaryBlockHeader header = {
+		.magic = DATALOG_BINARY_BLOCK_MAGIC,
+		.sample_count = count,
+		.first_time_us = writer->times[0],
+		.last_time_us = writer->times[count - 1],
+	};
+
+	// Timestamps become deltas in place; the buffer is refilled from row 0 next
+	for (uint32_t i = count - 1; i > 0; i--) {
+		writer->times[i] -= writer->times[i - 1];
+	}
+
+	size_t used = 0;
+	bool deflated = deflate_column(writer, &used, writer->times, count * sizeof(int64_t), &writer->sizes[0]);
+	for (uint32_t c = 0; deflated && c < writer->channel_count; c++) {
+		const float* column = writer->columns + (size_t)c * writer->block_samples;
+		deflated = deflate_column(writer, &used, column, count * sizeof(float), &writer->sizes[c + 1]);
+	}
+	if (!deflated) {
+		writer->failed = true;
+		return false;
+	}
+
+	DatalogBinaryIndexEntry* entry = &writer->index[writer->block_count];
+	*entry = (DatalogBinaryIndexEntry){
+		.offset = writer->offset,
+		.first_time_us = header.first_time_us,
+		.last_time_us = header.last_time_us,
+		.sample_count = count,
+	};
+
+	if (!write_bytes(writer, &header, sizeof(header))) return false;
+	if (!write_bytes(writer, writer->sizes, (writer->channel_count + 1) * sizeof(uint32_t))) return false;
+	if (!write_bytes(writer, writer->deflated, used)) return false;
+
+	writer->block_count++;
+	writer->pending = 0;
+	return true;
+}
+
+bool datalog_binary_append(DatalogBinaryWriter* writer, int64_t time_us, const float* values) {
+	if (!writer || !values || writer->failed || writer->pending >= writer->block_samples) return false;
+
+	uint32_t row = writer->pending;
+	writer->times[row] = time_us;
+	for (uint32_t c = 0; c < writer->channel_count; c++) {
+		writer->columns[(size_t)c * writer->block_samples + row] = values[c];
+	}
+	writer->pending = row + 1;
+	writer->sample_count++;
+
+	if (writer->pending == writer->block_samples) {
+		return write_block(writer);
+	}
+	return true;
+}
+
+bool datalog_binary_add_marker(DatalogBinaryWriter* writer, int64_t time_us, const char* label) {
+	if (!writer || !label) return false;
+	if (!grow((void**)&writer->markers, &writer->marker_allocated, writer->marker_count + 1, sizeof(DatalogBinaryMarker))) {
+		return false;
+	}
+	DatalogBinaryMarker* marker = &writer->markers[writer->marker_count++];
+	memset(marker, 0, sizeof(*marker));
+	marker->time_us = time_us;
+	snprintf(marker->label, sizeof(marker->label), "%s", label);
+	return true;
+}
+
+bool datalog_binary_flush(DatalogBinaryWriter* writer) {
+	if (!writer) return false;
+	if (!write_block(writer)) return false;
+	return fflush(writer->file) == 0 && !writer->failed;
+}
+
+bool datalog_binary_sync(DatalogBinaryWriter* writer) {
+	if (!writer || writer->failed) return false;
+	return fflush(writer->file) == 0 && fdatasync(fileno(writer->file)) == 0;
+}
+
+uint64_t datalog_binary_bytes_written(const DatalogBinaryWriter* writer) {
+	return writer ? writer->offset + (uint64_t)writer->pending * (writer->channel_count * sizeof(float) + sizeof(int64_t)) : 0;
+}
+
+bool datalog_binary_close(DatalogBinaryWriter* writer) {
+	if (!writer) return false;
+
+	bool ok = write_block(writer);
+	DatalogBinaryFooter footer = {
+		.index_offset = writer->offset,
+		.sample_count = writer->sample_count,
+		.block_count = writer->block_count,
+		.marker_count = writer->marker_count,
+		.magic = DATALOG_BINARY_FOOTER_MAGIC,
+	};
+	ok = ok && write_bytes(writer, writer->index, writer->block_count * sizeof(DatalogBinaryIndexEntry));
+	ok = ok && write_bytes(writer, writer->markers, writer->marker_count * sizeof(DatalogBinaryMarker));
+	ok = ok && write_bytes(writer, &footer, sizeof(footer));
+	if (fclose(writer->file) != 0) ok = false;
+
+	free(writer->times);
+	free(writer->columns);
+	free(writer->sizes);
+	free(writer->deflated);
+	free(writer->index);
+	free(writer->markers);
+	free(writer);
+	return ok;
+}
+
+// Reader
+
+static bool read_at(int fd, void* data, size_t size, uint64_t offset) {
+	char* out = data;
+	while (size > 0) {
+		ssize_t got = pread(fd, out, size, (off_t)offset);
+		if (got <= 0) return false;
+		out += got;
+		offset += (uint64_t)got;
+		size -= (size_t)got;
+	}
+	return true;
+}
+
+static bool load_footer(DatalogBinaryReader* reader, uint64_t file_size, uint64_t data_start) {
+	DatalogBinaryFooter footer;
+	if (file_size < data_start + sizeof(footer)) return false;
+	if (!read_at(reader->fd, &footer, sizeof(footer), file_size - sizeof(footer))) return false;
+	if (footer.magic != DATALOG_BINARY_FOOTER_MAGIC) return false;
+
+	uint64_t trailer = (uint64_t)footer.block_count * sizeof(DatalogBinaryIndexEntry)
+	                   + (uint64_t)footer.marker_count * sizeof(DatalogBinaryMarker);
+	if (footer.index_offset < data_start || footer.index_offset + trailer + sizeof(footer) != file_size) return false;
+
+	reader->index = malloc((footer.block_count ? footer.block_count : 1) * sizeof(DatalogBinaryIndexEntry));
+	reader->markers = malloc((footer.marker_count ? footer.marker_count : 1) * sizeof(DatalogBinaryMarker));
+	if (!reader->index || !reader->markers) return false;
+	if (!read_at(reader->fd, reader->index, footer.block_count * sizeof(DatalogBinaryIndexEntry), footer.index_offset)) return false;
+	if (!read_at(reader->fd, reader->markers, footer.marker_count * sizeof(DatalogBinaryMarker),
+	             footer.index_offset + footer.block_count * sizeof(DatalogBinaryIndexEntry))) {
+		return false;
+	}
+	reader->block_count = footer.block_count;
+	reader->marker_count = footer.marker_count;
+	reader->sample_count = footer.sample_count;
+	return true;
+}
+
+// Rebuild the index of a file whose writer never reached close(); stops at
+// the first block that is not complete on disk
+static bool scan_blocks(DatalogBinaryReader* reader, uint64_t file_size, uint64_t offset) {
+	uint32_t allocated = 0;
+	uint32_t channels = reader->header.channel_count;
+	free(reader->index);
+	free(reader->markers);
+	reader->index = NULL;
+	reader->markers = NULL;
+	reader->block_count = 0;
+	reader->marker_count = 0;
+	reader->sample_count = 0;
+
+	while (offset + sizeof(DatalogBinaryBlockHeader) <= file_size) {
+		DatalogBinaryBlockHeader header;
+		if (!read_at(reader->fd, &header, sizeof(header), offset)) break;
+		if (header.magic != DATALOG_BINARY_BLOCK_MAGIC || header.sample_count == 0
+		    || header.sample_count > reader->header.block_samples) {
+			break;
+		}
+		uint64_t payload = offset + sizeof(header) + (channels + 1) * sizeof(uint32_t);
+		if (payload > file_size || !read_at(reader->fd, reader->sizes, (channels + 1) * sizeof(uint32_t), offset + sizeof(header))) break;
+		for (uint32_t c = 0; c <= channels; c++) payload += reader->sizes[c];
+		if (payload > file_size) break;
+
+		if (!grow((void**)&reader->index, &allocated, reader->block_count + 1, sizeof(DatalogBinaryIndexEntry))) return false;
+		reader->index[reader->block_count++] = (DatalogBinaryIndexEntry){
+			.offset = offset,
+			.first_time_us = header.first_time_us,
+			.last_time_us = header.last_time_us,
+			.sample_count = header.sample_count,
+		};
+		reader->sample_count += header.sample_count;
+		offset = payload;
+	}
+	reader->recovered = true;
+	return true;
+}
+
+DatalogBinaryReader* datalog_binary_open(const char* path) {
+	if (!path) return NULL;
+	DatalogBinaryReader* reader = calloc(1, sizeof(DatalogBinaryReader));
+	if (!reader) return NULL;
+	reader->fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (reader->fd < 0) {
+		free(reader);
+		return NULL;
+	}
+
+	DatalogBinaryHeader* header = &reader->header;
+	off_t file_size = lseek(reader->fd, 0, SEEK_END);
+	if (file_size < (off_t)sizeof(*header) || !read_at(reader->fd, header, sizeof(*header), 0)
+	    || header->magic != DATALOG_BINARY_MAGIC || header->version != DATALOG_BINARY_VERSION
+	    || header->header_size != sizeof(*header) || header->channel_count == 0
+	    || header->channel_count > DATALOG_BINARY_MAX_CHANNELS || header->block_samples == 0) {
+		datalog_binary_close_reader(reader);
+		return NULL;
+	}
+
+	uint32_t channels = header->channel_count;
+	uint64_t data_start = sizeof(*header) + (uint64_t)channels * sizeof(DatalogBinaryChannel);
+	reader->channels = malloc(channels * sizeof(DatalogBinaryChannel));
+	reader->sizes = malloc((channels + 1) * sizeof(uint32_t));
+	if (!reader->channels || !reader->sizes
+	    || !read_at(reader->fd, reader->channels, channels * sizeof(DatalogBinaryChannel), sizeof(*header))) {
+		datalog_binary_close_reader(reader);
+		return NULL;
+	}
+	for (uint32_t c = 0; c < channels; c++) {
+		reader->channels[c].name[sizeof(reader->channels[c].name) - 1] = '\0';
+		reader->channels[c].unit[sizeof(reader->channels[c].unit) - 1] = '\0';
+	}
+
+	if (!load_footer(reader, (uint64_t)file_size, data_start)
+	    && !scan_blocks(reader, (uint64_t)file_size, data_start)) {
+		datalog_binary_close_reader(reader);
+		return NULL;
+	}
+	return reader;
+}
+
+void datalog_binary_close_reader(DatalogBinaryReader* reader) {
+	if (!reader) return;
+	if (reader->fd >= 0) close(reader->fd);
+	free(reader->channels);
+	free(reader->index);
+	free(reader->markers);
+	free(reader->sizes);
+	free(reader->scratch);
+	free(reader);
+}
+
+const DatalogBinaryHeader* datalog_binary_header(const DatalogBinaryReader* reader) {
+	return reader ? &reader->header : NULL;
+}
+
+const DatalogBinaryChannel* datalog_binary_channels(const DatalogBinaryReader* reader) {
+	return reader ? reader->channels : NULL;
+}
+
+int datalog_binary_find_channel(const DatalogBinaryReader* reader, const char* name) {
+	if (!reader || !name) return -1;
+	for (uint32_t c = 0; c < reader->header.channel_count; c++) {
+		if (strcmp(reader->channels[c].name, name) == 0) return (int)c;
+	}
+	return -1;
+}
+
+int datalog_binary_block_count(const DatalogBinaryReader* reader) {
+	return reader ? (int)reader->block_count : 0;
+}
+
+const DatalogBinaryIndexEntry* datalog_binary_block(const DatalogBinaryReader* reader, int block) {
+	if (!reader || block < 0 || (uint32_t)block >= reader->block_count) return NULL;
+	return &reader->index[block];
+}
+
+uint64_t datalog_binary_sample_count(const DatalogBinaryReader* reader) {
+	return reader ? reader->sample_count : 0;
+}
+
+int datalog_binary_marker_count(const DatalogBinaryReader* reader) {
+	return reader ? (int)reader->marker_count : 0;
+}
+
+const DatalogBinaryMarker* datalog_binary_marker(const DatalogBinaryReader* reader, int marker) {
+	if (!reader || marker < 0 || (uint32_t)marker >= reader->marker_count) return NULL;
+	return &reader->markers[marker];
+}
+
+bool datalog_binary_recovered(const DatalogBinaryReader* reader) {
+	return reader && reader->recovered;
+}
+
+int datalog_binary_find_block(const DatalogBinaryReader* reader, int64_t time_us) {
+	if (!reader) return 0;
+	uint32_t low = 0;
+	uint32_t high = reader->block_count;
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+		if (reader->index[mid].last_time_us < time_us) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return (int)low;
+}
+
+static bool inflate_column(DatalogBinaryReader* reader, uint64_t offset, uint32_t size, void* out, size_t out_size) {
+	if (size > reader->scratch_size) {
+		Bytef* grown = realloc(reader->scratch, size);
+		if (!grown) return false;
+		reader->scratch = grown;
+		reader->scratch_size = size;
+	}
+	if (!read_at(reader->fd, reader->scratch, size, offset)) return false;
+	uLongf length = (uLongf)out_size;
+	return uncompress(out, &length, reader->scratch, size) == Z_OK && length == out_size;
+}
+
+int datalog_binary_read_block(DatalogBinaryReader* reader, int block,
+                              const int* channels, int channel_count,
+                              int64_t* timestamps, float* values) {
+	const DatalogBinaryIndexEntry* entry = datalog_binary_block(reader, block);
+	if (!entry || channel_count < 0 || (channel_count > 0 && (!channels || !values))) return -1;
+
+	uint32_t columns = reader->header.channel_count + 1;
+	DatalogBinaryBlockHeader header;
+	if (!read_at(reader->fd, &header, sizeof(header), entry->offset)) return -1;
+	if (header.magic != DATALOG_BINARY_BLOCK_MAGIC || header.sample_count != entry->sample_count) return -1;
+	if (!read_at(reader->fd, reader->sizes, columns * sizeof(uint32_t), entry->offset + sizeof(header))) return -1;
+
+	uint32_t count = header.sample_count;
+	uint64_t payload = entry->offset + sizeof(header) + columns * sizeof(uint32_t);
+
+	if (timestamps) {
+		if (!inflate_column(reader, payload, reader->sizes[0], timestamps, count * sizeof(int64_t))) return -1;
+		for (uint32_t i = 1; i < count; i++) {
+			timestamps[i] += timestamps[i - 1];
+		}
+	}
+
+	for (int k = 0; k < channel_count; k++) {
+		int channel = channels[k];
+		if (channel < 0 || (uint32_t)channel >= reader->header.channel_count) return -1;
+		uint64_t offset = payload;
+		for (int c = 0; c <= channel; c++) offset += reader->sizes[c];
+		if (!inflate_column(reader, offset, reader->sizes[channel + 1], values + (size_t)k * count, count * sizeof(float))) {
+			return -1;
+		}
+	}
+	return (int)count;
+}
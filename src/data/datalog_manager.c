@@ -4,22 +4,53 @@
  * This establishes the foundation for professional data logging:
  * - Central configuration & lifecycle
  * - Session start/stop
- * - Append-only logging API (CSV/JSON/Binary to be implemented)
+ * - Append-only logging API (CSV, columnar binary and MegaLogViewer MLG;
+ *   JSON to be implemented)
+ *
+ * Samples are formatted on the calling thread and handed to a datalog_writer
+ * thread, so a slow disk never stalls acquisition. With auto_rotate, CSV
+ * sessions go to datalog_segment files that roll over by size or age and
+ * can be cut back to their last good block after a power cut.
  */
 
 #include "../../include/data/datalog_manager.h"
+#include "../../include/data/datalog_binary.h"
+#include "../../include/data/datalog_mlg.h"
+#include "../../include/data/datalog_segment.h"
+#include "../../include/data/datalog_writer.h"
 #include "../../include/utils/config.h"
 #include "../../include/megatunix_redux.h"
 
+#include <fcntl.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 typedef struct {
 	DatalogSettings settings;
-	FILE* file;
+	int fd;                         // Text sessions
+	DatalogSegmenter* segments;     // Text sessions with auto_rotate
+	DatalogWriter* writer;
+	char* line;                     // Text record being formatted
+	size_t line_used;
+	size_t line_size;
 	bool active;
 	char current_file_path[512];
+	char session[128];
+
+	// Binary and MLG sessions: channel set is fixed once the file exists
+	DatalogBinaryWriter* binary;
+	MlgEncoder* mlg;
+	int64_t session_start_us;       // MLG time field is relative to this
+	DatalogBinaryChannel* channels;
+	MlgField* fields;               // MLG raw types and scaling, NULL for F32
+	int channel_count;
+	bool channels_configured;       // From datalog_manager_set_channels
+	int* key_map;                   // Last key position -> channel
+	float* row;                     // Last value of every channel
 } DatalogState;
 
 static DatalogState g_datalog = {0};
@@ -32,21 +63,102 @@ static void build_default_settings(DatalogSettings* s) {
 	s->interval_ms = 100;
 	s->include_timestamps = true;
 	s->max_file_size_mb = 256;
+	s->sync_interval_ms = DATALOG_WRITER_SYNC_MS;
+	s->auto_rotate = true;
+	s->max_segment_seconds = 0;
 }
 
 bool datalog_manager_init(void) {
 	if (g_datalog.active) return true;
 	build_default_settings(&g_datalog.settings);
-	g_datalog.file = NULL;
+	g_datalog.fd = -1;
+	g_datalog.writer = NULL;
 	g_datalog.active = false;
 	g_datalog.current_file_path[0] = '\0';
 	return true;
 }
 
+static void clear_channels(void) {
+	free(g_datalog.channels);
+	free(g_datalog.fields);
+	g_datalog.fields = NULL;
+	free(g_datalog.key_map);
+	free(g_datalog.row);
+	g_datalog.channels = NULL;
+	g_datalog.key_map = NULL;
+	g_datalog.row = NULL;
+	g_datalog.channel_count = 0;
+}
+
 void datalog_manager_shutdown(void) {
 	if (g_datalog.active) {
 		datalog_manager_stop_session();
 	}
+	clear_channels();
+	g_datalog.channels_configured = false;
+	free(g_datalog.line);
+	g_datalog.line = NULL;
+	g_datalog.line_size = 0;
+}
+
+static bool define_channels(const char** names, const char** units, size_t count) {
+	if (!names || count == 0 || count > DATALOG_BINARY_MAX_CHANNELS) return false;
+	clear_channels();
+	g_datalog.channels = calloc(count, sizeof(DatalogBinaryChannel));
+	g_datalog.key_map = malloc(count * sizeof(int));
+	g_datalog.row = calloc(count, sizeof(float));
+	if (!g_datalog.channels || !g_datalog.key_map || !g_datalog.row) {
+		clear_channels();
+		return false;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		snprintf(g_datalog.channels[i].name, sizeof(g_datalog.channels[i].name), "%s", names[i] ? names[i] : "");
+		snprintf(g_datalog.channels[i].unit, sizeof(g_datalog.channels[i].unit), "%s", units && units[i] ? units[i] : "");
+		g_datalog.key_map[i] = (int)i;
+	}
+	g_datalog.channel_count = (int)count;
+	return true;
+}
+
+static bool is_row_format(void) {
+	return g_datalog.settings.format == DATALOG_FORMAT_BINARY || g_datalog.settings.format == DATALOG_FORMAT_MLG;
+}
+
+// True once a binary or MLG file exists and its column set is frozen
+static bool row_file_open(void) {
+	return g_datalog.binary || g_datalog.mlg;
+}
+
+bool datalog_manager_set_channels(const char** names, const char** units, size_t count) {
+	// A running binary file cannot change its column set
+	if (row_file_open()) return false;
+	g_datalog.channels_configured = define_channels(names, units, count);
+	return g_datalog.channels_configured;
+}
+
+bool datalog_manager_set_ini_channels(const INIField* channels, size_t count) {
+	if (row_file_open() || !channels || count == 0 || count > DATALOG_BINARY_MAX_CHANNELS) return false;
+	const char** names = malloc(count * sizeof(char*));
+	const char** units = malloc(count * sizeof(char*));
+	MlgField* fields = malloc(count * sizeof(MlgField));
+	bool ok = names && units && fields;
+	for (size_t i = 0; ok && i < count; ++i) {
+		names[i] = channels[i].name;
+		units[i] = channels[i].units;
+		if (!mlg_field_from_ini(&fields[i], &channels[i])) {
+			mlg_field_init(&fields[i], channels[i].name, channels[i].units, MLG_TYPE_F32, 1.0f, 0.0f, channels[i].digits);
+		}
+	}
+	ok = ok && define_channels(names, units, count);
+	free(names);
+	free(units);
+	if (!ok) {
+		free(fields);
+		return false;
+	}
+	g_datalog.fields = fields;
+	g_datalog.channels_configured = true;
+	return true;
 }
 
 void datalog_manager_set_settings(const DatalogSettings* settings) {
@@ -59,31 +171,118 @@ void datalog_manager_get_settings(DatalogSettings* out_settings) {
 	*out_settings = g_datalog.settings;
 }
 
-static void build_timestamped_filename(char* out, size_t out_size, const char* dir, const char* base, const char* ext) {
+static void build_timestamped_base(char* out, size_t out_size, const char* base) {
 	char ts[32];
 	time_t now = time(NULL);
 	struct tm tm_now;
 	localtime_r(&now, &tm_now);
 	strftime(ts, sizeof(ts), "%Y%m%d_%H%M%S", &tm_now);
-	snprintf(out, out_size, "%s/%s_%s.%s", dir, base, ts, ext);
+	snprintf(out, out_size, "%s_%s", base, ts);
+}
+
+static DatalogWriter* start_writer(int fd, DatalogBinaryWriter* binary) {
+	DatalogWriterConfig config = {0};
+	config.sync_interval_ms = g_datalog.settings.sync_interval_ms > 0 ? (uint32_t)g_datalog.settings.sync_interval_ms : 0;
+	if (g_datalog.segments) {
+		config.sink = datalog_segment_sink;
+		config.sync = datalog_segment_sink_sync;
+		config.sink_data = g_datalog.segments;
+	}
+	return datalog_writer_start(fd, binary, &config);
+}
+
+// CSV with auto_rotate: the writer thread feeds a segmenter instead of one file
+static bool open_segments(const char* base) {
+	DatalogSegmentConfig config = {0};
+	config.directory = g_datalog.settings.output_directory;
+	config.base = base;
+	config.extension = "csv";
+	config.session = g_datalog.session;
+	config.max_bytes = g_datalog.settings.max_file_size_mb > 0 ? (uint64_t)g_datalog.settings.max_file_size_mb << 20 : 0;
+	config.max_seconds = g_datalog.settings.max_segment_seconds > 0 ? (uint32_t)g_datalog.settings.max_segment_seconds : 0;
+	// Every segment starts with the column line so each one loads on its own
+	config.preamble = g_datalog.settings.include_timestamps ? "timestamp_ms\n" : "\n";
+	g_datalog.segments = datalog_segment_open(&config);
+	if (!g_datalog.segments) return false;
+	snprintf(g_datalog.current_file_path, sizeof(g_datalog.current_file_path), "%s", datalog_segment_manifest_path(g_datalog.segments));
+	g_datalog.writer = start_writer(-1, NULL);
+	if (!g_datalog.writer) {
+		datalog_segment_close(g_datalog.segments);
+		g_datalog.segments = NULL;
+		return false;
+	}
+	return true;
+}
+
+static void line_printf(const char* format, ...) {
+	for (;;) {
+		va_list args;
+		va_start(args, format);
+		size_t room = g_datalog.line_size - g_datalog.line_used;
+		int n = vsnprintf(g_datalog.line ? g_datalog.line + g_datalog.line_used : NULL, room, format, args);
+		va_end(args);
+		if (n < 0) return;
+		if ((size_t)n < room) {
+			g_datalog.line_used += (size_t)n;
+			return;
+		}
+		size_t size = g_datalog.line_size ? g_datalog.line_size * 2 : 1024;
+		while (size < g_datalog.line_used + (size_t)n + 1) size *= 2;
+		char* grown = realloc(g_datalog.line, size);
+		if (!grown) return;
+		g_datalog.line = grown;
+		g_datalog.line_size = size;
+	}
+}
+
+static bool line_submit(void) {
+	bool queued = datalog_writer_write(g_datalog.writer, g_datalog.line, g_datalog.line_used);
+	g_datalog.line_used = 0;
+	return queued;
 }
 
 bool datalog_manager_start_session(const char* optional_session_name) {
 	if (g_datalog.active) return true;
 	const char* name = optional_session_name && optional_session_name[0] ? optional_session_name : g_datalog.settings.session_name;
-	const char* ext = (g_datalog.settings.format == DATALOG_FORMAT_JSON) ? "json" : (g_datalog.settings.format == DATALOG_FORMAT_BINARY ? "bin" : "csv");
-	build_timestamped_filename(g_datalog.current_file_path, sizeof(g_datalog.current_file_path), g_datalog.settings.output_directory, name, ext);
+	static const char* extensions[] = { "csv", "json", "bin", "mlg" };
+	const char* ext = extensions[g_datalog.settings.format <= DATALOG_FORMAT_MLG ? g_datalog.settings.format : DATALOG_FORMAT_CSV];
+	char base[192];
+	build_timestamped_base(base, sizeof(base), name);
+	snprintf(g_datalog.current_file_path, sizeof(g_datalog.current_file_path), "%s/%s.%s", g_datalog.settings.output_directory, base, ext);
 
-	g_datalog.file = fopen(g_datalog.current_file_path, "w");
-	if (!g_datalog.file) return false;
+	snprintf(g_datalog.session, sizeof(g_datalog.session), "%s", name);
+	g_datalog.fd = -1;
+
+	if (g_datalog.settings.format == DATALOG_FORMAT_CSV && g_datalog.settings.auto_rotate) {
+		if (!open_segments(base)) return false;
+		g_datalog.active = true;
+		return true;
+	}
+
+	// Binary and MLG files are created once the channel set is known
+	if (is_row_format()) {
+		if (!g_datalog.channels_configured) clear_channels();
+		g_datalog.active = true;
+		return true;
+	}
+
+	g_datalog.fd = open(g_datalog.current_file_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (g_datalog.fd < 0) return false;
+	g_datalog.writer = start_writer(g_datalog.fd, NULL);
+	if (!g_datalog.writer) {
+		close(g_datalog.fd);
+		g_datalog.fd = -1;
+		return false;
+	}
 
 	// Write CSV header as an initial foundation
 	if (g_datalog.settings.format == DATALOG_FORMAT_CSV) {
 		if (g_datalog.settings.include_timestamps) {
-			fprintf(g_datalog.file, "timestamp_ms");
+			line_printf("timestamp_ms");
 		}
 		// Columns will be added on first batch write; keep minimal now
-		fprintf(g_datalog.file, "\n");
+		line_printf("\n");
+		line_submit();
 	}
 
 	g_datalog.active = true;
@@ -92,10 +291,25 @@ bool datalog_manager_start_session(const char* optional_session_name) {
 
 void datalog_manager_stop_session(void) {
 	if (!g_datalog.active) return;
-	if (g_datalog.file) {
-		fclose(g_datalog.file);
-		g_datalog.file = NULL;
+	// Drain the queue before closing what it writes to
+	if (g_datalog.writer) {
+		datalog_writer_stop(g_datalog.writer);
+		g_datalog.writer = NULL;
 	}
+	if (g_datalog.fd >= 0) {
+		close(g_datalog.fd);
+		g_datalog.fd = -1;
+	}
+	if (g_datalog.segments) {
+		datalog_segment_close(g_datalog.segments);
+		g_datalog.segments = NULL;
+	}
+	if (g_datalog.binary) {
+		datalog_binary_close(g_datalog.binary);
+		g_datalog.binary = NULL;
+	}
+	mlg_encoder_free(g_datalog.mlg);
+	g_datalog.mlg = NULL;
 	g_datalog.active = false;
 }
 
@@ -103,40 +317,177 @@ bool datalog_manager_is_active(void) {
 	return g_datalog.active;
 }
 
+bool datalog_manager_get_writer_stats(DatalogWriterStats* out_stats) {
+	if (!out_stats) return false;
+	datalog_writer_get_stats(g_datalog.writer, out_stats);
+	return g_datalog.writer != NULL;
+}
+
+const char* datalog_manager_current_path(void) {
+	return g_datalog.current_file_path[0] ? g_datalog.current_file_path : NULL;
+}
+
+int datalog_manager_recover_session(const char* manifest_path) {
+	return datalog_segment_recover_session(manifest_path);
+}
+
 static long current_time_ms(void) {
 	struct timespec ts;
 	clock_gettime(CLOCK_REALTIME, &ts);
 	return (long)(ts.tv_sec * 1000L + ts.tv_nsec / 1000000L);
 }
 
+static int64_t current_time_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool write_all(int fd, const uint8_t* data, size_t size) {
+	while (size > 0) {
+		ssize_t done = write(fd, data, size);
+		if (done < 0) return false;
+		data += done;
+		size -= (size_t)done;
+	}
+	return true;
+}
+
+static bool open_mlg(void) {
+	MlgField* fields = g_datalog.fields;
+	if (!fields) {
+		// No INI metadata: log engineering values as F32
+		fields = calloc((size_t)g_datalog.channel_count, sizeof(MlgField));
+		if (!fields) return false;
+		for (int c = 0; c < g_datalog.channel_count; ++c) {
+			mlg_field_init(&fields[c], g_datalog.channels[c].name, g_datalog.channels[c].unit, MLG_TYPE_F32, 1.0f, 0.0f, 2);
+		}
+	}
+	char info[192];
+	snprintf(info, sizeof(info), "Logged by MegaTunix Redux, session %s", g_datalog.session);
+	g_datalog.mlg = mlg_encoder_new(2, fields, g_datalog.channel_count, info);
+	if (fields != g_datalog.fields) free(fields);
+	if (!g_datalog.mlg) return false;
+
+	// The header goes straight to disk; only blocks go through the writer thread
+	const uint8_t* header = NULL;
+	size_t header_size = mlg_encoder_header(g_datalog.mlg, &header);
+	g_datalog.fd = open(g_datalog.current_file_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (g_datalog.fd >= 0 && header_size > 0 && write_all(g_datalog.fd, header, header_size)) {
+		g_datalog.writer = start_writer(g_datalog.fd, NULL);
+	}
+	if (!g_datalog.writer) {
+		if (g_datalog.fd >= 0) close(g_datalog.fd);
+		g_datalog.fd = -1;
+		mlg_encoder_free(g_datalog.mlg);
+		g_datalog.mlg = NULL;
+		return false;
+	}
+	g_datalog.session_start_us = current_time_us();
+	return true;
+}
+
+static bool open_row_file(const char** keys, size_t count) {
+	if (!g_datalog.channels && !define_channels(keys, NULL, count)) return false;
+	if (g_datalog.settings.format == DATALOG_FORMAT_MLG) return open_mlg();
+	g_datalog.binary = datalog_binary_create(g_datalog.current_file_path, g_datalog.session,
+	                                         g_datalog.channels, g_datalog.channel_count,
+	                                         DATALOG_BINARY_BLOCK_SAMPLES);
+	if (!g_datalog.binary) return false;
+	g_datalog.writer = start_writer(-1, g_datalog.binary);
+	if (!g_datalog.writer) {
+		datalog_binary_close(g_datalog.binary);
+		g_datalog.binary = NULL;
+		return false;
+	}
+	return true;
+}
+
+static int find_channel(const char* key, size_t position) {
+	// Callers normally pass the same keys in the same order every sample
+	if (position < (size_t)g_datalog.channel_count) {
+		int channel = g_datalog.key_map[position];
+		if (channel >= 0 && strcmp(g_datalog.channels[channel].name, key) == 0) return channel;
+	}
+	for (int c = 0; c < g_datalog.channel_count; ++c) {
+		if (strcmp(g_datalog.channels[c].name, key) == 0) {
+			if (position < (size_t)g_datalog.channel_count) g_datalog.key_map[position] = c;
+			return c;
+		}
+	}
+	return -1;
+}
+
+static bool log_row(const char** keys, const double* values, size_t count) {
+	if (!row_file_open() && !open_row_file(keys, count)) return false;
+	// Channels missing from this call keep their last value; unknown keys are dropped
+	for (size_t i = 0; i < count; ++i) {
+		if (!keys[i]) continue;
+		int channel = find_channel(keys[i], i);
+		if (channel >= 0) g_datalog.row[channel] = (float)values[i];
+	}
+	if (g_datalog.mlg) {
+		const uint8_t* block = NULL;
+		size_t size = mlg_encoder_row(g_datalog.mlg, current_time_us() - g_datalog.session_start_us, g_datalog.row, &block);
+		return size > 0 && datalog_writer_write(g_datalog.writer, block, size);
+	}
+	return datalog_writer_row(g_datalog.writer, current_time_us(), g_datalog.row, (uint32_t)g_datalog.channel_count);
+}
+
 bool datalog_manager_log_scalar(const char* key, double value) {
-	if (!g_datalog.active || !g_datalog.file || !key) return false;
+	if (!g_datalog.active || !key) return false;
+	// Binary rows are whole samples; a lone key updates one channel of the row
+	if (is_row_format()) {
+		return (row_file_open() || g_datalog.channels_configured) && log_row(&key, &value, 1);
+	}
+	if (!g_datalog.writer) return false;
 	if (g_datalog.settings.format == DATALOG_FORMAT_CSV) {
 		if (g_datalog.settings.include_timestamps) {
-			fprintf(g_datalog.file, "%ld,", current_time_ms());
+			line_printf("%ld,", current_time_ms());
 		}
-		fprintf(g_datalog.file, "%s=%.6f\n", key, value);
-		fflush(g_datalog.file);
-		return true;
+		line_printf("%s=%.6f\n", key, value);
+		return line_submit();
 	}
-	// JSON/Binary formats to be implemented
+	// JSON format to be implemented
 	return false;
 }
 
 bool datalog_manager_log_multiple(const char** keys, const double* values, size_t count) {
-	if (!g_datalog.active || !g_datalog.file || !keys || !values || count == 0) return false;
+	if (!g_datalog.active || !keys || !values || count == 0) return false;
+	if (is_row_format()) {
+		return log_row(keys, values, count);
+	}
+	if (!g_datalog.writer) return false;
 	if (g_datalog.settings.format == DATALOG_FORMAT_CSV) {
 		if (g_datalog.settings.include_timestamps) {
-			fprintf(g_datalog.file, "%ld", current_time_ms());
+			line_printf("%ld", current_time_ms());
 		}
 		for (size_t i = 0; i < count; ++i) {
-			fprintf(g_datalog.file, "%s%s=%.6f", g_datalog.settings.include_timestamps || i > 0 ? "," : "", keys[i], values[i]);
+			line_printf("%s%s=%.6f", g_datalog.settings.include_timestamps || i > 0 ? "," : "", keys[i], values[i]);
 		}
-		fprintf(g_datalog.file, "\n");
-		fflush(g_datalog.file);
-		return true;
+		line_printf("\n");
+		return line_submit();
 	}
 	return false;
 }
 
-
+bool datalog_manager_log_marker(const char* label) {
+	if (!g_datalog.active || !label) return false;
+	if (g_datalog.mlg) {
+		const uint8_t* block = NULL;
+		size_t size = mlg_encoder_marker(g_datalog.mlg, current_time_us() - g_datalog.session_start_us, label, &block);
+		return size > 0 && datalog_writer_write(g_datalog.writer, block, size);
+	}
+	if (is_row_format()) {
+		return g_datalog.writer && datalog_writer_marker(g_datalog.writer, current_time_us(), label);
+	}
+	if (!g_datalog.writer) return false;
+	if (g_datalog.settings.format == DATALOG_FORMAT_CSV) {
+		if (g_datalog.settings.include_timestamps) {
+			line_printf("%ld,", current_time_ms());
+		}
+		line_printf("marker=\"%s\"\n", label);
+		return line_submit();
+	}
+	return false;
+}
@@ -0,0 +1,469 @@
+/*
+ * MegaLogViewer Log Format - MegaTunix Redux
+ */
+
+#include "../../include/data/datalog_mlg.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MLG_HEADER_V1 22
+#define MLG_HEADER_V2 24
+#define MLG_FIELD_V1 55
+#define MLG_FIELD_V2 89
+#define MLG_BLOCK_HEADER 4
+#define MLG_TICK_US 10
+
+static const uint8_t type_sizes[] = { 1, 1, 2, 2, 4, 4, 8, 4 };
+
+struct MlgEncoder {
+	int version;
+	MlgField* fields;               // Time first
+	int count;
+	char* info;
+	uint16_t record_length;
+	uint8_t counter;
+	uint8_t* buffer;
+	size_t buffer_size;
+};
+
+struct MlgReader {
+	FILE* file;
+	int version;
+	uint32_t timestamp;
+	char* info;
+	MlgField* fields;
+	uint16_t* offsets;
+	int count;
+	uint16_t record_length;
+	uint8_t* block;
+	bool started;
+	uint16_t last_tick;
+	int64_t time_us;
+	uint64_t crc_errors;
+};
+
+static void put_u16(uint8_t* out, uint16_t value) {
+	out[0] = (uint8_t)(value >> 8);
+	out[1] = (uint8_t)value;
+}
+
+static void put_u32(uint8_t* out, uint32_t value) {
+	out[0] = (uint8_t)(value >> 24);
+	out[1] = (uint8_t)(value >> 16);
+	out[2] = (uint8_t)(value >> 8);
+	out[3] = (uint8_t)value;
+}
+
+static uint16_t get_u16(const uint8_t* in) {
+	return (uint16_t)(in[0] << 8 | in[1]);
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+	return (uint32_t)in[0] << 24 | (uint32_t)in[1] << 16 | (uint32_t)in[2] << 8 | in[3];
+}
+
+static void put_f32(uint8_t* out, float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	put_u32(out, bits);
+}
+
+static float get_f32(const uint8_t* in) {
+	uint32_t bits = get_u32(in);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void mlg_field_init(MlgField* field, const char* name, const char* units,
+                    MlgType type, float scale, float transform, int digits) {
+	memset(field, 0, sizeof(*field));
+	// MLG names and units are shorter than INI ones; truncate quietly
+	snprintf(field->name, sizeof(field->name), "%.*s", (int)sizeof(field->name) - 1, name ? name : "");
+	snprintf(field->units, sizeof(field->units), "%.*s", (int)sizeof(field->units) - 1, units ? units : "");
+	field->type = (uint8_t)type;
+	field->scale = scale != 0.0f ? scale : 1.0f;
+	field->transform = transform;
+	field->digits = (int8_t)digits;
+}
+
+bool mlg_field_from_ini(MlgField* field, const INIField* ini) {
+	static const struct {
+		const char* name;
+		MlgType type;
+	} types[] = {
+		{ "U08", MLG_TYPE_U08 }, { "S08", MLG_TYPE_S08 }, { "U16", MLG_TYPE_U16 }, { "S16", MLG_TYPE_S16 },
+		{ "U32", MLG_TYPE_U32 }, { "S32", MLG_TYPE_S32 }, { "S64", MLG_TYPE_S64 }, { "F32", MLG_TYPE_F32 },
+	};
+	if (!field || !ini) return false;
+	for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+		if (strcmp(ini->type, types[i].name) == 0) {
+			// Digits follow the scale: 0.1 -> 1, 0.01 -> 2
+			int digits = ini->digits;
+			if (digits <= 0 && ini->scale > 0.0f && ini->scale < 1.0f) {
+				digits = (int)ceilf(-log10f(ini->scale) - 1e-4f);
+			}
+			mlg_field_init(field, ini->name, ini->units, types[i].type, ini->scale, ini->translate, digits);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Encoder
+
+static bool reserve(MlgEncoder* encoder, size_t size) {
+	if (size <= encoder->buffer_size) return true;
+	uint8_t* grown = realloc(encoder->buffer, size);
+	if (!grown) return false;
+	encoder->buffer = grown;
+	encoder->buffer_size = size;
+	return true;
+}
+
+MlgEncoder* mlg_encoder_new(int version, const MlgField* fields, int count, const char* info) {
+	if ((version != 1 && version != 2) || count < 0 || count >= MLG_MAX_FIELDS || (count > 0 && !fields)) return NULL;
+
+	MlgEncoder* encoder = calloc(1, sizeof(MlgEncoder));
+	if (!encoder) return NULL;
+	encoder->version = version;
+	encoder->count = count + 1;
+	encoder->fields = calloc((size_t)encoder->count, sizeof(MlgField));
+	encoder->info = strdup(info ? info : "");
+	if (!encoder->fields || !encoder->info) {
+		mlg_encoder_free(encoder);
+		return NULL;
+	}
+
+	mlg_field_init(&encoder->fields[0], "Time", "s", MLG_TYPE_U32, 0.001f, 0.0f, 3);
+	uint32_t length = type_sizes[MLG_TYPE_U32];
+	for (int i = 0; i < count; i++) {
+		encoder->fields[i + 1] = fields[i];
+		if (encoder->fields[i + 1].type > MLG_TYPE_F32) encoder->fields[i + 1].type = MLG_TYPE_F32;
+		if (encoder->fields[i + 1].scale == 0.0f) encoder->fields[i + 1].scale = 1.0f;
+		length += type_sizes[encoder->fields[i + 1].type];
+	}
+	if (length > UINT16_MAX) {
+		mlg_encoder_free(encoder);
+		return NULL;
+	}
+	encoder->record_length = (uint16_t)length;
+	return encoder;
+}
+
+void mlg_encoder_free(MlgEncoder* encoder) {
+	if (!encoder) return;
+	free(encoder->fields);
+	free(encoder->info);
+	free(encoder->buffer);
+	free(encoder);
+}
+
+size_t mlg_encoder_header(MlgEncoder* encoder, const uint8_t** out) {
+	if (!encoder || !out) return 0;
+	size_t header = encoder->version == 1 ? MLG_HEADER_V1 : MLG_HEADER_V2;
+	size_t field_size = encoder->version == 1 ? MLG_FIELD_V1 : MLG_FIELD_V2;
+	size_t info_start = header + field_size * (size_t)encoder->count;
+	size_t data_start = info_start + strlen(encoder->info) + 1;
+	if (!reserve(encoder, data_start)) return 0;
+
+	uint8_t* p = encoder->buffer;
+	memset(p, 0, data_start);
+	memcpy(p, "MLVLG", 6);
+	put_u16(p + 6, (uint16_t)encoder->version);
+	put_u32(p + 8, (uint32_t)time(NULL));
+	p += 12;
+	if (encoder->version == 1) {
+		put_u16(p, (uint16_t)info_start);
+		p += 2;
+	} else {
+		put_u32(p, (uint32_t)info_start);
+		p += 4;
+	}
+	put_u32(p, (uint32_t)data_start);
+	put_u16(p + 4, encoder->record_length);
+	put_u16(p + 6, (uint16_t)encoder->count);
+	p += 8;
+
+	for (int i = 0; i < encoder->count; i++) {
+		const MlgField* field = &encoder->fields[i];
+		p[0] = field->type;
+		memcpy(p + 1, field->name, MLG_FIELD_NAME_LEN - 1);
+		memcpy(p + 35, field->units, MLG_FIELD_UNITS_LEN - 1);
+		p[45] = field->display_style;
+		put_f32(p + 46, field->scale);
+		put_f32(p + 50, field->transform);
+		p[54] = (uint8_t)field->digits;
+		if (encoder->version == 2) memcpy(p + 55, field->category, MLG_FIELD_NAME_LEN - 1);
+		p += field_size;
+	}
+	strcpy((char*)p, encoder->info);
+
+	*out = encoder->buffer;
+	return data_start;
+}
+
+static uint8_t* put_raw(uint8_t* p, uint8_t type, double raw) {
+	if (type == MLG_TYPE_F32) {
+		put_f32(p, (float)raw);
+		return p + 4;
+	}
+	static const double limits[][2] = {
+		{ 0, UINT8_MAX }, { INT8_MIN, INT8_MAX }, { 0, UINT16_MAX }, { INT16_MIN, INT16_MAX },
+		{ 0, UINT32_MAX }, { INT32_MIN, INT32_MAX }, { -9.2e18, 9.2e18 },
+	};
+	raw = nearbyint(raw);
+	if (!(raw >= limits[type][0])) raw = limits[type][0];   // Also catches NaN
+	if (raw > limits[type][1]) raw = limits[type][1];
+	int64_t value = (int64_t)raw;
+	int size = type_sizes[type];
+	for (int i = size - 1; i >= 0; i--) {
+		p[i] = (uint8_t)value;
+		value >>= 8;
+	}
+	return p + size;
+}
+
+static uint8_t* put_block_header(MlgEncoder* encoder, uint8_t kind, int64_t time_us) {
+	uint8_t* p = encoder->buffer;
+	p[0] = kind;
+	p[1] = encoder->counter++;
+	put_u16(p + 2, (uint16_t)(time_us / MLG_TICK_US));
+	return p + MLG_BLOCK_HEADER;
+}
+
+size_t mlg_encoder_row(MlgEncoder* encoder, int64_t time_us, const float* values, const uint8_t** out) {
+	if (!encoder || !out || (!values && encoder->count > 1)) return 0;
+	size_t size = MLG_BLOCK_HEADER + encoder->record_length + 1;
+	if (!reserve(encoder, size)) return 0;
+
+	uint8_t* record = put_block_header(encoder, 0, time_us);
+	uint8_t* p = put_raw(record, MLG_TYPE_U32, (double)time_us / 1000.0);
+	for (int i = 1; i < encoder->count; i++) {
+		const MlgField* field = &encoder->fields[i];
+		p = put_raw(p, field->type, (double)values[i - 1] / field->scale - field->transform);
+	}
+	uint8_t crc = 0;
+	for (uint8_t* q = record; q < p; q++) crc += *q;
+	*p = crc;
+
+	*out = encoder->buffer;
+	return size;
+}
+
+size_t mlg_encoder_marker(MlgEncoder* encoder, int64_t time_us, const char* message, const uint8_t** out) {
+	if (!encoder || !out || !message) return 0;
+	size_t size = MLG_BLOCK_HEADER + MLG_MARKER_LEN;
+	if (!reserve(encoder, size)) return 0;
+
+	uint8_t* p = put_block_header(encoder, 1, time_us);
+	memset(p, 0, MLG_MARKER_LEN);
+	size_t len = strlen(message);
+	memcpy(p, message, len < MLG_MARKER_LEN - 1 ? len : MLG_MARKER_LEN - 1);
+
+	*out = encoder->buffer;
+	return size;
+}
+
+// Reader
+
+MlgReader* mlg_reader_open(const char* path) {
+	if (!path) return NULL;
+	MlgReader* reader = calloc(1, sizeof(MlgReader));
+	if (!reader) return NULL;
+	reader->file = fopen(path, "rb");
+	if (!reader->file) {
+		free(reader);
+		return NULL;
+	}
+	setvbuf(reader->file, NULL, _IOFBF, 1 << 20);
+
+	uint8_t header[MLG_HEADER_V2];
+	if (fread(header, 1, MLG_HEADER_V1, reader->file) != MLG_HEADER_V1 || memcmp(header, "MLVLG", 6) != 0) {
+		mlg_reader_close(reader);
+		return NULL;
+	}
+	reader->version = get_u16(header + 6);
+	reader->timestamp = get_u32(header + 8);
+	uint32_t info_start;
+	const uint8_t* p = header + 12;
+	if (reader->version == 1) {
+		info_start = get_u16(p);
+		p += 2;
+	} else if (reader->version == 2 && fread(header + MLG_HEADER_V1, 1, 2, reader->file) == 2) {
+		info_start = get_u32(p);
+		p += 4;
+	} else {
+		mlg_reader_close(reader);
+		return NULL;
+	}
+	uint32_t data_start = get_u32(p);
+	reader->record_length = get_u16(p + 4);
+	reader->count = get_u16(p + 6);
+
+	size_t header_size = reader->version == 1 ? MLG_HEADER_V1 : MLG_HEADER_V2;
+	size_t field_size = reader->version == 1 ? MLG_FIELD_V1 : MLG_FIELD_V2;
+	uint8_t* raw_fields = malloc(field_size * (size_t)(reader->count ? reader->count : 1));
+	reader->fields = calloc((size_t)(reader->count ? reader->count : 1), sizeof(MlgField));
+	reader->offsets = calloc((size_t)(reader->count ? reader->count : 1), sizeof(uint16_t));
+	reader->block = malloc(MLG_BLOCK_HEADER + (size_t)reader->record_length + 1 + MLG_MARKER_LEN);
+	if (!raw_fields || !reader->fields || !reader->offsets || !reader->block
+	    || fread(raw_fields, field_size, (size_t)reader->count, reader->file) != (size_t)reader->count) {
+		free(raw_fields);
+		mlg_reader_close(reader);
+		return NULL;
+	}
+
+	uint32_t length = 0;
+	bool valid = true;
+	for (int i = 0; i < reader->count; i++) {
+		const uint8_t* f = raw_fields + (size_t)i * field_size;
+		MlgField* field = &reader->fields[i];
+		field->type = f[0];
+		memcpy(field->name, f + 1, MLG_FIELD_NAME_LEN - 1);
+		memcpy(field->units, f + 35, MLG_FIELD_UNITS_LEN - 1);
+		field->display_style = f[45];
+		field->scale = get_f32(f + 46);
+		field->transform = get_f32(f + 50);
+		field->digits = (int8_t)f[54];
+		if (reader->version == 2) memcpy(field->category, f + 55, MLG_FIELD_NAME_LEN - 1);
+		// Bit-field types (10 and up) need v2 bit descriptors this reader does not parse
+		if (field->type > MLG_TYPE_F32) valid = false;
+		else {
+			reader->offsets[i] = (uint16_t)length;
+			length += type_sizes[field->type];
+		}
+	}
+	free(raw_fields);
+	if (!valid || length != reader->record_length || data_start < header_size + field_size * (size_t)reader->count) {
+		mlg_reader_close(reader);
+		return NULL;
+	}
+
+	// Info text sits between the field table and the data
+	if (info_start && info_start < data_start) {
+		size_t info_len = data_start - info_start;
+		reader->info = calloc(info_len + 1, 1);
+		if (reader->info && fseek(reader->file, (long)info_start, SEEK_SET) == 0) {
+			if (fread(reader->info, 1, info_len, reader->file) != info_len) reader->info[0] = '\0';
+		}
+	}
+	if (fseek(reader->file, (long)data_start, SEEK_SET) != 0) {
+		mlg_reader_close(reader);
+		return NULL;
+	}
+	return reader;
+}
+
+void mlg_reader_close(MlgReader* reader) {
+	if (!reader) return;
+	if (reader->file) fclose(reader->file);
+	free(reader->info);
+	free(reader->fields);
+	free(reader->offsets);
+	free(reader->block);
+	free(reader);
+}
+
+int mlg_reader_version(const MlgReader* reader) {
+	return reader ? reader->version : 0;
+}
+
+uint32_t mlg_reader_timestamp(const MlgReader* reader) {
+	return reader ? reader->timestamp : 0;
+}
+
+const char* mlg_reader_info(const MlgReader* reader) {
+	return reader && reader->info ? reader->info : "";
+}
+
+int mlg_reader_field_count(const MlgReader* reader) {
+	return reader ? reader->count : 0;
+}
+
+const MlgField* mlg_reader_fields(const MlgReader* reader) {
+	return reader ? reader->fields : NULL;
+}
+
+int mlg_reader_find_field(const MlgReader* reader, const char* name) {
+	if (!reader || !name) return -1;
+	for (int i = 0; i < reader->count; i++) {
+		if (strcmp(reader->fields[i].name, name) == 0) return i;
+	}
+	return -1;
+}
+
+uint64_t mlg_reader_crc_errors(const MlgReader* reader) {
+	return reader ? reader->crc_errors : 0;
+}
+
+static double get_raw(const uint8_t* p, uint8_t type) {
+	switch (type) {
+	case MLG_TYPE_U08: return p[0];
+	case MLG_TYPE_S08: return (int8_t)p[0];
+	case MLG_TYPE_U16: return get_u16(p);
+	case MLG_TYPE_S16: return (int16_t)get_u16(p);
+	case MLG_TYPE_U32: return get_u32(p);
+	case MLG_TYPE_S32: return (int32_t)get_u32(p);
+	case MLG_TYPE_S64: return (double)(int64_t)((uint64_t)get_u32(p) << 32 | get_u32(p + 4));
+	default: return get_f32(p);
+	}
+}
+
+static void advance_time(MlgReader* reader, uint16_t tick) {
+	// Ticks wrap every 655 ms; gaps longer than that cannot be recovered
+	if (reader->started) {
+		reader->time_us += (int64_t)(uint16_t)(tick - reader->last_tick) * MLG_TICK_US;
+	}
+	reader->started = true;
+	reader->last_tick = tick;
+}
+
+MlgRecordKind mlg_reader_next(MlgReader* reader, int64_t* time_us, float* values, char* message) {
+	if (!reader) return MLG_RECORD_ERROR;
+	uint8_t* block = reader->block;
+
+	for (;;) {
+		size_t got = fread(block, 1, MLG_BLOCK_HEADER, reader->file);
+		if (got == 0) return MLG_RECORD_END;
+		if (got != MLG_BLOCK_HEADER) return MLG_RECORD_ERROR;
+
+		if (block[0] == 1) {
+			uint8_t* text = block + MLG_BLOCK_HEADER;
+			if (fread(text, 1, MLG_MARKER_LEN, reader->file) != MLG_MARKER_LEN) return MLG_RECORD_ERROR;
+			advance_time(reader, get_u16(block + 2));
+			if (time_us) *time_us = reader->time_us;
+			if (message) {
+				memcpy(message, text, MLG_MARKER_LEN);
+				message[MLG_MARKER_LEN] = '\0';
+			}
+			return MLG_RECORD_MARKER;
+		}
+		if (block[0] != 0) return MLG_RECORD_ERROR;
+
+		uint8_t* record = block + MLG_BLOCK_HEADER;
+		if (fread(record, 1, (size_t)reader->record_length + 1, reader->file) != (size_t)reader->record_length + 1) {
+			return MLG_RECORD_ERROR;
+		}
+		uint8_t crc = 0;
+		for (uint16_t i = 0; i < reader->record_length; i++) crc += record[i];
+		if (crc != record[reader->record_length]) {
+			reader->crc_errors++;
+			continue;
+		}
+
+		advance_time(reader, get_u16(block + 2));
+		if (time_us) *time_us = reader->time_us;
+		if (values) {
+			for (int i = 0; i < reader->count; i++) {
+				const MlgField* field = &reader->fields[i];
+				values[i] = (float)((get_raw(record + reader->offsets[i], field->type) + field->transform) * field->scale);
+			}
+		}
+		return MLG_RECORD_DATA;
+	}
+}
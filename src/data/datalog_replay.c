@@ -0,0 +1,753 @@
+/*
+ * Datalog Replay - MegaTunix Redux
+ *
+ * Loads a log into row-major floats over the ECU channels it has, then a
+ * thread publishes the rows into an ECUContext on the recorded schedule.
+ */
+
+#include "../../include/data/datalog_replay.h"
+#include "../../include/data/datalog_binary.h"
+#include "../../include/data/datalog_mlg.h"
+#include "../../include/ecu/ecu_channels.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#define CSV_MAX_COLUMNS 256
+
+struct DatalogReplay {
+	int64_t* time_us;               // Per row, from 0 and never going back
+	float* values;                  // rows x channel_count, NaN = hold the last value
+	uint64_t rows;
+	uint64_t capacity;
+	int channels[ECU_CHANNEL_COUNT];
+	int channel_count;
+	bool present[ECU_CHANNEL_COUNT];// While loading, rows are ECU_CHANNEL_COUNT wide
+	int64_t first_time_us;
+
+	ECUContext* ctx;
+	DatalogReplayConfig config;
+	pthread_t thread;
+	bool threaded;
+	pthread_mutex_t lock;           // Pacing waits, stop and speed changes
+	pthread_cond_t wake;
+	int stopping;
+	double speed;                   // Under lock
+	uint32_t speed_generation;      // Bumped by every speed change
+
+	// Statistics; written by the replay thread, read by anyone
+	int running;
+	int finished;
+	uint64_t position;
+	uint64_t samples;
+	uint64_t start_us;
+	uint64_t end_us;
+	int64_t log_us;
+	uint64_t paced_samples;
+	uint64_t late_total_us;
+	uint32_t late_max_us;
+	uint64_t publish_total_ns;
+	uint32_t publish_max_us;
+	uint64_t last_timestamp_us;     // Listener timestamp of the latest sample
+};
+
+// Data bridge side; the plugin callbacks have no user data
+static pthread_mutex_t g_plugin_lock = PTHREAD_MUTEX_INITIALIZER;
+static DatalogReplay* g_plugin_replay = NULL;
+static ECUSampleCallback g_sample_callback = NULL;
+static void* g_sample_user_data = NULL;
+
+static uint64_t monotonic_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t monotonic_us(void) {
+	return monotonic_ns() / 1000;
+}
+
+static void atomic_max_u32(uint32_t* target, uint32_t value) {
+	uint32_t seen = __atomic_load_n(target, __ATOMIC_RELAXED);
+	while (value > seen && !__atomic_compare_exchange_n(target, &seen, value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Loading
+
+// row holds ECU_CHANNEL_COUNT values, NaN where the log has none
+static bool add_row(DatalogReplay* replay, int64_t time_us, const float* row) {
+	if (replay->rows == replay->capacity) {
+		uint64_t capacity = replay->capacity ? replay->capacity * 2 : 4096;
+		int64_t* times = realloc(replay->time_us, capacity * sizeof(int64_t));
+		if (!times) return false;
+		replay->time_us = times;
+		float* values = realloc(replay->values, capacity * ECU_CHANNEL_COUNT * sizeof(float));
+		if (!values) return false;
+		replay->values = values;
+		replay->capacity = capacity;
+	}
+
+	if (replay->rows == 0) replay->first_time_us = time_us;
+	time_us -= replay->first_time_us;
+	// Clock steps in the log must not stall or rush the schedule
+	if (replay->rows > 0 && time_us < replay->time_us[replay->rows - 1]) {
+		time_us = replay->time_us[replay->rows - 1];
+	}
+	replay->time_us[replay->rows] = time_us;
+	memcpy(replay->values + replay->rows * ECU_CHANNEL_COUNT, row, ECU_CHANNEL_COUNT * sizeof(float));
+	for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+		if (!isnan(row[i])) replay->present[i] = true;
+	}
+	replay->rows++;
+	return true;
+}
+
+// Keep only the channels the log has values for
+static void compact(DatalogReplay* replay) {
+	replay->channel_count = 0;
+	for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+		if (replay->present[i]) replay->channels[replay->channel_count++] = i;
+	}
+	for (uint64_t row = 0; row < replay->rows; row++) {
+		const float* from = replay->values + row * ECU_CHANNEL_COUNT;
+		float* to = replay->values + row * replay->channel_count;
+		for (int c = 0; c < replay->channel_count; c++) {
+			to[c] = from[replay->channels[c]];
+		}
+	}
+	if (replay->rows > 0 && replay->channel_count > 0) {
+		float* values = realloc(replay->values, replay->rows * replay->channel_count * sizeof(float));
+		if (values) replay->values = values;
+	}
+}
+
+static void clear_row(float* row) {
+	for (int i = 0; i < ECU_CHANNEL_COUNT; i++) row[i] = NAN;
+}
+
+typedef struct {
+	char delimiter;
+	bool have_header;
+	bool first_data;                // Next line may be a units line
+	int column_count;
+	int column_channel[CSV_MAX_COLUMNS];
+	int time_column;
+	double time_scale;              // To microseconds
+	char cached_key[CSV_MAX_COLUMNS][32];   // key=value rows: last key seen per position
+	int cached_channel[CSV_MAX_COLUMNS];
+} CsvState;
+
+static char* trim(char* text) {
+	while (*text == ' ' || *text == '"') text++;
+	size_t len = strlen(text);
+	while (len > 0 && (text[len - 1] == ' ' || text[len - 1] == '"' || text[len - 1] == '\r')) text[--len] = '\0';
+	return text;
+}
+
+static void parse_csv_header(CsvState* state, char* line) {
+	state->delimiter = strchr(line, '\t') ? '\t' : ',';
+	state->time_column = -1;
+	state->column_count = 0;
+	for (char* field = line; field && state->column_count < CSV_MAX_COLUMNS;) {
+		char* next = strchr(field, state->delimiter);
+		if (next) *next++ = '\0';
+		char* name = trim(field);
+		int column = state->column_count++;
+		state->column_channel[column] = -1;
+		if (strcasecmp(name, "timestamp_ms") == 0) {
+			state->time_column = column;
+			state->time_scale = 1000.0;
+		} else if (strcasecmp(name, "timestamp_us") == 0) {
+			state->time_column = column;
+			state->time_scale = 1.0;
+		} else if (strcasecmp(name, "time") == 0 || strcasecmp(name, "seconds") == 0) {
+			state->time_column = column;
+			state->time_scale = 1000000.0;
+		} else {
+			state->column_channel[column] = ecu_channel_lookup(name);
+		}
+		field = next;
+	}
+	state->have_header = true;
+	state->first_data = true;
+}
+
+static int csv_key_channel(CsvState* state, int position, const char* key) {
+	if (position >= CSV_MAX_COLUMNS) return ecu_channel_lookup(key);
+	if (strncmp(state->cached_key[position], key, sizeof(state->cached_key[0])) != 0) {
+		snprintf(state->cached_key[position], sizeof(state->cached_key[0]), "%s", key);
+		state->cached_channel[position] = ecu_channel_lookup(key);
+	}
+	return state->cached_channel[position];
+}
+
+static bool parse_csv_row(DatalogReplay* replay, CsvState* state, char* line) {
+	float row[ECU_CHANNEL_COUNT];
+	double time = NAN;
+	bool any = false;
+	int position = 0;
+
+	clear_row(row);
+	for (char* field = line; field; position++) {
+		char* next = strchr(field, state->delimiter);
+		if (next) *next++ = '\0';
+		char* equals = strchr(field, '=');
+		char* end = NULL;
+		if (equals) {
+			// datalog_manager rows: timestamp,key=value,...
+			*equals = '\0';
+			int channel = csv_key_channel(state, position, trim(field));
+			float value = strtof(equals + 1, &end);
+			if (channel >= 0 && end != equals + 1) {
+				row[channel] = value;
+				any = true;
+			}
+		} else if (position < state->column_count) {
+			double value = strtod(field, &end);
+			if (end != field) {
+				if (position == state->time_column) {
+					time = value * state->time_scale;
+				} else if (state->column_channel[position] >= 0) {
+					row[state->column_channel[position]] = (float)value;
+					any = true;
+				}
+			} else if (position == 0 && state->first_data) {
+				return true;    // Units line under the header
+			}
+		}
+		field = next;
+	}
+	state->first_data = false;
+
+	// Marker rows carry no channel values
+	if (!any) return true;
+	if (isnan(time)) {
+		time = replay->rows > 0 ? (double)(replay->first_time_us + replay->time_us[replay->rows - 1] + DATALOG_REPLAY_DEFAULT_INTERVAL_US) : 0.0;
+	}
+	return add_row(replay, llround(time), row);
+}
+
+static bool load_csv(DatalogReplay* replay, const char* path) {
+	FILE* file = fopen(path, "r");
+	if (!file) return false;
+
+	CsvState* state = calloc(1, sizeof(CsvState));
+	if (!state) {
+		fclose(file);
+		return false;
+	}
+	state->delimiter = ',';
+	state->time_column = -1;
+
+	char* line = NULL;
+	size_t size = 0;
+	ssize_t len;
+	bool ok = true;
+	while (ok && (len = getline(&line, &size, file)) >= 0) {
+		while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+		// Segment headers and seals
+		if (line[0] == '#') continue;
+		if (!state->have_header) {
+			parse_csv_header(state, line);
+			continue;
+		}
+		if (len == 0) continue;
+		ok = parse_csv_row(replay, state, line);
+	}
+	free(line);
+	free(state);
+	fclose(file);
+	return ok;
+}
+
+static bool load_log(DatalogReplay* replay, const char* path);
+
+// datalog_segment manifest: the segments of one session, in order
+static bool load_manifest(DatalogReplay* replay, const char* path) {
+	FILE* manifest = fopen(path, "r");
+	if (!manifest) return false;
+
+	char directory[512];
+	snprintf(directory, sizeof(directory), "%s", path);
+	char* slash = strrchr(directory, '/');
+	if (slash) *slash = '\0';
+	else snprintf(directory, sizeof(directory), ".");
+
+	char line[768];
+	unsigned listed = 0;
+	bool ok = true;
+	while (ok && fgets(line, sizeof(line), manifest)) {
+		unsigned index = 0;
+		char name[256];
+		char segment[1024];
+		if (sscanf(line, "segment %u %255s", &index, name) != 2 || index != listed) continue;
+		listed++;
+		snprintf(segment, sizeof(segment), "%s/%s", directory, name);
+		ok = load_log(replay, segment);
+	}
+	fclose(manifest);
+	return ok && listed > 0;
+}
+
+static bool load_binary(DatalogReplay* replay, const char* path) {
+	DatalogBinaryReader* reader = datalog_binary_open(path);
+	if (!reader) return false;
+
+	const DatalogBinaryChannel* channels = datalog_binary_channels(reader);
+	int channel_count = (int)datalog_binary_header(reader)->channel_count;
+	int wanted[ECU_CHANNEL_COUNT];
+	int wanted_channel[ECU_CHANNEL_COUNT];
+	int wanted_count = 0;
+	bool taken[ECU_CHANNEL_COUNT] = { false };
+	for (int i = 0; i < channel_count && wanted_count < ECU_CHANNEL_COUNT; i++) {
+		int channel = ecu_channel_lookup(channels[i].name);
+		if (channel < 0 || taken[channel]) continue;
+		taken[channel] = true;
+		wanted[wanted_count] = i;
+		wanted_channel[wanted_count++] = channel;
+	}
+
+	bool ok = wanted_count > 0;
+	int64_t* times = NULL;
+	float* columns = NULL;
+	uint32_t room = 0;
+	for (int block = 0; ok && block < datalog_binary_block_count(reader); block++) {
+		uint32_t samples = datalog_binary_block(reader, block)->sample_count;
+		if (samples > room) {
+			free(times);
+			free(columns);
+			times = malloc(samples * sizeof(int64_t));
+			columns = malloc((size_t)samples * wanted_count * sizeof(float));
+			room = samples;
+			if (!times || !columns) {
+				ok = false;
+				break;
+			}
+		}
+		int count = datalog_binary_read_block(reader, block, wanted, wanted_count, times, columns);
+		if (count < 0) break;       // Torn tail of a crashed session
+		for (int s = 0; ok && s < count; s++) {
+			float row[ECU_CHANNEL_COUNT];
+			clear_row(row);
+			for (int c = 0; c < wanted_count; c++) {
+				row[wanted_channel[c]] = columns[(size_t)c * count + s];
+			}
+			ok = add_row(replay, times[s], row);
+		}
+	}
+	free(times);
+	free(columns);
+	datalog_binary_close_reader(reader);
+	return ok;
+}
+
+static bool load_mlg(DatalogReplay* replay, const char* path) {
+	MlgReader* reader = mlg_reader_open(path);
+	if (!reader) return false;
+
+	int field_count = mlg_reader_field_count(reader);
+	const MlgField* fields = mlg_reader_fields(reader);
+	int* field_channel = malloc((size_t)field_count * sizeof(int));
+	float* values = malloc((size_t)field_count * sizeof(float));
+	char message[MLG_MARKER_LEN + 1];
+	bool ok = field_channel && values;
+	for (int i = 0; ok && i < field_count; i++) {
+		field_channel[i] = ecu_channel_lookup(fields[i].name);
+	}
+
+	int64_t time_us = 0;
+	MlgRecordKind kind;
+	while (ok && (kind = mlg_reader_next(reader, &time_us, values, message)) > MLG_RECORD_END) {
+		if (kind != MLG_RECORD_DATA) continue;
+		float row[ECU_CHANNEL_COUNT];
+		clear_row(row);
+		for (int i = 0; i < field_count; i++) {
+			if (field_channel[i] >= 0) row[field_channel[i]] = values[i];
+		}
+		ok = add_row(replay, time_us, row);
+	}
+	free(field_channel);
+	free(values);
+	mlg_reader_close(reader);
+	return ok;
+}
+
+static bool load_log(DatalogReplay* replay, const char* path) {
+	char magic[12] = "";
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+	size_t got = fread(magic, 1, sizeof(magic) - 1, file);
+	fclose(file);
+	magic[got] = '\0';
+
+	if (strncmp(magic, "MXLG", 4) == 0) return load_binary(replay, path);
+	if (memcmp(magic, "MLVLG", 6) == 0) return load_mlg(replay, path);
+	if (strncmp(magic, "#MTXSESSION", 11) == 0) return load_manifest(replay, path);
+	return load_csv(replay, path);
+}
+
+DatalogReplay* datalog_replay_open(const char* path) {
+	if (!path) return NULL;
+
+	DatalogReplay* replay = calloc(1, sizeof(DatalogReplay));
+	if (!replay) return NULL;
+
+	bool ok = load_log(replay, path);
+	if (ok) compact(replay);
+	if (!ok || replay->rows == 0 || replay->channel_count == 0) {
+		free(replay->time_us);
+		free(replay->values);
+		free(replay);
+		return NULL;
+	}
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&replay->wake, &attr);
+	pthread_condattr_destroy(&attr);
+	pthread_mutex_init(&replay->lock, NULL);
+	replay->speed = 1.0;
+	return replay;
+}
+
+void datalog_replay_close(DatalogReplay* replay) {
+	if (!replay) return;
+	datalog_replay_stop(replay);
+	pthread_cond_destroy(&replay->wake);
+	pthread_mutex_destroy(&replay->lock);
+	free(replay->time_us);
+	free(replay->values);
+	free(replay);
+}
+
+uint64_t datalog_replay_rows(const DatalogReplay* replay) {
+	return replay ? replay->rows : 0;
+}
+
+double datalog_replay_duration(const DatalogReplay* replay) {
+	return replay && replay->rows ? replay->time_us[replay->rows - 1] / 1e6 : 0.0;
+}
+
+int datalog_replay_channel_count(const DatalogReplay* replay) {
+	return replay ? replay->channel_count : 0;
+}
+
+int datalog_replay_channel(const DatalogReplay* replay, int index) {
+	if (!replay || index < 0 || index >= replay->channel_count) return -1;
+	return replay->channels[index];
+}
+
+// ---------------------------------------------------------------------------
+// Playback
+
+static void apply_row(const DatalogReplay* replay, uint64_t row, ECUData* data) {
+	const float* values = replay->values + row * replay->channel_count;
+	for (int c = 0; c < replay->channel_count; c++) {
+		if (isnan(values[c])) continue;
+		const ECUChannelInfo* info = ecu_channel_info(replay->channels[c]);
+		char* field = (char*)data + info->offset;
+		if (info->type == ECU_CHANNEL_TYPE_BOOL) {
+			*(bool*)field = values[c] != 0.0f;
+		} else {
+			*(float*)field = values[c];
+		}
+	}
+}
+
+// Wait for a row's place on the schedule. A speed change restarts the
+// schedule at this row. False once stopped.
+static bool pace(DatalogReplay* replay, int64_t log_us, uint64_t* base_us, int64_t* base_log_us, double* speed) {
+	pthread_mutex_lock(&replay->lock);
+	for (;;) {
+		if (replay->stopping) {
+			pthread_mutex_unlock(&replay->lock);
+			return false;
+		}
+		if (replay->speed != *speed) {
+			*speed = replay->speed;
+			*base_us = monotonic_us();
+			*base_log_us = log_us;
+		}
+		if (*speed <= 0.0) break;
+
+		uint64_t due = *base_us + (uint64_t)((double)(log_us - *base_log_us) / *speed);
+		uint64_t now = monotonic_us();
+		if (now >= due) {
+			uint32_t late = (uint32_t)(now - due < UINT32_MAX ? now - due : UINT32_MAX);
+			__atomic_add_fetch(&replay->paced_samples, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&replay->late_total_us, late, __ATOMIC_RELAXED);
+			atomic_max_u32(&replay->late_max_us, late);
+			break;
+		}
+		struct timespec until = { (time_t)(due / 1000000), (long)(due % 1000000) * 1000 };
+		pthread_cond_timedwait(&replay->wake, &replay->lock, &until);
+	}
+	pthread_mutex_unlock(&replay->lock);
+	return true;
+}
+
+static void* replay_thread(void* arg) {
+	DatalogReplay* replay = arg;
+	ECUData data;
+	uint64_t origin_us = ecu_get_timestamp_us();    // Listener timeline
+	uint64_t base_us = monotonic_us();
+	int64_t base_log_us = 0;
+	int64_t loop_offset_us = 0;
+	uint32_t generation = __atomic_load_n(&replay->speed_generation, __ATOMIC_ACQUIRE);
+	double speed;
+
+	memset(&data, 0, sizeof(data));
+	pthread_mutex_lock(&replay->lock);
+	speed = replay->speed;
+	pthread_mutex_unlock(&replay->lock);
+
+	for (;;) {
+		for (uint64_t row = 0; row < replay->rows; row++) {
+			int64_t log_us = loop_offset_us + replay->time_us[row];
+			uint32_t seen = __atomic_load_n(&replay->speed_generation, __ATOMIC_ACQUIRE);
+			// As fast as possible only looks at the lock when told something changed
+			if (speed > 0.0 || seen != generation) {
+				generation = seen;
+				if (!pace(replay, log_us, &base_us, &base_log_us, &speed)) goto done;
+			} else if (__atomic_load_n(&replay->stopping, __ATOMIC_ACQUIRE)) {
+				goto done;
+			}
+
+			apply_row(replay, row, &data);
+			uint64_t timestamp_us = origin_us + (uint64_t)log_us;
+			uint64_t started = monotonic_ns();
+			__atomic_store_n(&replay->last_timestamp_us, timestamp_us, __ATOMIC_RELAXED);
+			ecu_inject_sample(replay->ctx, &data, timestamp_us);
+
+			pthread_mutex_lock(&g_plugin_lock);
+			ECUSampleCallback callback = g_plugin_replay == replay ? g_sample_callback : NULL;
+			void* user_data = g_sample_user_data;
+			pthread_mutex_unlock(&g_plugin_lock);
+			if (callback) callback(user_data, timestamp_us);
+
+			uint64_t spent = monotonic_ns() - started;
+			__atomic_add_fetch(&replay->publish_total_ns, spent, __ATOMIC_RELAXED);
+			atomic_max_u32(&replay->publish_max_us, (uint32_t)(spent / 1000));
+			__atomic_store_n(&replay->log_us, log_us, __ATOMIC_RELAXED);
+			__atomic_store_n(&replay->position, row + 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&replay->samples, 1, __ATOMIC_RELAXED);
+		}
+		if (!replay->config.loop) {
+			__atomic_store_n(&replay->finished, 1, __ATOMIC_RELEASE);
+			break;
+		}
+		loop_offset_us += replay->time_us[replay->rows - 1] + DATALOG_REPLAY_DEFAULT_INTERVAL_US;
+	}
+done:
+	__atomic_store_n(&replay->end_us, monotonic_us(), __ATOMIC_RELAXED);
+	__atomic_store_n(&replay->running, 0, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+bool datalog_replay_start(DatalogReplay* replay, ECUContext* ctx, const DatalogReplayConfig* config) {
+	if (!replay || !ctx || replay->threaded || ecu_is_connected(ctx)) return false;
+
+	if (config) replay->config = *config;
+	else replay->config.speed = 1.0;
+	replay->ctx = ctx;
+	replay->stopping = 0;
+	replay->speed = replay->config.speed > 0.0 ? replay->config.speed : 0.0;
+	replay->finished = 0;
+	replay->position = 0;
+	replay->samples = 0;
+	replay->log_us = 0;
+	replay->paced_samples = 0;
+	replay->late_total_us = 0;
+	replay->late_max_us = 0;
+	replay->publish_total_ns = 0;
+	replay->publish_max_us = 0;
+	replay->start_us = monotonic_us();
+	replay->end_us = 0;
+	replay->running = 1;
+
+	pthread_mutex_lock(&g_plugin_lock);
+	g_plugin_replay = replay;
+	pthread_mutex_unlock(&g_plugin_lock);
+
+	if (pthread_create(&replay->thread, NULL, replay_thread, replay) != 0) {
+		replay->running = 0;
+		pthread_mutex_lock(&g_plugin_lock);
+		g_plugin_replay = NULL;
+		pthread_mutex_unlock(&g_plugin_lock);
+		return false;
+	}
+	replay->threaded = true;
+	return true;
+}
+
+static void join(DatalogReplay* replay) {
+	pthread_join(replay->thread, NULL);
+	replay->threaded = false;
+	pthread_mutex_lock(&g_plugin_lock);
+	if (g_plugin_replay == replay) g_plugin_replay = NULL;
+	pthread_mutex_unlock(&g_plugin_lock);
+}
+
+void datalog_replay_stop(DatalogReplay* replay) {
+	if (!replay || !replay->threaded) return;
+	pthread_mutex_lock(&replay->lock);
+	__atomic_store_n(&replay->stopping, 1, __ATOMIC_RELEASE);
+	pthread_cond_signal(&replay->wake);
+	pthread_mutex_unlock(&replay->lock);
+	join(replay);
+}
+
+void datalog_replay_wait(DatalogReplay* replay) {
+	if (!replay || !replay->threaded || replay->config.loop) return;
+	join(replay);
+}
+
+void datalog_replay_set_speed(DatalogReplay* replay, double speed) {
+	if (!replay) return;
+	pthread_mutex_lock(&replay->lock);
+	replay->speed = speed > 0.0 ? speed : 0.0;
+	__atomic_add_fetch(&replay->speed_generation, 1, __ATOMIC_RELEASE);
+	pthread_cond_signal(&replay->wake);
+	pthread_mutex_unlock(&replay->lock);
+}
+
+void datalog_replay_get_stats(const DatalogReplay* replay, DatalogReplayStats* out) {
+	if (!out) return;
+	memset(out, 0, sizeof(*out));
+	if (!replay) return;
+
+	DatalogReplay* r = (DatalogReplay*)replay;
+	out->running = __atomic_load_n(&r->running, __ATOMIC_ACQUIRE) != 0;
+	out->finished = __atomic_load_n(&r->finished, __ATOMIC_ACQUIRE) != 0;
+	out->rows = r->rows;
+	out->position = __atomic_load_n(&r->position, __ATOMIC_RELAXED);
+	out->samples = __atomic_load_n(&r->samples, __ATOMIC_RELAXED);
+	if (r->start_us) {
+		uint64_t end = __atomic_load_n(&r->end_us, __ATOMIC_RELAXED);
+		out->elapsed_s = ((out->running || !end) ? monotonic_us() : end) - r->start_us;
+		out->elapsed_s /= 1e6;
+	}
+	out->log_s = __atomic_load_n(&r->log_us, __ATOMIC_RELAXED) / 1e6;
+	if (out->elapsed_s > 0.0) out->samples_per_s = out->samples / out->elapsed_s;
+	uint64_t paced = __atomic_load_n(&r->paced_samples, __ATOMIC_RELAXED);
+	if (paced) out->late_mean_us = (uint32_t)(__atomic_load_n(&r->late_total_us, __ATOMIC_RELAXED) / paced);
+	out->late_max_us = __atomic_load_n(&r->late_max_us, __ATOMIC_RELAXED);
+	if (out->samples) out->publish_mean_us = (uint32_t)(__atomic_load_n(&r->publish_total_ns, __ATOMIC_RELAXED) / out->samples / 1000);
+	out->publish_max_us = __atomic_load_n(&r->publish_max_us, __ATOMIC_RELAXED);
+}
+
+// ---------------------------------------------------------------------------
+// ECU plugin for the data bridge
+
+static ECUChannelDescriptor g_descriptors[ECU_CHANNEL_COUNT];
+static pthread_once_t g_descriptors_once = PTHREAD_ONCE_INIT;
+
+static void build_descriptors(void) {
+	for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+		const ECUChannelInfo* info = ecu_channel_info(i);
+		g_descriptors[i].name = info->name;
+		g_descriptors[i].unit = info->unit;
+		g_descriptors[i].scale = 1.0f;
+		g_descriptors[i].offset = 0.0f;
+		g_descriptors[i].type = info->type == ECU_CHANNEL_TYPE_BOOL ? ECU_CHANNEL_DATA_BOOL : ECU_CHANNEL_DATA_FLOAT;
+	}
+}
+
+// The context outlives the replay, so it can be used after the lock is dropped
+static ECUContext* plugin_context(uint64_t* timestamp_us) {
+	pthread_mutex_lock(&g_plugin_lock);
+	ECUContext* ctx = g_plugin_replay ? g_plugin_replay->ctx : NULL;
+	if (ctx && timestamp_us) *timestamp_us = __atomic_load_n(&g_plugin_replay->last_timestamp_us, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&g_plugin_lock);
+	return ctx;
+}
+
+static bool plugin_init(PluginContext* ctx) {
+	(void)ctx;
+	pthread_once(&g_descriptors_once, build_descriptors);
+	return true;
+}
+
+static void plugin_cleanup(void) {
+	pthread_mutex_lock(&g_plugin_lock);
+	g_sample_callback = NULL;
+	g_sample_user_data = NULL;
+	pthread_mutex_unlock(&g_plugin_lock);
+}
+
+static bool plugin_is_connected(void) {
+	return plugin_context(NULL) != NULL;
+}
+
+static const char* plugin_get_connection_status(void) {
+	return plugin_is_connected() ? "Replaying datalog" : "No replay running";
+}
+
+static bool plugin_set_sample_callback(ECUSampleCallback callback, void* user_data) {
+	pthread_mutex_lock(&g_plugin_lock);
+	g_sample_callback = callback;
+	g_sample_user_data = user_data;
+	pthread_mutex_unlock(&g_plugin_lock);
+	return true;
+}
+
+static uint32_t plugin_get_frame_id(void) {
+	ECUContext* ctx = plugin_context(NULL);
+	return ctx ? ecu_get_frame_id(ctx) : 0;
+}
+
+static int plugin_get_channel_descriptors(const ECUChannelDescriptor** descriptors) {
+	pthread_once(&g_descriptors_once, build_descriptors);
+	*descriptors = g_descriptors;
+	return ECU_CHANNEL_COUNT;
+}
+
+static bool plugin_read_sample_frame(ECUSampleHeader* header, float* values, int max_values) {
+	uint64_t timestamp_us = 0;
+	ECUContext* ctx = plugin_context(&timestamp_us);
+	ECUData data;
+	float all[ECU_CHANNEL_COUNT];
+	if (!ctx || !header || !values || max_values <= 0) return false;
+
+	uint32_t frame_id = ecu_read_frame(ctx, &data);
+	if (frame_id == 0) return false;
+	ecu_channels_snapshot(&data, all);
+	int count = max_values < ECU_CHANNEL_COUNT ? max_values : ECU_CHANNEL_COUNT;
+	memcpy(values, all, (size_t)count * sizeof(float));
+	header->timestamp = timestamp_us;
+	header->frame_id = frame_id;
+	header->channel_count = (uint32_t)count;
+	return true;
+}
+
+static PluginInterface g_plugin = {
+	.name = "datalog_replay",
+	.version = "1.0.0",
+	.author = "MegaTunix Redux Team",
+	.description = "Replays a recorded datalog as live ECU data",
+	.type = PLUGIN_TYPE_ECU,
+	.status = PLUGIN_STATUS_LOADED,
+	.init = plugin_init,
+	.cleanup = plugin_cleanup,
+	.interface.ecu = {
+		.is_connected = plugin_is_connected,
+		.get_connection_status = plugin_get_connection_status,
+		.set_sample_callback = plugin_set_sample_callback,
+		.get_frame_id = plugin_get_frame_id,
+		.abi_version = ECU_PLUGIN_ABI_V2,
+		.get_channel_descriptors = plugin_get_channel_descriptors,
+		.read_sample_frame = plugin_read_sample_frame,
+	},
+};
+
+PluginInterface* datalog_replay_plugin(void) {
+	return &g_plugin;
+}
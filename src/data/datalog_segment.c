@@ -0,0 +1,509 @@
+/*
+ * Segmented Datalog Sessions - MegaTunix Redux
+ *
+ * Threads: the datalog writer thread owns the current segment (writes,
+ * seals, rotation). The segmenter's retire thread creates the spare file
+ * for the next rotation and syncs and closes retired segments; lock guards
+ * only the spare and the retire queue. The manifest is written by open()
+ * and close() while the retire thread isn't running, and by the retire
+ * thread in between.
+ */
+
+#include "../../include/data/datalog_segment.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define RETIRE_QUEUE 4
+#define NO_SEGMENT UINT32_MAX
+#define MAX_SESSION_SEGMENTS 1000
+
+typedef struct {
+	int fd;
+	uint32_t index;
+	uint64_t bytes;
+	uint32_t blocks;
+	int64_t end_us;
+	uint32_t next_index;            // Segment that replaced it, NO_SEGMENT at close
+	int64_t next_start_us;
+} RetiredSegment;
+
+struct DatalogSegmenter {
+	char* directory;
+	char* base;
+	char* extension;
+	char* session;
+	char* preamble;
+	uint64_t max_bytes;
+	uint32_t max_seconds;
+	char manifest_path[512];
+	int manifest_fd;
+
+	// Writer thread
+	int fd;
+	uint32_t index;
+	uint64_t bytes;
+	uint64_t header_bytes;          // Segment header and preamble
+	uint32_t blocks;
+	uint64_t unsealed;
+	uint32_t crc;                   // Of the unsealed bytes
+	uint64_t opened_us;             // Monotonic
+
+	// Shared with the retire thread
+	pthread_t thread;
+	bool threaded;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	int spare_fd;
+	uint32_t spare_index;
+	bool spare_wanted;
+	RetiredSegment queue[RETIRE_QUEUE];
+	int queued;
+	bool stopping;
+	uint32_t segment_count;
+};
+
+static uint64_t monotonic_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t wall_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool write_all(int fd, const void* data, size_t size) {
+	const uint8_t* p = data;
+	while (size > 0) {
+		ssize_t done = write(fd, p, size);
+		if (done < 0 && errno == EINTR) continue;
+		if (done <= 0) return false;
+		p += done;
+		size -= (size_t)done;
+	}
+	return true;
+}
+
+static char* copy_string(const char* s) {
+	return strdup(s ? s : "");
+}
+
+static void segment_name(const DatalogSegmenter* segments, uint32_t index, char* out, size_t size) {
+	snprintf(out, size, "%s.%03u.%s", segments->base, index, segments->extension);
+}
+
+static int create_segment(const DatalogSegmenter* segments, uint32_t index) {
+	char name[256];
+	char path[512];
+	segment_name(segments, index, name, sizeof(name));
+	snprintf(path, sizeof(path), "%s/%s", segments->directory, name);
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) return -1;
+	// Make the new directory entry survive a power cut too
+	int dir = open(segments->directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (dir >= 0) {
+		fsync(dir);
+		close(dir);
+	}
+	return fd;
+}
+
+static void manifest_printf(DatalogSegmenter* segments, const char* format, ...) {
+	char line[768];
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	if (n <= 0 || segments->manifest_fd < 0) return;
+	if ((size_t)n >= sizeof(line)) n = sizeof(line) - 1;
+	write_all(segments->manifest_fd, line, (size_t)n);
+}
+
+static void manifest_segment(DatalogSegmenter* segments, uint32_t index, int64_t start_us) {
+	char name[256];
+	segment_name(segments, index, name, sizeof(name));
+	manifest_printf(segments, "segment %u %s start_us=%" PRId64 "\n", index, name, start_us);
+}
+
+// Seal the bytes written since the last seal with their length and CRC
+static bool seal(DatalogSegmenter* segments) {
+	if (segments->unsealed == 0) return true;
+	char trailer[64];
+	int n = snprintf(trailer, sizeof(trailer), "#BLK %u %" PRIu64 " %08x\n",
+	                 segments->blocks, segments->unsealed, segments->crc);
+	if (!write_all(segments->fd, trailer, (size_t)n)) return false;
+	segments->bytes += (uint64_t)n;
+	segments->blocks++;
+	segments->unsealed = 0;
+	segments->crc = (uint32_t)crc32(0L, Z_NULL, 0);
+	return true;
+}
+
+static bool append(DatalogSegmenter* segments, const void* data, size_t size) {
+	if (!write_all(segments->fd, data, size)) return false;
+	segments->crc = (uint32_t)crc32(segments->crc, data, (uInt)size);
+	segments->unsealed += size;
+	segments->bytes += size;
+	return true;
+}
+
+static bool begin_segment(DatalogSegmenter* segments, int fd, uint32_t index, int64_t start_us) {
+	char header[384];
+	int n = snprintf(header, sizeof(header), "#MTXSEG %d session=%s segment=%u start_us=%" PRId64 "\n",
+	                 DATALOG_SEGMENT_VERSION, segments->session, index, start_us);
+	segments->fd = fd;
+	segments->index = index;
+	segments->bytes = 0;
+	segments->blocks = 0;
+	segments->unsealed = 0;
+	segments->crc = (uint32_t)crc32(0L, Z_NULL, 0);
+	segments->opened_us = monotonic_us();
+	bool ok = append(segments, header, (size_t)(n < (int)sizeof(header) ? n : (int)sizeof(header) - 1));
+	if (ok && segments->preamble[0]) ok = append(segments, segments->preamble, strlen(segments->preamble));
+	ok = ok && seal(segments);
+	segments->header_bytes = segments->bytes;
+	return ok;
+}
+
+static void retire(DatalogSegmenter* segments, const RetiredSegment* old) {
+	fdatasync(old->fd);
+	close(old->fd);
+	manifest_printf(segments, "closed %u bytes=%" PRIu64 " blocks=%u end_us=%" PRId64 "\n",
+	                old->index, old->bytes, old->blocks, old->end_us);
+	if (old->next_index != NO_SEGMENT) manifest_segment(segments, old->next_index, old->next_start_us);
+	if (segments->manifest_fd >= 0) fdatasync(segments->manifest_fd);
+}
+
+static void* retire_thread(void* data) {
+	DatalogSegmenter* segments = data;
+
+	pthread_mutex_lock(&segments->lock);
+	for (;;) {
+		if (segments->queued > 0) {
+			RetiredSegment old = segments->queue[0];
+			memmove(&segments->queue[0], &segments->queue[1], (size_t)(segments->queued - 1) * sizeof(RetiredSegment));
+			segments->queued--;
+			pthread_mutex_unlock(&segments->lock);
+			retire(segments, &old);
+			pthread_mutex_lock(&segments->lock);
+			continue;
+		}
+		if (segments->spare_wanted && !segments->stopping) {
+			uint32_t index = segments->spare_index;
+			pthread_mutex_unlock(&segments->lock);
+			int fd = create_segment(segments, index);
+			pthread_mutex_lock(&segments->lock);
+			segments->spare_fd = fd;
+			segments->spare_wanted = false;
+			continue;
+		}
+		if (segments->stopping) break;
+		pthread_cond_wait(&segments->wake, &segments->lock);
+	}
+	pthread_mutex_unlock(&segments->lock);
+	return NULL;
+}
+
+// Swap to the spare file if it is ready; otherwise keep writing this one
+static void rotate(DatalogSegmenter* segments) {
+	if (!seal(segments)) return;
+	pthread_mutex_lock(&segments->lock);
+	if (segments->spare_fd < 0 || segments->queued == RETIRE_QUEUE) {
+		// A spare that couldn't be created is retried
+		if (segments->spare_fd < 0 && !segments->spare_wanted) {
+			segments->spare_wanted = true;
+			pthread_cond_signal(&segments->wake);
+		}
+		pthread_mutex_unlock(&segments->lock);
+		return;
+	}
+	int fd = segments->spare_fd;
+	uint32_t index = segments->spare_index;
+	int64_t now = wall_us();
+	segments->queue[segments->queued++] = (RetiredSegment){
+		.fd = segments->fd, .index = segments->index, .bytes = segments->bytes,
+		.blocks = segments->blocks, .end_us = now, .next_index = index, .next_start_us = now
+	};
+	segments->spare_fd = -1;
+	segments->spare_index = index + 1;
+	segments->spare_wanted = true;
+	segments->segment_count++;
+	pthread_cond_signal(&segments->wake);
+	pthread_mutex_unlock(&segments->lock);
+	begin_segment(segments, fd, index, now);
+}
+
+DatalogSegmenter* datalog_segment_open(const DatalogSegmentConfig* config) {
+	if (!config || !config->directory || !config->base) return NULL;
+	DatalogSegmenter* segments = calloc(1, sizeof(DatalogSegmenter));
+	if (!segments) return NULL;
+	segments->directory = copy_string(config->directory);
+	segments->base = copy_string(config->base);
+	segments->extension = copy_string(config->extension ? config->extension : "csv");
+	segments->session = copy_string(config->session);
+	segments->preamble = copy_string(config->preamble);
+	segments->max_bytes = config->max_bytes;
+	segments->max_seconds = config->max_seconds;
+	segments->fd = -1;
+	segments->spare_fd = -1;
+	segments->manifest_fd = -1;
+	pthread_mutex_init(&segments->lock, NULL);
+	pthread_cond_init(&segments->wake, NULL);
+
+	snprintf(segments->manifest_path, sizeof(segments->manifest_path), "%s/%s.manifest", segments->directory, segments->base);
+	segments->manifest_fd = open(segments->manifest_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	int fd = segments->manifest_fd >= 0 ? create_segment(segments, 0) : -1;
+	if (fd < 0) {
+		datalog_segment_close(segments);
+		return NULL;
+	}
+	int64_t now = wall_us();
+	manifest_printf(segments, "#MTXSESSION %d\nsession %s\nbase %s\nextension %s\n",
+	                DATALOG_SEGMENT_VERSION, segments->session, segments->base, segments->extension);
+	manifest_segment(segments, 0, now);
+	fdatasync(segments->manifest_fd);
+	segments->segment_count = 1;
+	if (!begin_segment(segments, fd, 0, now)) {
+		datalog_segment_close(segments);
+		return NULL;
+	}
+
+	// Only a segmenter that can roll over needs a spare and the retire thread
+	if (segments->max_bytes || segments->max_seconds) {
+		segments->spare_index = 1;
+		segments->spare_wanted = true;
+		if (pthread_create(&segments->thread, NULL, retire_thread, segments) != 0) {
+			datalog_segment_close(segments);
+			return NULL;
+		}
+		segments->threaded = true;
+	}
+	return segments;
+}
+
+void datalog_segment_close(DatalogSegmenter* segments) {
+	if (!segments) return;
+	if (segments->threaded) {
+		pthread_mutex_lock(&segments->lock);
+		segments->stopping = true;
+		pthread_cond_signal(&segments->wake);
+		pthread_mutex_unlock(&segments->lock);
+		pthread_join(segments->thread, NULL);
+	}
+	if (segments->spare_fd >= 0) {
+		char name[256];
+		char path[512];
+		close(segments->spare_fd);
+		segment_name(segments, segments->spare_index, name, sizeof(name));
+		snprintf(path, sizeof(path), "%s/%s", segments->directory, name);
+		unlink(path);
+	}
+	if (segments->fd >= 0) {
+		seal(segments);
+		RetiredSegment last = {
+			.fd = segments->fd, .index = segments->index, .bytes = segments->bytes,
+			.blocks = segments->blocks, .end_us = wall_us(), .next_index = NO_SEGMENT
+		};
+		retire(segments, &last);
+		manifest_printf(segments, "end segments=%u\n", segments->segment_count);
+	}
+	if (segments->manifest_fd >= 0) {
+		fdatasync(segments->manifest_fd);
+		close(segments->manifest_fd);
+	}
+	pthread_cond_destroy(&segments->wake);
+	pthread_mutex_destroy(&segments->lock);
+	free(segments->directory);
+	free(segments->base);
+	free(segments->extension);
+	free(segments->session);
+	free(segments->preamble);
+	free(segments);
+}
+
+bool datalog_segment_write(DatalogSegmenter* segments, const void* data, size_t size) {
+	if (!segments || segments->fd < 0 || !data) return false;
+	if (segments->bytes > segments->header_bytes) {
+		bool full = segments->max_bytes && segments->bytes + size > segments->max_bytes;
+		bool old = segments->max_seconds && monotonic_us() - segments->opened_us >= segments->max_seconds * 1000000ull;
+		if (full || old) rotate(segments);
+	}
+	if (!append(segments, data, size)) return false;
+	return segments->unsealed < DATALOG_SEGMENT_BLOCK_BYTES || seal(segments);
+}
+
+bool datalog_segment_sync(DatalogSegmenter* segments) {
+	if (!segments || segments->fd < 0) return false;
+	bool ok = seal(segments);
+	return fdatasync(segments->fd) == 0 && ok;
+}
+
+const char* datalog_segment_manifest_path(const DatalogSegmenter* segments) {
+	return segments ? segments->manifest_path : NULL;
+}
+
+uint32_t datalog_segment_count(const DatalogSegmenter* segments) {
+	if (!segments) return 0;
+	pthread_mutex_lock((pthread_mutex_t*)&segments->lock);
+	uint32_t count = segments->segment_count;
+	pthread_mutex_unlock((pthread_mutex_t*)&segments->lock);
+	return count;
+}
+
+ssize_t datalog_segment_sink(int fd, const void* data, size_t size, void* user_data) {
+	(void)fd;
+	return datalog_segment_write(user_data, data, size) ? (ssize_t)size : -1;
+}
+
+void datalog_segment_sink_sync(int fd, void* user_data) {
+	(void)fd;
+	datalog_segment_sync(user_data);
+}
+
+bool datalog_segment_recover(const char* path, DatalogSegmentRecovery* out) {
+	DatalogSegmentRecovery result = {0};
+	struct stat st;
+	int fd = path ? open(path, O_RDWR | O_CLOEXEC) : -1;
+	if (fd < 0) return false;
+	if (fstat(fd, &st) != 0 || st.st_size < 8) {
+		close(fd);
+		return false;
+	}
+	result.file_bytes = (uint64_t)st.st_size;
+	const char* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		close(fd);
+		return false;
+	}
+	if (memcmp(map, "#MTXSEG ", 8) != 0) {
+		munmap((void*)map, (size_t)st.st_size);
+		close(fd);
+		return false;
+	}
+
+	const char* end = map + st.st_size;
+	const char* block = map;
+	const char* p = map;
+	while (p < end) {
+		const char* eol = memchr(p, '\n', (size_t)(end - p));
+		if (!eol) break;        // Torn last line
+		if (eol - p > 5 && memcmp(p, "#BLK ", 5) == 0) {
+			char line[64];
+			unsigned seq = 0;
+			uint64_t length = 0;
+			unsigned crc = 0;
+			size_t n = (size_t)(eol - p) < sizeof(line) - 1 ? (size_t)(eol - p) : sizeof(line) - 1;
+			memcpy(line, p, n);
+			line[n] = '\0';
+			if (sscanf(line, "#BLK %u %" SCNu64 " %x", &seq, &length, &crc) != 3 || seq != result.blocks
+			    || length != (uint64_t)(p - block)
+			    || (uint32_t)crc32(crc32(0L, Z_NULL, 0), (const Bytef*)block, (uInt)length) != crc) {
+				break;
+			}
+			result.blocks++;
+			block = eol + 1;
+			result.valid_bytes = (uint64_t)(block - map);
+		}
+		p = eol + 1;
+	}
+	munmap((void*)map, (size_t)st.st_size);
+
+	if (result.valid_bytes < result.file_bytes) {
+		result.truncated = ftruncate(fd, (off_t)result.valid_bytes) == 0;
+		fsync(fd);
+	}
+	close(fd);
+	if (out) *out = result;
+	return true;
+}
+
+int datalog_segment_recover_session(const char* manifest_path) {
+	FILE* manifest = manifest_path ? fopen(manifest_path, "r+") : NULL;
+	if (!manifest) return -1;
+
+	char directory[512];
+	snprintf(directory, sizeof(directory), "%s", manifest_path);
+	char* slash = strrchr(directory, '/');
+	if (slash) *slash = '\0';
+	else snprintf(directory, sizeof(directory), ".");
+
+	char base[192] = "";
+	char extension[32] = "csv";
+	char (*names)[256] = calloc(MAX_SESSION_SEGMENTS, sizeof(*names));
+	bool* closed = calloc(MAX_SESSION_SEGMENTS, sizeof(bool));
+	uint32_t listed = 0;
+	if (!names || !closed) {
+		free(names);
+		free(closed);
+		fclose(manifest);
+		return -1;
+	}
+	bool ended = false;
+	char line[768];
+	while (fgets(line, sizeof(line), manifest)) {
+		unsigned index = 0;
+		char name[256];
+		line[strcspn(line, "\r\n")] = '\0';
+		if (strncmp(line, "base ", 5) == 0) {
+			snprintf(base, sizeof(base), "%.*s", (int)sizeof(base) - 1, line + 5);
+		} else if (strncmp(line, "extension ", 10) == 0) {
+			snprintf(extension, sizeof(extension), "%.*s", (int)sizeof(extension) - 1, line + 10);
+		} else if (sscanf(line, "segment %u %255s", &index, name) == 2 && index == listed && listed < MAX_SESSION_SEGMENTS) {
+			snprintf(names[listed++], sizeof(names[0]), "%s", name);
+		} else if (sscanf(line, "closed %u", &index) == 1 && index < listed) {
+			closed[index] = true;
+		} else if (strncmp(line, "end ", 4) == 0) {
+			ended = true;
+		}
+	}
+
+	// Segments the writer switched to before the manifest caught up. The
+	// spare made ahead of a rotation that never came is empty; drop it.
+	fseek(manifest, 0, SEEK_END);
+	while (base[0] && listed < MAX_SESSION_SEGMENTS) {
+		char path[1024];
+		struct stat st;
+		snprintf(names[listed], sizeof(names[0]), "%s.%03u.%s", base, listed, extension);
+		snprintf(path, sizeof(path), "%s/%s", directory, names[listed]);
+		if (stat(path, &st) != 0) break;
+		if (st.st_size == 0) {
+			unlink(path);
+			break;
+		}
+		fprintf(manifest, "segment %u %s start_us=0\n", listed, names[listed]);
+		listed++;
+	}
+
+	int repaired = 0;
+	for (uint32_t i = 0; i < listed; ++i) {
+		char path[1024];
+		DatalogSegmentRecovery recovery;
+		if (closed[i]) continue;
+		snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+		if (!datalog_segment_recover(path, &recovery)) continue;
+		fprintf(manifest, "recovered %u bytes=%" PRIu64 " blocks=%u dropped=%" PRIu64 "\n",
+		        i, recovery.valid_bytes, recovery.blocks, recovery.file_bytes - recovery.valid_bytes);
+		repaired++;
+	}
+	if (!ended) fprintf(manifest, "end segments=%u recovered=%d\n", listed, repaired);
+	fflush(manifest);
+	fsync(fileno(manifest));
+	fclose(manifest);
+	free(names);
+	free(closed);
+	return repaired;
+}
@@ -0,0 +1,325 @@
+/*
+ * Asynchronous Datalog Writer - MegaTunix Redux
+ *
+ * Ring protocol: records are 16-byte aligned, each starting with a
+ * RecordHeader. head is only stored by the producer and tail only by the
+ * writer thread, both as monotonically increasing byte counts. A record
+ * never wraps; if it does not fit before the end of the ring the producer
+ * fills the remainder with a pad record and starts again at offset 0.
+ */
+
+#include "../../include/data/datalog_writer.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+enum {
+	RECORD_PAD = 0,
+	RECORD_TEXT,
+	RECORD_ROW,
+	RECORD_MARKER
+};
+
+typedef struct {
+	uint32_t size;                  // Whole record, aligned
+	uint16_t kind;
+	uint16_t count;                 // Payload bytes (text/marker) or floats (row) in the first 16 bits
+	int64_t time_us;
+} RecordHeader;
+
+#define RECORD_ALIGN 16
+#define RECORD_MAX_PAYLOAD 65535
+
+struct DatalogWriter {
+	uint8_t* ring;
+	uint32_t capacity;
+	uint32_t mask;
+	uint64_t head;                  // Published by the producer
+	uint64_t tail;                  // Published by the writer thread
+	uint64_t reserved;              // Producer only: head plus any pad of the open record
+
+	int fd;
+	DatalogBinaryWriter* binary;
+	DatalogWriterConfig config;
+	uint8_t* batch;
+	size_t batch_used;
+
+	pthread_t thread;
+	pthread_mutex_t lock;           // Only for the condition variable
+	pthread_cond_t wake;
+	int stopping;
+
+	// Statistics; written by one side, read by anyone
+	uint64_t records_queued;
+	uint64_t records_dropped;
+	uint32_t high_water;
+	uint64_t bytes_written;
+	uint64_t bytes_per_second;
+	uint64_t write_errors;
+	uint64_t syncs;
+	uint32_t max_write_us;
+};
+
+static uint64_t monotonic_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static ssize_t default_sink(int fd, const void* data, size_t size, void* user_data) {
+	(void)user_data;
+	return write(fd, data, size);
+}
+
+static void note_write_time(DatalogWriter* writer, uint64_t started) {
+	uint32_t elapsed = (uint32_t)(monotonic_us() - started);
+	if (elapsed > writer->max_write_us) __atomic_store_n(&writer->max_write_us, elapsed, __ATOMIC_RELAXED);
+}
+
+static void flush_batch(DatalogWriter* writer) {
+	const uint8_t* data = writer->batch;
+	size_t left = writer->batch_used;
+	uint64_t started = monotonic_us();
+	while (left > 0) {
+		ssize_t done = writer->config.sink(writer->fd, data, left, writer->config.sink_data);
+		if (done < 0 && errno == EINTR) continue;
+		if (done <= 0) {
+			// Disk full or gone; drop the batch rather than spin on it
+			__atomic_add_fetch(&writer->write_errors, 1, __ATOMIC_RELAXED);
+			break;
+		}
+		data += done;
+		left -= (size_t)done;
+		__atomic_add_fetch(&writer->bytes_written, (uint64_t)done, __ATOMIC_RELAXED);
+	}
+	writer->batch_used = 0;
+	note_write_time(writer, started);
+}
+
+static void sync_outputs(DatalogWriter* writer) {
+	if (writer->batch_used) flush_batch(writer);
+	if (writer->config.sync) writer->config.sync(writer->fd, writer->config.sink_data);
+	else if (writer->fd >= 0) fdatasync(writer->fd);
+	if (writer->binary) datalog_binary_sync(writer->binary);
+	__atomic_add_fetch(&writer->syncs, 1, __ATOMIC_RELAXED);
+}
+
+static void consume_record(DatalogWriter* writer, const RecordHeader* record) {
+	const uint8_t* payload = (const uint8_t*)(record + 1);
+	switch (record->kind) {
+	case RECORD_TEXT:
+		if (writer->batch_used + record->count > writer->config.batch_bytes) flush_batch(writer);
+		memcpy(writer->batch + writer->batch_used, payload, record->count);
+		writer->batch_used += record->count;
+		if (writer->batch_used == writer->config.batch_bytes) flush_batch(writer);
+		break;
+	case RECORD_ROW:
+		if (writer->binary) {
+			uint64_t before = datalog_binary_bytes_written(writer->binary);
+			uint64_t started = monotonic_us();
+			if (!datalog_binary_append(writer->binary, record->time_us, (const float*)payload)) {
+				__atomic_add_fetch(&writer->write_errors, 1, __ATOMIC_RELAXED);
+			}
+			note_write_time(writer, started);
+			__atomic_add_fetch(&writer->bytes_written, datalog_binary_bytes_written(writer->binary) - before, __ATOMIC_RELAXED);
+		}
+		break;
+	case RECORD_MARKER:
+		if (writer->binary) datalog_binary_add_marker(writer->binary, record->time_us, (const char*)payload);
+		break;
+	default:
+		break;
+	}
+}
+
+static void* writer_thread(void* data) {
+	DatalogWriter* writer = data;
+	uint64_t last_sync = monotonic_us();
+	uint64_t rate_start = last_sync;
+	uint64_t rate_bytes = 0;
+
+	for (;;) {
+		uint64_t head = __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE);
+		uint64_t tail = writer->tail;
+		while (tail != head) {
+			const RecordHeader* record = (const RecordHeader*)(writer->ring + (tail & writer->mask));
+			consume_record(writer, record);
+			tail += record->size;
+			__atomic_store_n(&writer->tail, tail, __ATOMIC_RELEASE);
+		}
+
+		uint64_t now = monotonic_us();
+		if (now - rate_start >= 1000000) {
+			uint64_t total = __atomic_load_n(&writer->bytes_written, __ATOMIC_RELAXED);
+			__atomic_store_n(&writer->bytes_per_second, (total - rate_bytes) * 1000000 / (now - rate_start), __ATOMIC_RELAXED);
+			rate_bytes = total;
+			rate_start = now;
+		}
+		if (writer->config.sync_interval_ms && now - last_sync >= writer->config.sync_interval_ms * 1000ull) {
+			sync_outputs(writer);
+			last_sync = now;
+		}
+
+		// Ring empty: push out the partial batch, then sleep until woken
+		if (writer->batch_used) flush_batch(writer);
+		if (__atomic_load_n(&writer->stopping, __ATOMIC_ACQUIRE)) {
+			if (__atomic_load_n(&writer->head, __ATOMIC_ACQUIRE) == writer->tail) break;
+			continue;
+		}
+
+		pthread_mutex_lock(&writer->lock);
+		if (__atomic_load_n(&writer->head, __ATOMIC_ACQUIRE) == writer->tail
+		    && !__atomic_load_n(&writer->stopping, __ATOMIC_ACQUIRE)) {
+			// The producer signals without the lock, so a wakeup can be missed; the timeout bounds that
+			struct timespec until;
+			clock_gettime(CLOCK_REALTIME, &until);
+			until.tv_nsec += 10 * 1000000;
+			if (until.tv_nsec >= 1000000000) {
+				until.tv_sec++;
+				until.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&writer->wake, &writer->lock, &until);
+		}
+		pthread_mutex_unlock(&writer->lock);
+	}
+
+	sync_outputs(writer);
+	return NULL;
+}
+
+DatalogWriter* datalog_writer_start(int fd, DatalogBinaryWriter* binary, const DatalogWriterConfig* config) {
+	DatalogWriter* writer = calloc(1, sizeof(DatalogWriter));
+	if (!writer) return NULL;
+
+	if (config) writer->config = *config;
+	if (writer->config.ring_bytes == 0) writer->config.ring_bytes = DATALOG_WRITER_RING_BYTES;
+	if (writer->config.batch_bytes == 0) writer->config.batch_bytes = DATALOG_WRITER_BATCH_BYTES;
+	if (!writer->config.sink) writer->config.sink = default_sink;
+	// Every text record must fit a batch, and the ring must hold the largest record
+	if (writer->config.batch_bytes < RECORD_MAX_PAYLOAD) writer->config.batch_bytes = RECORD_MAX_PAYLOAD;
+	uint32_t capacity = writer->config.ring_bytes;
+	if ((capacity & (capacity - 1)) != 0 || capacity < 2 * (RECORD_MAX_PAYLOAD + sizeof(RecordHeader))) {
+		free(writer);
+		return NULL;
+	}
+
+	writer->capacity = capacity;
+	writer->mask = capacity - 1;
+	writer->fd = fd;
+	writer->binary = binary;
+	writer->ring = aligned_alloc(RECORD_ALIGN, capacity);
+	writer->batch = malloc(writer->config.batch_bytes);
+	pthread_mutex_init(&writer->lock, NULL);
+	pthread_cond_init(&writer->wake, NULL);
+	if (!writer->ring || !writer->batch || pthread_create(&writer->thread, NULL, writer_thread, writer) != 0) {
+		pthread_cond_destroy(&writer->wake);
+		pthread_mutex_destroy(&writer->lock);
+		free(writer->ring);
+		free(writer->batch);
+		free(writer);
+		return NULL;
+	}
+	return writer;
+}
+
+void datalog_writer_stop(DatalogWriter* writer) {
+	if (!writer) return;
+	__atomic_store_n(&writer->stopping, 1, __ATOMIC_RELEASE);
+	pthread_cond_signal(&writer->wake);
+	pthread_join(writer->thread, NULL);
+
+	pthread_cond_destroy(&writer->wake);
+	pthread_mutex_destroy(&writer->lock);
+	free(writer->ring);
+	free(writer->batch);
+	free(writer);
+}
+
+static void* reserve(DatalogWriter* writer, uint16_t kind, uint16_t count, int64_t time_us, size_t payload) {
+	if (!writer || payload > RECORD_MAX_PAYLOAD) return NULL;
+
+	uint32_t size = (uint32_t)((sizeof(RecordHeader) + payload + RECORD_ALIGN - 1) & ~(size_t)(RECORD_ALIGN - 1));
+	uint64_t head = writer->head;
+	uint32_t offset = (uint32_t)(head & writer->mask);
+	uint32_t pad = offset + size > writer->capacity ? writer->capacity - offset : 0;
+	uint64_t tail = __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE);
+	uint64_t used = head - tail;
+
+	if (used + pad + size > writer->capacity) {
+		__atomic_store_n(&writer->records_dropped, writer->records_dropped + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+	if (pad) {
+		RecordHeader* filler = (RecordHeader*)(writer->ring + offset);
+		*filler = (RecordHeader){ .size = pad, .kind = RECORD_PAD };
+		head += pad;
+		offset = 0;
+	}
+	if (used + pad + size > writer->high_water) {
+		__atomic_store_n(&writer->high_water, (uint32_t)(used + pad + size), __ATOMIC_RELAXED);
+	}
+
+	RecordHeader* record = (RecordHeader*)(writer->ring + offset);
+	*record = (RecordHeader){ .size = size, .kind = kind, .count = count, .time_us = time_us };
+	writer->reserved = head;
+	return record + 1;
+}
+
+// Pad and record become visible to the writer thread together
+static void commit(DatalogWriter* writer, const void* payload) {
+	const RecordHeader* record = (const RecordHeader*)payload - 1;
+	bool was_empty = writer->head == __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&writer->head, writer->reserved + record->size, __ATOMIC_RELEASE);
+	__atomic_store_n(&writer->records_queued, writer->records_queued + 1, __ATOMIC_RELAXED);
+	if (was_empty) pthread_cond_signal(&writer->wake);
+}
+
+bool datalog_writer_write(DatalogWriter* writer, const void* text, size_t size) {
+	if (!text || size == 0) return false;
+	void* payload = reserve(writer, RECORD_TEXT, (uint16_t)size, 0, size);
+	if (!payload) return false;
+	memcpy(payload, text, size);
+	commit(writer, payload);
+	return true;
+}
+
+bool datalog_writer_row(DatalogWriter* writer, int64_t time_us, const float* values, uint32_t count) {
+	if (!values || count == 0 || count > DATALOG_BINARY_MAX_CHANNELS) return false;
+	void* payload = reserve(writer, RECORD_ROW, (uint16_t)count, time_us, count * sizeof(float));
+	if (!payload) return false;
+	memcpy(payload, values, count * sizeof(float));
+	commit(writer, payload);
+	return true;
+}
+
+bool datalog_writer_marker(DatalogWriter* writer, int64_t time_us, const char* label) {
+	if (!label) return false;
+	size_t size = strlen(label) + 1;
+	void* payload = reserve(writer, RECORD_MARKER, (uint16_t)size, time_us, size);
+	if (!payload) return false;
+	memcpy(payload, label, size);
+	commit(writer, payload);
+	return true;
+}
+
+void datalog_writer_get_stats(const DatalogWriter* writer, DatalogWriterStats* stats) {
+	if (!stats) return;
+	memset(stats, 0, sizeof(*stats));
+	if (!writer) return;
+	uint64_t tail = __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE);
+	uint64_t head = __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE);
+	stats->queue_depth = head > tail ? (uint32_t)(head - tail) : 0;
+	stats->queue_high_water = __atomic_load_n(&writer->high_water, __ATOMIC_RELAXED);
+	stats->queue_capacity = writer->capacity;
+	stats->records_queued = __atomic_load_n(&writer->records_queued, __ATOMIC_RELAXED);
+	stats->records_dropped = __atomic_load_n(&writer->records_dropped, __ATOMIC_RELAXED);
+	stats->bytes_written = __atomic_load_n(&writer->bytes_written, __ATOMIC_RELAXED);
+	stats->bytes_per_second = __atomic_load_n(&writer->bytes_per_second, __ATOMIC_RELAXED);
+	stats->write_errors = __atomic_load_n(&writer->write_errors, __ATOMIC_RELAXED);
+	stats->syncs = __atomic_load_n(&writer->syncs, __ATOMIC_RELAXED);
+	stats->max_write_us = __atomic_load_n(&writer->max_write_us, __ATOMIC_RELAXED);
+}
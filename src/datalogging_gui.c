@@ -372,11 +372,12 @@ G_MODULE_EXPORT gboolean run_datalog(void)
 	GIOChannel *iochannel = NULL;
 	gconstpointer *object = NULL;
 	gfloat value = 0.0;
-	GArray *history = NULL;
-	GArray *array = NULL;
+	Rtv_History *history = NULL;
+	Rtv_History *array = NULL;
 	gint precision = 0;
 	gchar *tmpbuf = NULL;
 	Rtv_Map *rtv_map = NULL;
+	GMutex *rtv_mutex = (GMutex *)DATA_GET(global_data,"rtv_mutex");
 
 	ENTER();
 
@@ -423,7 +424,7 @@ G_MODULE_EXPORT gboolean run_datalog(void)
 	}
 	
 	/* Get current array length */
-	array = (GArray *)DATA_GET(g_list_nth_data(object_list,0),"history");
+	array = (Rtv_History *)DATA_GET(g_list_nth_data(object_list,0),"history");
 	cur_len = array->len;
 	if (cur_len > last_len)
 	{
@@ -442,12 +443,17 @@ G_MODULE_EXPORT gboolean run_datalog(void)
 		for(i=0;i<total_logables;i++)
 		{
 			object = (gconstpointer *)g_list_nth_data(object_list,i);
-			history = (GArray *)DATA_GET(object,"history");
+			history = (Rtv_History *)DATA_GET(object,"history");
 			precision = (GINT)DATA_GET(object,"precision");
 			if ((GINT)j <= 0)
 				value = 0.0;
 			else
-				value = g_array_index(history, gfloat, j);
+			{
+				/* Older samples may be read back from the spill file */
+				g_mutex_lock(rtv_mutex);
+				value = rtv_history_get(history,j);
+				g_mutex_unlock(rtv_mutex);
+			}
 
 			tmpbuf = g_strdelimit(g_strdup_printf("%1$.*2$f",value,precision),",",'.');
 			g_string_append(output,tmpbuf);
@@ -726,7 +732,7 @@ G_MODULE_EXPORT void dump_log_to_disk(GIOChannel *iochannel)
 	gsize count = 0;
 	GString *output;
 	gconstpointer * object = NULL;
-	GArray **histories = NULL;
+	Rtv_History **histories = NULL;
 	gint *precisions = NULL;
 	gchar *tmpbuf = NULL;
 	gchar *msg = NULL;
@@ -734,6 +740,7 @@ G_MODULE_EXPORT void dump_log_to_disk(GIOChannel *iochannel)
 	gboolean restart_tickler = FALSE;
 	GtkWidget * info_label = NULL;
 	Rtv_Map *rtv_map = NULL;
+	GMutex *rtv_mutex = (GMutex *)DATA_GET(global_data,"rtv_mutex");
 
 	ENTER();
 
@@ -749,7 +756,7 @@ G_MODULE_EXPORT void dump_log_to_disk(GIOChannel *iochannel)
 
 	write_log_header(iochannel, TRUE);
 
-	histories = g_new0(GArray *,rtv_map->derived_total);
+	histories = g_new0(Rtv_History *,rtv_map->derived_total);
 	precisions = g_new0(gint ,rtv_map->derived_total);
 	info_label = lookup_widget("info_label");
 	if (GTK_IS_LABEL(info_label))
@@ -758,16 +765,18 @@ G_MODULE_EXPORT void dump_log_to_disk(GIOChannel *iochannel)
 	for(i=0;i<rtv_map->derived_total;i++)
 	{
 		object = (gconstpointer *)g_ptr_array_index(rtv_map->rtv_list,i);
-		histories[i] = (GArray *)DATA_GET(object,"history");
+		histories[i] = (Rtv_History *)DATA_GET(object,"history");
 		precisions[i] = (GINT)DATA_GET(object,"precision");
 	}
 
-	for (x=0;x<rtv_map->ts_array->len;x++)
+	for (x=0;x<rtv_map->samples;x++)
 	{
 		j = 0;
 		for(i=0;i<rtv_map->derived_total;i++)
 		{
-			value = g_array_index(histories[i], gfloat, x);
+			g_mutex_lock(rtv_mutex);
+			value = rtv_history_get(histories[i],x);
+			g_mutex_unlock(rtv_mutex);
 			/*tmpbuf = g_ascii_formatd(buf,G_ASCII_DTOSTR_BUF_SIZE,"%1$.*2$f",value,precisions[i]);*/
 			tmpbuf = g_strdelimit(g_strdup_printf("%1$.*2$f",value,precisions[i]),",",'.');
 			g_string_append(output,tmpbuf);
@@ -783,7 +792,7 @@ G_MODULE_EXPORT void dump_log_to_disk(GIOChannel *iochannel)
 		output = g_string_append(output,"\r\n");
 		if (notifies && ((x % notif_divisor) == 0))
 		{
-			msg = g_strdup_printf(_("Flushing Datalog %i of %i records"),x,rtv_map->ts_array->len);
+			msg = g_strdup_printf(_("Flushing Datalog %i of %i records"),x,rtv_map->samples);
 			gtk_label_set_text(GTK_LABEL(info_label),msg);
 			g_free(msg);
 		}
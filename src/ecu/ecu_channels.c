@@ -0,0 +1,164 @@
+/*
+ * ECU Channels - Indexed access to realtime ECU data
+ * 
+ * Copyright (C) 2025 Pat Burke
+ * 
+ * Channel table and name resolution for ECUData fields.
+ */
+
+#include "../../include/ecu/ecu_channels.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FLOAT_CHANNEL(field, label, unit) \
+    { #field, label, unit, ECU_CHANNEL_TYPE_FLOAT, offsetof(ECUData, field) }
+#define BOOL_CHANNEL(field, label) \
+    { #field, label, "", ECU_CHANNEL_TYPE_BOOL, offsetof(ECUData, field) }
+
+// Channel table (indexed by ECUChannelId)
+static const ECUChannelInfo g_channels[ECU_CHANNEL_COUNT] = {
+    FLOAT_CHANNEL(rpm, "RPM", "RPM"),
+    FLOAT_CHANNEL(map, "MAP", "kPa"),
+    FLOAT_CHANNEL(tps, "TPS", "%"),
+    FLOAT_CHANNEL(coolant_temp, "Coolant Temp", "°C"),
+    FLOAT_CHANNEL(intake_temp, "Intake Temp", "°C"),
+    FLOAT_CHANNEL(battery_voltage, "Battery Voltage", "V"),
+    FLOAT_CHANNEL(afr, "AFR", "AFR"),
+    FLOAT_CHANNEL(afr_target, "AFR Target", "AFR"),
+    FLOAT_CHANNEL(timing, "Timing", "°"),
+    FLOAT_CHANNEL(fuel_pressure, "Fuel Pressure", "PSI"),
+    FLOAT_CHANNEL(oil_pressure, "Oil Pressure", "PSI"),
+    FLOAT_CHANNEL(oil_temp, "Oil Temp", "°C"),
+    FLOAT_CHANNEL(boost, "Boost", "PSI"),
+    FLOAT_CHANNEL(boost_target, "Boost Target", "PSI"),
+    FLOAT_CHANNEL(wastegate_duty, "Wastegate Duty", "%"),
+    FLOAT_CHANNEL(fuel_pw1, "Fuel PW1", "ms"),
+    FLOAT_CHANNEL(fuel_pw2, "Fuel PW2", "ms"),
+    FLOAT_CHANNEL(fuel_duty, "Fuel Duty", "%"),
+    FLOAT_CHANNEL(injector_duty, "Injector Duty", "%"),
+    FLOAT_CHANNEL(dwell, "Dwell", "ms"),
+    FLOAT_CHANNEL(spark_advance, "Spark Advance", "°"),
+    FLOAT_CHANNEL(knock_count, "Knock Count", ""),
+    FLOAT_CHANNEL(knock_retard, "Knock Retard", "°"),
+    BOOL_CHANNEL(engine_running, "Engine Running"),
+    BOOL_CHANNEL(engine_cranking, "Engine Cranking"),
+    BOOL_CHANNEL(boost_control_active, "Boost Control Active"),
+    BOOL_CHANNEL(knock_detected, "Knock Detected"),
+    BOOL_CHANNEL(check_engine_light, "Check Engine Light"),
+};
+
+// Common abbreviations used in INI files and alert conditions
+static const struct {
+    const char* alias;
+    int channel;
+} g_aliases[] = {
+    { "clt", ECU_CHANNEL_COOLANT_TEMP },
+    { "coolant", ECU_CHANNEL_COOLANT_TEMP },
+    { "temp", ECU_CHANNEL_COOLANT_TEMP },
+    { "iat", ECU_CHANNEL_INTAKE_TEMP },
+    { "mat", ECU_CHANNEL_INTAKE_TEMP },
+    { "batt", ECU_CHANNEL_BATTERY_VOLTAGE },
+    { "battery", ECU_CHANNEL_BATTERY_VOLTAGE },
+    { "voltage", ECU_CHANNEL_BATTERY_VOLTAGE },
+    { "throttle", ECU_CHANNEL_TPS },
+    { "advance", ECU_CHANNEL_SPARK_ADVANCE },
+    { "knock", ECU_CHANNEL_KNOCK_COUNT },
+    { "pw", ECU_CHANNEL_FUEL_PW1 },
+    { "pw1", ECU_CHANNEL_FUEL_PW1 },
+    { "pw2", ECU_CHANNEL_FUEL_PW2 },
+};
+
+// Lowercase and drop spaces/underscores so "Coolant Temp" matches "coolant_temp"
+static void normalize_name(const char* name, char* out, size_t out_size) {
+    size_t n = 0;
+    for (const char* p = name; *p && n < out_size - 1; p++) {
+        if (*p == ' ' || *p == '_' || *p == '\t') continue;
+        out[n++] = (char)tolower((unsigned char)*p);
+    }
+    out[n] = '\0';
+}
+
+int ecu_channel_lookup(const char* name) {
+    if (!name) return -1;
+    
+    char wanted[64];
+    normalize_name(name, wanted, sizeof(wanted));
+    if (wanted[0] == '\0') return -1;
+    
+    char candidate[64];
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        normalize_name(g_channels[i].name, candidate, sizeof(candidate));
+        if (strcmp(wanted, candidate) == 0) return i;
+    }
+    
+    for (size_t i = 0; i < sizeof(g_aliases) / sizeof(g_aliases[0]); i++) {
+        if (strcmp(wanted, g_aliases[i].alias) == 0) return g_aliases[i].channel;
+    }
+    
+    return -1;
+}
+
+const ECUChannelInfo* ecu_channel_info(int channel) {
+    if (channel < 0 || channel >= ECU_CHANNEL_COUNT) return NULL;
+    return &g_channels[channel];
+}
+
+float ecu_channel_value(const ECUData* data, int channel) {
+    if (!data || channel < 0 || channel >= ECU_CHANNEL_COUNT) return 0.0f;
+    
+    const char* field = (const char*)data + g_channels[channel].offset;
+    if (g_channels[channel].type == ECU_CHANNEL_TYPE_BOOL) {
+        return *(const bool*)field ? 1.0f : 0.0f;
+    }
+    return *(const float*)field;
+}
+
+void ecu_channels_snapshot(const ECUData* data, float* values) {
+    if (!data || !values) return;
+    
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        values[i] = ecu_channel_value(data, i);
+    }
+}
+
+void ecu_channels_snapshot_double(const ECUData* data, double* values) {
+    if (!data || !values) return;
+    
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        values[i] = ecu_channel_value(data, i);
+    }
+}
+
+int ecu_channels_ini_fields(const INIConfig* ini, INIField* fields) {
+    if (!fields) return 0;
+    
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        memset(&fields[i], 0, sizeof(INIField));
+        snprintf(fields[i].name, sizeof(fields[i].name), "%s", g_channels[i].name);
+        snprintf(fields[i].type, sizeof(fields[i].type), "%s", g_channels[i].type == ECU_CHANNEL_TYPE_BOOL ? "U08" : "F32");
+        snprintf(fields[i].units, sizeof(fields[i].units), "%s", g_channels[i].unit);
+        fields[i].scale = 1.0f;
+        fields[i].digits = g_channels[i].type == ECU_CHANNEL_TYPE_BOOL ? 0 : 2;
+    }
+    
+    // First [OutputChannels] entry that resolves to a channel wins, like ecu_find_output_channel()
+    int matched = 0;
+    bool taken[ECU_CHANNEL_COUNT] = {false};
+    for (int i = 0; ini && i < ini->output_channel_count; i++) {
+        const INIField* och = &ini->output_channels[i];
+        int channel = ecu_channel_lookup(och->name);
+        if (channel < 0 || taken[channel]) continue;
+        taken[channel] = true;
+        INIField* field = &fields[channel];
+        snprintf(field->type, sizeof(field->type), "%s", och->type);
+        snprintf(field->units, sizeof(field->units), "%s", och->units);
+        field->scale = och->scale != 0.0f ? och->scale : 1.0f;
+        field->translate = och->translate;
+        field->min_value = och->min_value;
+        field->max_value = och->max_value;
+        field->digits = och->digits;
+        matched++;
+    }
+    return matched;
+}
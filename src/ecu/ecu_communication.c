@@ -17,6 +17,7 @@
 #include <termios.h>
 #include <sys/ioctl.h>
 #include <errno.h>
+#include <time.h>
 
 // Platform-specific serial includes
 #ifdef PLATFORM_WINDOWS
@@ -25,6 +26,9 @@
     #include <sys/select.h>
 #endif
 
+// Frames are published in 32-bit words (see ecu_seqlock.h)
+_Static_assert(sizeof(ECUData) % sizeof(uint32_t) == 0, "ECUData must be a whole number of words");
+
 // ECU Communication Implementation
 ECUContext* ecu_init(void) {
     ECUContext* ctx = malloc(sizeof(ECUContext));
@@ -56,6 +60,8 @@ ECUContext* ecu_init(void) {
     ctx->on_data_update = NULL;
     ctx->on_connection_change = NULL;
     ctx->on_error = NULL;
+    ctx->sample_listener_count = 0;
+    ecu_seqlock_init(&ctx->frame_lock);
     
     // Initialize demo mode
     ctx->demo_mode = false;
@@ -237,6 +243,51 @@ const ECUData* ecu_get_data(ECUContext* ctx) {
     return ctx ? &ctx->data : NULL;
 }
 
+uint32_t ecu_get_frame_id(const ECUContext* ctx) {
+    return ctx ? ecu_seqlock_frame_id(&ctx->frame_lock) : 0;
+}
+
+uint32_t ecu_read_frame(const ECUContext* ctx, ECUData* out) {
+    if (!ctx || !out) {
+        return 0;
+    }
+    return ecu_seqlock_read(&ctx->frame_lock, out, &ctx->frame, sizeof(ECUData));
+}
+
+// Hand a completed ctx->data to everything downstream of acquisition
+static void publish_sample(ECUContext* ctx, uint64_t timestamp_us) {
+    ctx->data.last_update = SDL_GetTicks();
+    ctx->last_heartbeat = ctx->data.last_update;
+    ctx->error_count = 0;
+    
+    // Publish the completed frame for readers on other threads
+    ecu_seqlock_publish(&ctx->frame_lock, &ctx->frame, &ctx->data, sizeof(ECUData));
+    
+    // Call data update callback
+    if (ctx->on_data_update) {
+        ctx->on_data_update(&ctx->data);
+    }
+    
+    // Notify sample listeners with a sub-millisecond timestamp
+    for (int i = 0; i < ctx->sample_listener_count; i++) {
+        ctx->sample_listeners[i].callback(&ctx->data, timestamp_us,
+                                          ctx->sample_listeners[i].user_data);
+    }
+}
+
+bool ecu_inject_sample(ECUContext* ctx, const ECUData* data, uint64_t timestamp_us) {
+    // A live connection owns ctx->data
+    if (!ctx || !data || ctx->state == ECU_STATE_CONNECTED) {
+        return false;
+    }
+    
+    uint32_t connection_time = ctx->data.connection_time;
+    ctx->data = *data;
+    ctx->data.connection_time = connection_time;
+    publish_sample(ctx, timestamp_us);
+    return true;
+}
+
 bool ecu_update(ECUContext* ctx) {
     if (!ctx || ctx->state != ECU_STATE_CONNECTED) {
         return false;
@@ -261,14 +312,7 @@ bool ecu_update(ECUContext* ctx) {
     }
     
     if (success) {
-        ctx->data.last_update = SDL_GetTicks();
-        ctx->last_heartbeat = ctx->data.last_update;
-        ctx->error_count = 0;
-        
-        // Call data update callback
-        if (ctx->on_data_update) {
-            ctx->on_data_update(&ctx->data);
-        }
+        publish_sample(ctx, ecu_get_timestamp_us());
     } else {
         ctx->error_count++;
         if (ctx->error_count > 5) {
@@ -282,6 +326,73 @@ bool ecu_update(ECUContext* ctx) {
     return success;
 }
 
+uint64_t ecu_get_timestamp_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+bool ecu_add_sample_listener(ECUContext* ctx, ECUSampleListener callback, void* user_data) {
+    if (!ctx || !callback) {
+        return false;
+    }
+    
+    for (int i = 0; i < ctx->sample_listener_count; i++) {
+        if (ctx->sample_listeners[i].callback == callback &&
+            ctx->sample_listeners[i].user_data == user_data) {
+            return true;
+        }
+    }
+    
+    if (ctx->sample_listener_count >= ECU_MAX_SAMPLE_LISTENERS) {
+        return false;
+    }
+    
+    ctx->sample_listeners[ctx->sample_listener_count].callback = callback;
+    ctx->sample_listeners[ctx->sample_listener_count].user_data = user_data;
+    ctx->sample_listener_count++;
+    return true;
+}
+
+void ecu_remove_sample_listener(ECUContext* ctx, ECUSampleListener callback, void* user_data) {
+    if (!ctx || !callback) {
+        return;
+    }
+    
+    for (int i = 0; i < ctx->sample_listener_count; i++) {
+        if (ctx->sample_listeners[i].callback == callback &&
+            ctx->sample_listeners[i].user_data == user_data) {
+            memmove(&ctx->sample_listeners[i], &ctx->sample_listeners[i + 1],
+                    (size_t)(ctx->sample_listener_count - i - 1) * sizeof(ECUSampleListenerEntry));
+            ctx->sample_listener_count--;
+            return;
+        }
+    }
+}
+
+void ecu_set_capture(ECUContext* ctx, SerialCapture* capture) {
+    if (ctx) {
+        ctx->capture = capture;
+    }
+}
+
+// All port I/O of a context goes through these so a capture sees every chunk
+static ssize_t ecu_port_read(ECUContext* ctx, int fd, void* buffer, size_t size) {
+    ssize_t bytes_read = read(fd, buffer, size);
+    if (bytes_read > 0 && ctx->capture) {
+        serial_capture_record(ctx->capture, SERIAL_CAPTURE_RX, buffer, (size_t)bytes_read);
+    }
+    return bytes_read;
+}
+
+static ssize_t ecu_port_write(ECUContext* ctx, int fd, const void* buffer, size_t size) {
+    ssize_t bytes_written = write(fd, buffer, size);
+    if (bytes_written > 0 && ctx->capture) {
+        serial_capture_record(ctx->capture, SERIAL_CAPTURE_TX, buffer, (size_t)bytes_written);
+    }
+    return bytes_written;
+}
+
 bool ecu_send_command(ECUContext* ctx, const char* command) {
     if (!ctx || !command || ctx->state != ECU_STATE_CONNECTED) {
         return false;
@@ -301,7 +412,7 @@ bool ecu_send_command(ECUContext* ctx, const char* command) {
     DWORD bytes_written;
     return WriteFile((HANDLE)ctx->serial_handle, ctx->tx_buffer, ctx->tx_count, &bytes_written, NULL);
 #else
-    return write((int)(intptr_t)ctx->serial_handle, ctx->tx_buffer, ctx->tx_count) == ctx->tx_count;
+    return ecu_port_write(ctx, (int)(intptr_t)ctx->serial_handle, ctx->tx_buffer, ctx->tx_count) == ctx->tx_count;
 #endif
 }
 
@@ -644,7 +755,7 @@ static bool speeduino_send_command_and_read(ECUContext* ctx, const char* command
     
     // Send command without line terminator (Speeduino protocol)
     int cmd_len = strlen(command);
-    int bytes_written = write(fd, command, cmd_len);
+    int bytes_written = ecu_port_write(ctx, fd, command, cmd_len);
     if (bytes_written != cmd_len) {
         ecu_set_error(ctx, "Failed to send Speeduino command");
         return false;
@@ -672,7 +783,7 @@ static bool speeduino_send_command_and_read(ECUContext* ctx, const char* command
     }
     
     // Read available data with error checking
-    ssize_t bytes_read = read(fd, response, 256);
+    ssize_t bytes_read = ecu_port_read(ctx, fd, response, 256);
     if (bytes_read <= 0) {
         ecu_set_error(ctx, "Failed to read Speeduino response");
         return false;
@@ -769,7 +880,7 @@ bool ecu_speeduino_connect(ECUContext* ctx) {
         }
         
         // Send CRC packet
-        int bytes_written = write(fd, packet, packet_length);
+        int bytes_written = ecu_port_write(ctx, fd, packet, packet_length);
         if (bytes_written != packet_length) {
             printf("[DEBUG] Failed to send CRC packet for command 0x%02X: %s\n", test_commands[cmd_idx], strerror(errno));
             free(packet);
@@ -805,7 +916,7 @@ bool ecu_speeduino_connect(ECUContext* ctx) {
             
             if (select_result > 0 && FD_ISSET(fd, &read_fds)) {
                 printf("[DEBUG] Attempt %d: Data available, reading...\n", attempt);
-                int bytes_read = read(fd, test_response + test_response_length, sizeof(test_response) - test_response_length);
+                int bytes_read = ecu_port_read(ctx, fd, test_response + test_response_length, sizeof(test_response) - test_response_length);
                 printf("[DEBUG] Attempt %d: read() returned %d\n", attempt, bytes_read);
                 if (bytes_read > 0) {
                     test_response_length += bytes_read;
@@ -882,7 +993,7 @@ bool ecu_speeduino_connect(ECUContext* ctx) {
             tcflush(fd, TCIOFLUSH);
             
             // Send ASCII command
-            int bytes_written = write(fd, ascii_commands[cmd_idx], strlen(ascii_commands[cmd_idx]));
+            int bytes_written = ecu_port_write(ctx, fd, ascii_commands[cmd_idx], strlen(ascii_commands[cmd_idx]));
             if (bytes_written != strlen(ascii_commands[cmd_idx])) {
                 printf("[DEBUG] Failed to send ASCII command '%s': %s\n", ascii_commands[cmd_idx], strerror(errno));
                 continue;
@@ -906,7 +1017,7 @@ bool ecu_speeduino_connect(ECUContext* ctx) {
             }
             
             // Read response
-            test_response_length = read(fd, test_response, sizeof(test_response));
+            test_response_length = ecu_port_read(ctx, fd, test_response, sizeof(test_response));
             if (test_response_length <= 0) {
                 printf("[DEBUG] Failed to read ASCII response to '%s': %s\n", ascii_commands[cmd_idx], strerror(errno));
                 continue;
@@ -987,7 +1098,7 @@ bool ecu_speeduino_update(ECUContext* ctx) {
         tcflush(fd, TCIOFLUSH);
         
         // Send packet
-        int bytes_written = write(fd, packet, packet_length);
+        int bytes_written = ecu_port_write(ctx, fd, packet, packet_length);
         
         // Update TX statistics
         if (bytes_written > 0) {
@@ -1017,7 +1128,7 @@ bool ecu_speeduino_update(ECUContext* ctx) {
                 int select_result = select(fd + 1, &read_fds, NULL, NULL, &timeout);
                 
                 if (select_result > 0 && FD_ISSET(fd, &read_fds)) {
-                    int bytes_read = read(fd, response + response_length, sizeof(response) - response_length);
+                    int bytes_read = ecu_port_read(ctx, fd, response + response_length, sizeof(response) - response_length);
                     if (bytes_read > 0) {
                         response_length += bytes_read;
                         printf("[DEBUG] Read %d bytes (total: %d)\n", bytes_read, response_length);
@@ -1157,7 +1268,7 @@ bool ecu_megasquirt_update(ECUContext* ctx) {
     
     // Read response (simplified - in real implementation would parse binary data)
     uint8_t buffer[256];
-    int bytes_read = read((int)(intptr_t)ctx->serial_handle, buffer, sizeof(buffer));
+    int bytes_read = ecu_port_read(ctx, (int)(intptr_t)ctx->serial_handle, buffer, sizeof(buffer));
     
     if (bytes_read > 0) {
         // Parse MegaSquirt data (simplified)
@@ -1194,7 +1305,7 @@ bool ecu_libreems_update(ECUContext* ctx) {
     
     // Read response (simplified)
     uint8_t buffer[256];
-    int bytes_read = read((int)(intptr_t)ctx->serial_handle, buffer, sizeof(buffer));
+    int bytes_read = ecu_port_read(ctx, (int)(intptr_t)ctx->serial_handle, buffer, sizeof(buffer));
     
     if (bytes_read > 0) {
         // Parse LibreEMS data (simplified)
@@ -1557,7 +1668,7 @@ static bool epicefi_send_command_and_read(ECUContext* ctx, const char* command,
     char cmd_with_newline[256];
     snprintf(cmd_with_newline, sizeof(cmd_with_newline), "%s\n", command);
     int cmd_len = strlen(cmd_with_newline);
-    int bytes_written = write(fd, cmd_with_newline, cmd_len);
+    int bytes_written = ecu_port_write(ctx, fd, cmd_with_newline, cmd_len);
     if (bytes_written != cmd_len) {
         ecu_set_error(ctx, "Failed to send EpicEFI command");
         return false;
@@ -1581,7 +1692,7 @@ static bool epicefi_send_command_and_read(ECUContext* ctx, const char* command,
     }
     
     // Read available data
-    *response_length = read(fd, response, 256);
+    *response_length = ecu_port_read(ctx, fd, response, 256);
     if (*response_length <= 0) {
         ecu_set_error(ctx, "Failed to read EpicEFI response");
         return false;
@@ -72,6 +72,7 @@ INIConfig* ecu_load_ini_file(const char* file_path) {
     ecu_parse_tunerstudio_section(content, config);
     ecu_parse_constants_section(content, config);
     ecu_parse_megatune_section(content, config);
+    ecu_parse_output_channels_section(content, config);
     
     // Parse table dimensions
     ecu_parse_table_dimensions(content, config);
@@ -99,6 +100,10 @@ void ecu_free_ini_config(INIConfig* config) {
         config->table_capacity = 0;
     }
     
+    free(config->output_channels);
+    config->output_channels = NULL;
+    config->output_channel_count = 0;
+    
     // Free the config structure itself
     free(config);
 }
@@ -195,6 +200,121 @@ bool ecu_parse_megatune_section(const char* content, INIConfig* config) {
     return true;
 }
 
+// Copy the next comma-separated field of a definition, trimmed and unquoted
+static const char* next_definition_field(const char* cursor, char* out, size_t out_size) {
+    if (!cursor) return NULL;
+    while (*cursor == ' ' || *cursor == '\t') cursor++;
+    const char* end = cursor;
+    bool quoted = false;
+    while (*end && *end != '\n' && *end != '\r' && (quoted || (*end != ',' && *end != ';'))) {
+        if (*end == '"') quoted = !quoted;
+        end++;
+    }
+    const char* last = end;
+    while (last > cursor && (last[-1] == ' ' || last[-1] == '\t')) last--;
+    if (last - cursor >= 2 && *cursor == '"' && last[-1] == '"') {
+        cursor++;
+        last--;
+    }
+    size_t len = (size_t)(last - cursor);
+    if (len >= out_size) len = out_size - 1;
+    memcpy(out, cursor, len);
+    out[len] = '\0';
+    return *end == ',' ? end + 1 : NULL;
+}
+
+// [OutputChannels] scalar definitions:
+//   rpm     = scalar, U16, 14, "RPM", 1.000, 0.000
+//   coolant = scalar, U08, 7, "C", 1.000, -40.000
+// Bit fields and computed channels ({ expressions }) have no fixed raw
+// representation and are skipped. Where #if branches define a channel
+// twice the first definition wins.
+bool ecu_parse_output_channels_section(const char* content, INIConfig* config) {
+    if (!content || !config) return false;
+    
+    const char* line = strstr(content, "[OutputChannels]");
+    if (!line) return false;
+    line = strchr(line, '\n');
+    
+    int capacity = 0;
+    while (line && *line) {
+        line++;
+        while (*line == ' ' || *line == '\t') line++;
+        const char* next = strchr(line, '\n');
+        if (*line == '[') break;    // Next section
+        
+        const char* equals = strchr(line, '=');
+        if (*line == ';' || *line == '#' || !equals || (next && equals > next)) {
+            line = next;
+            continue;
+        }
+        
+        char name[64];
+        size_t name_len = (size_t)(equals - line);
+        while (name_len > 0 && isspace((unsigned char)line[name_len - 1])) name_len--;
+        if (name_len == 0 || name_len >= sizeof(name)) {
+            line = next;
+            continue;
+        }
+        memcpy(name, line, name_len);
+        name[name_len] = '\0';
+        
+        char kind[16];
+        char type[16];
+        char offset[16];
+        const char* cursor = next_definition_field(equals + 1, kind, sizeof(kind));
+        if (strcmp(kind, "scalar") != 0) {
+            // ochBlockSize and friends are plain settings in the same section
+            if (strcmp(name, "ochBlockSize") == 0) config->och_block_size = atoi(kind);
+            line = next;
+            continue;
+        }
+        
+        INIField field;
+        memset(&field, 0, sizeof(field));
+        char number[32];
+        snprintf(field.name, sizeof(field.name), "%s", name);
+        cursor = next_definition_field(cursor, type, sizeof(type));
+        snprintf(field.type, sizeof(field.type), "%s", type);
+        cursor = next_definition_field(cursor, offset, sizeof(offset));
+        field.offset = atoi(offset);
+        cursor = next_definition_field(cursor, field.units, sizeof(field.units));
+        field.scale = 1.0f;
+        if (cursor) {
+            cursor = next_definition_field(cursor, number, sizeof(number));
+            if (number[0] && number[0] != '{') field.scale = strtof(number, NULL);
+        }
+        if (cursor) {
+            next_definition_field(cursor, number, sizeof(number));
+            if (number[0] && number[0] != '{') field.translate = strtof(number, NULL);
+        }
+        
+        if (!ecu_find_output_channel(config, field.name)) {
+            if (config->output_channel_count >= capacity) {
+                int new_capacity = capacity ? capacity * 2 : 64;
+                INIField* grown = (INIField*)realloc(config->output_channels, new_capacity * sizeof(INIField));
+                if (!grown) return false;
+                config->output_channels = grown;
+                capacity = new_capacity;
+            }
+            config->output_channels[config->output_channel_count++] = field;
+        }
+        line = next;
+    }
+    
+    return config->output_channel_count > 0;
+}
+
+const INIField* ecu_find_output_channel(const INIConfig* config, const char* name) {
+    if (!config || !name) return NULL;
+    for (int i = 0; i < config->output_channel_count; i++) {
+        if (strcmp(config->output_channels[i].name, name) == 0) {
+            return &config->output_channels[i];
+        }
+    }
+    return NULL;
+}
+
 bool ecu_parse_ini_section(const char* content, const char* section_name, INIConfig* config) {
     if (!content || !section_name || !config) {
         return false;
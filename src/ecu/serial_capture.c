@@ -0,0 +1,535 @@
+/*
+ * Serial Capture - Raw ECU traffic recording and replay
+ *
+ * Copyright (C) 2025 Pat Burke
+ *
+ * Ring positions grow without bound; position % capacity is the offset in
+ * the ring. The writer moves the tail past the records it is about to
+ * overwrite before it writes, and the head past a record once it is
+ * complete, so [tail, head) always holds whole records.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     // ptsname_r, pipe2, ppoll
+#endif
+#include "../../include/ecu/serial_capture.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RECORD_SIZE sizeof(SerialCaptureRecord)
+#define MIN_CAPACITY (64u << 10)
+
+struct SerialCapture {
+    int fd;
+    uint8_t* map;
+    size_t map_size;
+    SerialCaptureHeader* header;
+    uint8_t* ring;
+    uint64_t capacity;
+    uint64_t start_us;          // Monotonic clock at creation
+    uint64_t bytes;
+    pthread_mutex_t lock;       // Reads and writes may come from different threads
+};
+
+struct SerialCaptureReader {
+    uint8_t* map;
+    size_t map_size;
+    const SerialCaptureHeader* header;
+    const uint8_t* ring;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t position;
+};
+
+struct SerialReplay {
+    SerialCaptureReader* reader;
+    SerialReplayConfig config;
+    int master;
+    int slave;                  // Held open so the master survives the host closing the port
+    int stop_pipe[2];
+    char port[64];
+    pthread_t thread;
+
+    // Statistics; written by the replay thread
+    int running;
+    int finished;
+    uint64_t chunks;
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t tx_mismatches;
+    uint64_t tx_timeouts;
+    uint32_t late_max_us;
+};
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint64_t record_span(uint32_t length) {
+    return (RECORD_SIZE + length + 7) & ~(uint64_t)7;
+}
+
+// ---------------------------------------------------------------------------
+// Recording
+
+SerialCapture* serial_capture_create(const char* path, size_t capacity, const char* port, int baud_rate) {
+    if (!path) {
+        return NULL;
+    }
+    if (capacity == 0) {
+        capacity = SERIAL_CAPTURE_DEFAULT_CAPACITY;
+    }
+    capacity = (capacity + 7) & ~(size_t)7;
+    if (capacity < MIN_CAPACITY) {
+        capacity = MIN_CAPACITY;
+    }
+
+    SerialCapture* capture = calloc(1, sizeof(SerialCapture));
+    if (!capture) {
+        return NULL;
+    }
+    capture->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    capture->map_size = SERIAL_CAPTURE_HEADER_SIZE + capacity;
+    if (capture->fd < 0 || ftruncate(capture->fd, (off_t)capture->map_size) != 0) {
+        if (capture->fd >= 0) {
+            close(capture->fd);
+        }
+        free(capture);
+        return NULL;
+    }
+    capture->map = mmap(NULL, capture->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, capture->fd, 0);
+    if (capture->map == MAP_FAILED) {
+        close(capture->fd);
+        free(capture);
+        return NULL;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    capture->header = (SerialCaptureHeader*)capture->map;
+    capture->ring = capture->map + SERIAL_CAPTURE_HEADER_SIZE;
+    capture->capacity = capacity;
+    capture->start_us = monotonic_us();
+    capture->header->version = SERIAL_CAPTURE_VERSION;
+    capture->header->header_size = SERIAL_CAPTURE_HEADER_SIZE;
+    capture->header->capacity = capacity;
+    capture->header->start_time_us = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    capture->header->baud_rate = baud_rate;
+    snprintf(capture->header->port, sizeof(capture->header->port), "%s", port ? port : "");
+    // The magic goes in last so a reader never sees a half-made header
+    __atomic_store_n(&capture->header->magic, SERIAL_CAPTURE_MAGIC, __ATOMIC_RELEASE);
+    pthread_mutex_init(&capture->lock, NULL);
+    return capture;
+}
+
+// Drop the oldest records until the ring has room up to position end
+static void make_room(SerialCapture* capture, uint64_t end) {
+    SerialCaptureHeader* header = capture->header;
+    uint64_t tail = header->tail;
+    while (end - tail > capture->capacity) {
+        uint64_t remain = capture->capacity - tail % capture->capacity;
+        if (remain < RECORD_SIZE) {
+            tail += remain;
+            continue;
+        }
+        const SerialCaptureRecord* record = (const SerialCaptureRecord*)(capture->ring + tail % capture->capacity);
+        if (record->direction != SERIAL_CAPTURE_PAD) {
+            header->dropped_chunks++;
+        }
+        tail += record_span(record->length);
+    }
+    __atomic_store_n(&header->tail, tail, __ATOMIC_RELEASE);
+}
+
+static void record_chunk(SerialCapture* capture, SerialCaptureDirection direction, const uint8_t* data, uint32_t length, uint64_t timestamp_us) {
+    SerialCaptureHeader* header = capture->header;
+    uint64_t position = header->head;
+    uint64_t span = record_span(length);
+    uint64_t remain = capture->capacity - position % capture->capacity;
+
+    if (remain < span) {
+        make_room(capture, position + remain);
+        if (remain >= RECORD_SIZE) {
+            SerialCaptureRecord pad = { timestamp_us, (uint32_t)(remain - RECORD_SIZE), SERIAL_CAPTURE_PAD, { 0 } };
+            memcpy(capture->ring + position % capture->capacity, &pad, RECORD_SIZE);
+        }
+        position += remain;
+    }
+    make_room(capture, position + span);
+
+    SerialCaptureRecord record = { timestamp_us, length, (uint8_t)direction, { 0 } };
+    uint8_t* at = capture->ring + position % capture->capacity;
+    memcpy(at, &record, RECORD_SIZE);
+    memcpy(at + RECORD_SIZE, data, length);
+    __atomic_store_n(&header->head, position + span, __ATOMIC_RELEASE);
+    header->chunk_count++;
+}
+
+void serial_capture_record(SerialCapture* capture, SerialCaptureDirection direction, const void* data, size_t length) {
+    if (!capture || !data || length == 0) {
+        return;
+    }
+    uint64_t timestamp_us = monotonic_us() - capture->start_us;
+    const uint8_t* bytes = data;
+
+    pthread_mutex_lock(&capture->lock);
+    while (length > 0) {
+        uint32_t piece = length < SERIAL_CAPTURE_MAX_CHUNK ? (uint32_t)length : SERIAL_CAPTURE_MAX_CHUNK;
+        record_chunk(capture, direction, bytes, piece, timestamp_us);
+        capture->bytes += piece;
+        bytes += piece;
+        length -= piece;
+    }
+    pthread_mutex_unlock(&capture->lock);
+}
+
+bool serial_capture_sync(SerialCapture* capture) {
+    return capture && msync(capture->map, capture->map_size, MS_SYNC) == 0;
+}
+
+void serial_capture_close(SerialCapture* capture) {
+    if (!capture) {
+        return;
+    }
+    msync(capture->map, capture->map_size, MS_SYNC);
+    munmap(capture->map, capture->map_size);
+    close(capture->fd);
+    pthread_mutex_destroy(&capture->lock);
+    free(capture);
+}
+
+uint64_t serial_capture_chunk_count(const SerialCapture* capture) {
+    return capture ? capture->header->chunk_count : 0;
+}
+
+uint64_t serial_capture_bytes(const SerialCapture* capture) {
+    return capture ? capture->bytes : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+
+SerialCaptureReader* serial_capture_open(const char* path) {
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < SERIAL_CAPTURE_HEADER_SIZE + MIN_CAPACITY) {
+        close(fd);
+        return NULL;
+    }
+    // A private mapping is a snapshot that a live writer can't change under us
+    uint8_t* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    const SerialCaptureHeader* header = (const SerialCaptureHeader*)map;
+    if (header->magic != SERIAL_CAPTURE_MAGIC || header->version != SERIAL_CAPTURE_VERSION ||
+        header->header_size != SERIAL_CAPTURE_HEADER_SIZE || header->capacity % 8 != 0 ||
+        header->capacity > (uint64_t)st.st_size - SERIAL_CAPTURE_HEADER_SIZE ||
+        header->head < header->tail || header->head - header->tail > header->capacity) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    SerialCaptureReader* reader = calloc(1, sizeof(SerialCaptureReader));
+    if (!reader) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    reader->map = map;
+    reader->map_size = (size_t)st.st_size;
+    reader->header = header;
+    reader->ring = map + SERIAL_CAPTURE_HEADER_SIZE;
+    reader->head = header->head;
+    reader->tail = header->tail;
+    reader->position = reader->tail;
+    return reader;
+}
+
+void serial_capture_close_reader(SerialCaptureReader* reader) {
+    if (!reader) {
+        return;
+    }
+    munmap(reader->map, reader->map_size);
+    free(reader);
+}
+
+const SerialCaptureHeader* serial_capture_header(const SerialCaptureReader* reader) {
+    return reader ? reader->header : NULL;
+}
+
+bool serial_capture_next(SerialCaptureReader* reader, SerialCaptureChunk* chunk) {
+    if (!reader || !chunk) {
+        return false;
+    }
+    uint64_t capacity = reader->header->capacity;
+    while (reader->position < reader->head) {
+        uint64_t offset = reader->position % capacity;
+        uint64_t remain = capacity - offset;
+        if (remain < RECORD_SIZE) {
+            reader->position += remain;
+            continue;
+        }
+        const SerialCaptureRecord* record = (const SerialCaptureRecord*)(reader->ring + offset);
+        uint64_t span = record_span(record->length);
+        if (span > remain || reader->position + span > reader->head) {
+            // Damaged; nothing after it can be trusted
+            reader->position = reader->head;
+            return false;
+        }
+        reader->position += span;
+        if (record->direction == SERIAL_CAPTURE_PAD) {
+            continue;
+        }
+        chunk->timestamp_us = record->timestamp_us;
+        chunk->direction = (SerialCaptureDirection)record->direction;
+        chunk->length = record->length;
+        chunk->data = (const uint8_t*)(record + 1);
+        return true;
+    }
+    return false;
+}
+
+void serial_capture_rewind(SerialCaptureReader* reader) {
+    if (reader) {
+        reader->position = reader->tail;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+
+// Wait for the master to be readable (or writable), a stop or the deadline.
+// Returns 1 when ready, 0 on timeout, -1 once stopped.
+static int replay_poll(SerialReplay* replay, short events, uint64_t deadline_us) {
+    for (;;) {
+        struct pollfd fds[2] = { { replay->stop_pipe[0], POLLIN, 0 }, { replay->master, events, 0 } };
+        // ppoll: response timing needs better than poll()'s milliseconds
+        uint64_t now = monotonic_us();
+        uint64_t wait_us = now >= deadline_us ? 0 : deadline_us - now;
+        struct timespec timeout = { (time_t)(wait_us / 1000000), (long)(wait_us % 1000000) * 1000 };
+        int result = ppoll(fds, events ? 2 : 1, deadline_us == UINT64_MAX ? NULL : &timeout, NULL);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0 || fds[0].revents) {
+            return -1;
+        }
+        if (result > 0 && fds[1].revents) {
+            return 1;
+        }
+        if (monotonic_us() >= deadline_us) {
+            return 0;
+        }
+    }
+}
+
+// Sleep until due. Without wait_for_tx the host's requests are read and
+// dropped meanwhile so its writes never block.
+static bool replay_sleep_until(SerialReplay* replay, uint64_t due_us) {
+    uint8_t sink[256];
+    for (;;) {
+        int ready = replay_poll(replay, replay->config.wait_for_tx ? 0 : POLLIN, due_us);
+        if (ready < 0) {
+            return false;
+        }
+        if (ready == 0) {
+            return true;
+        }
+        ssize_t n = read(replay->master, sink, sizeof(sink));
+        if (n > 0) {
+            __atomic_add_fetch(&replay->tx_bytes, (uint64_t)n, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// Read the host's version of a recorded request
+static bool replay_expect_tx(SerialReplay* replay, const SerialCaptureChunk* chunk) {
+    uint32_t timeout_ms = replay->config.tx_timeout_ms ? replay->config.tx_timeout_ms : 2000;
+    uint64_t deadline = monotonic_us() + (uint64_t)timeout_ms * 1000;
+    uint8_t buffer[SERIAL_CAPTURE_MAX_CHUNK];
+    uint32_t got = 0;
+
+    while (got < chunk->length) {
+        int ready = replay_poll(replay, POLLIN, deadline);
+        if (ready < 0) {
+            return false;
+        }
+        if (ready == 0) {
+            __atomic_add_fetch(&replay->tx_timeouts, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        ssize_t n = read(replay->master, buffer + got, chunk->length - got);
+        if (n > 0) {
+            got += (uint32_t)n;
+        }
+    }
+    __atomic_add_fetch(&replay->tx_bytes, got, __ATOMIC_RELAXED);
+    if (got == chunk->length && memcmp(buffer, chunk->data, got) != 0) {
+        __atomic_add_fetch(&replay->tx_mismatches, 1, __ATOMIC_RELAXED);
+    }
+    return true;
+}
+
+static bool replay_send_rx(SerialReplay* replay, const SerialCaptureChunk* chunk) {
+    uint32_t sent = 0;
+    while (sent < chunk->length) {
+        ssize_t n = write(replay->master, chunk->data + sent, chunk->length - sent);
+        if (n > 0) {
+            sent += (uint32_t)n;
+        } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            return false;
+        } else if (replay_poll(replay, POLLOUT, UINT64_MAX) < 0) {
+            return false;
+        }
+    }
+    __atomic_add_fetch(&replay->rx_bytes, sent, __ATOMIC_RELAXED);
+    return true;
+}
+
+static void* replay_thread(void* arg) {
+    SerialReplay* replay = arg;
+    SerialCaptureChunk chunk;
+    double speed = replay->config.speed;
+    uint64_t anchor_us = monotonic_us();
+    uint64_t anchor_ts = 0;
+    bool anchored = false;
+    bool ok = true;
+
+    while (ok && serial_capture_next(replay->reader, &chunk)) {
+        if (!anchored) {
+            anchor_ts = chunk.timestamp_us;
+            anchored = true;
+        }
+        if (chunk.direction == SERIAL_CAPTURE_TX) {
+            if (replay->config.wait_for_tx) {
+                // Responses are timed from the request that prompted them
+                ok = replay_expect_tx(replay, &chunk);
+                anchor_us = monotonic_us();
+                anchor_ts = chunk.timestamp_us;
+            }
+        } else {
+            if (speed > 0.0) {
+                uint64_t due = anchor_us + (uint64_t)((double)(chunk.timestamp_us - anchor_ts) / speed);
+                ok = replay_sleep_until(replay, due);
+                uint64_t now = monotonic_us();
+                if (ok && now > due) {
+                    uint32_t late = (uint32_t)(now - due < UINT32_MAX ? now - due : UINT32_MAX);
+                    if (late > replay->late_max_us) {
+                        __atomic_store_n(&replay->late_max_us, late, __ATOMIC_RELAXED);
+                    }
+                }
+            }
+            ok = ok && replay_send_rx(replay, &chunk);
+        }
+        if (ok) {
+            __atomic_add_fetch(&replay->chunks, 1, __ATOMIC_RELAXED);
+        }
+    }
+    if (ok) {
+        __atomic_store_n(&replay->finished, 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&replay->running, 0, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void replay_free(SerialReplay* replay) {
+    if (replay->master >= 0) close(replay->master);
+    if (replay->slave >= 0) close(replay->slave);
+    if (replay->stop_pipe[0] >= 0) close(replay->stop_pipe[0]);
+    if (replay->stop_pipe[1] >= 0) close(replay->stop_pipe[1]);
+    serial_capture_close_reader(replay->reader);
+    free(replay);
+}
+
+SerialReplay* serial_replay_start(const char* capture_path, const SerialReplayConfig* config) {
+    SerialReplay* replay = calloc(1, sizeof(SerialReplay));
+    if (!replay) {
+        return NULL;
+    }
+    replay->master = replay->slave = -1;
+    replay->stop_pipe[0] = replay->stop_pipe[1] = -1;
+    if (config) {
+        replay->config = *config;
+    } else {
+        replay->config.speed = 1.0;
+        replay->config.wait_for_tx = true;
+    }
+
+    replay->reader = serial_capture_open(capture_path);
+    replay->master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (!replay->reader || replay->master < 0 || grantpt(replay->master) != 0 ||
+        unlockpt(replay->master) != 0 ||
+        ptsname_r(replay->master, replay->port, sizeof(replay->port)) != 0 ||
+        pipe2(replay->stop_pipe, O_CLOEXEC) != 0) {
+        replay_free(replay);
+        return NULL;
+    }
+
+    // Raw from the start: a host that only clears some flags still gets no echo
+    replay->slave = open(replay->port, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    struct termios tty;
+    if (replay->slave < 0 || tcgetattr(replay->slave, &tty) != 0) {
+        replay_free(replay);
+        return NULL;
+    }
+    cfmakeraw(&tty);
+    tcsetattr(replay->slave, TCSANOW, &tty);
+
+    replay->running = 1;
+    if (pthread_create(&replay->thread, NULL, replay_thread, replay) != 0) {
+        replay_free(replay);
+        return NULL;
+    }
+    return replay;
+}
+
+const char* serial_replay_port(const SerialReplay* replay) {
+    return replay ? replay->port : NULL;
+}
+
+void serial_replay_get_stats(const SerialReplay* replay, SerialReplayStats* stats) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (!replay) {
+        return;
+    }
+    SerialReplay* r = (SerialReplay*)replay;
+    stats->running = __atomic_load_n(&r->running, __ATOMIC_ACQUIRE) != 0;
+    stats->finished = __atomic_load_n(&r->finished, __ATOMIC_ACQUIRE) != 0;
+    stats->chunks = __atomic_load_n(&r->chunks, __ATOMIC_RELAXED);
+    stats->rx_bytes = __atomic_load_n(&r->rx_bytes, __ATOMIC_RELAXED);
+    stats->tx_bytes = __atomic_load_n(&r->tx_bytes, __ATOMIC_RELAXED);
+    stats->tx_mismatches = __atomic_load_n(&r->tx_mismatches, __ATOMIC_RELAXED);
+    stats->tx_timeouts = __atomic_load_n(&r->tx_timeouts, __ATOMIC_RELAXED);
+    stats->late_max_us = __atomic_load_n(&r->late_max_us, __ATOMIC_RELAXED);
+}
+
+void serial_replay_stop(SerialReplay* replay) {
+    if (!replay) {
+        return;
+    }
+    char byte = 0;
+    ssize_t written = write(replay->stop_pipe[1], &byte, 1);
+    (void)written;
+    pthread_join(replay->thread, NULL);
+    replay_free(replay);
+}
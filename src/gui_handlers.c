@@ -991,6 +991,12 @@ G_MODULE_EXPORT gboolean spin_button_handler(GtkWidget *widget, gpointer data)
 				lv_configure_event(lookup_widget("logviewer_trace_darea"),NULL,NULL);
 			/*	g_signal_emit_by_name(tmpwidget,"configure_event",NULL);*/
 			break;
+		case LOGVIEW_SPAN:
+			DATA_SET(global_data,"lv_span",GINT_TO_POINTER(MAX(tmpi,1)));
+			tmpwidget = lookup_widget("logviewer_trace_darea");	
+			if (tmpwidget)
+				lv_configure_event(lookup_widget("logviewer_trace_darea"),NULL,NULL);
+			break;
 		default:
 			if (!common_handler)
 			{
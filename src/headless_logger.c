@@ -0,0 +1,418 @@
+/*
+ * MegaTunix Redux - Headless Datalogger
+ *
+ * Copyright (C) 2025 Pat Burke
+ *
+ * Connects to the ECU, polls it as fast as the protocol driver allows and
+ * writes every sample through the datalog manager, with no window, GL
+ * context or frame pacing in the way. Periodic stats (samples/s, request to
+ * sample latency p50/p99, bytes written) go to stderr; the drivers' debug
+ * output on stdout is discarded unless --verbose is given.
+ *
+ *   megatunix-logger --port /dev/ttyACM0 [--protocol speeduino] [--format binary]
+ *                    [--output dir] [--duration s] [--stats-interval s]
+ */
+
+#include "ecu/ecu_channels.h"
+#include "ecu/ecu_communication.h"
+#include "ecu/serial_capture.h"
+#include "data/datalog_manager.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RECONNECT_DELAY_US 1000000
+
+// Latency histogram: exact below 16 us, then 16 linear steps per power of two
+#define LATENCY_SUB_BITS 4
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((32 - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT)
+
+typedef struct {
+    uint64_t buckets[LATENCY_BUCKETS];
+    uint64_t count;
+    uint64_t max_us;
+} LatencyHistogram;
+
+typedef struct {
+    const char* port;
+    const char* ini_path;
+    ECUProtocol protocol;
+    int baud_rate;
+    DatalogFormat format;
+    const char* output_directory;
+    const char* session_name;
+    double duration_s;
+    double stats_interval_s;
+    const char* capture_path;
+    const char* replay_path;
+    double replay_speed;
+    bool verbose;
+} LoggerOptions;
+
+typedef struct {
+    const char* names[ECU_CHANNEL_COUNT];
+    uint64_t request_start_us;      // Set before every ecu_update()
+    uint64_t samples;
+    uint64_t log_failures;
+    LatencyHistogram interval;      // Reset after every stats line
+    LatencyHistogram total;
+} LoggerState;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void handle_signal(int signal_number) {
+    (void)signal_number;
+    g_stop = 1;
+}
+
+static int latency_bucket(uint64_t us) {
+    if (us > UINT32_MAX) {
+        us = UINT32_MAX;
+    }
+    if (us < LATENCY_SUB_COUNT) {
+        return (int)us;
+    }
+    int octave = 63 - __builtin_clzll(us);
+    int sub = (int)(us >> (octave - LATENCY_SUB_BITS)) & (LATENCY_SUB_COUNT - 1);
+    return (octave - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT + sub;
+}
+
+// Middle of the bucket's range
+static double latency_bucket_value(int bucket) {
+    if (bucket < LATENCY_SUB_COUNT) {
+        return bucket;
+    }
+    int octave = bucket / LATENCY_SUB_COUNT + LATENCY_SUB_BITS - 1;
+    int sub = bucket % LATENCY_SUB_COUNT;
+    double step = (double)(1ull << (octave - LATENCY_SUB_BITS));
+    return (LATENCY_SUB_COUNT + sub) * step + step / 2.0;
+}
+
+static void latency_add(LatencyHistogram* histogram, uint64_t us) {
+    histogram->buckets[latency_bucket(us)]++;
+    histogram->count++;
+    if (us > histogram->max_us) {
+        histogram->max_us = us;
+    }
+}
+
+static double latency_percentile_ms(const LatencyHistogram* histogram, double fraction) {
+    if (histogram->count == 0) {
+        return 0.0;
+    }
+    uint64_t rank = (uint64_t)(fraction * histogram->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            double us = latency_bucket_value(i);
+            return (us > histogram->max_us ? histogram->max_us : us) / 1000.0;
+        }
+    }
+    return histogram->max_us / 1000.0;
+}
+
+static void on_sample(const ECUData* data, uint64_t timestamp_us, void* user_data) {
+    LoggerState* state = user_data;
+    double values[ECU_CHANNEL_COUNT];
+
+    ecu_channels_snapshot_double(data, values);
+    if (!datalog_manager_log_multiple(state->names, values, ECU_CHANNEL_COUNT)) {
+        state->log_failures++;
+    }
+
+    // Samples published outside ecu_update() (e.g. during connect) have no request
+    if (state->request_start_us && timestamp_us >= state->request_start_us) {
+        uint64_t latency_us = timestamp_us - state->request_start_us;
+        latency_add(&state->interval, latency_us);
+        latency_add(&state->total, latency_us);
+    }
+    state->samples++;
+}
+
+static bool connect_ecu(ECUContext* ctx, const LoggerOptions* options, const char* port) {
+    if (options->ini_path) {
+        return ecu_connect_with_ini(ctx, port, options->ini_path);
+    }
+
+    ECUConfig config;
+    switch (options->protocol) {
+        case ECU_PROTOCOL_EPICEFI:
+            config = ecu_config_epicefi();
+            break;
+        case ECU_PROTOCOL_MEGASQUIRT:
+            config = ecu_config_megasquirt();
+            break;
+        case ECU_PROTOCOL_LIBREEMS:
+            config = ecu_config_libreems();
+            break;
+        default:
+            config = ecu_config_speeduino();
+            break;
+    }
+    strncpy(config.port, port, sizeof(config.port) - 1);
+    config.port[sizeof(config.port) - 1] = '\0';
+    if (options->baud_rate > 0) {
+        config.baud_rate = options->baud_rate;
+    }
+    return ecu_connect(ctx, &config);
+}
+
+static bool parse_format(const char* name, DatalogFormat* format) {
+    if (strcasecmp(name, "csv") == 0) {
+        *format = DATALOG_FORMAT_CSV;
+    } else if (strcasecmp(name, "binary") == 0 || strcasecmp(name, "bin") == 0) {
+        *format = DATALOG_FORMAT_BINARY;
+    } else if (strcasecmp(name, "mlg") == 0) {
+        *format = DATALOG_FORMAT_MLG;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s --port <device> [options]\n", program);
+    printf("Options:\n");
+    printf("  --port <device>               ECU serial port\n");
+    printf("  --ini <file>                  Detect protocol and port settings from an ECU INI\n");
+    printf("  --protocol <name>             speeduino, epicefi, megasquirt or libreems (default speeduino)\n");
+    printf("  --baud <rate>                 Override the protocol's baud rate\n");
+    printf("  --format <csv|binary|mlg>     Log format (default binary)\n");
+    printf("  --output <dir>                Directory for the log (default .)\n");
+    printf("  --session <name>              Session name (default session)\n");
+    printf("  --duration <s>                Stop after s seconds (default: until interrupted)\n");
+    printf("  --stats-interval <s>          Seconds between stats lines, 0 = summary only (default 1)\n");
+    printf("  --capture-serial <file>       Record raw ECU port traffic to a ring file\n");
+    printf("  --replay-serial <file>        Log from a serial capture served on a pseudo-terminal\n");
+    printf("  --replay-serial-speed <x>     Serial replay timing (1 = recorded, 0 = no delays)\n");
+    printf("  --verbose                     Keep the protocol drivers' debug output\n");
+    printf("  --help, -h                    Show this help message\n");
+}
+
+static void print_stats(const LoggerState* state, const LatencyHistogram* latency, uint64_t samples,
+                        double elapsed_s, const char* label) {
+    DatalogWriterStats writer = {0};
+    datalog_manager_get_writer_stats(&writer);
+    fprintf(stderr, "%s %8.1f s  %8.1f samples/s  latency p50 %.2f ms p99 %.2f ms max %.2f ms  "
+            "written %.2f MB  dropped %llu\n",
+            label, elapsed_s, elapsed_s > 0.0 ? samples / elapsed_s : 0.0,
+            latency_percentile_ms(latency, 0.50), latency_percentile_ms(latency, 0.99),
+            latency->max_us / 1000.0, writer.bytes_written / 1e6,
+            (unsigned long long)(writer.records_dropped + state->log_failures));
+}
+
+int main(int argc, char* argv[]) {
+    LoggerOptions options = {0};
+    options.protocol = ECU_PROTOCOL_SPEEDUINO;
+    options.format = DATALOG_FORMAT_BINARY;
+    options.output_directory = ".";
+    options.session_name = "session";
+    options.stats_interval_s = 1.0;
+    options.replay_speed = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--port") == 0 && has_value) {
+            options.port = argv[++i];
+        } else if (strcmp(arg, "--ini") == 0 && has_value) {
+            options.ini_path = argv[++i];
+        } else if (strcmp(arg, "--protocol") == 0 && has_value) {
+            options.protocol = ecu_parse_protocol_name(argv[++i]);
+        } else if (strcmp(arg, "--baud") == 0 && has_value) {
+            options.baud_rate = atoi(argv[++i]);
+        } else if (strcmp(arg, "--format") == 0 && has_value) {
+            if (!parse_format(argv[++i], &options.format)) {
+                fprintf(stderr, "Unknown log format: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(arg, "--output") == 0 && has_value) {
+            options.output_directory = argv[++i];
+        } else if (strcmp(arg, "--session") == 0 && has_value) {
+            options.session_name = argv[++i];
+        } else if (strcmp(arg, "--duration") == 0 && has_value) {
+            options.duration_s = atof(argv[++i]);
+        } else if (strcmp(arg, "--stats-interval") == 0 && has_value) {
+            options.stats_interval_s = atof(argv[++i]);
+        } else if (strcmp(arg, "--capture-serial") == 0 && has_value) {
+            options.capture_path = argv[++i];
+        } else if (strcmp(arg, "--replay-serial") == 0 && has_value) {
+            options.replay_path = argv[++i];
+        } else if (strcmp(arg, "--replay-serial-speed") == 0 && has_value) {
+            options.replay_speed = atof(argv[++i]);
+        } else if (strcmp(arg, "--verbose") == 0) {
+            options.verbose = true;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!options.port && !options.replay_path) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    // The protocol drivers print a debug line or two per sample
+    if (!options.verbose && !freopen("/dev/null", "w", stdout)) {
+        fprintf(stderr, "Could not silence driver output: %s\n", strerror(errno));
+    }
+
+    // No SA_RESTART: a blocking port read returns and the loop sees the flag
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    SerialReplay* replay = NULL;
+    const char* port = options.port;
+    if (options.replay_path) {
+        SerialReplayConfig replay_config = { options.replay_speed, true, 0 };
+        replay = serial_replay_start(options.replay_path, &replay_config);
+        if (!replay) {
+            fprintf(stderr, "Could not replay serial capture %s\n", options.replay_path);
+            return 1;
+        }
+        port = serial_replay_port(replay);
+        fprintf(stderr, "Serving serial capture %s on %s\n", options.replay_path, port);
+    }
+
+    ECUContext* ctx = ecu_init();
+    if (!ctx) {
+        fprintf(stderr, "Could not initialize ECU communication\n");
+        serial_replay_stop(replay);
+        return 1;
+    }
+
+    SerialCapture* capture = NULL;
+    if (options.capture_path) {
+        capture = serial_capture_create(options.capture_path, 0, port,
+                                        options.baud_rate > 0 ? options.baud_rate : 115200);
+        if (!capture) {
+            fprintf(stderr, "Could not create serial capture %s\n", options.capture_path);
+        }
+        ecu_set_capture(ctx, capture);
+    }
+
+    int exit_code = 0;
+    LoggerState* state = calloc(1, sizeof(LoggerState));
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        state->names[i] = ecu_channel_info(i)->name;
+    }
+
+    fprintf(stderr, "Connecting to %s...\n", port);
+    if (!connect_ecu(ctx, &options, port)) {
+        fprintf(stderr, "Connection failed: %s\n", ecu_get_last_error(ctx));
+        exit_code = 1;
+        goto cleanup;
+    }
+    fprintf(stderr, "Connected (%s)\n", ecu_get_protocol_name(ctx->protocol));
+
+    datalog_manager_init();
+    DatalogSettings settings;
+    datalog_manager_get_settings(&settings);
+    snprintf(settings.output_directory, sizeof(settings.output_directory), "%s", options.output_directory);
+    snprintf(settings.session_name, sizeof(settings.session_name), "%s", options.session_name);
+    settings.format = options.format;
+    datalog_manager_set_settings(&settings);
+    mkdir(options.output_directory, 0755);
+
+    // With an INI, MLG columns keep the ECU's native field types and scaling
+    if (ctx->ini_config) {
+        INIField fields[ECU_CHANNEL_COUNT];
+        int matched = ecu_channels_ini_fields(ctx->ini_config, fields);
+        datalog_manager_set_ini_channels(fields, ECU_CHANNEL_COUNT);
+        fprintf(stderr, "%d of %d channels typed from %s\n", matched, ECU_CHANNEL_COUNT, options.ini_path);
+    } else {
+        const char* units[ECU_CHANNEL_COUNT];
+        for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+            units[i] = ecu_channel_info(i)->unit;
+        }
+        datalog_manager_set_channels(state->names, units, ECU_CHANNEL_COUNT);
+    }
+    if (!datalog_manager_start_session(options.session_name)) {
+        fprintf(stderr, "Could not start a log session in %s\n", options.output_directory);
+        exit_code = 1;
+        goto shutdown;
+    }
+    fprintf(stderr, "Logging to %s\n", datalog_manager_current_path());
+
+    ecu_add_sample_listener(ctx, on_sample, state);
+
+    uint64_t start_us = ecu_get_timestamp_us();
+    uint64_t stats_us = start_us;
+    uint64_t stats_samples = 0;
+    uint64_t reconnects = 0;
+    uint64_t stats_interval_us = (uint64_t)(options.stats_interval_s * 1e6);
+    uint64_t duration_us = (uint64_t)(options.duration_s * 1e6);
+
+    while (!g_stop) {
+        uint64_t now_us = ecu_get_timestamp_us();
+        if (duration_us && now_us - start_us >= duration_us) {
+            break;
+        }
+
+        if (stats_interval_us && now_us - stats_us >= stats_interval_us) {
+            print_stats(state, &state->interval, state->samples - stats_samples,
+                        (now_us - stats_us) / 1e6, "interval");
+            memset(&state->interval, 0, sizeof(state->interval));
+            stats_samples = state->samples;
+            stats_us = now_us;
+        }
+
+        if (ecu_is_connected(ctx)) {
+            state->request_start_us = ecu_get_timestamp_us();
+            ecu_update(ctx);
+            state->request_start_us = 0;
+            continue;
+        }
+
+        fprintf(stderr, "Lost connection (%s), reconnecting...\n", ecu_get_state_name(ecu_get_state(ctx)));
+        ecu_disconnect(ctx);
+        usleep(RECONNECT_DELAY_US);
+        // A failed connect can block for several seconds; don't start one past the end
+        if (g_stop || (duration_us && ecu_get_timestamp_us() - start_us >= duration_us)) {
+            break;
+        }
+        if (connect_ecu(ctx, &options, port)) {
+            reconnects++;
+            fprintf(stderr, "Reconnected\n");
+        }
+    }
+
+    double elapsed_s = (ecu_get_timestamp_us() - start_us) / 1e6;
+    print_stats(state, &state->total, state->samples, elapsed_s, "total   ");
+    fprintf(stderr, "%llu samples, %llu reconnects, log %s\n", (unsigned long long)state->samples,
+            (unsigned long long)reconnects, datalog_manager_current_path());
+    if (state->samples == 0) {
+        exit_code = 1;
+    }
+    ecu_remove_sample_listener(ctx, on_sample, state);
+    datalog_manager_stop_session();
+
+shutdown:
+    datalog_manager_shutdown();
+cleanup:
+    ecu_disconnect(ctx);
+    ecu_cleanup(ctx);
+    serial_capture_close(capture);
+    serial_replay_stop(replay);
+    free(state);
+    return exit_code;
+}
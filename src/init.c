@@ -127,6 +127,7 @@ G_MODULE_EXPORT void init(void)
 
 	/* initialize all global variables to known states */
 	cleanup(DATA_GET(global_data,"potential_ports"));
+	DATA_SET(global_data,"lv_summary_cache",GINT_TO_POINTER(TRUE));
 #ifdef __WIN32__
 	if (!args->port)
 	{
@@ -342,6 +343,12 @@ G_MODULE_EXPORT gboolean read_config(void)
 
 		if ((GINT)DATA_GET(global_data,"lv_zoom") < 1)
 			DATA_SET(global_data,"lv_zoom",GINT_TO_POINTER(1));
+		if(cfg_read_int(cfgfile, "Logviewer", "span", &tmpi))
+			DATA_SET(global_data,"lv_span",GINT_TO_POINTER(tmpi));
+		if ((GINT)DATA_GET(global_data,"lv_span") < 1)
+			DATA_SET(global_data,"lv_span",GINT_TO_POINTER(1));
+		if(cfg_read_boolean(cfgfile, "Logviewer", "summary_cache", &tmpi))
+			DATA_SET(global_data,"lv_summary_cache",GINT_TO_POINTER(tmpi));
 		if(cfg_read_int(cfgfile, "Logviewer", "scroll_delay", &tmpi))
 			DATA_SET(global_data,"lv_scroll_delay",GINT_TO_POINTER(tmpi));
 		if ((GINT)DATA_GET(global_data,"lv_scroll_delay") < 40)
@@ -597,6 +604,8 @@ G_MODULE_EXPORT void save_config()
 			serial_params->read_wait);
 			
 	cfg_write_int(cfgfile, "Logviewer", "zoom", (GINT)DATA_GET(global_data,"lv_zoom"));
+	cfg_write_int(cfgfile, "Logviewer", "span", (GINT)DATA_GET(global_data,"lv_span"));
+	cfg_write_boolean(cfgfile, "Logviewer", "summary_cache", (GBOOLEAN)DATA_GET(global_data,"lv_summary_cache"));
 	cfg_write_int(cfgfile, "Logviewer", "scroll_delay",(GINT) DATA_GET(global_data,"lv_scroll_delay"));
 	write_logviewer_defaults(cfgfile);
 
@@ -1499,7 +1508,7 @@ G_MODULE_EXPORT void dealloc_table_params(Table_Params * table_params)
   */
 G_MODULE_EXPORT void dealloc_rtv_object(gconstpointer *object)
 {
-	GArray * array = NULL;
+	Rtv_History * history = NULL;
 	ENTER();
 
 	if (!object)
@@ -1507,10 +1516,10 @@ G_MODULE_EXPORT void dealloc_rtv_object(gconstpointer *object)
 		EXIT();
 		return;
 	}
-	array = (GArray *)DATA_GET(object, "history");
-	if (array)
+	history = (Rtv_History *)DATA_GET(object, "history");
+	if (history)
 	{
-		g_array_free((GArray *)DATA_GET(object,"history"),TRUE);
+		rtv_history_free(history);
 		DATA_SET(object,"history", NULL);
 	}
 
@@ -1573,6 +1582,7 @@ G_MODULE_EXPORT void dealloc_lookuptable(gpointer data)
 	ENTER();
 
 	cleanup(table->array);
+	lookup_inverse_free(table->inverse);
 	cleanup(table->filename);
 	cleanup(table);
 	EXIT();
@@ -1843,17 +1853,20 @@ G_MODULE_EXPORT void dealloc_rtv_map(gpointer data)
 		if (rtv_map->raw_list)
 			g_strfreev(rtv_map->raw_list);
 		cleanup (rtv_map->applicable_signatures);
+		/* Finish pending spills before the histories go away */
+		rtv_spill_free(rtv_map->spill);
 		for(int i=0;i<(gint)rtv_map->rtv_list->len;i++)
 		{
 			gconstpointer* data;
 			data = (gconstpointer *)g_ptr_array_index(rtv_map->rtv_list,i);
 			dealloc_rtv_object(data);
 		}
-		g_array_free(rtv_map->ts_array,TRUE);
 		g_ptr_array_free(rtv_map->rtv_list,TRUE);
 		g_hash_table_destroy(rtv_map->rtv_hash);
 		g_hash_table_foreach(rtv_map->offset_hash,dealloc_list,NULL);
 		g_hash_table_destroy(rtv_map->offset_hash);
+		rtv_plan_free(rtv_map->plan);
+		cleanup(rtv_map->values);
 		cleanup(rtv_map);
 		DATA_SET(global_data,"rtv_map",NULL);
 	}
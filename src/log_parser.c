@@ -0,0 +1,531 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute etc. this as long as the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file src/log_parser.c
+  \ingroup CoreMtx
+  \brief Parallel parser for delimited text datalogs.
+
+  The file is mapped read-only and the data section is cut into
+  newline-aligned chunks. Worker threads first count the lines of each chunk
+  so every chunk knows the row it starts at, then parse their chunks
+  straight into one preallocated float array per field. Rows that get
+  tossed (MARK lines, text, wrong field count) leave gaps that are closed up
+  once all chunks are done. The line rules are the ones read_log_data()
+  has always applied.
+  */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE		/* memmem() */
+#endif
+
+#include <log_parser.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHUNKS_PER_THREAD 8
+#define MIN_CHUNK_BYTES (256 * 1024)
+#define MAX_THREADS 64
+
+typedef struct
+{
+	const char *start;
+	const char *end;
+	size_t lines;		/* Pass 1: lines in the chunk */
+	size_t first_row;	/* Row the chunk writes from */
+	size_t rows;		/* Pass 2: rows kept */
+	size_t markers;
+	size_t skipped;
+} Chunk;
+
+typedef struct
+{
+	LogParse *parse;
+	Chunk *chunks;
+	int chunk_count;
+	int pass;
+	int next_chunk;		/* Shared work counter */
+	size_t bytes_done;	/* Shared, for progress */
+	size_t total_bytes;
+	char decimal;		/* Decimal point besides '.' (',' in TAB logs) */
+} Job;
+
+static const double powers_of_ten[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+/*!
+  \brief parse_float() converts one field. Plain decimals whose digits fit
+  in 53 bits, which is every value MegaTunix writes, take the exact
+  mantissa and power of ten path; anything else goes through strtod()
+  \param p is the start of the field
+  \param end is the end of the field
+  \param decimal is an alternate decimal point character
+  \returns the value, or 0 for an empty or non-numeric field as strtod does
+  */
+static float parse_float(const char *p, const char *end, char decimal)
+{
+	const char *start = p;
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int scale = 0;
+	int negative = 0;
+	char buffer[64];
+	size_t len = 0;
+
+	while ((p < end) && (*p == ' '))
+		p++;
+	if ((p < end) && ((*p == '-') || (*p == '+')))
+		negative = (*p++ == '-');
+	for (;(p < end) && (*p >= '0') && (*p <= '9');p++,digits++)
+		mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+	if ((p < end) && ((*p == '.') || (*p == decimal)))
+	{
+		for (p++;(p < end) && (*p >= '0') && (*p <= '9');p++,digits++,scale++)
+			mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+	}
+	if ((p < end) && ((*p == 'e') || (*p == 'E')))
+		goto slow;
+	if ((digits == 0) || (digits > 19) || (mantissa >> 53) || (scale > 22))
+		goto slow;
+	{
+		double value = (double)mantissa / powers_of_ten[scale];
+		return (float)(negative ? -value : value);
+	}
+
+slow:
+	len = (size_t)(end - start) < sizeof(buffer) - 1 ? (size_t)(end - start) : sizeof(buffer) - 1;
+	memcpy(buffer,start,len);
+	buffer[len] = '\0';
+	for (size_t i=0;i<len;i++)
+		if (buffer[i] == decimal)
+			buffer[i] = '.';
+	return (float)strtod(buffer,NULL);
+}
+
+
+/*!
+  \brief parse_line() applies the read_log_data() rules to one line and
+  stores its values at row
+  \param store is 0 to only classify the line
+  \returns 1 if the row was kept, 0 if tossed, -1 for a MARK line
+  */
+static int parse_line(LogParse *parse, const char *line, const char *end, size_t row, char decimal, int store)
+{
+	const char *p = line;
+	const char *field_end = NULL;
+	int field = 0;
+
+	if ((end - line >= 4) && (memmem(line,(size_t)(end - line),"MARK",4) != NULL))
+		return -1;
+	/* The first field must start with a digit in one of its first two chars */
+	if (!(((end - line > 0) && (line[0] >= '0') && (line[0] <= '9')) ||
+	      ((end - line > 1) && (line[1] >= '0') && (line[1] <= '9'))))
+		return 0;
+
+	/* Count the fields before writing so a short row touches nothing */
+	for (p=line;p < end;p++)
+		if (*p == parse->delimiter)
+			field++;
+	if (field + 1 != parse->field_count)
+		return 0;
+	if (!store)
+		return 1;
+
+	for (p=line,field=0;field < parse->field_count;field++,p=field_end+1)
+	{
+		field_end = memchr(p,parse->delimiter,(size_t)(end - p));
+		if (!field_end)
+			field_end = end;
+		parse->columns[field][row] = parse_float(p,field_end,decimal);
+	}
+	return 1;
+}
+
+
+static const char *line_end(const char *line, const char *end)
+{
+	const char *newline = memchr(line,'\n',(size_t)(end - line));
+	return newline ? newline : end;
+}
+
+
+static void count_chunk(Chunk *chunk)
+{
+	const char *p = chunk->start;
+	size_t lines = 0;
+
+	while (p < chunk->end)
+	{
+		const char *newline = memchr(p,'\n',(size_t)(chunk->end - p));
+		lines++;
+		if (!newline)
+			break;
+		p = newline + 1;
+	}
+	chunk->lines = lines;
+}
+
+
+static void parse_chunk(Job *job, Chunk *chunk)
+{
+	const char *p = chunk->start;
+	size_t row = chunk->first_row;
+
+	while (p < chunk->end)
+	{
+		const char *eol = line_end(p,chunk->end);
+		const char *content_end = eol;
+		int result = 0;
+
+		if ((content_end > p) && (content_end[-1] == '\r'))
+			content_end--;
+		/* Segment headers and block seals */
+		if ((content_end > p) && (*p == '#'))
+		{
+			p = eol + 1;
+			continue;
+		}
+		result = parse_line(job->parse,p,content_end,row,job->decimal,1);
+		if (result > 0)
+		{
+			row++;
+			chunk->rows++;
+		}
+		else if (result < 0)
+			chunk->markers++;
+		else
+			chunk->skipped++;
+		p = eol + 1;
+	}
+}
+
+
+static void *worker(void *data)
+{
+	Job *job = (Job *)data;
+
+	for (;;)
+	{
+		int index = __atomic_fetch_add(&job->next_chunk,1,__ATOMIC_RELAXED);
+		Chunk *chunk = NULL;
+
+		if (index >= job->chunk_count)
+			break;
+		chunk = &job->chunks[index];
+		if (job->pass == 0)
+			count_chunk(chunk);
+		else
+			parse_chunk(job,chunk);
+		__atomic_add_fetch(&job->bytes_done,(size_t)(chunk->end - chunk->start),__ATOMIC_RELAXED);
+	}
+	return NULL;
+}
+
+
+/*!
+  \brief run_pass() runs one pass over all chunks on the worker threads,
+  reporting progress from the calling thread while it waits
+  */
+static void run_pass(Job *job, int threads, int pass, LogParseProgress progress, void *data)
+{
+	pthread_t ids[MAX_THREADS];
+	int started = 0;
+
+	job->pass = pass;
+	job->next_chunk = 0;
+	job->bytes_done = 0;
+	for (started=0;started < threads;started++)
+		if (pthread_create(&ids[started],NULL,worker,job) != 0)
+			break;
+	if (started == 0)
+		worker(job);
+	while (progress && (__atomic_load_n(&job->bytes_done,__ATOMIC_RELAXED) < job->total_bytes) && (started > 0))
+	{
+		struct timespec wait = { 0, 20 * 1000000 };
+		size_t done = __atomic_load_n(&job->bytes_done,__ATOMIC_RELAXED);
+
+		/* Counting is a small fraction of the work */
+		progress(pass == 0 ? 0.05 * done / job->total_bytes : 0.05 + 0.95 * done / job->total_bytes,data);
+		nanosleep(&wait,NULL);
+	}
+	for (int i=0;i < started;i++)
+		pthread_join(ids[i],NULL);
+}
+
+
+/*!
+  \brief split_fields() splits the header line into trimmed names
+  */
+static int split_fields(LogParse *parse, const char *line, const char *end)
+{
+	const char *p = line;
+	int count = 1;
+
+	for (p=line;p < end;p++)
+		if (*p == parse->delimiter)
+			count++;
+	parse->names = (char **)calloc((size_t)count,sizeof(char *));
+	if (!parse->names)
+		return 0;
+	p = line;
+	for (int i=0;i < count;i++)
+	{
+		const char *field_end = memchr(p,parse->delimiter,(size_t)(end - p));
+		const char *last = NULL;
+
+		if (!field_end)
+			field_end = end;
+		last = field_end;
+		while ((p < last) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+			p++;
+		while ((last > p) && ((last[-1] == ' ') || (last[-1] == '\t') || (last[-1] == '\r')))
+			last--;
+		parse->names[i] = strndup(p,(size_t)(last - p));
+		p = field_end + 1;
+	}
+	parse->field_count = count;
+	return 1;
+}
+
+
+/*!
+  \brief find_precision() records the decimals of each field on the first
+  data row that was kept, as read_log_data() did
+  */
+static void find_precision(LogParse *parse, const char *p, const char *end, char decimal)
+{
+	while (p < end)
+	{
+		const char *eol = line_end(p,end);
+		const char *content_end = eol;
+
+		if ((content_end > p) && (content_end[-1] == '\r'))
+			content_end--;
+		if (parse_line(parse,p,content_end,0,decimal,0) > 0)
+		{
+			const char *field = p;
+			for (int i=0;i < parse->field_count;i++)
+			{
+				const char *field_end = memchr(field,parse->delimiter,(size_t)(content_end - field));
+				const char *point = NULL;
+
+				if (!field_end)
+					field_end = content_end;
+				for (point=field;(point < field_end) && (*point != '.') && (*point != decimal);point++);
+				parse->precision[i] = point < field_end ? (int)(field_end - point - 1) : 0;
+				field = field_end + 1;
+			}
+			return;
+		}
+		p = eol + 1;
+	}
+}
+
+
+/*!
+  \brief log_parse_file() parses a delimited text datalog into per-field
+  float arrays using several threads
+  \param path is the log file
+  \param threads is the worker count, 0 for one per online CPU
+  \param progress is called periodically on the calling thread, may be NULL
+  \param data is passed to progress
+  \returns the parsed log, or NULL if the file couldn't be read or has no
+  header line
+  */
+LogParse *log_parse_file(const char *path, int threads, LogParseProgress progress, void *data)
+{
+	LogParse *parse = NULL;
+	Job job;
+	struct stat st;
+	const char *map = NULL;
+	const char *p = NULL;
+	const char *end = NULL;
+	const char *header_end = NULL;
+	size_t total_lines = 0;
+	size_t chunk_bytes = 0;
+	int fd = -1;
+
+	if (!path)
+		return NULL;
+	fd = open(path,O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return NULL;
+	if ((fstat(fd,&st) != 0) || (st.st_size == 0))
+	{
+		close(fd);
+		return NULL;
+	}
+	map = (const char *)mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+	madvise((void *)map,(size_t)st.st_size,MADV_SEQUENTIAL);
+	end = map + st.st_size;
+
+	parse = (LogParse *)calloc(1,sizeof(LogParse));
+	memset(&job,0,sizeof(job));
+	job.parse = parse;
+
+	/* Quoted lines carry the ECU signature; the first other line is the
+	 * header. '#' lines are datalog_segment framing. */
+	for (p=map;p < end;p=header_end+1)
+	{
+		const char *quote = NULL;
+
+		header_end = line_end(p,end);
+		if (*p == '#')
+			continue;
+		quote = memchr(p,'"',(size_t)(header_end - p));
+		if (!quote)
+			break;
+		free(parse->signature);
+		{
+			const char *s = p;
+			const char *e = header_end;
+			while ((s < e) && ((*s == '"') || (*s == ' ') || (*s == '\t')))
+				s++;
+			while ((e > s) && ((e[-1] == '"') || (e[-1] == '\r') || (e[-1] == ' ')))
+				e--;
+			parse->signature = strndup(s,(size_t)(e - s));
+		}
+	}
+	if (p >= end)
+		goto fail;
+	parse->delimiter = memchr(p,',',(size_t)(header_end - p)) ? ',' :
+		(memchr(p,'\t',(size_t)(header_end - p)) ? '\t' : ',');
+	job.decimal = parse->delimiter == '\t' ? ',' : '.';
+	if (!split_fields(parse,p,header_end))
+		goto fail;
+	p = header_end < end ? header_end + 1 : end;
+
+	/* Newline-aligned chunks */
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads < 1)
+		threads = 1;
+	if (threads > MAX_THREADS)
+		threads = MAX_THREADS;
+	job.total_bytes = (size_t)(end - p);
+	chunk_bytes = job.total_bytes / ((size_t)threads * CHUNKS_PER_THREAD) + 1;
+	if (chunk_bytes < MIN_CHUNK_BYTES)
+		chunk_bytes = MIN_CHUNK_BYTES;
+	job.chunks = (Chunk *)calloc(job.total_bytes / chunk_bytes + 2,sizeof(Chunk));
+	if (!job.chunks)
+		goto fail;
+	while (p < end)
+	{
+		Chunk *chunk = &job.chunks[job.chunk_count++];
+		const char *cut = (size_t)(end - p) > chunk_bytes ? p + chunk_bytes : end;
+
+		if (cut < end)
+		{
+			const char *newline = memchr(cut,'\n',(size_t)(end - cut));
+			cut = newline ? newline + 1 : end;
+		}
+		chunk->start = p;
+		chunk->end = cut;
+		p = cut;
+	}
+	if ((size_t)threads > (size_t)job.chunk_count)
+		threads = job.chunk_count > 0 ? job.chunk_count : 1;
+
+	run_pass(&job,threads,0,progress,data);
+	for (int i=0;i < job.chunk_count;i++)
+	{
+		job.chunks[i].first_row = total_lines;
+		total_lines += job.chunks[i].lines;
+	}
+
+	parse->columns = (float **)calloc((size_t)parse->field_count,sizeof(float *));
+	parse->precision = (int *)calloc((size_t)parse->field_count,sizeof(int));
+	if ((!parse->columns) || (!parse->precision))
+		goto fail;
+	for (int i=0;i < parse->field_count;i++)
+	{
+		parse->columns[i] = (float *)malloc((total_lines ? total_lines : 1) * sizeof(float));
+		if (!parse->columns[i])
+			goto fail;
+	}
+	run_pass(&job,threads,1,progress,data);
+
+	/* Close the gaps left by tossed lines */
+	for (int i=0;i < job.chunk_count;i++)
+	{
+		Chunk *chunk = &job.chunks[i];
+		if (chunk->first_row != parse->rows)
+		{
+			for (int f=0;f < parse->field_count;f++)
+				memmove(parse->columns[f] + parse->rows,parse->columns[f] + chunk->first_row,chunk->rows * sizeof(float));
+		}
+		parse->rows += chunk->rows;
+		parse->markers += chunk->markers;
+		parse->skipped += chunk->skipped;
+	}
+	find_precision(parse,header_end < end ? header_end + 1 : end,end,job.decimal);
+	if (progress)
+		progress(1.0,data);
+
+	free(job.chunks);
+	munmap((void *)map,(size_t)st.st_size);
+	return parse;
+
+fail:
+	free(job.chunks);
+	munmap((void *)map,(size_t)st.st_size);
+	log_parse_free(parse);
+	return NULL;
+}
+
+
+/*!
+  \brief log_parse_take_column() hands one field's array to the caller,
+  who must free() it
+  */
+float *log_parse_take_column(LogParse *parse, int field)
+{
+	float *column = NULL;
+
+	if ((!parse) || (!parse->columns) || (field < 0) || (field >= parse->field_count))
+		return NULL;
+	column = parse->columns[field];
+	parse->columns[field] = NULL;
+	return column;
+}
+
+
+/*!
+  \brief log_parse_free() releases a parsed log
+  */
+void log_parse_free(LogParse *parse)
+{
+	if (!parse)
+		return;
+	for (int i=0;i < parse->field_count;i++)
+	{
+		if (parse->names)
+			free(parse->names[i]);
+		if (parse->columns)
+			free(parse->columns[i]);
+	}
+	free(parse->names);
+	free(parse->columns);
+	free(parse->precision);
+	free(parse->signature);
+	free(parse);
+}
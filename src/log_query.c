@@ -0,0 +1,576 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute etc. this as long as the source code
+ * is made available for FREE.
+ *
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file src/log_query.c
+  \ingroup CoreMtx
+  \brief Event search over loaded datalog fields.
+
+  A query such as "knock > 0 while rpm > 5000" is compiled into a short
+  postfix program of comparisons and logic steps. The program runs over
+  the field arrays a block of samples at a time: each comparison fills a
+  byte mask for the block in one branch-free loop the compiler vectorizes,
+  logic steps combine masks the same way, and the final mask is turned
+  into runs of matching samples, skipping eight samples at a time where
+  nothing changes.
+
+  Grammar, keywords and field names are case insensitive:
+    expr    := and { ("||" | "or") and }
+    and     := unary { ("&&" | "and" | "while") unary }
+    unary   := ("!" | "not") unary | "(" expr ")" | operand [ cmp operand ]
+    cmp     := "<" | "<=" | ">" | ">=" | "==" | "=" | "!="
+    operand := number | field | "quoted field"
+  A field on its own means field != 0.
+  */
+
+#include <log_query.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define BLOCK_SAMPLES 4096
+#define MAX_STEPS 256
+
+typedef enum
+{
+	CMP_LT,
+	CMP_LE,
+	CMP_GT,
+	CMP_GE,
+	CMP_EQ,
+	CMP_NE
+}CmpOp;
+
+typedef enum
+{
+	STEP_FIELD_CONST,	/* field op value */
+	STEP_FIELD_FIELD,	/* field op other */
+	STEP_AND,
+	STEP_OR,
+	STEP_NOT
+}StepKind;
+
+typedef struct
+{
+	StepKind kind;
+	CmpOp op;
+	int field;
+	int other;
+	float value;
+} Step;
+
+struct _LogQuery
+{
+	Step steps[MAX_STEPS];
+	int step_count;
+	int depth;		/* Masks the program needs at once */
+};
+
+typedef struct
+{
+	const char *text;
+	const char *p;
+	const char **names;
+	int field_count;
+	LogQuery *query;
+	int stack;
+	char *error;
+} Parser;
+
+typedef struct
+{
+	int is_field;
+	int field;
+	float value;
+} Operand;
+
+static int parse_or(Parser *);
+
+
+static void fail(Parser *parser, const char *format, ...)
+{
+	char message[256];
+	va_list args;
+
+	if (parser->error)
+		return;
+	va_start(args,format);
+	vsnprintf(message,sizeof(message),format,args);
+	va_end(args);
+	parser->error = (char *)malloc(strlen(message) + 32);
+	if (parser->error)
+		sprintf(parser->error,"%s at column %d",message,(int)(parser->p - parser->text) + 1);
+}
+
+
+static void skip_space(Parser *parser)
+{
+	while (isspace((unsigned char)*parser->p))
+		parser->p++;
+}
+
+
+/*!
+  \brief accept() consumes token if it is next; words must not run on into
+  an identifier
+  */
+static int accept(Parser *parser, const char *token)
+{
+	size_t len = strlen(token);
+
+	skip_space(parser);
+	if (strncasecmp(parser->p,token,len) != 0)
+		return 0;
+	if (isalpha((unsigned char)token[0]) &&
+			(isalnum((unsigned char)parser->p[len]) || (parser->p[len] == '_')))
+		return 0;
+	parser->p += len;
+	return 1;
+}
+
+
+static int emit(Parser *parser, Step step)
+{
+	if (parser->query->step_count == MAX_STEPS)
+	{
+		fail(parser,"Query is too long");
+		return 0;
+	}
+	parser->query->steps[parser->query->step_count++] = step;
+	if ((step.kind == STEP_FIELD_CONST) || (step.kind == STEP_FIELD_FIELD))
+		parser->stack++;
+	else if (step.kind != STEP_NOT)
+		parser->stack--;
+	if (parser->stack > parser->query->depth)
+		parser->query->depth = parser->stack;
+	return 1;
+}
+
+
+static int find_field(Parser *parser, const char *name, size_t len)
+{
+	for (int i=0;i < parser->field_count;i++)
+		if (parser->names[i] && (strlen(parser->names[i]) == len) && (strncasecmp(parser->names[i],name,len) == 0))
+			return i;
+	fail(parser,"No field named \"%.*s\"",(int)len,name);
+	return -1;
+}
+
+
+static int is_keyword(const char *word, size_t len)
+{
+	static const char *keywords[] = { "and", "or", "not", "while" };
+
+	for (size_t i=0;i < sizeof(keywords)/sizeof(keywords[0]);i++)
+		if ((strlen(keywords[i]) == len) && (strncasecmp(keywords[i],word,len) == 0))
+			return 1;
+	return 0;
+}
+
+
+static int parse_operand(Parser *parser, Operand *operand)
+{
+	const char *start = NULL;
+	char *end = NULL;
+
+	skip_space(parser);
+	start = parser->p;
+	if ((*start == '"') || (*start == '\''))
+	{
+		const char *close = strchr(start + 1,*start);
+		if (!close)
+		{
+			fail(parser,"Unterminated field name");
+			return 0;
+		}
+		operand->is_field = 1;
+		operand->field = find_field(parser,start + 1,(size_t)(close - start - 1));
+		parser->p = close + 1;
+		return operand->field >= 0;
+	}
+	if (isdigit((unsigned char)*start) || (*start == '.') ||
+			(((*start == '-') || (*start == '+')) && (isdigit((unsigned char)start[1]) || (start[1] == '.'))))
+	{
+		operand->is_field = 0;
+		operand->value = strtof(start,&end);
+		if (end == start)
+		{
+			fail(parser,"Bad number");
+			return 0;
+		}
+		parser->p = end;
+		return 1;
+	}
+	if (isalpha((unsigned char)*start) || (*start == '_'))
+	{
+		const char *p = start;
+		while (isalnum((unsigned char)*p) || (*p == '_') || (*p == '.') || (*p == '%') || (*p == '/'))
+			p++;
+		if (is_keyword(start,(size_t)(p - start)))
+		{
+			fail(parser,"Expected a field or number");
+			return 0;
+		}
+		operand->is_field = 1;
+		operand->field = find_field(parser,start,(size_t)(p - start));
+		parser->p = p;
+		return operand->field >= 0;
+	}
+	fail(parser,"Expected a field or number");
+	return 0;
+}
+
+
+static int parse_cmp(Parser *parser, CmpOp *op)
+{
+	/* Two character operators first */
+	if (accept(parser,"<="))
+		*op = CMP_LE;
+	else if (accept(parser,">="))
+		*op = CMP_GE;
+	else if (accept(parser,"=="))
+		*op = CMP_EQ;
+	else if (accept(parser,"!="))
+		*op = CMP_NE;
+	else if (accept(parser,"<"))
+		*op = CMP_LT;
+	else if (accept(parser,">"))
+		*op = CMP_GT;
+	else if (accept(parser,"="))
+		*op = CMP_EQ;
+	else
+		return 0;
+	return 1;
+}
+
+
+/* value op field is field (flipped op) value */
+static CmpOp flip(CmpOp op)
+{
+	switch (op)
+	{
+		case CMP_LT: return CMP_GT;
+		case CMP_LE: return CMP_GE;
+		case CMP_GT: return CMP_LT;
+		case CMP_GE: return CMP_LE;
+		default: return op;
+	}
+}
+
+
+static int parse_unary(Parser *parser)
+{
+	Operand left;
+	Operand right;
+	Step step;
+	CmpOp op = CMP_NE;
+
+	if (accept(parser,"!") || accept(parser,"not"))
+	{
+		if (!parse_unary(parser))
+			return 0;
+		step = (Step){ .kind = STEP_NOT };
+		return emit(parser,step);
+	}
+	if (accept(parser,"("))
+	{
+		if (!parse_or(parser))
+			return 0;
+		if (!accept(parser,")"))
+		{
+			fail(parser,"Expected \")\"");
+			return 0;
+		}
+		return 1;
+	}
+	if (!parse_operand(parser,&left))
+		return 0;
+	if (!parse_cmp(parser,&op))
+	{
+		if (!left.is_field)
+		{
+			fail(parser,"Expected a comparison");
+			return 0;
+		}
+		right = (Operand){ .is_field = 0, .value = 0.0f };
+	}
+	else if (!parse_operand(parser,&right))
+		return 0;
+
+	if ((!left.is_field) && (!right.is_field))
+	{
+		fail(parser,"Comparison needs a field");
+		return 0;
+	}
+	if (!left.is_field)
+	{
+		Operand swap = left;
+		left = right;
+		right = swap;
+		op = flip(op);
+	}
+	if (right.is_field)
+		step = (Step){ .kind = STEP_FIELD_FIELD, .op = op, .field = left.field, .other = right.field };
+	else
+		step = (Step){ .kind = STEP_FIELD_CONST, .op = op, .field = left.field, .value = right.value };
+	return emit(parser,step);
+}
+
+
+static int parse_and(Parser *parser)
+{
+	if (!parse_unary(parser))
+		return 0;
+	while (accept(parser,"&&") || accept(parser,"and") || accept(parser,"while"))
+	{
+		if (!parse_unary(parser))
+			return 0;
+		if (!emit(parser,(Step){ .kind = STEP_AND }))
+			return 0;
+	}
+	return 1;
+}
+
+
+static int parse_or(Parser *parser)
+{
+	if (!parse_and(parser))
+		return 0;
+	while (accept(parser,"||") || accept(parser,"or"))
+	{
+		if (!parse_and(parser))
+			return 0;
+		if (!emit(parser,(Step){ .kind = STEP_OR }))
+			return 0;
+	}
+	return 1;
+}
+
+
+/*!
+  \brief log_query_compile() compiles a query against a log's field names
+  \param text is the query
+  \param names are the field names, index i is column i at run time
+  \param field_count is how many names there are
+  \param error if not NULL receives a malloc()'d message when the query
+  doesn't compile
+  \returns the compiled query, or NULL
+  */
+LogQuery *log_query_compile(const char *text, const char **names, int field_count, char **error)
+{
+	Parser parser;
+
+	if (error)
+		*error = NULL;
+	if (!text)
+		return NULL;
+	memset(&parser,0,sizeof(parser));
+	parser.text = text;
+	parser.p = text;
+	parser.names = names;
+	parser.field_count = field_count;
+	parser.query = (LogQuery *)calloc(1,sizeof(LogQuery));
+	if (!parser.query)
+		return NULL;
+	if (parse_or(&parser))
+	{
+		skip_space(&parser);
+		if (*parser.p != '\0')
+			fail(&parser,"Unexpected \"%.16s\"",parser.p);
+	}
+	if (parser.error)
+	{
+		if (error)
+			*error = parser.error;
+		else
+			free(parser.error);
+		free(parser.query);
+		return NULL;
+	}
+	return parser.query;
+}
+
+
+void log_query_free(LogQuery *query)
+{
+	free(query);
+}
+
+
+/* One loop per operator so each one vectorizes */
+static void compare_const(uint8_t *restrict mask, const float *restrict column, size_t n, CmpOp op, float value)
+{
+	size_t i = 0;
+
+	switch (op)
+	{
+		case CMP_LT: for (i=0;i < n;i++) mask[i] = column[i] < value; break;
+		case CMP_LE: for (i=0;i < n;i++) mask[i] = column[i] <= value; break;
+		case CMP_GT: for (i=0;i < n;i++) mask[i] = column[i] > value; break;
+		case CMP_GE: for (i=0;i < n;i++) mask[i] = column[i] >= value; break;
+		case CMP_EQ: for (i=0;i < n;i++) mask[i] = column[i] == value; break;
+		case CMP_NE: for (i=0;i < n;i++) mask[i] = column[i] != value; break;
+	}
+}
+
+
+static void compare_field(uint8_t *restrict mask, const float *restrict column, const float *restrict other, size_t n, CmpOp op)
+{
+	size_t i = 0;
+
+	switch (op)
+	{
+		case CMP_LT: for (i=0;i < n;i++) mask[i] = column[i] < other[i]; break;
+		case CMP_LE: for (i=0;i < n;i++) mask[i] = column[i] <= other[i]; break;
+		case CMP_GT: for (i=0;i < n;i++) mask[i] = column[i] > other[i]; break;
+		case CMP_GE: for (i=0;i < n;i++) mask[i] = column[i] >= other[i]; break;
+		case CMP_EQ: for (i=0;i < n;i++) mask[i] = column[i] == other[i]; break;
+		case CMP_NE: for (i=0;i < n;i++) mask[i] = column[i] != other[i]; break;
+	}
+}
+
+
+typedef struct
+{
+	LogQueryMatch *matches;
+	size_t count;
+	size_t size;
+	int in_run;
+	size_t start;
+	int failed;
+} Runs;
+
+
+static void add_run(Runs *runs, size_t first, size_t last)
+{
+	if (runs->count == runs->size)
+	{
+		size_t size = runs->size ? runs->size * 2 : 64;
+		LogQueryMatch *grown = (LogQueryMatch *)realloc(runs->matches,size * sizeof(LogQueryMatch));
+		if (!grown)
+		{
+			runs->failed = 1;
+			return;
+		}
+		runs->matches = grown;
+		runs->size = size;
+	}
+	runs->matches[runs->count].first = first;
+	runs->matches[runs->count].last = last;
+	runs->count++;
+}
+
+
+/*!
+  \brief scan_mask() turns a block's mask into runs, carrying an open run
+  over to the next block
+  */
+static void scan_mask(Runs *runs, const uint8_t *mask, size_t n, size_t base)
+{
+	const uint64_t ones = 0x0101010101010101ull;
+	size_t i = 0;
+
+	while (i < n)
+	{
+		if (i + 8 <= n)
+		{
+			uint64_t word;
+			memcpy(&word,mask + i,8);
+			if (word == (runs->in_run ? ones : 0))
+			{
+				i += 8;
+				continue;
+			}
+		}
+		if (mask[i] != runs->in_run)
+		{
+			if (mask[i])
+				runs->start = base + i;
+			else
+				add_run(runs,runs->start,base + i - 1);
+			runs->in_run = mask[i];
+		}
+		i++;
+	}
+}
+
+
+/*!
+  \brief log_query_run() finds every run of samples where the query holds
+  \param query is the compiled query
+  \param columns are the field arrays, in the order of the compile names
+  \param rows is the sample count of every array
+  \param matches receives a malloc()'d array of runs, in sample order, or
+  NULL when there are none
+  \returns the number of runs
+  */
+size_t log_query_run(const LogQuery *query, const float **columns, size_t rows, LogQueryMatch **matches)
+{
+	Runs runs;
+	uint8_t *masks = NULL;
+
+	*matches = NULL;
+	if ((!query) || (query->depth == 0) || (rows == 0))
+		return 0;
+	masks = (uint8_t *)malloc((size_t)query->depth * BLOCK_SAMPLES);
+	if (!masks)
+		return 0;
+	memset(&runs,0,sizeof(runs));
+
+	for (size_t base=0;base < rows;base+=BLOCK_SAMPLES)
+	{
+		size_t n = rows - base < BLOCK_SAMPLES ? rows - base : BLOCK_SAMPLES;
+		int top = 0;
+
+		for (int s=0;s < query->step_count;s++)
+		{
+			const Step *step = &query->steps[s];
+			uint8_t *a = masks + (size_t)(top > 1 ? top - 2 : 0) * BLOCK_SAMPLES;
+			uint8_t *b = masks + (size_t)(top > 0 ? top - 1 : 0) * BLOCK_SAMPLES;
+
+			switch (step->kind)
+			{
+				case STEP_FIELD_CONST:
+					compare_const(masks + (size_t)top++ * BLOCK_SAMPLES,columns[step->field] + base,n,step->op,step->value);
+					break;
+				case STEP_FIELD_FIELD:
+					compare_field(masks + (size_t)top++ * BLOCK_SAMPLES,columns[step->field] + base,columns[step->other] + base,n,step->op);
+					break;
+				case STEP_AND:
+					for (size_t i=0;i < n;i++)
+						a[i] &= b[i];
+					top--;
+					break;
+				case STEP_OR:
+					for (size_t i=0;i < n;i++)
+						a[i] |= b[i];
+					top--;
+					break;
+				case STEP_NOT:
+					for (size_t i=0;i < n;i++)
+						b[i] ^= 1;
+					break;
+			}
+		}
+		scan_mask(&runs,masks,n,base);
+	}
+	if (runs.in_run)
+		add_run(&runs,runs.start,rows - 1);
+	free(masks);
+	if (runs.failed)
+	{
+		free(runs.matches);
+		return 0;
+	}
+	*matches = runs.matches;
+	return runs.count;
+}
@@ -0,0 +1,546 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute etc. this as long as the source code
+ * is made available for FREE.
+ *
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file src/log_summary.c
+  \ingroup CoreMtx
+  \brief Min/max/mean summary pyramid over loaded datalog fields.
+
+  Level 0 reduces every LOG_SUMMARY_FANOUT samples of a field to one bucket,
+  each level above reduces LOG_SUMMARY_FANOUT buckets of the level below,
+  until a level has a single bucket. A span of samples is answered from the
+  coarsest buckets that fit inside it, with raw samples only at unaligned
+  edges, so the cost of a pixel column doesn't grow with the zoom level or
+  the log length. Fields are summarized in parallel, one field per work
+  item. The pyramid can be saved next to the log and is reused while the
+  log's size and mtime still match.
+  */
+
+#include <log_summary.h>
+#include <fcntl.h>
+#include <float.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAX_LEVELS 24
+#define MAX_THREADS 64
+#define CACHE_VERSION 1
+#define CACHE_BYTE_ORDER 0x01020304
+
+struct _LogSummaryChannel
+{
+	const LogSummary *summary;
+	const float *samples;	/* Borrowed, must outlive the summary */
+	float *min;		/* Every level's buckets back to back */
+	float *max;
+	float *mean;
+};
+
+struct _LogSummary
+{
+	int channel_count;
+	size_t rows;
+	int level_count;
+	size_t span[MAX_LEVELS];	/* Samples per bucket */
+	size_t count[MAX_LEVELS];	/* Buckets in the level */
+	size_t offset[MAX_LEVELS];	/* First bucket of the level */
+	size_t buckets;			/* All levels */
+	LogSummaryChannel *channels;
+	float *storage;			/* channel_count * 3 * buckets */
+};
+
+typedef struct
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t fanout;
+	uint64_t log_size;
+	int64_t log_mtime;
+	int64_t log_mtime_nsec;
+	uint64_t rows;
+	uint32_t channels;
+	uint32_t reserved;
+} CacheHeader;
+
+typedef struct
+{
+	LogSummary *summary;
+	int next_channel;	/* Shared work counter */
+} Job;
+
+
+/*!
+  \brief summary_new() lays out the levels for rows samples and allocates
+  bucket storage for every channel
+  */
+static LogSummary *summary_new(const float **columns, int channels, size_t rows)
+{
+	LogSummary *summary = NULL;
+	size_t count = 0;
+	size_t span = LOG_SUMMARY_FANOUT;
+
+	summary = (LogSummary *)calloc(1,sizeof(LogSummary));
+	if (!summary)
+		return NULL;
+	summary->channel_count = channels;
+	summary->rows = rows;
+	count = rows;
+	while ((count > 1) && (summary->level_count < MAX_LEVELS))
+	{
+		int level = summary->level_count++;
+
+		count = (count + LOG_SUMMARY_FANOUT - 1) / LOG_SUMMARY_FANOUT;
+		summary->span[level] = span;
+		summary->count[level] = count;
+		summary->offset[level] = summary->buckets;
+		summary->buckets += count;
+		span *= LOG_SUMMARY_FANOUT;
+	}
+	summary->channels = (LogSummaryChannel *)calloc(channels > 0 ? channels : 1,sizeof(LogSummaryChannel));
+	if (summary->buckets > 0)
+		summary->storage = (float *)malloc((size_t)channels * 3 * summary->buckets * sizeof(float));
+	if ((!summary->channels) || ((summary->buckets > 0) && (!summary->storage)))
+	{
+		log_summary_free(summary);
+		return NULL;
+	}
+	for (int i=0;i < channels;i++)
+	{
+		LogSummaryChannel *channel = &summary->channels[i];
+
+		channel->summary = summary;
+		channel->samples = columns[i];
+		if (!summary->storage)
+			continue;
+		channel->min = summary->storage + (size_t)i * 3 * summary->buckets;
+		channel->max = channel->min + summary->buckets;
+		channel->mean = channel->max + summary->buckets;
+	}
+	return summary;
+}
+
+
+/*!
+  \brief bucket_samples() is how many samples a bucket covers, only the
+  last bucket of a level can be short
+  */
+static size_t bucket_samples(const LogSummary *summary, int level, size_t bucket)
+{
+	size_t start = bucket * summary->span[level];
+	size_t left = summary->rows - start;
+
+	return left < summary->span[level] ? left : summary->span[level];
+}
+
+
+/*!
+  \brief summarize_channel() fills level 0 from the samples and every
+  level above from the one below it
+  */
+static void summarize_channel(LogSummaryChannel *channel)
+{
+	const LogSummary *summary = channel->summary;
+	const float *samples = channel->samples;
+
+	if ((!samples) || (summary->level_count == 0))
+		return;
+	for (size_t b=0;b < summary->count[0];b++)
+	{
+		size_t start = b * LOG_SUMMARY_FANOUT;
+		size_t end = start + LOG_SUMMARY_FANOUT;
+		float lo = samples[start];
+		float hi = samples[start];
+		double sum = 0.0;
+
+		if (end > summary->rows)
+			end = summary->rows;
+		for (size_t i=start;i < end;i++)
+		{
+			float v = samples[i];
+			if (v < lo)
+				lo = v;
+			if (v > hi)
+				hi = v;
+			sum += v;
+		}
+		channel->min[b] = lo;
+		channel->max[b] = hi;
+		channel->mean[b] = (float)(sum / (double)(end - start));
+	}
+	for (int level=1;level < summary->level_count;level++)
+	{
+		size_t below = summary->offset[level - 1];
+		size_t here = summary->offset[level];
+
+		for (size_t b=0;b < summary->count[level];b++)
+		{
+			size_t first = b * LOG_SUMMARY_FANOUT;
+			size_t last = first + LOG_SUMMARY_FANOUT;
+			float lo = channel->min[below + first];
+			float hi = channel->max[below + first];
+			double sum = 0.0;
+			size_t samples_seen = 0;
+
+			if (last > summary->count[level - 1])
+				last = summary->count[level - 1];
+			for (size_t c=first;c < last;c++)
+			{
+				size_t n = bucket_samples(summary,level - 1,c);
+				if (channel->min[below + c] < lo)
+					lo = channel->min[below + c];
+				if (channel->max[below + c] > hi)
+					hi = channel->max[below + c];
+				sum += (double)channel->mean[below + c] * n;
+				samples_seen += n;
+			}
+			channel->min[here + b] = lo;
+			channel->max[here + b] = hi;
+			channel->mean[here + b] = (float)(sum / (double)samples_seen);
+		}
+	}
+}
+
+
+static void *worker(void *data)
+{
+	Job *job = (Job *)data;
+
+	for (;;)
+	{
+		int index = __atomic_fetch_add(&job->next_channel,1,__ATOMIC_RELAXED);
+
+		if (index >= job->summary->channel_count)
+			break;
+		summarize_channel(&job->summary->channels[index]);
+	}
+	return NULL;
+}
+
+
+/*!
+  \brief log_summary_build() summarizes every field of a loaded log
+  \param columns are the channels sample arrays, which the summary keeps
+  pointers to for the unaligned edges of a query
+  \param channels is how many columns there are
+  \param rows is the sample count of every column
+  \param threads is the worker count, 0 for one per online CPU
+  \returns the summary, or NULL if out of memory
+  */
+LogSummary *log_summary_build(const float **columns, int channels, size_t rows, int threads)
+{
+	LogSummary *summary = NULL;
+	pthread_t ids[MAX_THREADS];
+	Job job;
+	int started = 0;
+
+	summary = summary_new(columns,channels,rows);
+	if (!summary)
+		return NULL;
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads > channels)
+		threads = channels;
+	if (threads > MAX_THREADS)
+		threads = MAX_THREADS;
+
+	job.summary = summary;
+	job.next_channel = 0;
+	for (started=0;started < threads;started++)
+		if (pthread_create(&ids[started],NULL,worker,&job) != 0)
+			break;
+	if (started == 0)
+		worker(&job);
+	for (int i=0;i < started;i++)
+		pthread_join(ids[i],NULL);
+	return summary;
+}
+
+
+/*!
+  \brief log_summary_cache_path() names the cache file kept next to a log
+  \returns a malloc()'d path the caller must free()
+  */
+char *log_summary_cache_path(const char *log_path)
+{
+	size_t len = strlen(log_path);
+	char *path = (char *)malloc(len + sizeof(".mtxsum"));
+
+	if (path)
+		snprintf(path,len + sizeof(".mtxsum"),"%s.mtxsum",log_path);
+	return path;
+}
+
+
+/*!
+  \brief log_summary_save() writes the summary next to its log, through a
+  temporary file so a reader never sees half a cache
+  \param summary is the summary to save
+  \param path is the cache file
+  \param log_path is the log it summarizes, whose size and mtime are stored
+  \returns 0 on success, -1 on error
+  */
+int log_summary_save(const LogSummary *summary, const char *path, const char *log_path)
+{
+	CacheHeader header;
+	struct stat st;
+	char *tmp = NULL;
+	size_t bytes = 0;
+	int fd = -1;
+	int result = -1;
+
+	if ((!summary) || (stat(log_path,&st) != 0))
+		return -1;
+	memset(&header,0,sizeof(header));
+	memcpy(header.magic,"MTXS",4);
+	header.version = CACHE_VERSION;
+	header.byte_order = CACHE_BYTE_ORDER;
+	header.fanout = LOG_SUMMARY_FANOUT;
+	header.log_size = (uint64_t)st.st_size;
+	header.log_mtime = (int64_t)st.st_mtim.tv_sec;
+	header.log_mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+	header.rows = summary->rows;
+	header.channels = (uint32_t)summary->channel_count;
+
+	tmp = (char *)malloc(strlen(path) + sizeof(".tmp"));
+	if (!tmp)
+		return -1;
+	sprintf(tmp,"%s.tmp",path);
+	fd = open(tmp,O_WRONLY|O_CREAT|O_TRUNC,0644);
+	if (fd < 0)
+	{
+		free(tmp);
+		return -1;
+	}
+	bytes = (size_t)summary->channel_count * 3 * summary->buckets * sizeof(float);
+	if ((write(fd,&header,sizeof(header)) == (ssize_t)sizeof(header)) &&
+			((bytes == 0) || (write(fd,summary->storage,bytes) == (ssize_t)bytes)))
+		result = 0;
+	if (close(fd) != 0)
+		result = -1;
+	if (result == 0)
+		result = rename(tmp,path) == 0 ? 0 : -1;
+	if (result != 0)
+		unlink(tmp);
+	free(tmp);
+	return result;
+}
+
+
+/*!
+  \brief log_summary_load() reads a saved summary back if it still
+  describes the log
+  \param path is the cache file
+  \param log_path is the log, whose size and mtime must match the cache
+  \param columns are the loaded sample arrays, as for log_summary_build()
+  \param channels is how many columns there are
+  \param rows is the sample count of every column
+  \returns the summary, or NULL if there is no usable cache
+  */
+LogSummary *log_summary_load(const char *path, const char *log_path, const float **columns, int channels, size_t rows)
+{
+	LogSummary *summary = NULL;
+	CacheHeader header;
+	struct stat log_st;
+	struct stat st;
+	size_t bytes = 0;
+	int fd = -1;
+
+	if (stat(log_path,&log_st) != 0)
+		return NULL;
+	fd = open(path,O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	if ((fstat(fd,&st) != 0) ||
+			(read(fd,&header,sizeof(header)) != (ssize_t)sizeof(header)) ||
+			(memcmp(header.magic,"MTXS",4) != 0) ||
+			(header.version != CACHE_VERSION) ||
+			(header.byte_order != CACHE_BYTE_ORDER) ||
+			(header.fanout != LOG_SUMMARY_FANOUT) ||
+			(header.log_size != (uint64_t)log_st.st_size) ||
+			(header.log_mtime != (int64_t)log_st.st_mtim.tv_sec) ||
+			(header.log_mtime_nsec != (int64_t)log_st.st_mtim.tv_nsec) ||
+			(header.rows != rows) ||
+			(header.channels != (uint32_t)channels))
+	{
+		close(fd);
+		return NULL;
+	}
+	summary = summary_new(columns,channels,rows);
+	if (!summary)
+	{
+		close(fd);
+		return NULL;
+	}
+	bytes = (size_t)channels * 3 * summary->buckets * sizeof(float);
+	if (((size_t)st.st_size != sizeof(header) + bytes) ||
+			((bytes > 0) && (read(fd,summary->storage,bytes) != (ssize_t)bytes)))
+	{
+		log_summary_free(summary);
+		summary = NULL;
+	}
+	close(fd);
+	return summary;
+}
+
+
+/*!
+  \brief log_summary_open() gets the summary of a loaded log, from its
+  cache file when that is current, otherwise by building it and, when
+  caching, saving it for next time
+  \param log_path is the log file
+  \param columns are the loaded sample arrays
+  \param channels is how many columns there are
+  \param rows is the sample count of every column
+  \param threads is the build worker count, 0 for one per online CPU
+  \param cache is nonzero to read and write the cache file
+  \returns the summary, or NULL if out of memory
+  */
+LogSummary *log_summary_open(const char *log_path, const float **columns, int channels, size_t rows, int threads, int cache)
+{
+	LogSummary *summary = NULL;
+	char *path = NULL;
+
+	if (cache)
+		path = log_summary_cache_path(log_path);
+	if (path)
+		summary = log_summary_load(path,log_path,columns,channels,rows);
+	if (!summary)
+	{
+		summary = log_summary_build(columns,channels,rows,threads);
+		/* A read-only log directory just means no cache */
+		if ((summary) && (path))
+			log_summary_save(summary,path,log_path);
+	}
+	free(path);
+	return summary;
+}
+
+
+/*!
+  \brief log_summary_channel() gets one field of a summary
+  */
+const LogSummaryChannel *log_summary_channel(const LogSummary *summary, int channel)
+{
+	if ((!summary) || (channel < 0) || (channel >= summary->channel_count))
+		return NULL;
+	return &summary->channels[channel];
+}
+
+
+/*!
+  \brief log_summary_levels() is how many levels the pyramid has
+  */
+int log_summary_levels(const LogSummary *summary)
+{
+	return summary ? summary->level_count : 0;
+}
+
+
+/*!
+  \brief log_summary_level_for() picks the level matching a pixel density
+  \param summary is the summary
+  \param samples_per_pixel is how many samples one pixel column covers
+  \returns the coarsest level whose buckets fit in a pixel, or -1 when
+  raw samples are needed
+  */
+int log_summary_level_for(const LogSummary *summary, double samples_per_pixel)
+{
+	int level = -1;
+
+	if (!summary)
+		return -1;
+	while ((level + 1 < summary->level_count) && ((double)summary->span[level + 1] <= samples_per_pixel))
+		level++;
+	return level;
+}
+
+
+/*!
+  \brief log_summary_query() reduces a span of samples to min/max/mean,
+  using the coarsest buckets that lie wholly inside the span
+  \param channel is the field
+  \param first is the first sample
+  \param count is how many samples, clipped to the end of the log
+  \param range is filled in
+  \returns the number of samples covered, 0 if the span is empty
+  */
+size_t log_summary_query(const LogSummaryChannel *channel, size_t first, size_t count, LogSummaryRange *range)
+{
+	const LogSummary *summary = NULL;
+	size_t end = 0;
+	size_t p = first;
+	float lo = FLT_MAX;
+	float hi = -FLT_MAX;
+	double sum = 0.0;
+
+	if ((!channel) || (!channel->samples) || (!range))
+		return 0;
+	summary = channel->summary;
+	if ((count == 0) || (first >= summary->rows))
+		return 0;
+	end = (count > summary->rows - first) ? summary->rows : first + count;
+	while (p < end)
+	{
+		int level = summary->level_count - 1;
+
+		for (;level >= 0;level--)
+		{
+			size_t span = summary->span[level];
+			size_t stop = p + span;
+			size_t b = 0;
+
+			if (p % span != 0)
+				continue;
+			if (stop > summary->rows)
+				stop = summary->rows;
+			if (stop > end)
+				continue;
+			b = summary->offset[level] + p / span;
+			if (channel->min[b] < lo)
+				lo = channel->min[b];
+			if (channel->max[b] > hi)
+				hi = channel->max[b];
+			sum += (double)channel->mean[b] * (stop - p);
+			p = stop;
+			break;
+		}
+		if (level < 0)
+		{
+			float v = channel->samples[p++];
+			if (v < lo)
+				lo = v;
+			if (v > hi)
+				hi = v;
+			sum += v;
+		}
+	}
+	range->min = lo;
+	range->max = hi;
+	range->samples = end - first;
+	range->mean = (float)(sum / (double)range->samples);
+	return range->samples;
+}
+
+
+/*!
+  \brief log_summary_free() releases a summary, not the sample arrays
+  */
+void log_summary_free(LogSummary *summary)
+{
+	if (!summary)
+		return;
+	free(summary->storage);
+	free(summary->channels);
+	free(summary);
+}
@@ -19,10 +19,13 @@
   \author David Andruczyk
   */
 
+#include <data/datalog_mlg.h>
 #include <debugging.h>
 #include <getfiles.h>
 #include <gui_handlers.h>
 #include <keyparser.h>
+#include <log_parser.h>
+#include <log_summary.h>
 #include <logviewer_gui.h>
 #include <math.h>
 #include <notifications.h>
@@ -116,7 +119,7 @@ G_MODULE_EXPORT gboolean select_datalog_for_import(GtkWidget *widget, gpointer d
 {
 	MtxFileIO *fileio = NULL;
 	gchar *filename = NULL;
-	GIOChannel *iochannel = NULL;
+	gboolean loaded = FALSE;
 
 	ENTER();
 	reset_logviewer_state();
@@ -138,19 +141,19 @@ G_MODULE_EXPORT gboolean select_datalog_for_import(GtkWidget *widget, gpointer d
 		return FALSE;
 	}
 
-	iochannel = g_io_channel_new_file(filename, "r+",NULL);
-	if (!iochannel)
+	if (g_str_has_suffix(filename,".mlg") || g_str_has_suffix(filename,".MLG"))
+		loaded = load_logviewer_mlg(filename);
+	else
+		loaded = load_logviewer_path(filename);
+	if (!loaded)
 	{
 		update_logbar("dlog_view","warning",_("File open FAILURE! \n"),FALSE,FALSE,FALSE);
+		free_mtxfileio(fileio);
 		EXIT();
 		return FALSE;
 	}
 
 	update_logbar("dlog_view",NULL,_("DataLog ViewFile Opened\n"),FALSE,FALSE,FALSE);
-	load_logviewer_file(iochannel);
-	g_io_channel_shutdown(iochannel,FALSE,NULL);
-	g_io_channel_unref(iochannel);
-
 	update_logbar("dlog_view",NULL,_("LogView File Closed\n"),FALSE,FALSE,FALSE);
 	gtk_widget_set_sensitive(lookup_widget("logviewer_controls_hbox"),TRUE);
 	enable_playback_controls(TRUE);
@@ -184,6 +187,215 @@ G_MODULE_EXPORT void load_logviewer_file(GIOChannel *iochannel)
 }
 
 
+/*!
+  \brief report_load_progress() shows datalog load progress in the logbar
+  every 10% and keeps the GUI drawing while the parser threads run
+  \param fraction is how much of the file has been parsed
+  \param data points at the last percentage shown
+  */
+static void report_load_progress(double fraction, void *data)
+{
+	gint *shown = (gint *)data;
+	gint percent = (gint)(fraction * 100.0);
+	gchar *msg = NULL;
+
+	if (percent / 10 <= *shown / 10)
+		return;
+	*shown = percent;
+	msg = g_strdup_printf(_("Loading datalog... %i%%\n"),percent);
+	update_logbar("dlog_view",NULL,msg,FALSE,FALSE,FALSE);
+	g_free(msg);
+	while (gtk_events_pending())
+		gtk_main_iteration();
+}
+
+
+/*!
+  \brief load_logviewer_path() loads a text datalog for playback using the
+  parallel parser, which fills each field's array in one go instead of
+  appending value by value
+  \param filename is the path of the datalog
+  \returns TRUE if the file had a header and was loaded
+  */
+G_MODULE_EXPORT gboolean load_logviewer_path(const gchar *filename)
+{
+	LogParse *parse = NULL;
+	Log_Info *log_info = NULL;
+	Rtv_Map *rtv_map = NULL;
+	gconstpointer *object = NULL;
+	GArray *array = NULL;
+	gfloat *column = NULL;
+	gint shown = 0;
+
+	ENTER();
+	parse = log_parse_file(filename,0,report_load_progress,&shown);
+	if (!parse)
+	{
+		EXIT();
+		return FALSE;
+	}
+	log_info = initialize_log_info();
+	DATA_SET(global_data,"log_info",log_info);
+	log_info->delimiter = g_strdup(parse->delimiter == '\t' ? "\t" : ",");
+	log_info->field_count = parse->field_count;
+	if (parse->signature)
+	{
+		log_info->signature = g_strdup(parse->signature);
+		rtv_map = (Rtv_Map *)DATA_GET(global_data,"rtv_map");
+		if ((DATA_GET(global_data,"offline")) && (rtv_map) && (rtv_map->applicable_signatures))
+		{
+			if (strstr(rtv_map->applicable_signatures,log_info->signature) != NULL)
+				printf(_("Good this firmware is compatible with the firmware we're using\n"));
+			else
+				printf(_("mismatch between datalog and current firmware, playback via full gui will probably not work like you expected\n"));
+		}
+	}
+
+	for (gint i=0;i<parse->field_count;i++)
+	{
+		object = g_new0(gconstpointer, 1);
+		array = g_array_sized_new(FALSE,TRUE,sizeof(gfloat),parse->rows);
+		column = log_parse_take_column(parse,i);
+		g_array_append_vals(array,column,parse->rows);
+		free(column);
+		DATA_SET(object,"data_array",(gpointer)array);
+		DATA_SET_FULL(object,"lview_name",g_strdup(parse->names[i]),g_free);
+		if (parse->precision[i] > 0)
+			DATA_SET(object,"precision",GINT_TO_POINTER(parse->precision[i]));
+		g_ptr_array_add(log_info->log_list,object);
+	}
+	if (parse->markers > 0)
+		printf(_("%i MARKs found in logfile. MTX doesn't do anything with these yet...!\n"),(gint)parse->markers);
+	if (parse->skipped > 0)
+		MTXDBG(CRITICAL,_("%i malformed datalog lines were tossed\n"),(gint)parse->skipped);
+
+	attach_log_summary(log_info,filename);
+	gtk_widget_set_sensitive(lookup_widget("logviewer_select_params_button"), TRUE);
+	OBJ_SET(lookup_widget("logviewer_trace_darea"),"log_info",(gpointer)log_info);
+	populate_limits(log_info);
+	log_parse_free(parse);
+	EXIT();
+	return TRUE;
+}
+
+
+/*!
+  \brief load_logviewer_mlg() streams a MegaLogViewer binary log straight
+  into the per-field arrays, without the text parsing pass
+  \param filename is the path of the .mlg file
+  \returns TRUE if the file was an MLG log and was loaded
+  */
+G_MODULE_EXPORT gboolean load_logviewer_mlg(const gchar *filename)
+{
+	MlgReader *reader = NULL;
+	Log_Info *log_info = NULL;
+	const MlgField *fields = NULL;
+	GArray **arrays = NULL;
+	gconstpointer *object = NULL;
+	gfloat *values = NULL;
+	gint64 time_us = 0;
+	gint count = 0;
+	gint markers = 0;
+	MlgRecordKind kind;
+
+	ENTER();
+	reader = mlg_reader_open(filename);
+	if (!reader)
+	{
+		EXIT();
+		return FALSE;
+	}
+	log_info = initialize_log_info();
+	DATA_SET(global_data,"log_info",log_info);
+	log_info->delimiter = g_strdup(",");
+	log_info->signature = g_strdup(mlg_reader_info(reader));
+
+	count = mlg_reader_field_count(reader);
+	fields = mlg_reader_fields(reader);
+	log_info->field_count = count;
+	arrays = g_new0(GArray *, count);
+	values = g_new0(gfloat, count);
+	for (gint i=0;i<count;i++)
+	{
+		object = g_new0(gconstpointer, 1);
+		arrays[i] = g_array_sized_new(FALSE,TRUE,sizeof(gfloat),4096);
+		DATA_SET(object,"data_array",(gpointer)arrays[i]);
+		DATA_SET_FULL(object,"lview_name",g_strdup(fields[i].name),g_free);
+		DATA_SET(object,"precision",GINT_TO_POINTER(fields[i].digits > 0 ? fields[i].digits : 0));
+		g_ptr_array_add(log_info->log_list,object);
+	}
+
+	while ((kind = mlg_reader_next(reader,&time_us,values,NULL)) > MLG_RECORD_END)
+	{
+		if (kind == MLG_RECORD_MARKER)
+		{
+			markers++;
+			continue;
+		}
+		for (gint i=0;i<count;i++)
+			g_array_append_val(arrays[i],values[i]);
+	}
+	if (kind == MLG_RECORD_ERROR)
+		MTXDBG(CRITICAL,_("MLG log is truncated, loaded what was readable\n"));
+	if (markers > 0)
+		printf(_("%i markers found in logfile. MTX doesn't do anything with these yet...!\n"),markers);
+	if (mlg_reader_crc_errors(reader) > 0)
+		MTXDBG(CRITICAL,_("%i MLG records failed their checksum and were skipped\n"),(gint)mlg_reader_crc_errors(reader));
+
+	attach_log_summary(log_info,filename);
+	gtk_widget_set_sensitive(lookup_widget("logviewer_select_params_button"), TRUE);
+	OBJ_SET(lookup_widget("logviewer_trace_darea"),"log_info",(gpointer)log_info);
+	populate_limits(log_info);
+
+	g_free(values);
+	g_free(arrays);
+	mlg_reader_close(reader);
+	EXIT();
+	return TRUE;
+}
+
+
+/*!
+  \brief attach_log_summary() gives every loaded field a min/max/mean
+  pyramid, read from the cache next to the log when it is still current,
+  so trace_update() can draw any zoom level without walking every sample.
+  The data_arrays must not grow while the summary is attached.
+  \param log_info is the loaded log
+  \param filename is the path of the log
+  */
+G_MODULE_EXPORT void attach_log_summary(Log_Info *log_info, const gchar *filename)
+{
+	const gfloat **columns = NULL;
+	gconstpointer *object = NULL;
+	GArray *array = NULL;
+	guint rows = G_MAXUINT;
+
+	ENTER();
+	if (log_info->field_count == 0)
+	{
+		EXIT();
+		return;
+	}
+	columns = g_new0(const gfloat *, log_info->field_count);
+	for (guint i=0;i<log_info->field_count;i++)
+	{
+		object = (gconstpointer *)g_ptr_array_index(log_info->log_list,i);
+		array = (GArray *)DATA_GET(object,"data_array");
+		columns[i] = (const gfloat *)array->data;
+		rows = MIN(rows,array->len);
+	}
+	log_info->summary = log_summary_open(filename,columns,log_info->field_count,rows,0,(GBOOLEAN)DATA_GET(global_data,"lv_summary_cache"));
+	for (guint i=0;i<log_info->field_count;i++)
+	{
+		object = (gconstpointer *)g_ptr_array_index(log_info->log_list,i);
+		DATA_SET(object,"summary",(gpointer)log_summary_channel(log_info->summary,i));
+	}
+	g_free(columns);
+	EXIT();
+	return;
+}
+
+
 /*!
   \brief initialixe_log_info() alocates, and sets to sane defaults the fields
   of the log_info struture
@@ -427,6 +639,7 @@ G_MODULE_EXPORT void free_log_info(Log_Info *log_info)
 		return;
 	}
 
+	log_summary_free(log_info->summary);
 	for (i=0;i<log_info->field_count;i++)
 	{
 		object = NULL;
@@ -434,10 +647,13 @@ G_MODULE_EXPORT void free_log_info(Log_Info *log_info)
 		if (!object)
 			continue;
 		array = (GArray *)DATA_GET(object,"data_array");
+		DATA_SET(object,"summary",NULL);
 		g_free(DATA_GET(object,"lview_name"));
 		if (array)
 			g_array_free(array,TRUE);
 	}
+	if (log_info->events)
+		g_array_free(log_info->events,TRUE);
 	if (log_info->delimiter)
 		g_free(log_info->delimiter);
 	g_free(log_info);
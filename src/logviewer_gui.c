@@ -22,9 +22,12 @@
 #include <getfiles.h>
 #include <glade/glade.h>
 #include <listmgmt.h>
+#include <log_query.h>
+#include <log_summary.h>
 #include <logviewer_events.h>
 #include <logviewer_gui.h>
 #include <math.h>
+#include <notifications.h>
 #include <rtv_map_loader.h>
 #include <stdlib.h>
 #include <timeout_handlers.h>
@@ -40,6 +43,15 @@ Logview_Data *lv_data = NULL;
 static GMutex update_mutex;
 extern gconstpointer *global_data;
 
+static guint trace_len(Viewable_Value *);
+static gfloat trace_value(Viewable_Value *, guint);
+static gboolean trace_span(Viewable_Value *, guint, guint, LogSummaryRange *);
+static guint first_event(GArray *, guint);
+static gboolean event_in_range(GArray *, guint, guint);
+static void draw_event_marks(GdkPixmap *, guint, gint, gint, gint, gint);
+static void present_event_list(Log_Info *);
+static void event_row_activated(GtkTreeView *, GtkTreePath *, GtkTreeViewColumn *, gpointer);
+
 /*!
   \brief present_viewer_choices() presents the user with the a list of 
   variables from EITHER the realtime vars (if in realtime mode) or from a 
@@ -544,6 +556,7 @@ G_MODULE_EXPORT Viewable_Value * build_v_value(gconstpointer *object)
 		 * over to v_value so it can be drawn...
 		 */
 		v_value->data_source = g_strdup("data_array");
+		v_value->live = FALSE;
 	}
 	else
 	{
@@ -555,6 +568,7 @@ G_MODULE_EXPORT Viewable_Value * build_v_value(gconstpointer *object)
 		 * (more initial mem usage,  but less calls to malloc...
 		 */
 		v_value->data_source = g_strdup("history");
+		v_value->live = TRUE;
 	}
 	/* Store pointer to object, but DO NOT FREE THIS on v_value destruction
 	 * as its the SAME one used for all Viewable_Values */
@@ -684,6 +698,16 @@ G_MODULE_EXPORT GdkGC * initialize_gc(GdkDrawable *drawable, GcType type)
 					&values,
 					GDK_GC_FOREGROUND);
 			break;
+		case EVENT_MARK:
+			color.red = 10240;
+			color.green = 14336;
+			color.blue = 30720;
+			gdk_colormap_alloc_color(cmap,&color,TRUE,TRUE);
+			values.foreground = color;
+			gc = gdk_gc_new_with_values(GDK_DRAWABLE(drawable),
+					&values,
+					GDK_GC_FOREGROUND);
+			break;
 	}	
 	EXIT();
 	return gc;	
@@ -871,7 +895,6 @@ G_MODULE_EXPORT void draw_valtext(gboolean force_draw)
 	gint info_ctr = 0;
 	gint h = 0;
 	gint i = 0;
-	GArray *array = NULL;
 	Viewable_Value *v_value = NULL;
 	PangoLayout *layout;
 	GdkPixmap *pixmap = lv_data->pixmap;
@@ -896,10 +919,9 @@ G_MODULE_EXPORT void draw_valtext(gboolean force_draw)
 		val_y = info_ctr + 1;
 
 		last_index = v_value->last_index;
-		array = (GArray *)DATA_GET(v_value->object,v_value->data_source);
-		val = g_array_index(array,gfloat,last_index);
-		if (array->len > 1)
-			last_val = g_array_index(array,gfloat,last_index-1);
+		val = trace_value(v_value,last_index);
+		if (trace_len(v_value) > 1)
+			last_val = trace_value(v_value,last_index-1);
 		/* IF this value matches the last one,  don't bother
 		 * updating the text as there's no point... */
 		if ((val == last_val) && (!force_draw) && (!v_value->force_update))
@@ -1030,10 +1052,11 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 	guint i = 0;
 	gfloat log_pos = 0.0;
 	gfloat newpos = 0.0;
-	GArray *array = NULL;
 	GdkPoint pts[2048]; /* Bad idea as static...*/
 	Viewable_Value *v_value = NULL;
 	gint lv_zoom;
+	gint lv_span;
+	LogSummaryRange range;
 	/*static gulong sig_id = 0;*/
 	static GtkWidget *scale = NULL;
 	GtkAllocation allocation;
@@ -1044,6 +1067,7 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 	pixmap = lv_data->pixmap;
 
 	lv_zoom = (GINT)DATA_GET(global_data,"lv_zoom");
+	lv_span = MAX((GINT)DATA_GET(global_data,"lv_span"),1);
 	/*
 	if (sig_id == 0)
 		sig_id = g_signal_handler_find(lookup_widget("logviewer_log_position_hscale"),G_SIGNAL_MATCH_FUNC,0,0,NULL,(gpointer)logviewer_log_position_change,NULL);
@@ -1060,12 +1084,17 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 	if ((GBOOLEAN)redraw_all)
 	{
 		gint lo_width = allocation.width-lv_data->info_width;
+		/* Event search matches go under the traces */
+		if ((DATA_GET(global_data,"playback_mode")) && (lv_data->tlist))
+		{
+			v_value = (Viewable_Value *)g_list_nth_data(lv_data->tlist,0);
+			draw_event_marks(pixmap,trace_len(v_value)*(log_pos/100.0),w,h,lv_zoom,lv_span);
+		}
 		for (i=0;i<g_list_length(lv_data->tlist);i++)
 		{
 			gint total = 0;
 			v_value = (Viewable_Value *)g_list_nth_data(lv_data->tlist,i);
-			array = (GArray *)DATA_GET(v_value->object,v_value->data_source);
-			len = array->len;
+			len = trace_len(v_value);
 			if (len == 0)	/* If empty */
 			{
 				EXIT();
@@ -1076,17 +1105,40 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 			/*printf("length after is  %i\n", len);*/
 			/* Determine total number of points 
 			 * that'll fit on the window
-			 * taking into account the scroll amount
+			 * taking into account the scroll amount,
+			 * each point covering lv_span samples
 			 */
-			total = len < lo_width/lv_zoom ? len : lo_width/lv_zoom;
+			total = (len+lv_span-1)/lv_span;
+			total = total < lo_width/lv_zoom ? total : lo_width/lv_zoom;
 
 
 			/* Draw is reverse order, from right to left, 
 			 * easier to think out in my head... :) 
+			 * Zoomed out, each point is the mean of its samples
+			 * with a bar from their min to their max, which come
+			 * from the log summary so this doesn't walk the log.
 			 */
 			for (gint x=0;x<total;x++)
 			{
-				val = g_array_index(array,gfloat,len-1-x);
+				if (lv_span > 1)
+				{
+					gint first = len-(x+1)*lv_span;
+					gint count = lv_span;
+					if (first < 0)
+					{
+						count += first;
+						first = 0;
+					}
+					trace_span(v_value,first,count,&range);
+					val = range.mean;
+					if (range.max > range.min)
+						gdk_draw_line(pixmap,
+								v_value->trace_gc,
+								w-(x*lv_zoom)-1,(GINT)((1.0-(range.max/(float)(v_value->upper-v_value->lower)))*(h-2))+1,
+								w-(x*lv_zoom)-1,(GINT)((1.0-(range.min/(float)(v_value->upper-v_value->lower)))*(h-2))+1);
+				}
+				else
+					val = trace_value(v_value,len-1-x);
 				percent = 1.0-(val/(float)(v_value->upper-v_value->lower));
 				pts[x].x = w-(x*lv_zoom)-1;
 				pts[x].y = (GINT) (percent*(h-2))+1;
@@ -1125,25 +1177,46 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 	/* Playback mode, playing from logfile.... */
 	if (DATA_GET(global_data,"playback_mode"))
 	{
+		Log_Info *log_info = (Log_Info *)DATA_GET(global_data,"log_info");
+
+		/* Mark the new column if it plays back part of an event */
+		v_value = (Viewable_Value *)g_list_nth_data(lv_data->tlist,0);
+		if ((v_value) && (log_info) && (log_info->events) &&
+				(event_in_range(log_info->events,v_value->last_index+1,v_value->last_index+lv_span)))
+		{
+			if (!lv_data->event_gc)
+				lv_data->event_gc = initialize_gc(pixmap,EVENT_MARK);
+			gdk_draw_rectangle(pixmap,lv_data->event_gc,TRUE,w-lv_zoom,0,lv_zoom,h);
+		}
 		for (i=0;i<g_list_length(lv_data->tlist);i++)
 		{
 			v_value = (Viewable_Value *)g_list_nth_data(lv_data->tlist,i);
-			array = (GArray *)DATA_GET(v_value->object,v_value->data_source);
 			last_index = v_value->last_index;
-			if(last_index >= array->len)
+			if(last_index >= trace_len(v_value))
 			{
 				EXIT();
 				return;
 			}
 
 			/*printf("got data from array at index %i\n",last_index+1);*/
-			val = g_array_index(array,gfloat,last_index+1);
+			/* Zoomed out, each step plays back lv_span samples */
+			if (!trace_span(v_value,last_index+1,lv_span,&range))
+			{
+				EXIT();
+				return;
+			}
+			val = range.mean;
 			percent = 1.0-(val/(float)(v_value->upper-v_value->lower));
-			if (val > (v_value->max))
-				v_value->max = val;
-			if (val < (v_value->min))
-				v_value->min = val;
+			if (range.max > (v_value->max))
+				v_value->max = range.max;
+			if (range.min < (v_value->min))
+				v_value->min = range.min;
 
+			if (range.max > range.min)
+				gdk_draw_line(pixmap,
+						v_value->trace_gc,
+						w-1,(GINT)((1.0-(range.max/(float)(v_value->upper-v_value->lower)))*(h-2))+1,
+						w-1,(GINT)((1.0-(range.min/(float)(v_value->upper-v_value->lower)))*(h-2))+1);
 			gdk_draw_line(pixmap,
 					v_value->trace_gc,
 					w-lv_zoom-1,v_value->last_y,
@@ -1152,10 +1225,10 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 
 			v_value->last_y = (GINT)((percent*(h-2))+1);
 
-			v_value->last_index = last_index + 1;
+			v_value->last_index = last_index + range.samples;
 			if (adj_scale)
 			{
-				newpos = 100.0*((gfloat)(v_value->last_index)/(gfloat)array->len);
+				newpos = 100.0*((gfloat)(v_value->last_index)/(gfloat)trace_len(v_value));
 				blocked=TRUE;
 				gtk_range_set_value(GTK_RANGE(scale),newpos);
 				blocked=FALSE;
@@ -1186,8 +1259,7 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 	for (i=0;i<g_list_length(lv_data->tlist);i++)
 	{
 		v_value = (Viewable_Value *)g_list_nth_data(lv_data->tlist,i);
-		array = (GArray *)DATA_GET(v_value->object,v_value->data_source);
-		val = g_array_index(array,gfloat, array->len-1);
+		val = trace_value(v_value,trace_len(v_value)-1);
 
 		if (val > (v_value->max))
 			v_value->max = val;
@@ -1200,7 +1272,7 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 		/* If watching at the edge (full realtime) */
 		if (log_pos >= 100)
 		{
-			v_value->last_index = array->len-1;
+			v_value->last_index = trace_len(v_value)-1;
 			percent = 1.0-(val/(float)(v_value->upper-v_value->lower));
 			gdk_draw_line(pixmap,
 					v_value->trace_gc,
@@ -1211,9 +1283,9 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 		{	/* Watching somewhat behind realtime... */
 			last_index = v_value->last_index;
 
-			last_val = g_array_index(array,gfloat,last_index);
+			last_val = trace_value(v_value,last_index);
 			last_percent = 1.0-(last_val/(float)(v_value->upper-v_value->lower));
-			val = g_array_index(array,gfloat,last_index+1);
+			val = trace_value(v_value,last_index+1);
 			percent = 1.0-(val/(float)(v_value->upper-v_value->lower));
 
 			v_value->last_index = last_index + 1;
@@ -1223,7 +1295,7 @@ G_MODULE_EXPORT void trace_update(gboolean redraw_all)
 					w-1,(GINT)(percent*(h-2))+1);
 			if (adj_scale)
 			{
-				newpos = 100.0*((gfloat)v_value->last_index/(gfloat)array->len);
+				newpos = 100.0*((gfloat)v_value->last_index/(gfloat)trace_len(v_value));
 				blocked = TRUE;
 				gtk_range_set_value(GTK_RANGE(scale),newpos);
 				blocked = FALSE;
@@ -1433,6 +1505,84 @@ G_MODULE_EXPORT gboolean logviewer_log_position_change(GtkWidget * widget, gpoin
 }
 
 
+/*!
+  \brief logviewer_search_activate() runs the event search typed into the
+  logviewer search entry over the loaded log, marks the matches on the
+  traces and lists them so the user can jump to each one. An empty search
+  clears the marks.
+  \param widget is the search entry
+  \param data is unused
+  \returns TRUE
+  */
+G_MODULE_EXPORT gboolean logviewer_search_activate(GtkWidget *widget, gpointer data)
+{
+	Log_Info *log_info = NULL;
+	LogQuery *query = NULL;
+	LogQueryMatch *matches = NULL;
+	gconstpointer *object = NULL;
+	GArray *array = NULL;
+	const gchar **names = NULL;
+	const gfloat **columns = NULL;
+	const gchar *text = NULL;
+	gchar *error = NULL;
+	gchar *msg = NULL;
+	guint rows = G_MAXUINT;
+	gsize count = 0;
+	guint i = 0;
+
+	ENTER();
+	log_info = (Log_Info *)DATA_GET(global_data,"log_info");
+	if ((!log_info) || (!DATA_GET(global_data,"playback_mode")))
+	{
+		EXIT();
+		return TRUE;
+	}
+	if (log_info->events)
+		g_array_free(log_info->events,TRUE);
+	log_info->events = NULL;
+
+	text = gtk_entry_get_text(GTK_ENTRY(widget));
+	if ((text) && (*text))
+	{
+		names = g_new0(const gchar *,log_info->field_count);
+		columns = g_new0(const gfloat *,log_info->field_count);
+		for (i=0;i<log_info->field_count;i++)
+		{
+			object = (gconstpointer *)g_ptr_array_index(log_info->log_list,i);
+			array = (GArray *)DATA_GET(object,"data_array");
+			names[i] = (const gchar *)DATA_GET(object,"lview_name");
+			columns[i] = array ? (const gfloat *)array->data : NULL;
+			rows = MIN(rows,array ? array->len : 0);
+		}
+		query = log_query_compile(text,names,log_info->field_count,&error);
+		if (!query)
+		{
+			msg = g_strdup_printf(_("Event search: %s\n"),error);
+			update_logbar("dlog_view","warning",msg,FALSE,FALSE,FALSE);
+			g_free(msg);
+			free(error);
+		}
+		else
+		{
+			count = log_query_run(query,columns,rows,&matches);
+			log_query_free(query);
+			log_info->events = g_array_sized_new(FALSE,FALSE,sizeof(LogQueryMatch),count);
+			g_array_append_vals(log_info->events,matches,count);
+			free(matches);
+			msg = g_strdup_printf(_("Event search found %i matches\n"),(gint)count);
+			update_logbar("dlog_view",NULL,msg,FALSE,FALSE,FALSE);
+			g_free(msg);
+			present_event_list(log_info);
+		}
+		g_free(names);
+		g_free(columns);
+	}
+	lv_configure_event(lookup_widget("logviewer_trace_darea"),NULL,NULL);
+	EXIT();
+	return TRUE;
+}
+
+
 /*!
   \brief Enable log playback controls
   \param state whether to enable or disable the playback controls
@@ -1660,3 +1810,299 @@ G_MODULE_EXPORT void read_logviewer_defaults(ConfigFile *cfgfile)
 	EXIT();
 	return;
 }
+
+
+/*!
+  \brief trace_len() gets the number of samples behind a trace, from the
+  realtime history or the playback data_array
+  \param v_value is the trace
+  \returns the sample count
+  */
+static guint trace_len(Viewable_Value *v_value)
+{
+	if (v_value->live)
+		return ((Rtv_History *)DATA_GET(v_value->object,"history"))->len;
+	return ((GArray *)DATA_GET(v_value->object,v_value->data_source))->len;
+}
+
+
+/*!
+  \brief trace_span() reduces count samples of a trace from first on to
+  their min/max/mean. Loaded logs answer from their summary pyramid in
+  about the same time at any span, realtime history is walked.
+  \param v_value is the trace
+  \param first is the first sample
+  \param count is the sample count, clipped to the end of the trace
+  \param range is filled in
+  \returns TRUE if any samples were covered
+  */
+static gboolean trace_span(Viewable_Value *v_value, guint first, guint count, LogSummaryRange *range)
+{
+	const LogSummaryChannel *channel = NULL;
+	guint len = trace_len(v_value);
+	gdouble sum = 0.0;
+	gfloat val = 0.0;
+
+	if (!v_value->live)
+		channel = (const LogSummaryChannel *)DATA_GET(v_value->object,"summary");
+	if (channel)
+		return log_summary_query(channel,first,count,range) > 0;
+	if ((count == 0) || (first >= len))
+		return FALSE;
+	count = MIN(count,len-first);
+	range->min = range->max = trace_value(v_value,first);
+	for (guint i=first;i<first+count;i++)
+	{
+		val = trace_value(v_value,i);
+		range->min = MIN(range->min,val);
+		range->max = MAX(range->max,val);
+		sum += val;
+	}
+	range->mean = sum/count;
+	range->samples = count;
+	return TRUE;
+}
+
+
+/*!
+  \brief trace_value() gets one sample of a trace. Realtime history may
+  read back spilled blocks, so it is read under the rtv_mutex.
+  \param v_value is the trace
+  \param index is the sample number
+  \returns the sample value
+  */
+static gfloat trace_value(Viewable_Value *v_value, guint index)
+{
+	static GMutex *rtv_mutex = NULL;
+	gfloat value = 0.0;
+
+	if (!v_value->live)
+		return g_array_index((GArray *)DATA_GET(v_value->object,v_value->data_source),gfloat,index);
+	if (!rtv_mutex)
+		rtv_mutex = (GMutex *)DATA_GET(global_data,"rtv_mutex");
+	g_mutex_lock(rtv_mutex);
+	value = rtv_history_get((Rtv_History *)DATA_GET(v_value->object,"history"),index);
+	g_mutex_unlock(rtv_mutex);
+	return value;
+}
+
+
+/*!
+  \brief first_event() finds the first event search match that ends at or
+  after a sample
+  \param events is the array of LogQueryMatch runs, in sample order
+  \param sample is the sample number
+  \returns the index of the match, events->len if there is none
+  */
+static guint first_event(GArray *events, guint sample)
+{
+	guint lo = 0;
+	guint hi = events->len;
+	guint mid = 0;
+
+	while (lo < hi)
+	{
+		mid = lo + (hi-lo)/2;
+		if (g_array_index(events,LogQueryMatch,mid).last < sample)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+
+/*!
+  \brief event_in_range() checks if any event search match covers part of
+  a span of samples
+  \param events is the array of LogQueryMatch runs
+  \param first is the first sample of the span
+  \param last is the last sample of the span
+  \returns TRUE if a match overlaps the span
+  */
+static gboolean event_in_range(GArray *events, guint first, guint last)
+{
+	guint i = first_event(events,first);
+
+	return (i < events->len) && (g_array_index(events,LogQueryMatch,i).first <= last);
+}
+
+
+/*!
+  \brief draw_event_marks() shades the pixel columns of every event search
+  match that is onscreen. Columns map to samples the way the full redraw
+  in trace_update() lays them out, right to left from the log position.
+  \param pixmap is the backing pixmap
+  \param len is the sample at the log position (the right edge)
+  \param w is the drawing area width
+  \param h is the drawing area height
+  \param zoom is the pixels per point
+  \param span is the samples per point
+  */
+static void draw_event_marks(GdkPixmap *pixmap, guint len, gint w, gint h, gint zoom, gint span)
+{
+	Log_Info *log_info = NULL;
+	LogQueryMatch *match = NULL;
+	guint visible = 0;
+	guint first_visible = 0;
+	gint x_start = 0;
+	gint x_end = 0;
+
+	log_info = (Log_Info *)DATA_GET(global_data,"log_info");
+	if ((!log_info) || (!log_info->events) || (len == 0))
+		return;
+	if (!lv_data->event_gc)
+		lv_data->event_gc = initialize_gc(pixmap,EVENT_MARK);
+	visible = ((w-lv_data->info_width)/zoom)*span;
+	first_visible = len > visible ? len-visible : 0;
+	for (guint i=first_event(log_info->events,first_visible);i<log_info->events->len;i++)
+	{
+		match = &g_array_index(log_info->events,LogQueryMatch,i);
+		if (match->first >= len)
+			break;
+		x_start = w-(gint)((len-1-MAX(match->first,first_visible))/span)*zoom-1;
+		x_end = w-(gint)((len-1-MIN(match->last,len-1))/span)*zoom-1;
+		x_start = MAX(x_start,lv_data->info_width);
+		if (x_end >= x_start)
+			gdk_draw_rectangle(pixmap,lv_data->event_gc,TRUE,x_start,0,x_end-x_start+1,h);
+	}
+}
+
+
+/*!
+  \brief present_event_list() lists the event search matches, with the
+  time and length of each when the log has a Time field. Activating a row
+  moves the log position to that match. Very long lists are cut short,
+  the marks still show every match.
+  \param log_info is the log that was searched
+  */
+static void present_event_list(Log_Info *log_info)
+{
+	static GtkWidget *window = NULL;
+	GtkWidget *scroll = NULL;
+	GtkWidget *view = NULL;
+	GtkListStore *store = NULL;
+	GtkCellRenderer *renderer = NULL;
+	GtkTreeIter iter;
+	gconstpointer *object = NULL;
+	GArray *times = NULL;
+	LogQueryMatch *match = NULL;
+	gchar *start = NULL;
+	gchar *length = NULL;
+	gchar *title = NULL;
+	guint shown = 0;
+	guint i = 0;
+
+	if (window)
+		gtk_widget_destroy(window);
+
+	for (i=0;i<log_info->field_count;i++)
+	{
+		object = (gconstpointer *)g_ptr_array_index(log_info->log_list,i);
+		if ((DATA_GET(object,"lview_name")) &&
+				(g_ascii_strcasecmp((const gchar *)DATA_GET(object,"lview_name"),"Time") == 0))
+			times = (GArray *)DATA_GET(object,"data_array");
+	}
+
+	store = gtk_list_store_new(EVENT_NUM_COLS,
+			G_TYPE_UINT,	/* number */
+			G_TYPE_STRING,	/* start */
+			G_TYPE_STRING,	/* length */
+			G_TYPE_UINT,	/* first sample */
+			G_TYPE_UINT);	/* last sample */
+	shown = MIN(log_info->events->len,5000);
+	for (i=0;i<shown;i++)
+	{
+		match = &g_array_index(log_info->events,LogQueryMatch,i);
+		if (times)
+		{
+			start = g_strdup_printf("%.3f s",g_array_index(times,gfloat,match->first));
+			length = g_strdup_printf("%.3f s",g_array_index(times,gfloat,match->last)-g_array_index(times,gfloat,match->first));
+		}
+		else
+		{
+			start = g_strdup_printf(_("sample %u"),(guint)match->first);
+			length = g_strdup_printf(_("%u samples"),(guint)(match->last-match->first+1));
+		}
+		gtk_list_store_append(store,&iter);
+		gtk_list_store_set(store,&iter,
+				COL_EVENT_NUMBER,i+1,
+				COL_EVENT_START,start,
+				COL_EVENT_LENGTH,length,
+				COL_EVENT_FIRST,(guint)match->first,
+				COL_EVENT_LAST,(guint)match->last,
+				-1);
+		g_free(start);
+		g_free(length);
+	}
+
+	view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+	g_object_unref(store);
+	renderer = gtk_cell_renderer_text_new();
+	gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view),-1,"#",renderer,"text",COL_EVENT_NUMBER,NULL);
+	gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view),-1,_("Start"),renderer,"text",COL_EVENT_START,NULL);
+	gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view),-1,_("Length"),renderer,"text",COL_EVENT_LENGTH,NULL);
+	g_signal_connect(G_OBJECT(view),"row-activated",
+			G_CALLBACK(event_row_activated),
+			NULL);
+
+	window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+	gtk_window_set_transient_for(GTK_WINDOW(window),GTK_WINDOW(lookup_widget("main_window")));
+	if (shown < log_info->events->len)
+		title = g_strdup_printf(_("Event Search: first %i of %i matches"),(gint)shown,(gint)log_info->events->len);
+	else
+		title = g_strdup_printf(_("Event Search: %i matches"),(gint)shown);
+	gtk_window_set_title(GTK_WINDOW(window),title);
+	g_free(title);
+	gtk_window_set_default_size(GTK_WINDOW(window),320,400);
+	g_signal_connect(G_OBJECT(window),"destroy",
+			G_CALLBACK(gtk_widget_destroyed),
+			&window);
+
+	scroll = gtk_scrolled_window_new(NULL,NULL);
+	gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),GTK_POLICY_AUTOMATIC,GTK_POLICY_AUTOMATIC);
+	gtk_container_add(GTK_CONTAINER(scroll),view);
+	gtk_container_add(GTK_CONTAINER(window),scroll);
+	gtk_widget_show_all(window);
+}
+
+
+/*!
+  \brief event_row_activated() moves the log position so the activated
+  event search match sits in the middle of the trace area
+  \param view is the event list
+  \param path is the activated row
+  \param column is unused
+  \param data is unused
+  */
+static void event_row_activated(GtkTreeView *view, GtkTreePath *path, GtkTreeViewColumn *column, gpointer data)
+{
+	GtkTreeModel *model = gtk_tree_view_get_model(view);
+	GtkTreeIter iter;
+	GtkAllocation allocation;
+	Viewable_Value *v_value = NULL;
+	guint first = 0;
+	guint last = 0;
+	guint rows = 0;
+	guint visible = 0;
+	guint end = 0;
+
+	if ((!lv_data) || (!lv_data->darea) || (!gtk_tree_model_get_iter(model,&iter,path)))
+		return;
+	gtk_tree_model_get(model,&iter,
+			COL_EVENT_FIRST,&first,
+			COL_EVENT_LAST,&last,
+			-1);
+	v_value = (Viewable_Value *)g_list_nth_data(lv_data->tlist,0);
+	if (!v_value)
+		return;
+	rows = trace_len(v_value);
+	if (rows == 0)
+		return;
+	gtk_widget_get_allocation(lv_data->darea,&allocation);
+	visible = ((allocation.width-lv_data->info_width)/MAX((GINT)DATA_GET(global_data,"lv_zoom"),1))*MAX((GINT)DATA_GET(global_data,"lv_span"),1);
+	end = first+(last-first)/2+visible/2;
+	end = MAX(end,last+1);
+	end = MIN(end,rows);
+	gtk_range_set_value(GTK_RANGE(lookup_widget("logviewer_log_position_hscale")),100.0*end/rows);
+}
@@ -0,0 +1,161 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute etc. this as long as the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file src/lookuptable_inverse.c
+  \ingroup CoreMtx
+  \brief Precomputed inverses for the lookuptables.
+
+  The reverse lookups return the midpoint of the longest run of entries
+  exactly equal to the value (the first such run on a tie), or 0 if the
+  value isn't in the table. That answer only depends on the value, so it is
+  computed once per value at load time into a dense table covering the
+  table's value range. This works for any table, monotonic or not; only
+  tables with an absurdly wide value range keep using the scan.
+  */
+
+#include <lookuptable_inverse.h>
+#include <stdlib.h>
+
+
+/*!
+  \brief lookup_inverse_build() precomputes the reverse lookup of every
+  value a lookuptable contains
+  \param array is the lookuptable data
+  \param len is the number of entries to consider
+  \returns the inverse, or NULL if the value range is too wide (callers
+  then use lookup_reverse_scan())
+  */
+LookupInverse *lookup_inverse_build(const int *array, int len)
+{
+	LookupInverse *inverse = NULL;
+	int *best = NULL;
+	int lo = 0;
+	int hi = 0;
+	int i = 0;
+	int j = 0;
+
+	if ((!array) || (len <= 0))
+		return NULL;
+	lo = hi = array[0];
+	for (i=1;i<len;i++)
+	{
+		if (array[i] < lo)
+			lo = array[i];
+		if (array[i] > hi)
+			hi = array[i];
+	}
+	if ((long)hi - lo + 1 > LOOKUP_INVERSE_MAX_SPAN)
+		return NULL;
+
+	inverse = (LookupInverse *)calloc(1,sizeof(LookupInverse));
+	inverse->base = lo;
+	inverse->span = hi - lo + 1;
+	inverse->index = (unsigned char *)calloc(inverse->span,1);
+	best = (int *)calloc(inverse->span,sizeof(int));
+	if ((!inverse->index) || (!best))
+	{
+		free(best);
+		lookup_inverse_free(inverse);
+		return NULL;
+	}
+
+	/* One pass over the runs; strictly longer wins, so the first of
+	 * equally long runs keeps it, as with the scan */
+	for (i=0;i<len;i=j)
+	{
+		for (j=i+1;(j<len) && (array[j] == array[i]);j++);
+		if (j-i > best[array[i]-lo])
+		{
+			best[array[i]-lo] = j-i;
+			inverse->index[array[i]-lo] = (unsigned char)(i+(j-i)/2);
+		}
+	}
+	free(best);
+	return inverse;
+}
+
+
+/*!
+  \brief lookup_inverse_find() gets the reverse lookup of a value
+  \param inverse is the precomputed inverse
+  \param value is the value to find
+  \returns the lookuptable index, 0 if the value isn't in the table
+  */
+int lookup_inverse_find(const LookupInverse *inverse, int value)
+{
+	unsigned int offset = (unsigned int)(value - inverse->base);
+
+	if (offset >= (unsigned int)inverse->span)
+		return 0;
+	return inverse->index[offset];
+}
+
+
+/*!
+  \brief lookup_inverse_free() frees an inverse
+  \param inverse is the inverse to free
+  */
+void lookup_inverse_free(LookupInverse *inverse)
+{
+	if (!inverse)
+		return;
+	free(inverse->index);
+	free(inverse);
+}
+
+
+/*!
+  \brief lookup_reverse_scan() is the weighted search the reverse lookups
+  have always done. When it finds a match it counts the sequential matches
+  as the "weight" of that start point, then picks the midpoint of the
+  heaviest span.
+  \param array is the lookuptable data
+  \param len is the number of entries to search
+  \param value is the value to be reverse looked up
+  \returns the index closest to that data
+  */
+int lookup_reverse_scan(const int *array, int len, int value)
+{
+	int i = 0;
+	int j = 0;
+	int closest_index = 0;
+	int min = 0;
+	int weight[LOOKUP_REVERSE_LEN];
+
+	if (len > LOOKUP_REVERSE_LEN)
+		len = LOOKUP_REVERSE_LEN;
+	for (i=0;i<len;i++)
+		weight[i]=0;
+
+	for (i=0;i<len;i++)
+	{
+		if (array[i] == value)
+		{
+			j = i;
+			while (array[j] == value)
+			{
+				weight[i]++;
+				if (j+1 == len)
+					break;
+				else
+					j++;
+			}
+			i=j;
+		}
+	}
+	for (i=0;i<len;i++)
+	{
+		if (weight[i] > min)
+		{
+			min = weight[i];
+			closest_index=i+(min/2);
+		}
+	}
+	return closest_index;
+}
@@ -24,6 +24,7 @@
 #include <getfiles.h>
 #include <init.h>
 #include <listmgmt.h>
+#include <lookuptable_inverse.h>
 #include <lookuptables.h>
 #include <plugin.h>
 #include <stdlib.h>
@@ -43,6 +44,7 @@ enum
 };
 
 void editing_started(GtkCellRenderer *renderer, GtkCellEditable *editable, gchar *path, gpointer data);
+static gint table_reverse_lookup(LookupTable *, gint);
 /*!
   \brief get_table() gets a valid filehandle of the lookuptable from 
   get_file and passes it to load_table(void)
@@ -142,6 +144,10 @@ G_MODULE_EXPORT gboolean load_table(gchar *table_name, gchar *filename)
 	vector = g_strsplit(filename,PSEP,-1);
 	lookuptable = g_new0(LookupTable, 1);
 	lookuptable->array = (gint *)g_memdup(&tmparray,i*sizeof(gint));
+	lookuptable->len = i;
+	lookuptable->inverse = lookup_inverse_build(lookuptable->array,MIN(i,LOOKUP_REVERSE_LEN));
+	if (!lookuptable->inverse)
+		MTXDBG(CRITICAL,_("Lookuptable %s spans too wide a range to invert, reverse lookups will scan it\n"),filename);
 	lookuptable->filename = g_strdup(vector[g_strv_length(vector)-1]);
 	g_strfreev(vector);
 	lookuptables = (GHashTable *)DATA_GET(global_data,"lookuptables");
@@ -174,17 +180,9 @@ G_MODULE_EXPORT gboolean load_table(gchar *table_name, gchar *filename)
   */
 G_MODULE_EXPORT gint reverse_lookup(gconstpointer *object, gint value)
 {
-	gint i = 0;
-	gint j = 0;
-	gint closest_index = 0;
-	gint min = 0;
-	gint len = 0;
-	gint weight[255];
-
 	ENTER();
 	gconstpointer *dep_obj = NULL;
 	LookupTable *lookuptable = NULL;
-	gint *array = NULL;
 	gchar *table = NULL;
 	gchar *alt_table = NULL;
 	gboolean state = FALSE;
@@ -207,44 +205,8 @@ G_MODULE_EXPORT gint reverse_lookup(gconstpointer *object, gint value)
 	else
 		lookuptable = (LookupTable *)g_hash_table_lookup((GHashTable *)DATA_GET(global_data,"lookuptables"),table);	
 
-	array = lookuptable->array;
-	len=255;
-	for (i=0;i<len;i++)
-		weight[i]=0;
-
-	for (i=0;i<len;i++)
-	{
-		/*printf("counter is %i\n",i);*/
-		if (array[i] == value)
-		{
-			/*printf("match at %i\n",i);*/
-			j = i;
-			while (array[j] == value)
-			{
-				/*printf("searching for dups to upp the weight\n");*/
-				weight[i]++;
-				if (j+1 == len)
-					break;
-				else
-					j++;
-			}
-			i=j;
-		}
-	}
-	for (i=0;i<len;i++)
-	{
-		if (weight[i] > min)
-		{
-			/*printf("weight[%i]= %i greater than %i\n",i,weight[i],min);*/
-			min = weight[i];
-			closest_index=i+(min/2);
-		}
-	}
-
-	/*printf("closest index is %i\n",closest_index);*/
-
 	EXIT();
-	return closest_index;
+	return table_reverse_lookup(lookuptable,value);
 }
 
 
@@ -265,17 +227,9 @@ G_MODULE_EXPORT gint reverse_lookup(gconstpointer *object, gint value)
   */
 G_MODULE_EXPORT gint reverse_lookup_obj(GObject *object, gint value)
 {
-	gint i = 0;
-	gint j = 0;
-	gint closest_index = 0;
-	gint min = 0;
-	gint len = 0;
-	gint weight[255];
-
 	ENTER();
 	gconstpointer *dep_obj = NULL;
 	LookupTable *lookuptable = NULL;
-	gint *array = NULL;
 	gchar *table = NULL;
 	gchar *alt_table = NULL;
 	gboolean state = FALSE;
@@ -299,44 +253,8 @@ G_MODULE_EXPORT gint reverse_lookup_obj(GObject *object, gint value)
 	else
 		lookuptable = (LookupTable *)g_hash_table_lookup((GHashTable *)DATA_GET(global_data,"lookuptables"),table);	
 
-	array = lookuptable->array;
-	len=255;
-	for (i=0;i<len;i++)
-		weight[i]=0;
-
-	for (i=0;i<len;i++)
-	{
-		/*printf("counter is %i\n",i);*/
-		if (array[i] == value)
-		{
-			/*printf("match at %i\n",i);*/
-			j = i;
-			while (array[j] == value)
-			{
-				/*printf("searching for dups to upp the weight\n");*/
-				weight[i]++;
-				if (j+1 == len)
-					break;
-				else
-					j++;
-			}
-			i=j;
-		}
-	}
-	for (i=0;i<len;i++)
-	{
-		if (weight[i] > min)
-		{
-			/*printf("weight[%i]= %i greater than %i\n",i,weight[i],min);*/
-			min = weight[i];
-			closest_index=i+(min/2);
-		}
-	}
-
-	/*printf("closest index is %i\n",closest_index);*/
-
 	EXIT();
-	return closest_index;
+	return table_reverse_lookup(lookuptable,value);
 }
 
 
@@ -350,16 +268,8 @@ G_MODULE_EXPORT gint reverse_lookup_obj(GObject *object, gint value)
   */
 G_MODULE_EXPORT gint direct_reverse_lookup(gchar *table, gint value)
 {
-	gint i = 0;
-	gint j = 0;
-	gint closest_index = 0;
-	gint min = 0;
-	gint len = 0;
-	gint weight[255];
-
 	ENTER();
 	LookupTable *lookuptable = NULL;
-	gint *array = NULL;
 
 	lookuptable = (LookupTable *)g_hash_table_lookup((GHashTable *)DATA_GET(global_data,"lookuptables"),table);	
 	if (!lookuptable)
@@ -367,45 +277,24 @@ G_MODULE_EXPORT gint direct_reverse_lookup(gchar *table, gint value)
 		EXIT();
 		return value;
 	}
-	array = lookuptable->array;
-
-	len=255;
-	for (i=0;i<len;i++)
-		weight[i]=0;
-
-	for (i=0;i<len;i++)
-	{
-		/*printf("counter is %i\n",i);*/
-		if (array[i] == value)
-		{
-			/*printf("match at %i\n",i);*/
-			j = i;
-			while (array[j] == value)
-			{
-				/*printf("searching for dups to upp the weight\n");*/
-				weight[i]++;
-				if (j+1 == len)
-					break;
-				else
-					j++;
-			}
-			i=j;
-		}
-	}
-	for (i=0;i<len;i++)
-	{
-		if (weight[i] > min)
-		{
-			/*printf("weight[%i]= %i greater than %i\n",i,weight[i],min);*/
-			min = weight[i];
-			closest_index=i+(min/2);
-		}
-	}
+	EXIT();
+	return table_reverse_lookup(lookuptable,value);
+}
 
-	/*printf("closest index is %i\n",closest_index);*/
 
-	EXIT();
-	return closest_index;
+/*!
+  \brief table_reverse_lookup() does the reverse lookup for a resolved
+  lookuptable, from its precomputed inverse when it has one
+  \param lookuptable is the table to search
+  \param value is the value to be reverse looked up
+  \returns the index closest to that data
+  */
+static gint table_reverse_lookup(LookupTable *lookuptable, gint value)
+{
+	g_return_val_if_fail(lookuptable,0);
+	if (lookuptable->inverse)
+		return lookup_inverse_find(lookuptable->inverse,value);
+	return lookup_reverse_scan(lookuptable->array,MIN(lookuptable->len,LOOKUP_REVERSE_LEN),value);
 }
 
 
@@ -61,8 +61,10 @@
 #include "../include/plugin/plugin_manager.h"
 #include "../include/core/data_bridge.h"
 #include "../include/data/datalog_manager.h"
+#include "../include/data/datalog_replay.h"
 #include "../include/automation/macro_engine.h"
 #include "../include/automation/action_triggers.h"
+#include "../include/automation/alert_rules.h"
 #include "../include/integrations/gps_provider.h"
 #include "../include/ui/undo_redo.h"
 #include "../include/ui/keybindings_prefs.h"
@@ -427,6 +429,7 @@ void cleanup_imgui();
 void cleanup_ecu_communication();
 void handle_events();
 void update();
+bool publish_trigger_event(const char* event_name, const void* data, size_t size);
 void render();
 void render_main_window();
 void render_about_tab();
@@ -709,6 +712,11 @@ int main(int argc, char* argv[]) {
     // Parse command line arguments
     bool demo_mode = false;
     bool debug_mode = false;
+    const char* replay_path = NULL;
+    DatalogReplayConfig replay_config = { 1.0, false };
+    const char* capture_path = NULL;
+    const char* serial_replay_path = NULL;
+    SerialReplayConfig serial_replay_config = { 1.0, true, 0 };
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--demo-mode") == 0 || strcmp(argv[i], "-d") == 0) {
@@ -717,11 +725,29 @@ int main(int argc, char* argv[]) {
         } else if (strcmp(argv[i], "--debug") == 0) {
             debug_mode = true;
             printf("Debug mode enabled\n");
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc) {
+            replay_config.speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--replay-loop") == 0) {
+            replay_config.loop = true;
+        } else if (strcmp(argv[i], "--capture-serial") == 0 && i + 1 < argc) {
+            capture_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay-serial") == 0 && i + 1 < argc) {
+            serial_replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay-serial-speed") == 0 && i + 1 < argc) {
+            serial_replay_config.speed = atof(argv[++i]);
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             printf("Usage: %s [options]\n", argv[0]);
             printf("Options:\n");
             printf("  --demo-mode, -d    Enable demo mode with simulated data\n");
             printf("  --debug            Enable debug mode\n");
+            printf("  --replay <log>     Play a datalog back as live ECU data\n");
+            printf("  --replay-speed <x> Replay at x times the recorded rate (0 = as fast as possible)\n");
+            printf("  --replay-loop      Start the replay over at the end of the log\n");
+            printf("  --capture-serial <file>       Record raw ECU port traffic to a ring file\n");
+            printf("  --replay-serial <file>        Serve a serial capture on a pseudo-terminal\n");
+            printf("  --replay-serial-speed <x>     Serial replay timing (1 = recorded, 0 = no delays)\n");
             printf("  --help, -h         Show this help message\n");
             return 0;
         }
@@ -782,6 +808,7 @@ int main(int argc, char* argv[]) {
     datalog_manager_init();
     macro_engine_init();
     action_triggers_init();
+    alert_rules_init();
     gps_provider_init();
     undo_redo_init();
     keybindings_prefs_init();
@@ -797,6 +824,28 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     add_log_entry(0, "ECU communication initialized successfully");
+
+    // Raw serial capture under the ECU transport, and replay of one on a pty
+    SerialCapture* serial_capture = NULL;
+    if (capture_path) {
+        serial_capture = serial_capture_create(capture_path, 0, NULL, 0);
+        if (serial_capture) {
+            ecu_set_capture(get_ecu_context(), serial_capture);
+            add_log_entry(0, "Capturing serial traffic to %s", capture_path);
+        } else {
+            add_log_entry(2, "Could not create serial capture %s", capture_path);
+        }
+    }
+    SerialReplay* serial_replay = NULL;
+    if (serial_replay_path) {
+        serial_replay = serial_replay_start(serial_replay_path, &serial_replay_config);
+        if (serial_replay) {
+            add_log_entry(0, "Serving serial capture %s on %s - connect to that port",
+                          serial_replay_path, serial_replay_port(serial_replay));
+        } else {
+            add_log_entry(2, "Could not replay serial capture %s", serial_replay_path);
+        }
+    }
     
     // Set up global demo mode callback
     ecu_set_global_demo_mode_callback([](bool enabled) {
@@ -916,6 +965,9 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     add_log_entry(0, "Plugin System module initialized successfully");
+    
+    // Route action trigger events onto the plugin event bus
+    action_triggers_set_event_publisher(publish_trigger_event);
 
     // Automatically scan and load plugins during startup
     add_log_entry(0, "Auto-scanning plugin directory...");
@@ -925,11 +977,14 @@ int main(int argc, char* argv[]) {
         mgr->scan_plugin_directory("plugins");
         add_log_entry(0, "Plugin directory scanned");
         
+        // Rebuilt plugins are swapped in without restarting
+        plugin_system_watch_directory("plugins");
+        
         // Initialize all loaded plugins
         if (mgr->init_all_plugins) {
             add_log_entry(0, "Initializing all plugins...");
             mgr->init_all_plugins();
-            add_log_entry(0, "All plugins initialized");
+            add_log_entry(0, "Plugin init() running in the background; UI starting");
         } else {
             add_log_entry(2, "Warning: init_all_plugins function not available");
         }
@@ -956,6 +1011,25 @@ int main(int argc, char* argv[]) {
     }
     add_log_entry(0, "Data Bridge System initialized successfully");
 
+    // Datalog replay stands in for the ECU: alerts, triggers and charts see the log
+    DatalogReplay* replay = NULL;
+    if (replay_path) {
+        replay = datalog_replay_open(replay_path);
+        if (!replay) {
+            add_log_entry(2, "Could not load datalog %s for replay", replay_path);
+        } else if (!datalog_replay_start(replay, get_ecu_context(), &replay_config)) {
+            add_log_entry(2, "Datalog replay needs a disconnected ECU context");
+            datalog_replay_close(replay);
+            replay = NULL;
+        } else {
+            data_bridge_register_ecu_plugin(datalog_replay_plugin());
+            add_log_entry(0, "Replaying %s: %llu rows, %d channels, %.1f s at %.1fx",
+                          replay_path, (unsigned long long)datalog_replay_rows(replay),
+                          datalog_replay_channel_count(replay), datalog_replay_duration(replay),
+                          replay_config.speed);
+        }
+    }
+
     // Initialize VE table early so it's available for the update loop
     add_log_entry(0, "Initializing VE table...");
     g_ve_table = imgui_ve_table_create(16, 12); // Start with default size, will be resized based on INI
@@ -1024,6 +1098,18 @@ int main(int argc, char* argv[]) {
         handle_events();
         update();
         
+        // Run plugin update() under the frame budget (also harvests finished init() jobs)
+        PluginManager* plugin_mgr = get_plugin_manager();
+        if (plugin_mgr && plugin_mgr->update_all_plugins) {
+            plugin_mgr->update_all_plugins();
+        }
+        
+        // Deliver queued plugin events on the main thread
+        EventSystem* events = get_event_system();
+        if (events && events->process_events) {
+            events->process_events();
+        }
+        
         // Update Speeduino communication status
         speeduino_update_connection_status();
         
@@ -1037,6 +1123,15 @@ int main(int argc, char* argv[]) {
     add_log_entry(0, "User settings saved");
 
     // Cleanup
+    if (replay) {
+        DatalogReplayStats replay_stats;
+        datalog_replay_stop(replay);
+        datalog_replay_get_stats(replay, &replay_stats);
+        add_log_entry(0, "Replay published %llu samples (%.0f/s), late mean %u us max %u us",
+                      (unsigned long long)replay_stats.samples, replay_stats.samples_per_s,
+                      replay_stats.late_mean_us, replay_stats.late_max_us);
+        datalog_replay_close(replay);
+    }
     data_bridge_cleanup();
     plugin_system_cleanup();
     speeduino_cleanup();
@@ -1049,12 +1144,15 @@ int main(int argc, char* argv[]) {
     cleanup_logging_system();
     cleanup_settings_manager();
     gps_provider_shutdown();
+    alert_rules_shutdown();
     action_triggers_shutdown();
     macro_engine_shutdown();
     datalog_manager_shutdown();
     diagnostics_shutdown();
     config_cleanup();
     cleanup_ecu_communication();
+    serial_capture_close(serial_capture);
+    serial_replay_stop(serial_replay);
     cleanup_imgui();
     cleanup_ttf();
     cleanup_opengl();
@@ -2021,6 +2119,14 @@ void handle_events() {
     }
 }
 
+bool publish_trigger_event(const char* event_name, const void* data, size_t size) {
+    EventSystem* events = get_event_system();
+    if (!events || !events->publish) {
+        return false;
+    }
+    return events->publish(event_name, const_cast<void*>(data), size);
+}
+
 void update() {
     // Update ECU status and data
     if (g_ecu_context) {
@@ -2058,10 +2164,10 @@ void update() {
                 strcpy(g_ecu_status, "Unknown");
                 break;
         }
-        // Use ecu_get_data correctly (it returns a pointer)
-        const ECUData* data = ecu_get_data(g_ecu_context);
-        if (data) {
-            g_ecu_data = *data;
+        // Copy the latest published frame only when a new one is available
+        static uint32_t last_frame_id = 0;
+        if (ecu_get_frame_id(g_ecu_context) != last_frame_id) {
+            last_frame_id = ecu_read_frame(g_ecu_context, &g_ecu_data);
         }
     }
     
@@ -4384,6 +4490,131 @@ void render_plugin_manager_view() {
     const char* bridge_status = data_bridge_get_status();
     ImGui::TextWrapped("%s", bridge_status);
     
+    // Event bus backpressure
+    ImGui::Spacing();
+    ImGui::TextColored(g_ui_theme.accent_color, "Event Bus");
+    EventBusStats bus_stats;
+    get_event_bus_stats(&bus_stats);
+    ImGui::Text("Topics: %d  Published: %lu  Delivered: %lu",
+                bus_stats.topic_count, (unsigned long)bus_stats.published, (unsigned long)bus_stats.delivered);
+    ImGui::Text("Queue: %u / %u (high water %u)",
+                bus_stats.queue_depth, bus_stats.queue_capacity, bus_stats.queue_high_water);
+    ImGui::TextColored(bus_stats.dropped > 0 ? g_ui_theme.error_color : g_ui_theme.text_secondary,
+                       "Dropped: %lu", (unsigned long)bus_stats.dropped);
+    if (bus_stats.dropped > 0) {
+        EventTopicStats topic_stats[32];
+        int topic_count = get_event_topic_stats(topic_stats, 32);
+        for (int i = 0; i < topic_count; i++) {
+            if (topic_stats[i].dropped > 0) {
+                ImGui::BulletText("%s: %lu dropped of %lu", topic_stats[i].name,
+                                  (unsigned long)topic_stats[i].dropped,
+                                  (unsigned long)(topic_stats[i].published + topic_stats[i].dropped));
+            }
+        }
+    }
+    
+    // Per-plugin startup cost
+    ImGui::Spacing();
+    ImGui::TextColored(g_ui_theme.accent_color, "Startup");
+    PluginStartupTiming startup[32];
+    int startup_count = get_plugin_startup_report(startup, 32);
+    if (startup_count == 0) {
+        ImGui::TextColored(g_ui_theme.text_muted, "No plugins loaded");
+    } else if (ImGui::BeginTable("plugin_startup", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Plugin");
+        ImGui::TableSetupColumn("Scan (ms)");
+        ImGui::TableSetupColumn("Load (ms)");
+        ImGui::TableSetupColumn("Init (ms)");
+        ImGui::TableSetupColumn("State");
+        ImGui::TableSetupColumn("Reloads");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < startup_count; i++) {
+            const PluginStartupTiming& t = startup[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(t.name);
+            if (ImGui::IsItemHovered() && t.path[0]) {
+                ImGui::SetTooltip("%s", t.path);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", t.scan_us / 1000.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", t.load_us / 1000.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", t.init_us / 1000.0);
+            ImGui::TableNextColumn();
+            if (t.init_pending) {
+                ImGui::TextColored(g_ui_theme.warning_color, "Initializing");
+            } else if (t.init_timed_out) {
+                ImGui::TextColored(g_ui_theme.error_color, "Timed out");
+            } else if (t.init_failed) {
+                ImGui::TextColored(g_ui_theme.error_color, "Failed");
+            } else {
+                ImGui::TextColored(g_ui_theme.success_color, "Ready");
+            }
+            ImGui::TableNextColumn();
+            if (t.reload_count > 0) {
+                ImGui::Text("%u (last pause %.1f ms)", t.reload_count, t.last_swap_us / 1000.0);
+            } else {
+                ImGui::TextColored(g_ui_theme.text_muted, "-");
+            }
+        }
+        ImGui::EndTable();
+    }
+    
+    // Per-plugin update() cost against the frame budget
+    ImGui::Spacing();
+    ImGui::TextColored(g_ui_theme.accent_color, "Frame Budget");
+    int budget_us = (int)plugin_system_get_update_budget();
+    ImGui::SetNextItemWidth(120);
+    if (ImGui::InputInt("update() budget (us)", &budget_us, 100, 1000)) {
+        plugin_system_set_update_budget((uint32_t)(budget_us < 100 ? 100 : budget_us));
+    }
+    PluginUpdateStats update_stats[32];
+    int update_count = get_plugin_update_stats(update_stats, 32);
+    if (update_count == 0) {
+        ImGui::TextColored(g_ui_theme.text_muted, "No plugin update() calls yet");
+    } else if (ImGui::BeginTable("plugin_frame_budget", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Plugin");
+        ImGui::TableSetupColumn("Mean (us)");
+        ImGui::TableSetupColumn("p99 (us)");
+        ImGui::TableSetupColumn("Max (us)");
+        ImGui::TableSetupColumn("Over budget");
+        ImGui::TableSetupColumn("Mode");
+        ImGui::TableSetupColumn("");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < update_count; i++) {
+            const PluginUpdateStats& u = update_stats[i];
+            bool over = u.p99_us > plugin_system_get_update_budget();
+            ImGui::PushID(u.name);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(u.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", u.mean_us);
+            ImGui::TableNextColumn();
+            ImGui::TextColored(over ? g_ui_theme.error_color : g_ui_theme.text_primary, "%u", u.p99_us);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", u.max_us);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u / %lu", u.over_budget, (unsigned long)u.calls);
+            ImGui::TableNextColumn();
+            if (u.offloaded) {
+                ImGui::TextColored(g_ui_theme.warning_color, "Worker thread");
+            } else if (u.interval > 1) {
+                ImGui::TextColored(g_ui_theme.warning_color, "Every %d frames", u.interval);
+            } else {
+                ImGui::Text("Every frame");
+            }
+            ImGui::TableNextColumn();
+            if ((u.offloaded || u.interval > 1) && ImGui::SmallButton("Reset")) {
+                plugin_system_reset_update_policy(u.name);
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+    
     ImGui::Spacing();
     if (ImGui::Button("Create ECU-Chart Connection")) {
         bool success = data_bridge_create_connection("rpm_chart_connection",
@@ -4481,14 +4712,39 @@ void render_plugin_manager_view() {
                             status_text = "Disabled";
                             status_color = g_ui_theme.text_muted;
                             break;
+                        case PLUGIN_STATUS_INITIALIZING:
+                            status_text = "Initializing";
+                            status_color = g_ui_theme.warning_color;
+                            break;
                     }
                     
                     ImGui::TextColored(status_color, "Status: %s", status_text);
+                    ImGui::SameLine();
+                    if (ImGui::SmallButton("Reload")) {
+                        plugin_system_reload(plugin->name);
+                    }
+                    
+                    // Plugin interfaces aren't safe to call until init() returns
+                    if (plugin->status == PLUGIN_STATUS_INITIALIZING) {
+                        ImGui::TextColored(g_ui_theme.text_muted, "Waiting for init() to finish...");
+                    }
                     
                     // ECU-specific information and controls
-                    if (plugin->type == PLUGIN_TYPE_ECU) {
+                    else if (plugin->type == PLUGIN_TYPE_ECU) {
                         ImGui::TextColored(g_ui_theme.text_secondary, "Type: ECU Plugin");
                         
+                        // Shared-memory channel export for external tools
+                        bool exporting = data_bridge_is_exporting(plugin->name);
+                        if (ImGui::Checkbox("Export channels (" CHANNEL_EXPORT_DEFAULT_NAME ")", &exporting)) {
+                            if (exporting) {
+                                bool success = data_bridge_export_channels(plugin->name, CHANNEL_EXPORT_DEFAULT_NAME);
+                                add_log_entry(0, "Channel export for %s: %s", plugin->name, success ? "STARTED" : "FAILED");
+                            } else {
+                                data_bridge_stop_export(plugin->name);
+                                add_log_entry(0, "Channel export for %s stopped", plugin->name);
+                            }
+                        }
+                        
                         // Show protocol info if available
                         if (plugin->interface.ecu.get_protocol_info) {
                             ImGui::TextColored(g_ui_theme.text_secondary, "Protocol: %s", 
@@ -4507,6 +4763,29 @@ void render_plugin_manager_view() {
                             ImGui::TextColored(conn_color, "Connection: %s", conn_status);
                         }
                         
+                        // Realtime poll cadence
+                        ECUPollStats poll_stats;
+                        if (plugin->interface.ecu.abi_version >= ECU_PLUGIN_ABI_V4 &&
+                            plugin->interface.ecu.get_poll_stats && plugin->interface.ecu.get_poll_stats(&poll_stats)) {
+                            int poll_rate = (int)poll_stats.target_hz;
+                            ImGui::SetNextItemWidth(120);
+                            if (ImGui::InputInt("Poll rate (Hz)", &poll_rate, 5, 25) && poll_rate > 0 &&
+                                plugin->interface.ecu.set_poll_rate) {
+                                plugin->interface.ecu.set_poll_rate((uint32_t)poll_rate);
+                            }
+                            ImGui::TextColored(g_ui_theme.text_secondary,
+                                               "Achieved: %.1f Hz  Jitter: %u us mean, %u us max",
+                                               poll_stats.achieved_hz, poll_stats.jitter_mean_us, poll_stats.jitter_max_us);
+                            ImGui::TextColored(poll_stats.crc_errors || poll_stats.framing_errors || poll_stats.timeouts ?
+                                               g_ui_theme.warning_color : g_ui_theme.text_muted,
+                                               "Frames: %llu  CRC errors: %llu  Framing: %llu  Timeouts: %llu  Overruns: %llu",
+                                               (unsigned long long)poll_stats.frames,
+                                               (unsigned long long)poll_stats.crc_errors,
+                                               (unsigned long long)poll_stats.framing_errors,
+                                               (unsigned long long)poll_stats.timeouts,
+                                               (unsigned long long)poll_stats.overruns);
+                        }
+                        
                         // Connection controls for ECU plugins
                         ImGui::Spacing();
                         ImGui::TextColored(g_ui_theme.text_primary, "Connection Controls:");
@@ -7,14 +7,31 @@
  */
 
 #include "../../include/plugin/plugin_interface.h"
+#include "../../include/plugin/plugin_manager.h"
 #include "../../include/core/data_bridge.h"
 #include "../../include/ui/logging_system.h"
 #include <dlfcn.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <elf.h>
+#include <link.h>
+#include <sys/inotify.h>
+#endif
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <new>
+#include <string>
+#include <vector>
+#include <pthread.h>
 
 // Plugin manager instance
 static struct {
@@ -25,23 +42,123 @@ static struct {
     bool initialized;
 } g_plugin_manager = {0};
 
+// Startup and update() budget sizing
+#define PLUGIN_MAX_SLOTS 64
+#define PLUGIN_DISCOVERY_MAX_WORKERS 8
+#define PLUGIN_UPDATE_WINDOW 128        // Recent update() samples kept for mean/p99
+#define PLUGIN_UPDATE_EVAL_SAMPLES 32   // Samples between budget checks
+#define PLUGIN_UPDATE_MAX_INTERVAL 8    // Most frames a throttled plugin may skip before offloading
+
+// One candidate file's discovery result, filled in by a discovery worker
+typedef struct {
+    char path[512];
+    void* handle;
+    PluginInterface* plugin;    // Interface from get_plugin_interface, NULL on failure
+    char error[256];
+    uint64_t scan_us;
+    uint64_t load_us;
+} PluginLoadResult;
+
+enum {
+    PLUGIN_INIT_JOB_IDLE,
+    PLUGIN_INIT_JOB_RUNNING,
+    PLUGIN_INIT_JOB_DONE
+};
+
+// Per-plugin record, keyed by plugin name because the plugins array moves when it grows
+typedef struct {
+    // Startup timing and asynchronous init() job
+    PluginStartupTiming timing;
+    bool (*init)(PluginContext* ctx);
+    PluginContext context;
+    uint64_t started_us;
+    uint64_t finished_us;       // Written by the worker before job_state goes DONE
+    bool init_result;
+    std::atomic<int> job_state;
+    
+    // update() timing (guarded by update_mutex)
+    uint32_t samples[PLUGIN_UPDATE_WINDOW];
+    uint32_t sample_count;
+    uint32_t since_eval;
+    uint64_t calls;
+    uint64_t skipped;
+    uint32_t max_us;
+    uint32_t last_us;
+    uint32_t over_budget;
+    
+    // update() scheduling (main thread)
+    int interval;               // Call update() every N frames
+    uint32_t frame_counter;
+    bool offloaded;
+    bool worker_running;
+    pthread_t worker;
+    void (*update)(void);
+} PluginSlot;
+
+static struct {
+    PluginSlot slots[PLUGIN_MAX_SLOTS];
+    int count;
+    uint32_t init_timeout_ms;
+    bool report_logged;
+    
+    uint32_t update_budget_us;
+    uint64_t update_frame;                  // Bumped once per update_all_plugins()
+    pthread_mutex_t update_mutex;
+    pthread_cond_t update_cond;
+} g_plugin_slots = {};
+
+// Plugin directory watch for hot reload
+#define PLUGIN_RELOAD_SETTLE_US 300000  // Quiet time before a changed file is loaded (linkers write in steps)
+
+static struct {
+    int fd;
+    std::vector<std::pair<int, std::string>> dirs;          // inotify watch descriptor -> directory
+    std::vector<std::pair<std::string, uint64_t>> pending;  // Changed file -> last event time
+} g_plugin_watch = { -1, {}, {} };
+
+// Event bus sizing (both must be powers of two)
+#define EVENT_MAX_TOPICS 256
+#define EVENT_QUEUE_CAPACITY 1024
+#define EVENT_MAX_SUBSCRIBERS_PER_TOPIC 16
+
+// Refcounted copy of a published payload; data follows the header
+typedef struct {
+    std::atomic<int> refs;
+    size_t size;
+} EventPayload;
+
+// Interned topic; slots are insert-only so lookups need no lock
+typedef struct {
+    std::atomic<const char*> name;
+    uint32_t hash;
+    EventCallback subscribers[EVENT_MAX_SUBSCRIBERS_PER_TOPIC];
+    int subscriber_count;
+    std::atomic<uint64_t> published;
+    std::atomic<uint64_t> dropped;
+} EventTopic;
+
+// Bounded MPSC ring cell (sequence-numbered, Vyukov style)
+typedef struct {
+    std::atomic<size_t> sequence;
+    PluginEvent event;
+    const void* target;         // Image base of the addressed plugin, NULL = every subscriber
+} EventQueueCell;
+
 // Event system instance
 static struct {
-    struct {
-        const char* event_name;
-        EventCallback callback;
-        const char* plugin_name;
-    } subscriptions[100];
-    int subscription_count;
-    
-    struct {
-        PluginEvent event;
-        bool processed;
-    } event_queue[1000];
-    int event_count;
-    int event_head;
-    int event_tail;
-} g_event_system = {0};
+    EventTopic topics[EVENT_MAX_TOPICS];
+    std::atomic<int> topic_count;
+    pthread_mutex_t topic_mutex;        // Serializes topic inserts and subscriber changes
+    
+    EventQueueCell queue[EVENT_QUEUE_CAPACITY];
+    alignas(64) std::atomic<size_t> enqueue_pos;
+    alignas(64) std::atomic<size_t> dequeue_pos;    // Written by the consumer (process_events) only
+    
+    std::atomic<uint64_t> published;
+    std::atomic<uint64_t> delivered;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint32_t> queue_high_water;
+} g_event_system;
 
 // Plugin manager functions
 static bool load_plugin(const char* plugin_path);
@@ -51,6 +168,7 @@ static PluginInterface* find_plugin(const char* name);
 static bool init_all_plugins(void);
 static void cleanup_all_plugins(void);
 static void update_all_plugins(void);
+// Send event to specific plugin
 static bool send_event(const char* plugin_name, const char* event, void* data);
 static bool broadcast_event(const char* event, void* data);
 
@@ -61,6 +179,13 @@ static bool publish(const char* event_name, void* data, size_t size);
 static bool publish_to_plugin(const char* plugin_name, const char* event_name, void* data, size_t size);
 static void process_events(void);
 static void clear_events(void);
+static int intern_topic(const char* event_name);
+static bool subscribe_topic(int topic_id, EventCallback callback);
+static bool publish_topic(int topic_id, const void* data, size_t size);
+static void* retain_payload(const PluginEvent* event);
+static void release_payload(void* payload);
+static bool enqueue_event(int topic_id, const char* source_plugin, const void* data, size_t size,
+                          const void* target);
 
 // Plugin validation
 static bool validate_plugin(PluginInterface* plugin);
@@ -90,7 +215,12 @@ static EventSystem g_event_system_interface = {
     .publish = publish,
     .publish_to_plugin = publish_to_plugin,
     .process_events = process_events,
-    .clear_events = clear_events
+    .clear_events = clear_events,
+    .intern_topic = intern_topic,
+    .subscribe_topic = subscribe_topic,
+    .publish_topic = publish_topic,
+    .retain_payload = retain_payload,
+    .release_payload = release_payload
 };
 
 // Initialize plugin system
@@ -111,11 +241,22 @@ bool plugin_system_init(void) {
     // Set default plugin directory
     strcpy(g_plugin_manager.plugin_directory, "plugins");
     
+    if (g_plugin_slots.init_timeout_ms == 0) {
+        g_plugin_slots.init_timeout_ms = PLUGIN_INIT_TIMEOUT_MS_DEFAULT;
+    }
+    if (g_plugin_slots.update_budget_us == 0) {
+        g_plugin_slots.update_budget_us = PLUGIN_UPDATE_BUDGET_US_DEFAULT;
+    }
+    pthread_mutex_init(&g_plugin_slots.update_mutex, NULL);
+    pthread_cond_init(&g_plugin_slots.update_cond, NULL);
+    
     // Initialize event system
-    g_event_system.subscription_count = 0;
-    g_event_system.event_count = 0;
-    g_event_system.event_head = 0;
-    g_event_system.event_tail = 0;
+    pthread_mutex_init(&g_event_system.topic_mutex, NULL);
+    for (int i = 0; i < EVENT_QUEUE_CAPACITY; i++) {
+        g_event_system.queue[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    g_event_system.enqueue_pos.store(0, std::memory_order_relaxed);
+    g_event_system.dequeue_pos.store(0, std::memory_order_relaxed);
     
     g_plugin_manager.initialized = true;
     add_log_entry(LOG_LEVEL_INFO, "Plugin system initialized successfully");
@@ -132,66 +273,365 @@ void plugin_system_cleanup(void) {
     // Cleanup all plugins
     cleanup_all_plugins();
     
+    // Release queued payloads
+    clear_events();
+    
     // Free plugin manager memory
     if (g_plugin_manager.plugins) {
         free(g_plugin_manager.plugins);
         g_plugin_manager.plugins = nullptr;
     }
     
+    if (g_plugin_watch.fd >= 0) {
+        close(g_plugin_watch.fd);
+        g_plugin_watch.fd = -1;
+        g_plugin_watch.dirs.clear();
+        g_plugin_watch.pending.clear();
+    }
+    
     g_plugin_manager.initialized = false;
     add_log_entry(LOG_LEVEL_INFO, "Plugin system cleaned up");
 }
 
-// Load a plugin from file
-static bool load_plugin(const char* plugin_path) {
-    if (!g_plugin_manager.initialized) {
-        add_log_entry(LOG_LEVEL_ERROR, "Plugin system not initialized");
-        return false;
+// Monotonic clock for startup timing
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000;
+}
+
+#ifdef __linux__
+// Look for a defined symbol in an ELF image's dynamic symbol table.
+// Returns 1 if found, 0 if absent, -1 if the image can't be checked this way.
+template <typename Ehdr, typename Shdr, typename Sym>
+static int elf_find_dynamic_symbol(const uint8_t* image, size_t size, const char* symbol) {
+    if (size < sizeof(Ehdr)) {
+        return -1;
     }
     
-    add_log_entry(LOG_LEVEL_INFO, "Loading plugin: %s", plugin_path);
+    const Ehdr* header = (const Ehdr*)image;
+    if (header->e_type != ET_DYN) {
+        return 0;
+    }
+    if (header->e_shoff == 0 || header->e_shentsize != sizeof(Shdr) ||
+        header->e_shoff + (uint64_t)header->e_shnum * sizeof(Shdr) > size) {
+        return -1;
+    }
+    
+    const Shdr* sections = (const Shdr*)(image + header->e_shoff);
+    size_t symbol_len = strlen(symbol);
+    for (int i = 0; i < header->e_shnum; i++) {
+        if (sections[i].sh_type != SHT_DYNSYM) {
+            continue;
+        }
+        if (sections[i].sh_link >= header->e_shnum) {
+            return -1;
+        }
+        
+        const Shdr* strtab = &sections[sections[i].sh_link];
+        if (sections[i].sh_offset + sections[i].sh_size > size ||
+            strtab->sh_offset + strtab->sh_size > size) {
+            return -1;
+        }
+        
+        const Sym* symbols = (const Sym*)(image + sections[i].sh_offset);
+        const char* names = (const char*)(image + strtab->sh_offset);
+        size_t count = sections[i].sh_size / sizeof(Sym);
+        for (size_t k = 0; k < count; k++) {
+            if (symbols[k].st_shndx == SHN_UNDEF || symbols[k].st_name + symbol_len >= strtab->sh_size) {
+                continue;
+            }
+            if (memcmp(names + symbols[k].st_name, symbol, symbol_len + 1) == 0) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    
+    // No section headers (stripped); leave it to dlsym
+    return -1;
+}
+#endif
+
+// Check a candidate file exports a symbol without running any of its code
+static int plugin_file_exports(const char* path, const char* symbol) {
+#ifdef __linux__
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    
+    int result = -1;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= EI_NIDENT) {
+        void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            const uint8_t* image = (const uint8_t*)map;
+            const uint8_t native_data = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) ? ELFDATA2LSB : ELFDATA2MSB;
+            
+            if (memcmp(image, ELFMAG, SELFMAG) != 0) {
+                result = 0;
+            } else if (image[EI_DATA] != native_data) {
+                result = -1;
+            } else if (image[EI_CLASS] == ELFCLASS64) {
+                result = elf_find_dynamic_symbol<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym>(image, (size_t)st.st_size, symbol);
+            } else if (image[EI_CLASS] == ELFCLASS32) {
+                result = elf_find_dynamic_symbol<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym>(image, (size_t)st.st_size, symbol);
+            }
+            munmap(map, (size_t)st.st_size);
+        }
+    }
+    close(fd);
+    return result;
+#else
+    (void)path;
+    (void)symbol;
+    return -1;
+#endif
+}
+
+// Check, dlopen and validate one plugin file. Runs on discovery workers,
+// so errors are recorded in the result rather than logged.
+static bool open_plugin(PluginLoadResult* result) {
+    uint64_t start = monotonic_us();
+    int exported = plugin_file_exports(result->path, "get_plugin_interface");
+    result->scan_us = monotonic_us() - start;
+    if (exported == 0) {
+        snprintf(result->error, sizeof(result->error), "no get_plugin_interface export");
+        return false;
+    }
     
-    // Load dynamic library
-    void* handle = dlopen(plugin_path, RTLD_LAZY);
+    start = monotonic_us();
+    void* handle = dlopen(result->path, RTLD_LAZY);
     if (!handle) {
-        add_log_entry(LOG_LEVEL_ERROR, "Failed to load plugin %s: %s", plugin_path, dlerror());
+        snprintf(result->error, sizeof(result->error), "%s", dlerror());
+        result->load_us = monotonic_us() - start;
         return false;
     }
     
-    // Get plugin interface function
     PluginInterface* (*get_interface)(void) = (PluginInterface*(*)(void))dlsym(handle, "get_plugin_interface");
+    PluginInterface* plugin = get_interface ? get_interface() : nullptr;
+    result->load_us = monotonic_us() - start;
+    
     if (!get_interface) {
-        add_log_entry(LOG_LEVEL_ERROR, "Failed to find get_plugin_interface in %s: %s", plugin_path, dlerror());
-        dlclose(handle);
-        return false;
+        snprintf(result->error, sizeof(result->error), "failed to find get_plugin_interface: %s", dlerror());
+    } else if (!plugin) {
+        snprintf(result->error, sizeof(result->error), "returned null interface");
+    } else if (!validate_plugin(plugin)) {
+        snprintf(result->error, sizeof(result->error), "validation failed");
+    } else {
+        result->handle = handle;
+        result->plugin = plugin;
+        return true;
     }
     
-    // Get plugin interface
-    PluginInterface* plugin = get_interface();
-    if (!plugin) {
-        add_log_entry(LOG_LEVEL_ERROR, "Plugin %s returned null interface", plugin_path);
-        dlclose(handle);
+    dlclose(handle);
+    return false;
+}
+
+// Clear update() stats and put the plugin back on every frame (caller stops any worker first)
+static void reset_update_stats(PluginSlot* slot) {
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    slot->sample_count = 0;
+    slot->since_eval = 0;
+    slot->calls = 0;
+    slot->skipped = 0;
+    slot->max_us = 0;
+    slot->last_us = 0;
+    slot->over_budget = 0;
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
+    slot->interval = 1;
+    slot->frame_counter = 0;
+    slot->offloaded = false;
+}
+
+// Mean and p99 over the recent window (caller holds update_mutex)
+static void window_stats(const PluginSlot* slot, uint32_t* mean_us, uint32_t* p99_us) {
+    uint32_t n = std::min<uint32_t>(slot->sample_count, PLUGIN_UPDATE_WINDOW);
+    if (n == 0) {
+        *mean_us = 0;
+        *p99_us = 0;
+        return;
+    }
+    
+    uint32_t sorted[PLUGIN_UPDATE_WINDOW];
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sorted[i] = slot->samples[i];
+        total += sorted[i];
+    }
+    uint32_t rank = (n * 99 + 99) / 100 - 1;
+    std::nth_element(sorted, sorted + rank, sorted + n);
+    *mean_us = (uint32_t)(total / n);
+    *p99_us = sorted[rank];
+}
+
+// Record one update() duration; returns true when a budget check is due
+static bool record_update_sample(PluginSlot* slot, uint64_t elapsed_us, uint64_t skipped) {
+    uint32_t us = (uint32_t)std::min<uint64_t>(elapsed_us, UINT32_MAX);
+    
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    slot->samples[slot->sample_count % PLUGIN_UPDATE_WINDOW] = us;
+    slot->sample_count++;
+    slot->calls++;
+    slot->skipped += skipped;
+    slot->last_us = us;
+    slot->max_us = std::max(slot->max_us, us);
+    if (us > g_plugin_slots.update_budget_us) {
+        slot->over_budget++;
+    }
+    bool eval = ++slot->since_eval >= PLUGIN_UPDATE_EVAL_SAMPLES;
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
+    return eval;
+}
+
+// Runs an offloaded plugin's update() once per frame tick, off the render thread
+static void* plugin_update_worker(void* arg) {
+    PluginSlot* slot = (PluginSlot*)arg;
+    
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    uint64_t seen = g_plugin_slots.update_frame;
+    while (slot->worker_running) {
+        while (slot->worker_running && g_plugin_slots.update_frame == seen) {
+            pthread_cond_wait(&g_plugin_slots.update_cond, &g_plugin_slots.update_mutex);
+        }
+        if (!slot->worker_running) {
+            break;
+        }
+        
+        // Ticks that arrived while update() was still running are counted as skipped
+        uint64_t skipped = g_plugin_slots.update_frame - seen - 1;
+        seen = g_plugin_slots.update_frame;
+        void (*update)(void) = slot->update;
+        pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+        
+        uint64_t start = monotonic_us();
+        update();
+        record_update_sample(slot, monotonic_us() - start, skipped);
+        
+        pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    }
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    return nullptr;
+}
+
+static bool start_update_worker(PluginSlot* slot, void (*update)(void)) {
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    slot->update = update;
+    slot->worker_running = true;
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
+    if (pthread_create(&slot->worker, NULL, plugin_update_worker, slot) != 0) {
+        slot->worker_running = false;
         return false;
     }
+    slot->offloaded = true;
+    return true;
+}
+
+// Stop an offloaded plugin's worker; waits for an in-flight update() to return
+static void stop_update_worker(PluginSlot* slot) {
+    if (!slot || !slot->offloaded) {
+        return;
+    }
+    
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    slot->worker_running = false;
+    pthread_cond_broadcast(&g_plugin_slots.update_cond);
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
+    pthread_join(slot->worker, NULL);
+    slot->offloaded = false;
+}
+
+// Throttle a plugin that runs over budget; once throttling is exhausted, move it to a worker
+static void apply_update_budget(PluginSlot* slot, PluginInterface* plugin) {
+    uint32_t mean_us, p99_us;
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    slot->since_eval = 0;
+    window_stats(slot, &mean_us, &p99_us);
+    uint32_t budget_us = g_plugin_slots.update_budget_us;
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
+    if (slot->offloaded) {
+        return;
+    }
+    
+    if (p99_us > budget_us) {
+        if (slot->interval < PLUGIN_UPDATE_MAX_INTERVAL) {
+            slot->interval *= 2;
+            add_log_entry(LOG_LEVEL_WARNING, "Plugin %s update() p99 %u us over %u us budget; running every %d frames",
+                          plugin->name, p99_us, budget_us, slot->interval);
+        } else if (start_update_worker(slot, plugin->update)) {
+            add_log_entry(LOG_LEVEL_WARNING, "Plugin %s update() p99 %u us still over budget; moved off the render thread",
+                          plugin->name, p99_us);
+        }
+    } else if (p99_us < budget_us / 2 && slot->interval > 1) {
+        slot->interval /= 2;
+    }
+}
+
+// Find or create the record for a plugin name (main thread only)
+static PluginSlot* get_plugin_slot(const char* name, bool create) {
+    for (int i = 0; i < g_plugin_slots.count; i++) {
+        if (strcmp(g_plugin_slots.slots[i].timing.name, name) == 0) {
+            return &g_plugin_slots.slots[i];
+        }
+    }
+    if (!create || g_plugin_slots.count >= PLUGIN_MAX_SLOTS) {
+        return nullptr;
+    }
     
-    // Validate plugin
-    if (!validate_plugin(plugin)) {
-        add_log_entry(LOG_LEVEL_ERROR, "Plugin %s validation failed", plugin_path);
-        dlclose(handle);
+    PluginSlot* slot = &g_plugin_slots.slots[g_plugin_slots.count++];
+    memset(&slot->timing, 0, sizeof(slot->timing));
+    snprintf(slot->timing.name, sizeof(slot->timing.name), "%s", name);
+    slot->job_state.store(PLUGIN_INIT_JOB_IDLE, std::memory_order_relaxed);
+    reset_update_stats(slot);
+    return slot;
+}
+
+// Register a successfully opened plugin and log its result (main thread only)
+static bool finish_load(PluginLoadResult* result) {
+    if (!result->plugin) {
+        add_log_entry(LOG_LEVEL_ERROR, "Failed to load plugin %s: %s", result->path, result->error);
         return false;
     }
     
-    // Register plugin
-    if (!register_plugin(plugin, handle)) {
-        add_log_entry(LOG_LEVEL_ERROR, "Failed to register plugin %s", plugin_path);
-        dlclose(handle);
+    if (!register_plugin(result->plugin, result->handle)) {
+        add_log_entry(LOG_LEVEL_ERROR, "Failed to register plugin %s", result->path);
+        dlclose(result->handle);
         return false;
     }
     
-    add_log_entry(LOG_LEVEL_INFO, "Plugin %s loaded successfully", plugin->name);
+    PluginSlot* slot = get_plugin_slot(result->plugin->name, true);
+    if (slot) {
+        snprintf(slot->timing.path, sizeof(slot->timing.path), "%s", result->path);
+        slot->timing.scan_us = result->scan_us;
+        slot->timing.load_us = result->load_us;
+    }
+    
+    add_log_entry(LOG_LEVEL_INFO, "Plugin %s loaded successfully (%.1f ms)",
+                  result->plugin->name, (result->scan_us + result->load_us) / 1000.0);
     return true;
 }
 
+// Load a plugin from file
+static bool load_plugin(const char* plugin_path) {
+    if (!g_plugin_manager.initialized) {
+        add_log_entry(LOG_LEVEL_ERROR, "Plugin system not initialized");
+        return false;
+    }
+    
+    add_log_entry(LOG_LEVEL_INFO, "Loading plugin: %s", plugin_path);
+    
+    PluginLoadResult result = {};
+    snprintf(result.path, sizeof(result.path), "%s", plugin_path);
+    open_plugin(&result);
+    return finish_load(&result);
+}
+
 // Unload a plugin
 static bool unload_plugin(const char* plugin_name) {
     if (!g_plugin_manager.initialized) {
@@ -202,6 +642,18 @@ static bool unload_plugin(const char* plugin_name) {
         if (strcmp(g_plugin_manager.plugins[i].name, plugin_name) == 0) {
             PluginInterface* plugin = &g_plugin_manager.plugins[i];
             
+            // A worker is still inside init(); the library can't go away under it
+            if (plugin->status == PLUGIN_STATUS_INITIALIZING) {
+                add_log_entry(LOG_LEVEL_WARNING, "Plugin %s is still initializing; not unloading", plugin_name);
+                return false;
+            }
+            
+            PluginSlot* slot = get_plugin_slot(plugin_name, false);
+            stop_update_worker(slot);
+            if (slot) {
+                reset_update_stats(slot);
+            }
+            
             // Cleanup plugin
             if (plugin->cleanup) {
                 plugin->cleanup();
@@ -227,10 +679,16 @@ static bool unload_plugin(const char* plugin_name) {
     return false;
 }
 
-// Recursively scan plugin directory for available plugins
-static void scan_plugin_directory_recursive(const char* directory) {
-    add_log_entry(LOG_LEVEL_INFO, "Scanning directory: %s", directory);
-    
+// Plugin libraries by extension; dotfiles are skipped (hot reload stages its copies as dotfiles)
+static bool is_plugin_file(const char* name) {
+    if (name[0] == '.') {
+        return false;
+    }
+    return strstr(name, ".so") || strstr(name, ".dll") || strstr(name, ".dylib");
+}
+
+// Recursively collect candidate plugin files
+static void collect_plugin_candidates(const char* directory, std::vector<std::string>& candidates) {
     DIR* dir = opendir(directory);
     if (!dir) {
         add_log_entry(LOG_LEVEL_WARNING, "Failed to open directory: %s", directory);
@@ -249,17 +707,11 @@ static void scan_plugin_directory_recursive(const char* directory) {
         
         if (entry->d_type == DT_DIR) {
             // Recursively scan subdirectories
-            scan_plugin_directory_recursive(full_path);
+            collect_plugin_candidates(full_path, candidates);
         } else if (entry->d_type == DT_REG) {
             // Check if it's a plugin file
-            const char* name = entry->d_name;
-            if (strstr(name, ".so") || strstr(name, ".dll") || strstr(name, ".dylib")) {
-                add_log_entry(LOG_LEVEL_INFO, "Found plugin: %s", full_path);
-                
-                // Try to load the plugin
-                if (load_plugin(full_path)) {
-                    // Plugin count is tracked in g_plugin_manager.count
-                }
+            if (is_plugin_file(entry->d_name)) {
+                candidates.push_back(full_path);
             }
         }
     }
@@ -267,6 +719,24 @@ static void scan_plugin_directory_recursive(const char* directory) {
     closedir(dir);
 }
 
+typedef struct {
+    PluginLoadResult* results;
+    int count;
+    std::atomic<int> next;
+} DiscoveryWork;
+
+static void* discovery_worker(void* arg) {
+    DiscoveryWork* work = (DiscoveryWork*)arg;
+    for (;;) {
+        int i = work->next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= work->count) {
+            break;
+        }
+        open_plugin(&work->results[i]);
+    }
+    return nullptr;
+}
+
 // Scan plugin directory for available plugins
 static void scan_plugin_directory(const char* directory) {
     add_log_entry(LOG_LEVEL_INFO, "Starting plugin directory scan: %s", directory);
@@ -276,10 +746,48 @@ static void scan_plugin_directory(const char* directory) {
         return;
     }
     
-    // Start recursive scan
-    scan_plugin_directory_recursive(directory);
+    uint64_t scan_start = monotonic_us();
+    std::vector<std::string> candidates;
+    collect_plugin_candidates(directory, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    
+    // Check and open candidates in parallel; registration stays on this thread in path order
+    std::vector<PluginLoadResult> results(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        snprintf(results[i].path, sizeof(results[i].path), "%s", candidates[i].c_str());
+    }
+    
+    DiscoveryWork work;
+    work.results = results.data();
+    work.count = (int)results.size();
+    work.next.store(0, std::memory_order_relaxed);
+    
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int worker_count = (int)std::min<long>(std::max<long>(cpus, 1), PLUGIN_DISCOVERY_MAX_WORKERS);
+    worker_count = std::min(worker_count, work.count);
+    
+    pthread_t workers[PLUGIN_DISCOVERY_MAX_WORKERS];
+    int started = 0;
+    for (int i = 1; i < worker_count; i++) {
+        if (pthread_create(&workers[started], NULL, discovery_worker, &work) == 0) {
+            started++;
+        }
+    }
+    discovery_worker(&work);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    
+    int loaded = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        add_log_entry(LOG_LEVEL_INFO, "Found plugin: %s", results[i].path);
+        if (finish_load(&results[i])) {
+            loaded++;
+        }
+    }
     
-    add_log_entry(LOG_LEVEL_INFO, "Plugin directory scan complete. Found %d plugins", g_plugin_manager.count);
+    add_log_entry(LOG_LEVEL_INFO, "Plugin directory scan complete. Loaded %d of %d candidates in %.1f ms (%d workers)",
+                  loaded, (int)results.size(), (monotonic_us() - scan_start) / 1000.0, started + 1);
 }
 
 // Find plugin by name
@@ -297,7 +805,17 @@ static PluginInterface* find_plugin(const char* name) {
     return nullptr;
 }
 
-// Initialize all loaded plugins
+// Runs one plugin's init() on its own detached thread
+static void* plugin_init_worker(void* arg) {
+    PluginSlot* slot = (PluginSlot*)arg;
+    bool ok = slot->init(&slot->context);
+    slot->init_result = ok;
+    slot->finished_us = monotonic_us();
+    slot->job_state.store(PLUGIN_INIT_JOB_DONE, std::memory_order_release);
+    return nullptr;
+}
+
+// Initialize all loaded plugins; init() runs on workers and is harvested by plugin_system_poll()
 static bool init_all_plugins(void) {
     if (!g_plugin_manager.initialized) {
         return false;
@@ -305,22 +823,68 @@ static bool init_all_plugins(void) {
     
     add_log_entry(LOG_LEVEL_INFO, "Initializing %d plugins", g_plugin_manager.count);
     
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    
     for (int i = 0; i < g_plugin_manager.count; i++) {
         PluginInterface* plugin = &g_plugin_manager.plugins[i];
         
-        if (plugin->status == PLUGIN_STATUS_LOADED) {
-            PluginContext ctx = create_plugin_context();
+        if (plugin->status != PLUGIN_STATUS_LOADED) {
+            continue;
+        }
+        if (!plugin->init) {
+            plugin->status = PLUGIN_STATUS_ERROR;
+            add_log_entry(LOG_LEVEL_ERROR, "Failed to initialize plugin %s", plugin->name);
+            continue;
+        }
+        
+        PluginSlot* slot = get_plugin_slot(plugin->name, true);
+        if (slot && slot->job_state.load(std::memory_order_acquire) == PLUGIN_INIT_JOB_RUNNING) {
+            // A timed-out init() from an earlier attempt is still running
+            add_log_entry(LOG_LEVEL_WARNING, "Plugin %s has an init() still running; skipping", plugin->name);
+            continue;
+        }
+        
+        if (slot) {
+            slot->init = plugin->init;
+            slot->context = create_plugin_context();
+            slot->started_us = monotonic_us();
+            slot->timing.init_us = 0;
+            slot->timing.init_pending = true;
+            slot->timing.init_failed = false;
+            slot->timing.init_timed_out = false;
+            slot->job_state.store(PLUGIN_INIT_JOB_RUNNING, std::memory_order_release);
             
-            if (plugin->init && plugin->init(&ctx)) {
-                plugin->status = PLUGIN_STATUS_INITIALIZED;
-                add_log_entry(LOG_LEVEL_INFO, "Plugin %s initialized successfully", plugin->name);
-            } else {
-                plugin->status = PLUGIN_STATUS_ERROR;
-                add_log_entry(LOG_LEVEL_ERROR, "Failed to initialize plugin %s", plugin->name);
+            pthread_t thread;
+            if (pthread_create(&thread, &attr, plugin_init_worker, slot) == 0) {
+                plugin->status = PLUGIN_STATUS_INITIALIZING;
+                continue;
             }
+            slot->job_state.store(PLUGIN_INIT_JOB_IDLE, std::memory_order_relaxed);
+            slot->timing.init_pending = false;
+        }
+        
+        // No slot or no thread: fall back to initializing inline
+        PluginContext ctx = create_plugin_context();
+        uint64_t start = monotonic_us();
+        bool ok = plugin->init(&ctx);
+        if (slot) {
+            slot->timing.init_us = monotonic_us() - start;
+            slot->timing.init_failed = !ok;
+        }
+        
+        if (ok) {
+            plugin->status = PLUGIN_STATUS_INITIALIZED;
+            add_log_entry(LOG_LEVEL_INFO, "Plugin %s initialized successfully", plugin->name);
+        } else {
+            plugin->status = PLUGIN_STATUS_ERROR;
+            add_log_entry(LOG_LEVEL_ERROR, "Failed to initialize plugin %s", plugin->name);
         }
     }
     
+    pthread_attr_destroy(&attr);
+    g_plugin_slots.report_logged = false;
     return true;
 }
 
@@ -335,6 +899,18 @@ static void cleanup_all_plugins(void) {
     for (int i = 0; i < g_plugin_manager.count; i++) {
         PluginInterface* plugin = &g_plugin_manager.plugins[i];
         
+        // Never unmap code a stuck init() is still executing
+        PluginSlot* slot = get_plugin_slot(plugin->name, false);
+        if (slot && slot->job_state.load(std::memory_order_acquire) == PLUGIN_INIT_JOB_RUNNING) {
+            add_log_entry(LOG_LEVEL_WARNING, "Plugin %s still inside init(); leaving it loaded", plugin->name);
+            continue;
+        }
+        
+        stop_update_worker(slot);
+        if (slot) {
+            reset_update_stats(slot);
+        }
+        
         if (plugin->cleanup) {
             plugin->cleanup();
         }
@@ -353,100 +929,327 @@ static void update_all_plugins(void) {
         return;
     }
     
+    plugin_system_poll();
+    
+    // Tick offloaded plugins
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    g_plugin_slots.update_frame++;
+    pthread_cond_broadcast(&g_plugin_slots.update_cond);
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
     for (int i = 0; i < g_plugin_manager.count; i++) {
         PluginInterface* plugin = &g_plugin_manager.plugins[i];
         
-        if (plugin->status == PLUGIN_STATUS_INITIALIZED && plugin->update) {
+        if (plugin->status != PLUGIN_STATUS_INITIALIZED || !plugin->update) {
+            continue;
+        }
+        
+        PluginSlot* slot = get_plugin_slot(plugin->name, false);
+        if (!slot) {
             plugin->update();
+            continue;
+        }
+        if (slot->offloaded) {
+            continue;
+        }
+        if (++slot->frame_counter % slot->interval != 0) {
+            continue;
+        }
+        
+        uint64_t start = monotonic_us();
+        plugin->update();
+        if (record_update_sample(slot, monotonic_us() - start, slot->interval - 1)) {
+            apply_update_budget(slot, plugin);
         }
     }
 }
 
-// Send event to specific plugin
+// Load address of the shared object holding a function (the executable for built-ins)
+static const void* image_of(const void* function) {
+    Dl_info info;
+    return function && dladdr(function, &info) ? info.dli_fbase : nullptr;
+}
+
+// Image whose subscribers count as the plugin's own, for targeted events
+static const void* plugin_image(const PluginInterface* plugin) {
+    if (!plugin) {
+        return nullptr;
+    }
+    const void* entry = plugin->init ? (const void*)plugin->init :
+                        plugin->update ? (const void*)plugin->update : (const void*)plugin->cleanup;
+    return image_of(entry);
+}
+
 static bool send_event(const char* plugin_name, const char* event, void* data) {
     if (!g_plugin_manager.initialized) {
         return false;
     }
     
-    PluginInterface* plugin = find_plugin(plugin_name);
-    if (!plugin) {
+    const void* target = plugin_image(find_plugin(plugin_name));
+    if (!target) {
         return false;
     }
     
-    // Add to event queue
-    if (g_event_system.event_count < 1000) {
-        int idx = g_event_system.event_tail;
-        g_event_system.event_queue[idx].event.event_name = event;
-        g_event_system.event_queue[idx].event.source_plugin = "system";
-        g_event_system.event_queue[idx].event.data = data;
-        g_event_system.event_queue[idx].event.data_size = 0;
-        g_event_system.event_queue[idx].event.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
-        g_event_system.event_queue[idx].processed = false;
-        
-        g_event_system.event_tail = (g_event_system.event_tail + 1) % 1000;
-        g_event_system.event_count++;
-        
-        return true;
-    }
-    
-    return false;
+    return enqueue_event(intern_topic(event), "system", data, 0, target);
 }
 
-// Broadcast event to all plugins
+// Broadcast event to all plugins (one queued event, delivered to every subscriber)
 static bool broadcast_event(const char* event, void* data) {
     if (!g_plugin_manager.initialized) {
         return false;
     }
     
-    // Add to event queue for all plugins
-    for (int i = 0; i < g_plugin_manager.count; i++) {
-        send_event(g_plugin_manager.plugins[i].name, event, data);
+    return enqueue_event(intern_topic(event), "system", data, 0, nullptr);
+}
+
+// FNV-1a hash of a topic name
+static uint32_t hash_topic_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Probe for an existing topic without locking; returns -1 if absent
+static int lookup_topic(const char* event_name, uint32_t hash) {
+    for (int probe = 0; probe < EVENT_MAX_TOPICS; probe++) {
+        int slot = (hash + probe) & (EVENT_MAX_TOPICS - 1);
+        const char* name = g_event_system.topics[slot].name.load(std::memory_order_acquire);
+        if (!name) {
+            return -1;
+        }
+        if (g_event_system.topics[slot].hash == hash && strcmp(name, event_name) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+// Intern a topic name; the returned id is stable for the life of the process
+static int intern_topic(const char* event_name) {
+    if (!event_name) {
+        return -1;
     }
     
-    return true;
+    uint32_t hash = hash_topic_name(event_name);
+    int topic_id = lookup_topic(event_name, hash);
+    if (topic_id >= 0) {
+        return topic_id;
+    }
+    
+    pthread_mutex_lock(&g_event_system.topic_mutex);
+    topic_id = lookup_topic(event_name, hash);
+    if (topic_id < 0) {
+        for (int probe = 0; probe < EVENT_MAX_TOPICS; probe++) {
+            int slot = (hash + probe) & (EVENT_MAX_TOPICS - 1);
+            EventTopic* topic = &g_event_system.topics[slot];
+            if (!topic->name.load(std::memory_order_relaxed)) {
+                topic->hash = hash;
+                topic->subscriber_count = 0;
+                topic->name.store(strdup(event_name), std::memory_order_release);
+                g_event_system.topic_count.fetch_add(1, std::memory_order_relaxed);
+                topic_id = slot;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&g_event_system.topic_mutex);
+    
+    if (topic_id < 0) {
+        add_log_entry(LOG_LEVEL_ERROR, "Event topic table full, cannot intern '%s'", event_name);
+    }
+    return topic_id;
+}
+
+static bool valid_topic(int topic_id) {
+    return topic_id >= 0 && topic_id < EVENT_MAX_TOPICS &&
+           g_event_system.topics[topic_id].name.load(std::memory_order_acquire) != nullptr;
 }
 
 // Subscribe to events
 static bool subscribe(const char* event_name, EventCallback callback) {
-    if (g_event_system.subscription_count >= 100) {
+    return subscribe_topic(intern_topic(event_name), callback);
+}
+
+static bool subscribe_topic(int topic_id, EventCallback callback) {
+    if (!valid_topic(topic_id) || !callback) {
         return false;
     }
     
-    g_event_system.subscriptions[g_event_system.subscription_count].event_name = event_name;
-    g_event_system.subscriptions[g_event_system.subscription_count].callback = callback;
-    g_event_system.subscriptions[g_event_system.subscription_count].plugin_name = "system";
-    g_event_system.subscription_count++;
+    EventTopic* topic = &g_event_system.topics[topic_id];
+    bool success = false;
     
-    return true;
+    pthread_mutex_lock(&g_event_system.topic_mutex);
+    if (topic->subscriber_count < EVENT_MAX_SUBSCRIBERS_PER_TOPIC) {
+        topic->subscribers[topic->subscriber_count++] = callback;
+        success = true;
+    }
+    pthread_mutex_unlock(&g_event_system.topic_mutex);
+    
+    return success;
 }
 
 // Unsubscribe from events
 static bool unsubscribe(const char* event_name, EventCallback callback) {
-    for (int i = 0; i < g_event_system.subscription_count; i++) {
-        if (g_event_system.subscriptions[i].event_name == event_name && 
-            g_event_system.subscriptions[i].callback == callback) {
-            
+    int topic_id = intern_topic(event_name);
+    if (!valid_topic(topic_id)) {
+        return false;
+    }
+    
+    EventTopic* topic = &g_event_system.topics[topic_id];
+    bool success = false;
+    
+    pthread_mutex_lock(&g_event_system.topic_mutex);
+    for (int i = 0; i < topic->subscriber_count; i++) {
+        if (topic->subscribers[i] == callback) {
             // Remove subscription
-            for (int j = i; j < g_event_system.subscription_count - 1; j++) {
-                g_event_system.subscriptions[j] = g_event_system.subscriptions[j + 1];
+            for (int j = i; j < topic->subscriber_count - 1; j++) {
+                topic->subscribers[j] = topic->subscribers[j + 1];
             }
-            g_event_system.subscription_count--;
-            return true;
+            topic->subscriber_count--;
+            success = true;
+            break;
         }
     }
+    pthread_mutex_unlock(&g_event_system.topic_mutex);
     
-    return false;
+    return success;
+}
+
+// Copy a payload so it outlives the publisher's stack
+static EventPayload* create_payload(const void* data, size_t size) {
+    void* memory = malloc(sizeof(EventPayload) + size);
+    if (!memory) {
+        return nullptr;
+    }
+    
+    EventPayload* payload = new (memory) EventPayload;
+    payload->refs.store(1, std::memory_order_relaxed);
+    payload->size = size;
+    memcpy((unsigned char*)(payload + 1), data, size);
+    return payload;
+}
+
+static void* retain_payload(const PluginEvent* event) {
+    if (!event || !event->payload) {
+        return nullptr;
+    }
+    
+    EventPayload* payload = (EventPayload*)event->payload;
+    payload->refs.fetch_add(1, std::memory_order_relaxed);
+    return payload;
+}
+
+static void release_payload(void* payload_handle) {
+    EventPayload* payload = (EventPayload*)payload_handle;
+    if (payload && payload->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        payload->~EventPayload();
+        free(payload);
+    }
+}
+
+// Lock-free multi-producer enqueue; drops (and counts) when the ring is full
+static bool enqueue_event(int topic_id, const char* source_plugin, const void* data, size_t size,
+                          const void* target) {
+    if (!valid_topic(topic_id)) {
+        return false;
+    }
+    
+    EventTopic* topic = &g_event_system.topics[topic_id];
+    
+    // Sized payloads are copied so they outlive the publisher's buffer; unsized
+    // pointers are passed through as before. Without a copy there is nothing
+    // safe to queue, so the event is dropped.
+    EventPayload* payload = nullptr;
+    if (data && size > 0) {
+        payload = create_payload(data, size);
+        if (!payload) {
+            topic->dropped.fetch_add(1, std::memory_order_relaxed);
+            g_event_system.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    
+    EventQueueCell* cell;
+    size_t pos = g_event_system.enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &g_event_system.queue[pos & (EVENT_QUEUE_CAPACITY - 1)];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (g_event_system.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            topic->dropped.fetch_add(1, std::memory_order_relaxed);
+            g_event_system.dropped.fetch_add(1, std::memory_order_relaxed);
+            release_payload(payload);
+            return false;
+        } else {
+            pos = g_event_system.enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    
+    PluginEvent* event = &cell->event;
+    event->event_name = topic->name.load(std::memory_order_relaxed);
+    event->source_plugin = source_plugin;
+    event->data = payload ? (void*)(payload + 1) : (void*)data;
+    event->data_size = payload ? size : 0;
+    event->timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    event->topic_id = topic_id;
+    event->payload = payload;
+    cell->target = target;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    
+    topic->published.fetch_add(1, std::memory_order_relaxed);
+    g_event_system.published.fetch_add(1, std::memory_order_relaxed);
+    
+    // Track the deepest backlog seen (the consumer may already be past this cell)
+    size_t dequeued = g_event_system.dequeue_pos.load(std::memory_order_acquire);
+    uint32_t depth = dequeued < pos + 1 ? (uint32_t)(pos + 1 - dequeued) : 0;
+    uint32_t high_water = g_event_system.queue_high_water.load(std::memory_order_relaxed);
+    while (depth > high_water &&
+           !g_event_system.queue_high_water.compare_exchange_weak(high_water, depth, std::memory_order_relaxed)) {
+    }
+    
+    return true;
+}
+
+// Single-consumer dequeue
+static bool dequeue_event(PluginEvent* out, const void** target) {
+    size_t pos = g_event_system.dequeue_pos.load(std::memory_order_relaxed);
+    EventQueueCell* cell = &g_event_system.queue[pos & (EVENT_QUEUE_CAPACITY - 1)];
+    size_t seq = cell->sequence.load(std::memory_order_acquire);
+    if ((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+        return false;
+    }
+    
+    *out = cell->event;
+    *target = cell->target;
+    cell->sequence.store(pos + EVENT_QUEUE_CAPACITY, std::memory_order_release);
+    g_event_system.dequeue_pos.store(pos + 1, std::memory_order_release);
+    return true;
 }
 
 // Publish event
 static bool publish(const char* event_name, void* data, size_t size) {
-    return broadcast_event(event_name, data);
+    return enqueue_event(intern_topic(event_name), "system", data, size, nullptr);
+}
+
+static bool publish_topic(int topic_id, const void* data, size_t size) {
+    return enqueue_event(topic_id, "system", data, size, nullptr);
 }
 
-// Publish event to specific plugin
+// Publish event to specific plugin: only subscribers inside its image see it
 static bool publish_to_plugin(const char* plugin_name, const char* event_name, void* data, size_t size) {
-    return send_event(plugin_name, event_name, data);
+    const void* target = plugin_image(find_plugin(plugin_name));
+    if (!target) {
+        return false;
+    }
+    return enqueue_event(intern_topic(event_name), "system", data, size, target);
 }
 
 // Process events
@@ -455,31 +1258,40 @@ static void process_events(void) {
         return;
     }
     
-    while (g_event_system.event_count > 0) {
-        int idx = g_event_system.event_head;
-        PluginEvent* event = &g_event_system.event_queue[idx].event;
+    PluginEvent event;
+    const void* target;
+    EventCallback subscribers[EVENT_MAX_SUBSCRIBERS_PER_TOPIC];
+    
+    while (dequeue_event(&event, &target)) {
+        EventTopic* topic = &g_event_system.topics[event.topic_id];
         
-        if (!g_event_system.event_queue[idx].processed) {
-            // Process event
-            for (int i = 0; i < g_event_system.subscription_count; i++) {
-                if (strcmp(g_event_system.subscriptions[i].event_name, event->event_name) == 0) {
-                    g_event_system.subscriptions[i].callback(event);
-                }
+        // Snapshot subscribers so callbacks may (un)subscribe
+        pthread_mutex_lock(&g_event_system.topic_mutex);
+        int subscriber_count = topic->subscriber_count;
+        memcpy(subscribers, topic->subscribers, subscriber_count * sizeof(EventCallback));
+        pthread_mutex_unlock(&g_event_system.topic_mutex);
+        
+        int delivered = 0;
+        for (int i = 0; i < subscriber_count; i++) {
+            if (target && image_of((const void*)subscribers[i]) != target) {
+                continue;
             }
-            
-            g_event_system.event_queue[idx].processed = true;
+            subscribers[i](&event);
+            delivered++;
         }
+        g_event_system.delivered.fetch_add(delivered, std::memory_order_relaxed);
         
-        g_event_system.event_head = (g_event_system.event_head + 1) % 1000;
-        g_event_system.event_count--;
+        release_payload(event.payload);
     }
 }
 
 // Clear events
 static void clear_events(void) {
-    g_event_system.event_count = 0;
-    g_event_system.event_head = 0;
-    g_event_system.event_tail = 0;
+    PluginEvent event;
+    const void* target;
+    while (dequeue_event(&event, &target)) {
+        release_payload(event.payload);
+    }
 }
 
 // Validate plugin interface
@@ -523,7 +1335,9 @@ static bool validate_plugin(PluginInterface* plugin) {
 static PluginContext create_plugin_context(void) {
     PluginContext ctx = {0};
     // Note: In a real implementation, these would be populated with actual module instances
-    // For now, we'll leave them as null pointers
+    // For now, only the event system and plugin manager are exposed
+    ctx.events = &g_event_system_interface;
+    ctx.plugin_mgr = &g_plugin_manager_interface;
     return ctx;
 }
 
@@ -587,3 +1401,551 @@ extern "C" PluginInterface* get_plugin_by_index(int index) {
 extern "C" bool is_plugin_system_initialized(void) {
     return g_plugin_manager.initialized;
 }
+
+// Event bus statistics
+extern "C" void get_event_bus_stats(EventBusStats* stats) {
+    if (!stats) {
+        return;
+    }
+    
+    // Dequeue position first: the enqueue position read after it is never behind
+    size_t dequeued = g_event_system.dequeue_pos.load(std::memory_order_acquire);
+    size_t enqueued = g_event_system.enqueue_pos.load(std::memory_order_acquire);
+    stats->published = g_event_system.published.load(std::memory_order_relaxed);
+    stats->delivered = g_event_system.delivered.load(std::memory_order_relaxed);
+    stats->dropped = g_event_system.dropped.load(std::memory_order_relaxed);
+    stats->queue_depth = (uint32_t)(enqueued - dequeued);
+    stats->queue_high_water = g_event_system.queue_high_water.load(std::memory_order_relaxed);
+    stats->queue_capacity = EVENT_QUEUE_CAPACITY;
+    stats->topic_count = g_event_system.topic_count.load(std::memory_order_relaxed);
+}
+
+extern "C" int get_event_topic_stats(EventTopicStats* stats, int max_topics) {
+    if (!stats) {
+        return 0;
+    }
+    
+    int count = 0;
+    pthread_mutex_lock(&g_event_system.topic_mutex);
+    for (int i = 0; i < EVENT_MAX_TOPICS && count < max_topics; i++) {
+        EventTopic* topic = &g_event_system.topics[i];
+        const char* name = topic->name.load(std::memory_order_acquire);
+        if (!name) {
+            continue;
+        }
+        
+        stats[count].name = name;
+        stats[count].topic_id = i;
+        stats[count].subscriber_count = topic->subscriber_count;
+        stats[count].published = topic->published.load(std::memory_order_relaxed);
+        stats[count].dropped = topic->dropped.load(std::memory_order_relaxed);
+        count++;
+    }
+    pthread_mutex_unlock(&g_event_system.topic_mutex);
+    
+    return count;
+}
+
+// Log per-plugin startup cost once every init() has settled
+static void log_startup_report(void) {
+    uint64_t total_us = 0;
+    for (int i = 0; i < g_plugin_slots.count; i++) {
+        const PluginStartupTiming* t = &g_plugin_slots.slots[i].timing;
+        total_us += t->scan_us + t->load_us + t->init_us;
+        add_log_entry(t->init_failed ? LOG_LEVEL_WARNING : LOG_LEVEL_INFO,
+                      "Startup: %s scan %.1f ms, load %.1f ms, init %.1f ms%s",
+                      t->name, t->scan_us / 1000.0, t->load_us / 1000.0, t->init_us / 1000.0,
+                      t->init_timed_out ? " (timed out)" : (t->init_failed ? " (failed)" : ""));
+    }
+    add_log_entry(LOG_LEVEL_INFO, "Startup: %d plugins, %.1f ms total plugin time",
+                  g_plugin_slots.count, total_us / 1000.0);
+}
+
+#ifdef __linux__
+// Subscription whose callback lived in a library image that was replaced
+typedef struct {
+    int topic_id;
+    char symbol[128];           // Exported name of the callback, empty if it had none
+} MovedSubscription;
+
+// Copy a plugin next to itself under a unique dotfile name, so a reload maps a
+// new image even while the old one is still loaded
+static bool stage_plugin_copy(const char* path, char* staged, size_t staged_size) {
+    const char* slash = strrchr(path, '/');
+    int dir_len = slash ? (int)(slash - path) : 1;
+    snprintf(staged, staged_size, "%.*s/.%s.reload-XXXXXX.so", dir_len, slash ? path : ".", slash ? slash + 1 : path);
+    
+    int out = mkstemps(staged, 3);
+    if (out < 0) {
+        return false;
+    }
+    int in = open(path, O_RDONLY | O_CLOEXEC);
+    bool ok = in >= 0;
+    
+    char buffer[65536];
+    while (ok) {
+        ssize_t n = read(in, buffer, sizeof(buffer));
+        if (n <= 0) {
+            ok = n == 0;
+            break;
+        }
+        ok = write(out, buffer, (size_t)n) == n;
+    }
+    
+    if (in >= 0) {
+        close(in);
+    }
+    close(out);
+    if (!ok) {
+        unlink(staged);
+    }
+    return ok;
+}
+
+// Pull subscriptions whose callbacks point into the named library image
+static void detach_library_subscriptions(const char* library, std::vector<MovedSubscription>& moved) {
+    pthread_mutex_lock(&g_event_system.topic_mutex);
+    for (int t = 0; t < EVENT_MAX_TOPICS; t++) {
+        EventTopic* topic = &g_event_system.topics[t];
+        if (!topic->name.load(std::memory_order_acquire)) {
+            continue;
+        }
+        
+        int kept = 0;
+        for (int i = 0; i < topic->subscriber_count; i++) {
+            EventCallback callback = topic->subscribers[i];
+            Dl_info info;
+            if (dladdr((void*)callback, &info) && info.dli_fname && strcmp(info.dli_fname, library) == 0) {
+                MovedSubscription m;
+                m.topic_id = t;
+                bool exact = info.dli_sname && info.dli_saddr == (void*)callback;
+                snprintf(m.symbol, sizeof(m.symbol), "%s", exact ? info.dli_sname : "");
+                moved.push_back(m);
+            } else {
+                topic->subscribers[kept++] = callback;
+            }
+        }
+        topic->subscriber_count = kept;
+    }
+    pthread_mutex_unlock(&g_event_system.topic_mutex);
+}
+
+// Re-subscribe moved callbacks by symbol in the new image unless init() already did
+static int transfer_subscriptions(void* handle, const std::vector<MovedSubscription>& moved) {
+    int transferred = 0;
+    for (const auto& m : moved) {
+        EventCallback callback = m.symbol[0] ? (EventCallback)dlsym(handle, m.symbol) : nullptr;
+        if (!callback) {
+            continue;
+        }
+        
+        EventTopic* topic = &g_event_system.topics[m.topic_id];
+        bool present = false;
+        pthread_mutex_lock(&g_event_system.topic_mutex);
+        for (int i = 0; i < topic->subscriber_count; i++) {
+            present |= topic->subscribers[i] == callback;
+        }
+        pthread_mutex_unlock(&g_event_system.topic_mutex);
+        
+        if (!present && subscribe_topic(m.topic_id, callback)) {
+            transferred++;
+        }
+    }
+    return transferred;
+}
+#endif
+
+// Swap a loaded plugin for the current build of its file, keeping host-owned state
+extern "C" bool plugin_system_reload(const char* plugin_name) {
+#ifdef __linux__
+    PluginInterface* plugin = plugin_name ? find_plugin(plugin_name) : nullptr;
+    PluginSlot* slot = plugin ? get_plugin_slot(plugin_name, false) : nullptr;
+    if (!plugin || !slot || !slot->timing.path[0]) {
+        add_log_entry(LOG_LEVEL_WARNING, "Plugin %s not found for reload", plugin_name ? plugin_name : "(null)");
+        return false;
+    }
+    if (plugin->status == PLUGIN_STATUS_INITIALIZING ||
+        slot->job_state.load(std::memory_order_acquire) != PLUGIN_INIT_JOB_IDLE) {
+        add_log_entry(LOG_LEVEL_WARNING, "Plugin %s is still initializing; not reloading", plugin_name);
+        return false;
+    }
+    
+    // Load and validate the new build first; on failure the running version stays
+    char staged[512];
+    if (!stage_plugin_copy(slot->timing.path, staged, sizeof(staged))) {
+        add_log_entry(LOG_LEVEL_ERROR, "Reload of %s failed: can't stage %s", plugin_name, slot->timing.path);
+        return false;
+    }
+    PluginLoadResult result = {};
+    snprintf(result.path, sizeof(result.path), "%s", staged);
+    bool opened = open_plugin(&result);
+    unlink(staged);
+    if (!opened || result.plugin->type != plugin->type) {
+        add_log_entry(LOG_LEVEL_ERROR, "Reload of %s failed: %s; keeping the running version", plugin_name,
+                      opened ? "plugin type changed" : result.error);
+        if (opened) {
+            dlclose(result.handle);
+        }
+        return false;
+    }
+    
+    // Swap pause starts here: quiesce everything that can call into the old image
+    uint64_t pause_start = monotonic_us();
+    process_events();
+    data_bridge_suspend();
+    stop_update_worker(slot);
+    
+    ECUSessionHandoff session;
+    session.fd = -1;
+    bool have_session = false;
+    bool dropped_session = false;
+    if (plugin->type == PLUGIN_TYPE_ECU) {
+        if (plugin->interface.ecu.abi_version >= ECU_PLUGIN_ABI_V3 && plugin->interface.ecu.detach_session) {
+            have_session = plugin->interface.ecu.detach_session(&session);
+        }
+        dropped_session = !have_session && plugin->interface.ecu.is_connected && plugin->interface.ecu.is_connected();
+    }
+    
+    std::vector<MovedSubscription> moved;
+    struct link_map* old_map = nullptr;
+    if (plugin->library_handle && dlinfo(plugin->library_handle, RTLD_DI_LINKMAP, &old_map) == 0 && old_map) {
+        detach_library_subscriptions(old_map->l_name, moved);
+    }
+    
+    PluginStatus old_status = plugin->status;
+    void* old_handle = plugin->library_handle;
+    if (plugin->cleanup) {
+        plugin->cleanup();
+    }
+    
+    // Replace the entry in place; the data bridge holds pointers to it
+    *plugin = *result.plugin;
+    plugin->library_handle = result.handle;
+    plugin->status = PLUGIN_STATUS_LOADED;
+    if (old_handle) {
+        dlclose(old_handle);
+    }
+    
+    bool init_ok = true;
+    if (old_status == PLUGIN_STATUS_INITIALIZED) {
+        PluginContext ctx = create_plugin_context();
+        init_ok = plugin->init && plugin->init(&ctx);
+        plugin->status = init_ok ? PLUGIN_STATUS_INITIALIZED : PLUGIN_STATUS_ERROR;
+    }
+    
+    bool session_kept = false;
+    if (have_session) {
+        session_kept = init_ok && plugin->interface.ecu.abi_version >= ECU_PLUGIN_ABI_V3 &&
+                       plugin->interface.ecu.attach_session &&
+                       plugin->interface.ecu.attach_session(&session);
+        if (!session_kept) {
+            close(session.fd);
+        }
+    }
+    
+    int transferred = transfer_subscriptions(result.handle, moved);
+    data_bridge_resume();
+    uint64_t swap_us = monotonic_us() - pause_start;
+    
+    snprintf(slot->timing.name, sizeof(slot->timing.name), "%s", plugin->name);
+    slot->timing.scan_us = result.scan_us;
+    slot->timing.load_us = result.load_us;
+    slot->timing.reload_count++;
+    slot->timing.last_swap_us = swap_us;
+    reset_update_stats(slot);
+    
+    add_log_entry(init_ok ? LOG_LEVEL_INFO : LOG_LEVEL_ERROR,
+                  "Reloaded plugin %s: %.1f ms pause, %d of %d subscriptions moved by symbol%s%s",
+                  plugin->name, swap_us / 1000.0, transferred, (int)moved.size(),
+                  session_kept ? ", ECU session kept" : "", init_ok ? "" : ", init() failed");
+    if ((have_session && !session_kept) || dropped_session) {
+        add_log_entry(LOG_LEVEL_WARNING, "Plugin %s could not keep its ECU session; reconnect required", plugin->name);
+    }
+    return init_ok;
+#else
+    add_log_entry(LOG_LEVEL_WARNING, "Plugin hot reload is not supported on this platform");
+    (void)plugin_name;
+    return false;
+#endif
+}
+
+#ifdef __linux__
+static void watch_directory_recursive(const char* directory) {
+    int wd = inotify_add_watch(g_plugin_watch.fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+    if (wd < 0) {
+        add_log_entry(LOG_LEVEL_WARNING, "Failed to watch directory: %s", directory);
+        return;
+    }
+    g_plugin_watch.dirs.push_back(std::make_pair(wd, std::string(directory)));
+    
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_type == DT_DIR && entry->d_name[0] != '.') {
+            char full_path[512];
+            snprintf(full_path, sizeof(full_path), "%s/%s", directory, entry->d_name);
+            watch_directory_recursive(full_path);
+        }
+    }
+    closedir(dir);
+}
+
+// Drain directory events and reload plugin files once they stop changing (main thread)
+static void poll_plugin_watch(void) {
+    if (g_plugin_watch.fd < 0) {
+        return;
+    }
+    
+    uint64_t now = monotonic_us();
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t len;
+    while ((len = read(g_plugin_watch.fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + len; ) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + event->len;
+            if (event->len == 0) {
+                continue;
+            }
+            
+            const std::string* directory = nullptr;
+            for (const auto& dir : g_plugin_watch.dirs) {
+                if (dir.first == event->wd) {
+                    directory = &dir.second;
+                    break;
+                }
+            }
+            if (!directory) {
+                continue;
+            }
+            
+            std::string path = *directory + "/" + event->name;
+            if (event->mask & IN_ISDIR) {
+                if (event->name[0] != '.') {
+                    watch_directory_recursive(path.c_str());
+                }
+                continue;
+            }
+            if (!(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) || !is_plugin_file(event->name)) {
+                continue;
+            }
+            
+            bool found = false;
+            for (auto& pending : g_plugin_watch.pending) {
+                if (pending.first == path) {
+                    pending.second = now;
+                    found = true;
+                }
+            }
+            if (!found) {
+                g_plugin_watch.pending.push_back(std::make_pair(path, now));
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < g_plugin_watch.pending.size(); ) {
+        if (now - g_plugin_watch.pending[i].second < PLUGIN_RELOAD_SETTLE_US) {
+            i++;
+            continue;
+        }
+        std::string path = g_plugin_watch.pending[i].first;
+        g_plugin_watch.pending.erase(g_plugin_watch.pending.begin() + i);
+        
+        // Build tools often write a temporary and rename it away
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        
+        const char* loaded_name = nullptr;
+        for (int s = 0; s < g_plugin_slots.count; s++) {
+            if (path == g_plugin_slots.slots[s].timing.path && find_plugin(g_plugin_slots.slots[s].timing.name)) {
+                loaded_name = g_plugin_slots.slots[s].timing.name;
+                break;
+            }
+        }
+        
+        add_log_entry(LOG_LEVEL_INFO, "Plugin file changed: %s", path.c_str());
+        if (loaded_name) {
+            plugin_system_reload(loaded_name);
+        } else if (load_plugin(path.c_str())) {
+            init_all_plugins();
+        }
+    }
+}
+#endif
+
+extern "C" bool plugin_system_watch_directory(const char* directory) {
+#ifdef __linux__
+    if (!g_plugin_manager.initialized || !directory) {
+        return false;
+    }
+    if (g_plugin_watch.fd < 0) {
+        g_plugin_watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (g_plugin_watch.fd < 0) {
+            add_log_entry(LOG_LEVEL_WARNING, "Plugin hot reload unavailable: inotify_init1 failed");
+            return false;
+        }
+    }
+    
+    watch_directory_recursive(directory);
+    add_log_entry(LOG_LEVEL_INFO, "Watching %s for plugin changes", directory);
+    return true;
+#else
+    (void)directory;
+    return false;
+#endif
+}
+
+// Harvest finished init() jobs and time out stuck ones (main thread)
+extern "C" void plugin_system_poll(void) {
+    if (!g_plugin_manager.initialized) {
+        return;
+    }
+    
+#ifdef __linux__
+    poll_plugin_watch();
+#endif
+    
+    uint64_t now = monotonic_us();
+    bool pending = false;
+    
+    for (int i = 0; i < g_plugin_slots.count; i++) {
+        PluginSlot* slot = &g_plugin_slots.slots[i];
+        int state = slot->job_state.load(std::memory_order_acquire);
+        if (state == PLUGIN_INIT_JOB_IDLE) {
+            continue;
+        }
+        
+        PluginInterface* plugin = find_plugin(slot->timing.name);
+        
+        if (state == PLUGIN_INIT_JOB_RUNNING) {
+            if (slot->timing.init_timed_out) {
+                continue;
+            }
+            slot->timing.init_us = now - slot->started_us;
+            if (slot->timing.init_us < (uint64_t)g_plugin_slots.init_timeout_ms * 1000) {
+                pending = true;
+                continue;
+            }
+            
+            // Give up on it; the worker keeps running and is reported if it ever returns
+            slot->timing.init_pending = false;
+            slot->timing.init_failed = true;
+            slot->timing.init_timed_out = true;
+            if (plugin) {
+                plugin->status = PLUGIN_STATUS_ERROR;
+            }
+            add_log_entry(LOG_LEVEL_ERROR, "Plugin %s init() timed out after %u ms",
+                          slot->timing.name, g_plugin_slots.init_timeout_ms);
+            continue;
+        }
+        
+        // PLUGIN_INIT_JOB_DONE
+        uint64_t elapsed_us = slot->finished_us - slot->started_us;
+        slot->job_state.store(PLUGIN_INIT_JOB_IDLE, std::memory_order_relaxed);
+        
+        if (slot->timing.init_timed_out) {
+            add_log_entry(LOG_LEVEL_WARNING, "Plugin %s init() returned %s after %.1f ms, past its timeout",
+                          slot->timing.name, slot->init_result ? "success" : "failure", elapsed_us / 1000.0);
+            continue;
+        }
+        
+        slot->timing.init_us = elapsed_us;
+        slot->timing.init_pending = false;
+        slot->timing.init_failed = !slot->init_result;
+        if (plugin && plugin->status == PLUGIN_STATUS_INITIALIZING) {
+            plugin->status = slot->init_result ? PLUGIN_STATUS_INITIALIZED : PLUGIN_STATUS_ERROR;
+        }
+        
+        if (slot->init_result) {
+            add_log_entry(LOG_LEVEL_INFO, "Plugin %s initialized successfully (%.1f ms)",
+                          slot->timing.name, elapsed_us / 1000.0);
+        } else {
+            add_log_entry(LOG_LEVEL_ERROR, "Failed to initialize plugin %s", slot->timing.name);
+        }
+    }
+    
+    if (!pending && !g_plugin_slots.report_logged && g_plugin_slots.count > 0) {
+        g_plugin_slots.report_logged = true;
+        log_startup_report();
+    }
+}
+
+extern "C" void plugin_system_set_init_timeout(uint32_t timeout_ms) {
+    g_plugin_slots.init_timeout_ms = timeout_ms > 0 ? timeout_ms : PLUGIN_INIT_TIMEOUT_MS_DEFAULT;
+}
+
+extern "C" bool plugin_system_startup_pending(void) {
+    for (int i = 0; i < g_plugin_slots.count; i++) {
+        if (g_plugin_slots.slots[i].timing.init_pending) {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern "C" int get_plugin_startup_report(PluginStartupTiming* report, int max_entries) {
+    if (!report) {
+        return 0;
+    }
+    
+    int count = std::min(g_plugin_slots.count, max_entries);
+    for (int i = 0; i < count; i++) {
+        report[i] = g_plugin_slots.slots[i].timing;
+    }
+    return count;
+}
+
+extern "C" void plugin_system_set_update_budget(uint32_t budget_us) {
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    g_plugin_slots.update_budget_us = budget_us > 0 ? budget_us : PLUGIN_UPDATE_BUDGET_US_DEFAULT;
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+}
+
+extern "C" uint32_t plugin_system_get_update_budget(void) {
+    return g_plugin_slots.update_budget_us;
+}
+
+extern "C" int get_plugin_update_stats(PluginUpdateStats* stats, int max_entries) {
+    if (!stats) {
+        return 0;
+    }
+    
+    int count = 0;
+    pthread_mutex_lock(&g_plugin_slots.update_mutex);
+    for (int i = 0; i < g_plugin_slots.count && count < max_entries; i++) {
+        const PluginSlot* slot = &g_plugin_slots.slots[i];
+        if (slot->calls == 0 && !slot->offloaded) {
+            continue;
+        }
+        
+        PluginUpdateStats* out = &stats[count++];
+        memcpy(out->name, slot->timing.name, sizeof(out->name));
+        out->calls = slot->calls;
+        out->skipped = slot->skipped;
+        window_stats(slot, &out->mean_us, &out->p99_us);
+        out->max_us = slot->max_us;
+        out->last_us = slot->last_us;
+        out->over_budget = slot->over_budget;
+        out->interval = slot->interval;
+        out->offloaded = slot->offloaded;
+    }
+    pthread_mutex_unlock(&g_plugin_slots.update_mutex);
+    
+    return count;
+}
+
+extern "C" bool plugin_system_reset_update_policy(const char* plugin_name) {
+    PluginSlot* slot = plugin_name ? get_plugin_slot(plugin_name, false) : nullptr;
+    if (!slot) {
+        return false;
+    }
+    
+    stop_update_worker(slot);
+    reset_update_stats(slot);
+    add_log_entry(LOG_LEVEL_INFO, "Plugin %s update() back on the render thread", plugin_name);
+    return true;
+}
@@ -0,0 +1,341 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute etc. this as long as the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file src/rtv_history.c
+  \ingroup CoreMtx
+  \brief Bounded history buffers for the realtime variables.
+  
+  Each derived variable's history is a list of fixed size blocks. Only the
+  newest RTV_HISTORY_RESIDENT blocks stay in memory; once a block falls out
+  of that window it is handed to a spill thread, which deflates it into a
+  temp file shared by all variables. Reads of spilled samples inflate the
+  block back into a one block cache, so sequential readers (datalog dumps,
+  the logviewer) decompress each block once.
+
+  All history calls are made with the rtv_mutex held, the same lock
+  the old GArray histories were read and written under. The spill thread
+  takes that lock only to retire a block it has written.
+  */
+
+#include <defines.h>
+#include <glib/gstdio.h>
+#include <gmodule.h>
+#include <rtv_history.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define BLOCK_BYTES (RTV_HISTORY_BLOCK * sizeof(gfloat))
+
+/*!
+ \brief _Rtv_Spill is the spill file and the thread writing to it
+ */
+struct _Rtv_Spill
+{
+	gint fd;		/*!< Unlinked temp file, -1 if spilling is off */
+	gchar *path;		/*!< Temp file name, for cleanup */
+	GMutex *lock;		/*!< rtv_mutex */
+	GAsyncQueue *queue;	/*!< Spill_Job's for the thread */
+	GThread *thread;	/*!< Compresses and writes blocks */
+	gint64 end;		/*!< Next write offset, thread owned */
+};
+
+typedef struct
+{
+	Rtv_History *history;	/* NULL tells the thread to exit */
+	guint generation;
+	guint block;
+	gfloat *data;
+}Spill_Job;
+
+static gpointer spill_thread(gpointer);
+static gboolean read_block(Rtv_Spill *, Rtv_History_Block *, gfloat *);
+
+
+/*!
+  \brief rtv_spill_new() opens the spill file and starts its thread. If no
+  temp file can be made, histories simply keep every block in memory.
+  \param lock is the mutex guarding the histories (rtv_mutex)
+  \returns the spill context, free with rtv_spill_free()
+  */
+G_MODULE_EXPORT Rtv_Spill *rtv_spill_new(GMutex *lock)
+{
+	Rtv_Spill *spill = g_new0(Rtv_Spill, 1);
+	GError *error = NULL;
+
+	spill->lock = lock;
+	spill->fd = g_file_open_tmp("mtx-history-XXXXXX",&spill->path,&error);
+	if (spill->fd < 0)
+	{
+		printf(_("Unable to create history spill file, realtime history will stay in memory: %s\n"),error ? error->message : "unknown error");
+		if (error)
+			g_error_free(error);
+		return spill;
+	}
+	/* Gone from the filesystem as soon as we close it, where supported */
+	if (g_unlink(spill->path) == 0)
+	{
+		g_free(spill->path);
+		spill->path = NULL;
+	}
+	spill->queue = g_async_queue_new();
+	spill->thread = g_thread_new("History spill thread",spill_thread,spill);
+	return spill;
+}
+
+
+/*!
+  \brief rtv_spill_free() finishes any queued spills, stops the thread and
+  removes the spill file. Must be called without the rtv_mutex held, and
+  before the histories using it are freed.
+  \param spill is the spill context to free
+  */
+G_MODULE_EXPORT void rtv_spill_free(Rtv_Spill *spill)
+{
+	Spill_Job *job = NULL;
+
+	if (!spill)
+		return;
+	if (spill->thread)
+	{
+		job = g_new0(Spill_Job, 1);
+		g_async_queue_push(spill->queue,job);
+		g_thread_join(spill->thread);
+		g_async_queue_unref(spill->queue);
+	}
+	if (spill->fd >= 0)
+		close(spill->fd);
+	if (spill->path)
+	{
+		g_unlink(spill->path);
+		g_free(spill->path);
+	}
+	g_free(spill);
+}
+
+
+/*!
+  \brief spill_thread() deflates queued blocks into the spill file and
+  retires them from their history
+  \param data is the Rtv_Spill
+  */
+static gpointer spill_thread(gpointer data)
+{
+	Rtv_Spill *spill = (Rtv_Spill *)data;
+	uLongf bound = compressBound(BLOCK_BYTES);
+	Bytef *buf = (Bytef *)g_malloc(bound);
+	Rtv_History_Block *block = NULL;
+	Spill_Job *job = NULL;
+	uLongf length = 0;
+	gboolean written = FALSE;
+
+	while (TRUE)
+	{
+		job = (Spill_Job *)g_async_queue_pop(spill->queue);
+		if (!job->history)
+		{
+			g_free(job);
+			break;
+		}
+		length = bound;
+		written = (compress2(buf,&length,(const Bytef *)job->data,BLOCK_BYTES,Z_BEST_SPEED) == Z_OK) &&
+			(pwrite(spill->fd,buf,length,spill->end) == (ssize_t)length);
+
+		g_mutex_lock(spill->lock);
+		if (job->history->generation != job->generation)
+		{
+			/* History was cleared while we worked, the block is ours */
+			g_free(job->data);
+		}
+		else
+		{
+			block = &g_array_index(job->history->blocks,Rtv_History_Block,job->block);
+			block->spilling = FALSE;
+			if (written)
+			{
+				block->offset = spill->end;
+				block->length = length;
+				block->data = NULL;
+				job->history->resident--;
+				g_free(job->data);
+			}
+		}
+		g_mutex_unlock(spill->lock);
+		if (written)
+			spill->end += length;
+		g_free(job);
+	}
+	g_free(buf);
+	return NULL;
+}
+
+
+/*!
+  \brief read_block() inflates a spilled block
+  \param spill is the spill file
+  \param block is the spilled block
+  \param out receives RTV_HISTORY_BLOCK samples
+  \returns TRUE on success
+  */
+static gboolean read_block(Rtv_Spill *spill, Rtv_History_Block *block, gfloat *out)
+{
+	Bytef *buf = (Bytef *)g_malloc(block->length);
+	uLongf length = BLOCK_BYTES;
+	gboolean ok = FALSE;
+
+	if (pread(spill->fd,buf,block->length,block->offset) == (ssize_t)block->length)
+		ok = (uncompress((Bytef *)out,&length,buf,block->length) == Z_OK) && (length == BLOCK_BYTES);
+	g_free(buf);
+	if (!ok)
+		printf(_("Unable to read back spilled history block at offset %"G_GINT64_FORMAT"\n"),block->offset);
+	return ok;
+}
+
+
+/*!
+  \brief rtv_history_new() creates an empty history
+  \param spill is the spill context to use, NULL to keep everything in memory
+  \returns the new history
+  */
+G_MODULE_EXPORT Rtv_History *rtv_history_new(Rtv_Spill *spill)
+{
+	Rtv_History *history = g_new0(Rtv_History, 1);
+
+	history->spill = spill;
+	history->blocks = g_array_new(FALSE,TRUE,sizeof(Rtv_History_Block));
+	history->cached_block = -1;
+	return history;
+}
+
+
+/*!
+  \brief rtv_history_free() frees a history. No spill may be in flight for
+  it, so free the spill context first.
+  \param history is the history to free
+  */
+G_MODULE_EXPORT void rtv_history_free(Rtv_History *history)
+{
+	if (!history)
+		return;
+	rtv_history_clear(history);
+	g_array_free(history->blocks,TRUE);
+	g_free(history->cache);
+	g_free(history);
+}
+
+
+/*!
+  \brief rtv_history_clear() drops every sample, indices restart at 0.
+  Blocks still being spilled are left to the spill thread to free.
+  \param history is the history to clear
+  */
+G_MODULE_EXPORT void rtv_history_clear(Rtv_History *history)
+{
+	Rtv_History_Block *block = NULL;
+	guint i = 0;
+
+	for (i=0;i<history->blocks->len;i++)
+	{
+		block = &g_array_index(history->blocks,Rtv_History_Block,i);
+		if (!block->spilling)
+			g_free(block->data);
+	}
+	g_array_set_size(history->blocks,0);
+	history->len = 0;
+	history->resident = 0;
+	history->next_spill = 0;
+	history->generation++;
+	history->cached_block = -1;
+}
+
+
+/*!
+  \brief rtv_history_append() appends a sample, queueing the oldest
+  resident block for spilling once the resident window is full
+  \param history is the history to append to
+  \param value is the sample
+  */
+G_MODULE_EXPORT void rtv_history_append(Rtv_History *history, gfloat value)
+{
+	Rtv_History_Block fresh = {0};
+	Rtv_History_Block *block = NULL;
+	Rtv_Spill *spill = history->spill;
+	Spill_Job *job = NULL;
+	guint index = history->len % RTV_HISTORY_BLOCK;
+
+	if (index == 0)
+	{
+		fresh.data = g_new(gfloat, RTV_HISTORY_BLOCK);
+		g_array_append_val(history->blocks,fresh);
+		history->resident++;
+	}
+	block = &g_array_index(history->blocks,Rtv_History_Block,history->blocks->len-1);
+	block->data[index] = value;
+	history->len++;
+
+	if ((index != RTV_HISTORY_BLOCK-1) || (!spill) || (!spill->thread))
+		return;
+	while (history->blocks->len - history->next_spill > RTV_HISTORY_RESIDENT)
+	{
+		block = &g_array_index(history->blocks,Rtv_History_Block,history->next_spill);
+		block->spilling = TRUE;
+		job = g_new(Spill_Job, 1);
+		job->history = history;
+		job->generation = history->generation;
+		job->block = history->next_spill;
+		job->data = block->data;
+		g_async_queue_push(spill->queue,job);
+		history->next_spill++;
+	}
+}
+
+
+/*!
+  \brief rtv_history_get() reads a sample by absolute index, from memory or
+  the spill file
+  \param history is the history to read
+  \param index is the sample number
+  \returns the sample, 0.0 if out of range or unreadable
+  */
+G_MODULE_EXPORT gfloat rtv_history_get(Rtv_History *history, guint index)
+{
+	Rtv_History_Block *block = NULL;
+	gint number = index / RTV_HISTORY_BLOCK;
+
+	if (index >= history->len)
+		return 0.0;
+	block = &g_array_index(history->blocks,Rtv_History_Block,number);
+	if (block->data)
+		return block->data[index % RTV_HISTORY_BLOCK];
+	if (history->cached_block != number)
+	{
+		if (!history->cache)
+			history->cache = g_new(gfloat, RTV_HISTORY_BLOCK);
+		history->cached_block = -1;
+		if (!read_block(history->spill,block,history->cache))
+			return 0.0;
+		history->cached_block = number;
+	}
+	return history->cache[index % RTV_HISTORY_BLOCK];
+}
+
+
+/*!
+  \brief rtv_history_last() reads a sample counting back from the newest
+  \param history is the history to read
+  \param back is how many samples back, 0 for the newest
+  \returns the sample, 0.0 if there aren't that many
+  */
+G_MODULE_EXPORT gfloat rtv_history_last(Rtv_History *history, guint back)
+{
+	if (back >= history->len)
+		return 0.0;
+	return rtv_history_get(history,history->len-1-back);
+}
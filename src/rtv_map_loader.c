@@ -112,8 +112,8 @@ G_MODULE_EXPORT gboolean load_realtime_map_pf(void )
 	rtv_map->rtv_list = g_ptr_array_new();
 	rtv_map->rtv_hash = g_hash_table_new_full(g_str_hash,g_str_equal,g_free,NULL);
 	rtv_map->rtvars_size = firmware->rtvars_size;
-	rtv_map->ts_array = g_array_sized_new(FALSE,TRUE, sizeof(GTimeVal),4096);
 	rtv_map->derived_total = 0; /* Will be incremented for each one loaded*/
+	rtv_map->spill = rtv_spill_new((GMutex *)DATA_GET(global_data,"rtv_mutex"));
 	root_element = xmlDocGetRootElement(doc);
 	xml_result = load_rtv_xml_elements(root_element,rtv_map);
 	xmlFreeDoc(doc);
@@ -206,7 +206,7 @@ void load_derived_var(xmlNode *node, Rtv_Map *map)
 {
 	guint i = 0;
 	gconstpointer *object = NULL;
-	GArray *history = NULL;
+	Rtv_History *history = NULL;
 	gfloat *newfloat = NULL;
 	GList *list = NULL;
 	gfloat tmpf = 0.0;
@@ -261,8 +261,8 @@ void load_derived_var(xmlNode *node, Rtv_Map *map)
 	/* Index */
 	DATA_SET(object,"index",GINT_TO_POINTER(map->derived_total));
 	map->derived_total++;
-	/* History Array */
-	history = g_array_sized_new(FALSE,TRUE,sizeof(gfloat),4096);
+	/* History buffer */
+	history = rtv_history_new(map->spill);
 	/* bind history array to object for future retrieval */
 	DATA_SET(object,"history",(gpointer)history);
 
@@ -0,0 +1,383 @@
+/*
+ * This software comes under the GPL (GNU Public License)
+ * You may freely copy,distribute etc. this as long as the source code
+ * is made available for FREE.
+ * 
+ * No warranty is made or implied. You use this program at your own risk.
+ */
+
+/*!
+  \file src/rtv_plan.c
+  \ingroup CoreMtx
+  \brief Executes the precompiled conversion plan for realtime variables.
+  rtv_processor.c builds the plan from the Rtv_Map with rtv_plan_add_object(),
+  which reads each variable's GData dataset once; rtv_plan_execute() never
+  touches them, so a sample is decoded in one pass over a flat array.
+  */
+
+#include <enums.h>
+#include <gmodule.h>
+#include <mtxmatheval.h>
+#include <rtv_plan.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Same as DATA_GET()/DATA_SET_FULL(), without pulling in defines.h */
+#define OBJ_GET(object, name) g_dataset_get_data(object,name)
+#define OBJ_INT(object, name) GPOINTER_TO_INT(g_dataset_get_data(object,name))
+
+static void init_rtv_field(Rtv_Field *, gint, DataSize, guint32);
+static gboolean compile_complex_step(Rtv_Step *, gconstpointer *);
+
+
+/*!
+  \brief rtv_plan_new() creates an empty conversion plan
+  \param bigendian is the byte order of the realtime block
+  \returns a new plan, free with rtv_plan_free()
+  */
+G_MODULE_EXPORT Rtv_Plan *rtv_plan_new(gboolean bigendian)
+{
+	Rtv_Plan *plan = g_new0(Rtv_Plan, 1);
+
+	plan->bigendian = bigendian;
+	return plan;
+}
+
+
+/*!
+  \brief rtv_plan_free() releases a plan and its compiled expressions. The
+  history arrays and objects belong to the Rtv_Map and are left alone.
+  \param plan is the plan to free
+  */
+G_MODULE_EXPORT void rtv_plan_free(Rtv_Plan *plan)
+{
+	guint i = 0;
+
+	if (!plan)
+		return;
+	for (i=0;i<plan->count;i++)
+	{
+		if (plan->steps[i].compiled)
+			evaluator_compiled_destroy(plan->steps[i].compiled);
+		g_free(plan->steps[i].symbols);
+	}
+	g_free(plan->steps);
+	g_free(plan->scratch);
+	g_free(plan);
+}
+
+
+/*!
+  \brief rtv_plan_add_step() appends a zeroed step to the plan
+  \param plan is the plan to grow
+  \returns the new step, valid until the next rtv_plan_add_step()
+  */
+G_MODULE_EXPORT Rtv_Step *rtv_plan_add_step(Rtv_Plan *plan)
+{
+	Rtv_Step *step = NULL;
+
+	if (plan->count == plan->allocated)
+	{
+		plan->allocated = plan->allocated ? plan->allocated * 2 : 64;
+		plan->steps = g_renew(Rtv_Step, plan->steps, plan->allocated);
+	}
+	step = &plan->steps[plan->count++];
+	memset(step,0,sizeof(Rtv_Step));
+	step->lower_limit = -G_MAXDOUBLE;
+	step->upper_limit = G_MAXDOUBLE;
+	return step;
+}
+
+
+/*!
+  \brief rtv_plan_add_object() appends the step for one derived variable.
+  Everything process_rt_vars() used to look up per sample (offsets, sizes,
+  multipliers, history buffers, evaluators) is resolved here once. Complex
+  expressions over raw variables are compiled to bytecode; lookuptables get
+  their multiplier and adder applied to the callback's result; specials,
+  multi-expressions and expressions needing ECU variables stay on the
+  callback path.
+  \param plan is the plan to grow
+  \param object is the derived variable
+  \returns TRUE if the step runs without the callback
+  */
+G_MODULE_EXPORT gboolean rtv_plan_add_object(Rtv_Plan *plan, gconstpointer *object)
+{
+	Rtv_Step *step = NULL;
+	gfloat *multiplier = NULL;
+	gfloat *adder = NULL;
+
+	step = rtv_plan_add_step(plan);
+	step->object = object;
+	step->slot = OBJ_INT(object,"index");
+	step->history = (Rtv_History *)OBJ_GET(object,"history");
+	step->kind = RTV_CONV_CALLBACK;
+	init_rtv_field(&step->field,OBJ_INT(object,"offset"),(DataSize)OBJ_INT(object,"size"),0);
+
+	/* Specials never get the temperature conversion */
+	if (OBJ_GET(object,"special"))
+		return FALSE;
+	step->temp_dep = (gboolean)OBJ_INT(object,"temp_dep");
+	if (OBJ_GET(object,"multi_expr_hash"))
+		return FALSE;
+	if (OBJ_GET(object,"fromecu_complex"))
+		return compile_complex_step(step,object);
+
+	/* An adder without a multiplier has always been ignored */
+	multiplier = (gfloat *)OBJ_GET(object,"fromecu_mult");
+	adder = (gfloat *)OBJ_GET(object,"fromecu_add");
+	step->multiplier = multiplier ? *multiplier : 1.0f;
+	step->adder = ((multiplier) && (adder)) ? *adder : 0.0f;
+	if (OBJ_GET(object,"lookuptable"))
+	{
+		step->kind = RTV_CONV_LOOKUP;
+		return FALSE;
+	}
+	if ((multiplier) && (adder))
+		step->kind = RTV_CONV_ADD_MULT;
+	else if (multiplier)
+		step->kind = RTV_CONV_MULT;
+	else
+		step->kind = RTV_CONV_RAW;
+	return TRUE;
+}
+
+
+/*!
+  \brief init_rtv_field() fills in a plan field from an MTX DataSize
+  \param field is the field to fill in
+  \param offset is the byte offset in the realtime block
+  \param size is the size enumeration of the variable
+  \param bitmask selects an embedded bitfield, 0 for the whole field
+  */
+static void init_rtv_field(Rtv_Field *field, gint offset, DataSize size, guint32 bitmask)
+{
+	switch (size)
+	{
+		case MTX_CHAR:
+		case MTX_U08:
+			rtv_field_init(field,offset,1,FALSE,bitmask);
+			break;
+		case MTX_S08:
+			rtv_field_init(field,offset,1,TRUE,bitmask);
+			break;
+		case MTX_U16:
+			rtv_field_init(field,offset,2,FALSE,bitmask);
+			break;
+		case MTX_S16:
+			rtv_field_init(field,offset,2,TRUE,bitmask);
+			break;
+		case MTX_U32:
+			rtv_field_init(field,offset,4,FALSE,bitmask);
+			break;
+		case MTX_S32:
+			rtv_field_init(field,offset,4,TRUE,bitmask);
+			break;
+		default:
+			rtv_field_init(field,offset,0,FALSE,bitmask);
+			break;
+	}
+}
+
+
+/*!
+  \brief compile_complex_step() turns a fromecu_complex variable into a
+  compiled expression step, if all of its symbols come from the realtime
+  block
+  \param step is the plan step to fill in
+  \param object is the derived variable
+  \returns TRUE if the step can skip handle_complex_expr()
+  */
+static gboolean compile_complex_step(Rtv_Step *step, gconstpointer *object)
+{
+	gchar **symbols = NULL;
+	gint *expr_types = NULL;
+	gint total_symbols = 0;
+	gchar *tmpbuf = NULL;
+	gint offset = 0;
+	DataSize size = MTX_U08;
+	guint bitmask = 0;
+	void *evaluator = NULL;
+	gint i = 0;
+
+	symbols = (gchar **)OBJ_GET(object,"expr_symbols");
+	expr_types = (gint *)OBJ_GET(object,"expr_types");
+	total_symbols = OBJ_INT(object,"total_symbols");
+	if ((!symbols) || (!expr_types))
+		return FALSE;
+	for (i=0;i<total_symbols;i++)
+		if ((expr_types[i] != RAW_VAR) && (expr_types[i] != RAW_EMB_BIT))
+			return FALSE;
+
+	evaluator = (void *)OBJ_GET(object,"ul_evaluator");
+	if (!evaluator)
+	{
+		evaluator = evaluator_create((gchar *)OBJ_GET(object,"fromecu_conv_expr"));
+		if (!evaluator)
+			return FALSE;
+		g_dataset_set_data_full(object,"ul_evaluator",evaluator,(GDestroyNotify)evaluator_destroy);
+	}
+	step->compiled = evaluator_compile(evaluator,total_symbols,symbols);
+	if (!step->compiled)
+		return FALSE;
+
+	step->symbol_count = total_symbols;
+	step->symbols = g_new0(Rtv_Field, MAX(total_symbols,1));
+	for (i=0;i<total_symbols;i++)
+	{
+		tmpbuf = g_strdup_printf("%s_offset",symbols[i]);
+		offset = OBJ_INT(object,tmpbuf);
+		g_free(tmpbuf);
+		if (expr_types[i] == RAW_VAR)
+		{
+			tmpbuf = g_strdup_printf("%s_size",symbols[i]);
+			size = (DataSize)OBJ_INT(object,tmpbuf);
+			g_free(tmpbuf);
+			init_rtv_field(&step->symbols[i],offset,size,0);
+		}
+		else
+		{
+			tmpbuf = g_strdup_printf("%s_bitmask",symbols[i]);
+			bitmask = OBJ_INT(object,tmpbuf);
+			g_free(tmpbuf);
+			init_rtv_field(&step->symbols[i],offset,MTX_U08,bitmask);
+		}
+	}
+	if (OBJ_GET(object,"real_lower"))
+		step->lower_limit = strtod((gchar *)OBJ_GET(object,"real_lower"),NULL);
+	if (OBJ_GET(object,"real_upper"))
+		step->upper_limit = strtod((gchar *)OBJ_GET(object,"real_upper"),NULL);
+	step->kind = RTV_CONV_EXPR;
+	return TRUE;
+}
+
+
+/*!
+  \brief rtv_plan_finish() sizes the expression scratch space once all
+  steps have been added
+  \param plan is the plan to finish
+  */
+G_MODULE_EXPORT void rtv_plan_finish(Rtv_Plan *plan)
+{
+	guint i = 0;
+
+	plan->max_symbols = 1;
+	for (i=0;i<plan->count;i++)
+		plan->max_symbols = MAX(plan->max_symbols,plan->steps[i].symbol_count);
+	g_free(plan->scratch);
+	plan->scratch = g_new0(gdouble, plan->max_symbols);
+}
+
+
+/*!
+  \brief rtv_field_init() fills in a field descriptor
+  \param field is the field to fill in
+  \param offset is the byte offset in the realtime block
+  \param width is the field width in bytes (1, 2 or 4)
+  \param is_signed says whether to sign extend the field
+  \param bitmask selects an embedded bitfield, 0 for the whole field
+  */
+G_MODULE_EXPORT void rtv_field_init(Rtv_Field *field, gint offset, guint8 width, gboolean is_signed, guint32 bitmask)
+{
+	field->offset = offset;
+	field->width = width;
+	field->is_signed = is_signed;
+	field->bitmask = bitmask;
+	field->bitshift = 0;
+	if (bitmask)
+		while (!(bitmask & (1u << field->bitshift)))
+			field->bitshift++;
+}
+
+
+/*!
+  \brief rtv_field_decode() assembles a field from the realtime block, the
+  same way _get_sized_data() does
+  \param field is the field to decode
+  \param raw is the realtime block
+  \param bigendian is the byte order of the block
+  \returns the field value
+  */
+G_MODULE_EXPORT gint rtv_field_decode(const Rtv_Field *field, const guchar *raw, gboolean bigendian)
+{
+	const guchar *p = raw + field->offset;
+	guint32 value = 0;
+
+	switch (field->width)
+	{
+		case 1:
+			value = field->is_signed ? (guint32)(gint8)p[0] : p[0];
+			break;
+		case 2:
+			value = bigendian ? (p[0] << 8) | p[1] : p[0] | (p[1] << 8);
+			if (field->is_signed)
+				value = (guint32)(gint16)value;
+			break;
+		case 4:
+			if (bigendian)
+				value = ((guint32)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+			else
+				value = p[0] | (p[1] << 8) | (p[2] << 16) | ((guint32)p[3] << 24);
+			break;
+		default:
+			return 0;
+	}
+	if (field->bitmask)
+		value = (value & field->bitmask) >> field->bitshift;
+	return (gint)value;
+}
+
+
+/*!
+  \brief rtv_plan_execute() converts one realtime sample
+  \param plan is the plan to run
+  \param raw is the incoming realtime block
+  \param values receives each step's result at its slot
+  \param callback converts RTV_CONV_CALLBACK and RTV_CONV_LOOKUP steps
+  \param data is passed to the callback
+  */
+G_MODULE_EXPORT void rtv_plan_execute(Rtv_Plan *plan, guchar *raw, gfloat *values, Rtv_Plan_Callback callback, gpointer data)
+{
+	const gboolean bigendian = plan->bigendian;
+	gdouble *scratch = plan->scratch;
+	gdouble result = 0.0;
+	Rtv_Step *step = NULL;
+	guint i = 0;
+	gint j = 0;
+
+	for (i=0;i<plan->count;i++)
+	{
+		step = &plan->steps[i];
+		switch (step->kind)
+		{
+			case RTV_CONV_RAW:
+				result = rtv_field_decode(&step->field,raw,bigendian);
+				break;
+			case RTV_CONV_MULT:
+				result = (gfloat)rtv_field_decode(&step->field,raw,bigendian) * step->multiplier;
+				break;
+			case RTV_CONV_ADD_MULT:
+				result = ((gfloat)rtv_field_decode(&step->field,raw,bigendian) + step->adder) * step->multiplier;
+				break;
+			case RTV_CONV_EXPR:
+				for (j=0;j<step->symbol_count;j++)
+					scratch[j] = rtv_field_decode(&step->symbols[j],raw,bigendian);
+				result = evaluator_compiled_evaluate(step->compiled,scratch);
+				if (result < step->lower_limit)
+					result = step->lower_limit;
+				if (result > step->upper_limit)
+					result = step->upper_limit;
+				result = (gfloat)result;
+				break;
+			case RTV_CONV_CALLBACK:
+				result = callback ? callback(step,raw,data) : 0.0;
+				break;
+			case RTV_CONV_LOOKUP:
+				result = ((callback ? callback(step,raw,data) : 0.0f) + step->adder) * step->multiplier;
+				break;
+		}
+		if ((step->temp_dep) && (plan->temp_to_host))
+			result = plan->temp_to_host(result);
+		values[step->slot] = (gfloat)result;
+	}
+}
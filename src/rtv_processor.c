@@ -42,6 +42,9 @@
 
 extern gconstpointer *global_data;
 
+static Rtv_Plan *compile_rtv_plan(Rtv_Map *, Firmware_Details *);
+static gfloat convert_rtv_step(Rtv_Step *, guchar *, gpointer);
+
 /*!
   \brief process_rt_vars() processes incoming realtime variables. It's a pretty
   complex function so read the sourcecode.. ;)
@@ -55,22 +58,10 @@ G_MODULE_EXPORT void process_rt_vars(void *incoming, gint len)
 	static Firmware_Details *firmware = NULL;
 	gint mtx_temp_units;
 	guchar *raw_realtime = (guchar *)incoming;
-	gconstpointer * object = NULL;
-	GList * list= NULL;
+	Rtv_Plan *plan = NULL;
 	guint i = 0;
-	guint j = 0;
-	gfloat x = 0;
-	gint offset = 0;
-	DataSize size = MTX_U08;
-	gfloat result = 0.0;
 	gfloat tmpf = 0.0;
-	gfloat *adder = NULL;
-	gfloat *multiplier = NULL;
-	gboolean temp_dep = FALSE;
 	GTimeVal timeval;
-	GArray *history = NULL;
-	gchar *special = NULL;
-	GHashTable *hash = NULL;
 
 	ENTER();
 	if (!firmware)
@@ -92,16 +83,20 @@ G_MODULE_EXPORT void process_rt_vars(void *incoming, gint len)
 	memcpy(firmware->rt_data,incoming,len);
 	mtx_temp_units = (GINT)DATA_GET(global_data,"mtx_temp_units");
 	g_get_current_time(&timeval);
-	g_array_append_val(rtv_map->ts_array,timeval);
-	if (rtv_map->ts_array->len%250 == 0)
+	/* Only the first and latest timestamps are ever read back */
+	if (rtv_map->samples == 0)
+		rtv_map->ts_first = timeval;
+	rtv_map->ts_last = timeval;
+	rtv_map->samples++;
+	if (rtv_map->samples%250 == 0)
 	{
 		GTimeVal curr;
 		GTimeVal begin;
 		gint hours = 0;
 		gint minutes = 0;
 		gint seconds = 0;
-		curr = g_array_index(rtv_map->ts_array,GTimeVal, rtv_map->ts_array->len-1);
-		begin = g_array_index(rtv_map->ts_array,GTimeVal,0);
+		curr = rtv_map->ts_last;
+		begin = rtv_map->ts_first;
 		tmpf = curr.tv_sec-begin.tv_sec-((curr.tv_usec-begin.tv_usec)/1000000);
 		hours = tmpf > 3600.0 ? floor(tmpf/3600.0) : 0;
 		tmpf -= hours*3600.0;
@@ -109,101 +104,92 @@ G_MODULE_EXPORT void process_rt_vars(void *incoming, gint len)
 		tmpf -= minutes*60.0;
 		seconds = (GINT)tmpf;
 
-		thread_update_logbar("dlog_view",NULL,g_strdup_printf(_("Currently %i samples stored, Total Logged Time (HH:MM:SS) (%02i:%02i:%02i)\n"),rtv_map->ts_array->len,hours,minutes,seconds),FALSE,FALSE);
+		thread_update_logbar("dlog_view",NULL,g_strdup_printf(_("Currently %i samples stored, Total Logged Time (HH:MM:SS) (%02i:%02i:%02i)\n"),rtv_map->samples,hours,minutes,seconds),FALSE,FALSE);
+	}
+
+	if (!rtv_map->plan)
+	{
+		rtv_map->plan = compile_rtv_plan(rtv_map,firmware);
+		rtv_map->values = g_new0(gfloat, MAX(rtv_map->derived_total,1));
 	}
+	plan = rtv_map->plan;
+	rtv_plan_execute(plan,raw_realtime,rtv_map->values,convert_rtv_step,NULL);
 
+	/* Store data in history buffers, one lock for the whole sample */
+	g_mutex_lock(rtv_mutex);
+	for (i=0;i<plan->count;i++)
+		rtv_history_append(plan->steps[i].history,rtv_map->values[plan->steps[i].slot]);
+	g_mutex_unlock(rtv_mutex);
+	EXIT();
+	return;
+}
+
+
+/*!
+  \brief compile_rtv_plan() flattens the realtime map into a conversion plan,
+  one rtv_plan_add_object() step per derived variable
+  \param rtv_map is the realtime map to compile
+  \param firmware is the firmware the map belongs to
+  \returns the plan, in the same variable order as the offset hash walk
+  */
+static Rtv_Plan *compile_rtv_plan(Rtv_Map *rtv_map, Firmware_Details *firmware)
+{
+	Rtv_Plan *plan = NULL;
+	gconstpointer *object = NULL;
+	GList *list = NULL;
+	guint i = 0;
+	guint fast = 0;
+
+	ENTER();
+	plan = rtv_plan_new(firmware->bigendian);
+	plan->temp_to_host = temp_to_host;
 	for (i=0;i<rtv_map->rtvars_size;i++)
 	{
-		/* Get list of derived vars for raw offset "i" */
 		list = (GList *)g_hash_table_lookup(rtv_map->offset_hash,GINT_TO_POINTER(i));
-		if (list == NULL) /* no derived vars for this variable */
-		{
-			continue;
-		}
-		list = g_list_first(list);
-		for (j=0;j<g_list_length(list);j++)
+		for (list = g_list_first(list);list;list = list->next)
 		{
-			history = NULL;
-			special = NULL;
-			hash = NULL;
-			temp_dep = FALSE;
-			object=(gconstpointer *)g_list_nth_data(list,j);
-			/*
-			printf("Dumping datalist for objects\n");
-			g_dataset_foreach(object,dump_datalist,NULL);
-			*/
-			 
+			object = (gconstpointer *)list->data;
 			if (!object)
 			{
 				MTXDBG(COMPLEX_EXPR|CRITICAL,_("Object bound to list at offset %i is invalid!!!!\n"),i);
 				continue;
 			}
-			special = (gchar *)DATA_GET(object,"special");
-			if (special)
-			{
-				tmpf = handle_special(object,special);
-				goto store_it;
-			}
-			temp_dep = (GBOOLEAN)DATA_GET(object,"temp_dep");
-			hash = (GHashTable *)DATA_GET(object,"multi_expr_hash");
-			if (hash)
-			{
-				tmpf = handle_multi_expression(object,raw_realtime,hash);
-				goto store_it;
-			}
-			offset = (GINT)DATA_GET(object,"offset");
-			size = (DataSize)(GINT)DATA_GET(object,"size");
-			if (DATA_GET(object,"fromecu_complex"))
-			{
-				tmpf = handle_complex_expr(object,incoming,UPLOAD);
-				goto store_it;
-			}
-
-			if (DATA_GET(object,"lookuptable"))
-			{
-				MTXDBG(COMPLEX_EXPR,_("Getting Lookuptable for var using offset %i\n"),offset);
-				x = lookup_data(object,raw_realtime[offset]);
-			}
-			else
-			{
-				MTXDBG(COMPLEX_EXPR,_("No Lookuptable needed for var using offset %i\n"),offset);
-				x = _get_sized_data((guint8 *)incoming,offset,size,firmware->bigendian);
-			}
-
-			/* MS Simple math without the complex math... */
-			multiplier = NULL;
-			adder = NULL;
-			multiplier = (gfloat *)DATA_GET(object,"fromecu_mult");
-			adder = (gfloat *)DATA_GET(object,"fromecu_add");
-			if ((multiplier) && (adder))
-				tmpf = (x + (*adder)) * (*multiplier);
-			else if (multiplier)
-				tmpf = x * (*multiplier);
-			else
-				tmpf = x;
-
-store_it:
-			if (temp_dep)
-			{
-				MTXDBG(COMPLEX_EXPR,_("Var at offset %i is temp dependant.\n"),offset);
-				result = temp_to_host(tmpf);
-			}
-			else
-				result = tmpf;
-			/* Get history array and current index point */
-			history = (GArray *)DATA_GET(object,"history");
-			/* Store data in history buffer */
-			g_mutex_lock(rtv_mutex);
-			g_array_append_val(history,result);
-			/*printf("array size %i, current index %i, appended %f, readback %f previous %f\n",history->len,history->len-1,result,g_array_index(history, gfloat, history->len-1),g_array_index(history, gfloat, history->len-2));*/
-			g_mutex_unlock(rtv_mutex);
-
-			/*printf("Result of %s is %f\n",(gchar *)DATA_GET(object,"internal_names"),result);*/
-
+			if (rtv_plan_add_object(plan,object))
+				fast++;
 		}
 	}
+	rtv_plan_finish(plan);
+	MTXDBG(COMPLEX_EXPR,_("Compiled realtime map, %i of %i variables on the fast path\n"),fast,plan->count);
 	EXIT();
-	return;
+	return plan;
+}
+
+
+/*!
+  \brief convert_rtv_step() converts a plan step that has no fast path, the
+  way process_rt_vars() always has
+  \param step is the plan step
+  \param raw_realtime is the incoming realtime block
+  \param data is unused
+  \returns the converted value; lookuptable values are scaled and
+  temperatures converted by the plan afterwards
+  */
+static gfloat convert_rtv_step(Rtv_Step *step, guchar *raw_realtime, gpointer data)
+{
+	gconstpointer *object = (gconstpointer *)step->object;
+	gchar *special = NULL;
+	GHashTable *hash = NULL;
+
+	special = (gchar *)DATA_GET(object,"special");
+	if (special)
+		return handle_special(object,special);
+	hash = (GHashTable *)DATA_GET(object,"multi_expr_hash");
+	if (hash)
+		return handle_multi_expression(object,raw_realtime,hash);
+	if (DATA_GET(object,"fromecu_complex"))
+		return handle_complex_expr(object,raw_realtime,UPLOAD);
+	MTXDBG(COMPLEX_EXPR,_("Getting Lookuptable for var using offset %i\n"),step->field.offset);
+	return lookup_data(object,raw_realtime[step->field.offset]);
 }
 
 
@@ -643,7 +629,7 @@ G_MODULE_EXPORT gboolean lookup_current_index(const gchar *internal_name, gint *
 	static GMutex *rtv_mutex = NULL;
 	Rtv_Map *rtv_map = NULL;
 	gconstpointer * object = NULL;
-	GArray * history = NULL;
+	Rtv_History * history = NULL;
 	rtv_map = (Rtv_Map *)DATA_GET(global_data,"rtv_map");
 
 	ENTER();
@@ -663,7 +649,7 @@ G_MODULE_EXPORT gboolean lookup_current_index(const gchar *internal_name, gint *
 		return FALSE;
 	}
 
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -688,7 +674,7 @@ G_MODULE_EXPORT gboolean lookup_current_value(const gchar *internal_name, gfloat
 	static GMutex *rtv_mutex = NULL;
 	Rtv_Map *rtv_map = NULL;
 	gconstpointer * object = NULL;
-	GArray * history = NULL;
+	Rtv_History * history = NULL;
 	rtv_map = (Rtv_Map *)DATA_GET(global_data,"rtv_map");
 
 	ENTER();
@@ -708,7 +694,7 @@ G_MODULE_EXPORT gboolean lookup_current_value(const gchar *internal_name, gfloat
 		return FALSE;
 	}
 
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -722,7 +708,7 @@ G_MODULE_EXPORT gboolean lookup_current_value(const gchar *internal_name, gfloat
 	}
 
 	g_mutex_lock(rtv_mutex);
-	*value = g_array_index(history,gfloat,history->len-1);
+	*value = rtv_history_get(history,history->len-1);
 	g_mutex_unlock(rtv_mutex);
 	EXIT();
 	return TRUE;
@@ -740,7 +726,7 @@ G_MODULE_EXPORT gboolean lookup_previous_value(const gchar *internal_name, gfloa
 {
 	static GMutex *rtv_mutex = NULL;
 	gconstpointer * object = NULL;
-	GArray * history = NULL;
+	Rtv_History * history = NULL;
 	Rtv_Map *rtv_map = NULL;
 	rtv_map = (Rtv_Map *)DATA_GET(global_data,"rtv_map");
 
@@ -761,7 +747,7 @@ G_MODULE_EXPORT gboolean lookup_previous_value(const gchar *internal_name, gfloa
 		return FALSE;
 	}
 
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -775,7 +761,7 @@ G_MODULE_EXPORT gboolean lookup_previous_value(const gchar *internal_name, gfloa
 	}
 
 	g_mutex_lock(rtv_mutex);
-	*value = g_array_index(history,gfloat,history->len-2);
+	*value = rtv_history_get(history,history->len-2);
 	g_mutex_unlock(rtv_mutex);
 	EXIT();
 	return TRUE;
@@ -795,7 +781,7 @@ G_MODULE_EXPORT gboolean lookup_previous_nth_value(const gchar *internal_name, g
 {
 	static GMutex *rtv_mutex = NULL;
 	gconstpointer * object = NULL;
-	GArray * history = NULL;
+	Rtv_History * history = NULL;
 	gint index = 0;
 	Rtv_Map *rtv_map = NULL;
 	rtv_map = (Rtv_Map *)DATA_GET(global_data,"rtv_map");
@@ -817,7 +803,7 @@ G_MODULE_EXPORT gboolean lookup_previous_nth_value(const gchar *internal_name, g
 		return FALSE;
 	}
 
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -833,9 +819,9 @@ G_MODULE_EXPORT gboolean lookup_previous_nth_value(const gchar *internal_name, g
 	g_mutex_lock(rtv_mutex);
 	if (index > n)
 		index -= n;  /* get PREVIOUS nth one */
-	*value = g_array_index(history,gfloat,index);
+	*value = rtv_history_get(history,index);
 	g_mutex_unlock(rtv_mutex);
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	EXIT();
 	return TRUE;
 }
@@ -854,7 +840,7 @@ G_MODULE_EXPORT gboolean lookup_previous_n_values(const gchar *internal_name, gi
 {
 	static GMutex *rtv_mutex = NULL;
 	gconstpointer * object = NULL;
-	GArray * history = NULL;
+	Rtv_History * history = NULL;
 	gint index = 0;
 	gint i = 0;
 	Rtv_Map *rtv_map = NULL;
@@ -879,7 +865,7 @@ G_MODULE_EXPORT gboolean lookup_previous_n_values(const gchar *internal_name, gi
 		return FALSE;
 	}
 
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -899,7 +885,7 @@ G_MODULE_EXPORT gboolean lookup_previous_n_values(const gchar *internal_name, gi
 		for (i=0;i<n;i++)
 		{
 			index--;  /* get PREVIOUS nth one */
-			values[i] = g_array_index(history,gfloat,index);
+			values[i] = rtv_history_get(history,index);
 		}
 	}
 	g_mutex_unlock(rtv_mutex);
@@ -920,7 +906,7 @@ G_MODULE_EXPORT gboolean lookup_previous_n_skip_x_values(const gchar *internal_n
 {
 	static GMutex *rtv_mutex = NULL;
 	gconstpointer * object = NULL;
-	GArray * history = NULL;
+	Rtv_History * history = NULL;
 	gint index = 0;
 	gint i = 0;
 	Rtv_Map *rtv_map = NULL;
@@ -944,7 +930,7 @@ G_MODULE_EXPORT gboolean lookup_previous_n_skip_x_values(const gchar *internal_n
 		return FALSE;
 	}
 
-	history = (GArray *)DATA_GET(object,"history");
+	history = (Rtv_History *)DATA_GET(object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -964,7 +950,7 @@ G_MODULE_EXPORT gboolean lookup_previous_n_skip_x_values(const gchar *internal_n
 		for (i=0;i<n;i++)
 		{
 			index-=skip;  /* get PREVIOUS nth one */
-			values[i] = g_array_index(history,gfloat,index);
+			values[i] = rtv_history_get(history,index);
 		}
 	}
 	g_mutex_unlock(rtv_mutex);
@@ -1013,7 +999,6 @@ G_MODULE_EXPORT gboolean lookup_precision(const gchar *internal_name, gint *prec
 G_MODULE_EXPORT void flush_rt_arrays(void)
 {
 	GMutex *rtv_mutex = NULL;
-	GArray *history = NULL;
 	guint i = 0;
 	guint j = 0;
 	gconstpointer * object = NULL;
@@ -1023,10 +1008,10 @@ G_MODULE_EXPORT void flush_rt_arrays(void)
 	rtv_mutex = (GMutex *)DATA_GET(global_data,"rtv_mutex");
 
 	ENTER();
-	/* Flush and recreate the timestamp array */
-	g_array_free(rtv_map->ts_array,TRUE);
-	rtv_map->ts_array = g_array_sized_new(FALSE,TRUE,sizeof(GTimeVal),4096);
+	/* Restart the sample count and timestamps */
+	rtv_map->samples = 0;
 
+	g_mutex_lock(rtv_mutex);
 	for (i=0;i<rtv_map->rtvars_size;i++)
 	{
 		/* Get list of derived vars for raw offset "i" */
@@ -1039,18 +1024,12 @@ G_MODULE_EXPORT void flush_rt_arrays(void)
 			object=(gconstpointer *)g_list_nth_data(list,j);
 			if (!(object))
 				continue;
-			g_mutex_lock(rtv_mutex);
-			history = (GArray *)DATA_GET(object,"history");
-			/* Truncate array,  but don't free/recreate as it
-			 * makes the logviewer explode!
-			 */
-			g_array_free(history,TRUE);
-			history = g_array_sized_new(FALSE,TRUE,sizeof(gfloat),4096);
-			DATA_SET(object,"history",(gpointer)history);
-			g_mutex_unlock(rtv_mutex);
-	                /* bind history array to object for future retrieval */
+			/* Truncate in place, the logviewer and the conversion
+			 * plan hold on to the history pointer */
+			rtv_history_clear((Rtv_History *)DATA_GET(object,"history"));
 		}
 	}
+	g_mutex_unlock(rtv_mutex);
 	thread_update_logbar("dlog_view","warning",g_strdup(_("Realtime Variables History buffers flushed...\n")),FALSE,FALSE);
 	EXIT();
 	return;
@@ -416,7 +416,7 @@ G_MODULE_EXPORT Rt_Slider * add_slider(gchar *ctrl_name, gint tbl, gint table_nu
 		slider->upper = (GINT)strtol((gchar *)DATA_GET(object,"real_upper"),NULL,10);
 	else
 		MTXDBG(CRITICAL,_("No \"real_upper\" value defined for control name %s, datasource %s\n"),ctrl_name,source);
-	slider->history = (GArray *) DATA_GET(object,"history");
+	slider->history = (Rtv_History *)DATA_GET(object,"history");
 	slider->object = object;
 	hbox = gtk_hbox_new(FALSE,5);
 
@@ -538,7 +538,7 @@ G_MODULE_EXPORT void register_rt_range(GtkWidget * widget)
 	slider->tbl = -1;
 	slider->table_num = -1;
 	slider->row = -1;
-	slider->history = (GArray *) DATA_GET(object,"history");
+	slider->history = (Rtv_History *)DATA_GET(object,"history");
 	slider->friendly_name = (gchar *) DATA_GET(object,"dlog_gui_name");
 	slider->temp_dep = (GBOOLEAN)DATA_GET(object,"temp_dep");
 	if ((gchar *)DATA_GET(object,"real_lower"))
@@ -768,7 +768,7 @@ G_MODULE_EXPORT void rt_update_values(gpointer key, gpointer value, gpointer dat
 	gint precision = 0;
 	gfloat current = 0.0;
 	gfloat previous = 0.0;
-	GArray *history = NULL;
+	Rtv_History *history = NULL;
 	gchar * tmpbuf = NULL;
 
 	ENTER();
@@ -782,7 +782,7 @@ G_MODULE_EXPORT void rt_update_values(gpointer key, gpointer value, gpointer dat
 		rtv_mutex = (GMutex *)DATA_GET(global_data,"rtv_mutex");
 	if (!rand)
 		rand = g_rand_new();
-	history = (GArray *)DATA_GET(slider->object,"history");
+	history = (Rtv_History *)DATA_GET(slider->object,"history");
 	if (!history)
 	{
 		EXIT();
@@ -796,7 +796,7 @@ G_MODULE_EXPORT void rt_update_values(gpointer key, gpointer value, gpointer dat
 	precision = (GINT)DATA_GET(slider->object,"precision");
 	g_mutex_lock(rtv_mutex);
 	/*printf("runtime_gui history length is %i, current index %i\n",history->len,history->len-1);*/
-	current = g_array_index(history, gfloat, history->len-1);
+	current = rtv_history_get(history,history->len-1);
 	previous = slider->last;
 	slider->last = current;
 	g_mutex_unlock(rtv_mutex);
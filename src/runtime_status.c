@@ -335,7 +335,7 @@ G_MODULE_EXPORT void reset_runtime_status(void)
 G_MODULE_EXPORT void rt_update_status(gpointer key, gpointer data)
 {
 	static gconstpointer *object = NULL;
-	static GArray * history = NULL;
+	static Rtv_History * history = NULL;
 	static gchar * source = NULL;
 	static const gchar * last_source = "";
 	GtkWidget *widget = (GtkWidget *) key;
@@ -374,7 +374,7 @@ G_MODULE_EXPORT void rt_update_status(gpointer key, gpointer data)
 			EXIT();
 			return;
 		}
-		history = (GArray *)DATA_GET(object,"history");
+		history = (Rtv_History *)DATA_GET(object,"history");
 		if (!history)
 		{
 			EXIT();
@@ -496,7 +496,7 @@ G_MODULE_EXPORT void rtt_update_values(gpointer key, gpointer value, gpointer da
 	gint precision = 0;
 	gfloat current = 0.0;
 	gfloat previous = 0.0;
-	GArray *history = NULL;
+	Rtv_History *history = NULL;
 	gchar * tmpbuf = NULL;
 	gchar * tmpbuf2 = NULL;
 
@@ -514,7 +514,7 @@ G_MODULE_EXPORT void rtt_update_values(gpointer key, gpointer value, gpointer da
 
 	count = rtt->count;
 	last_upd = rtt->last_upd;
-	history = (GArray *)DATA_GET(rtt->object,"history");
+	history = (Rtv_History *)DATA_GET(rtt->object,"history");
 	precision = (GINT)DATA_GET(rtt->object,"precision");
 
 	if (!history)
@@ -528,8 +528,8 @@ G_MODULE_EXPORT void rtt_update_values(gpointer key, gpointer value, gpointer da
 		return;
 	}
 	g_mutex_lock(rtv_mutex);
-	current = g_array_index(history, gfloat, history->len-1);
-	previous = g_array_index(history, gfloat, history->len-2);
+	current = rtv_history_get(history,history->len-1);
+	previous = rtv_history_get(history,history->len-2);
 	g_mutex_unlock(rtv_mutex);
 
 	if (GTK_IS_WIDGET(gtk_widget_get_window(GTK_WIDGET(rtt->textval))))
@@ -623,7 +623,7 @@ G_MODULE_EXPORT gboolean rtt_foreach(GtkTreeModel *model, GtkTreePath *path, Gtk
 	gint precision = 0;
 	gfloat current = 0.0;
 	gfloat previous = 0.0;
-	GArray *history = NULL;
+	Rtv_History *history = NULL;
 	gchar * tmpbuf = NULL;
 
 	ENTER();
@@ -640,7 +640,7 @@ G_MODULE_EXPORT gboolean rtt_foreach(GtkTreeModel *model, GtkTreePath *path, Gtk
 		EXIT();
 		return FALSE;
 	}
-	history = (GArray *)DATA_GET(rtt->object,"history");
+	history = (Rtv_History *)DATA_GET(rtt->object,"history");
 	precision = (GINT)DATA_GET(rtt->object,"precision");
 
 	if (!history)
@@ -654,7 +654,7 @@ G_MODULE_EXPORT gboolean rtt_foreach(GtkTreeModel *model, GtkTreePath *path, Gtk
 		return FALSE;
 	}
 	g_mutex_lock(rtv_mutex);
-	current = g_array_index(history, gfloat, history->len-1);
+	current = rtv_history_get(history,history->len-1);
 	g_mutex_unlock(rtv_mutex);
 
 	if ((current != previous) || (DATA_GET(global_data,"forced_update")))
@@ -142,6 +142,8 @@ G_MODULE_EXPORT void build_string_2_enum_table(void)
 			GINT_TO_POINTER(CLOSE_LOGFILE));
 	g_hash_table_insert(str_2_enum,(gpointer)"_LOGVIEW_ZOOM_",
 			GINT_TO_POINTER(LOGVIEW_ZOOM));
+	g_hash_table_insert(str_2_enum,(gpointer)"_LOGVIEW_SPAN_",
+			GINT_TO_POINTER(LOGVIEW_SPAN));
 	g_hash_table_insert(str_2_enum,(gpointer)"_IMPORT_VETABLE_",
 			GINT_TO_POINTER(IMPORT_VETABLE));
 	g_hash_table_insert(str_2_enum,(gpointer)"_EXPORT_VETABLE_",
@@ -23,6 +23,10 @@
 #include "../../include/ui/logging_system.h"
 #include "../../include/ui/ui_theme_manager.h"
 #include "../../include/ecu/ecu_communication.h"
+#include "../../include/ecu/ecu_channels.h"
+#include "../../include/data/datalog_manager.h"
+#include "../../include/automation/alert_rules.h"
+#include "../../include/automation/action_triggers.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -81,6 +85,45 @@ void cleanup_ecu_integration(void) {
     add_log_entry(0, "ECU Integration module cleaned up");
 }
 
+// Datalog column names, one per ECU channel
+static const char* g_datalog_names[ECU_CHANNEL_COUNT];
+
+// Datalog sessions (started by the user or an action trigger) record every sample
+static void datalog_on_sample(const ECUData* data, uint64_t timestamp_us, void* user_data) {
+    (void)timestamp_us;
+    (void)user_data;
+    if (!data || !datalog_manager_is_active()) {
+        return;
+    }
+    
+    double values[ECU_CHANNEL_COUNT];
+    ecu_channels_snapshot_double(data, values);
+    datalog_manager_log_multiple(g_datalog_names, values, ECU_CHANNEL_COUNT);
+}
+
+void configure_ecu_datalog_channels(ECUContext* ctx) {
+    if (!ctx) {
+        return;
+    }
+    
+    // INI connections log MLG columns in the ECU's native field types and scaling
+    const INIConfig* ini = ctx->ini_config ? ctx->ini_config : ctx->demo_ini_config;
+    if (ini) {
+        INIField fields[ECU_CHANNEL_COUNT];
+        int matched = ecu_channels_ini_fields(ini, fields);
+        if (datalog_manager_set_ini_channels(fields, ECU_CHANNEL_COUNT)) {
+            add_log_entry(0, "Datalog channels: %d of %d typed from INI", matched, ECU_CHANNEL_COUNT);
+        }
+        return;
+    }
+    
+    const char* units[ECU_CHANNEL_COUNT];
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        units[i] = ecu_channel_info(i)->unit;
+    }
+    datalog_manager_set_channels(g_datalog_names, units, ECU_CHANNEL_COUNT);
+}
+
 // ECU communication management
 bool init_ecu_communication(void) {
     g_ecu_integration.ecu_context = ecu_init();
@@ -89,12 +132,23 @@ bool init_ecu_communication(void) {
         return false;
     }
     
+    // Alert rules and action triggers are evaluated on every sample from the acquisition path
+    ecu_add_sample_listener(g_ecu_integration.ecu_context, alert_rules_on_sample, NULL);
+    ecu_add_sample_listener(g_ecu_integration.ecu_context, action_triggers_on_sample, NULL);
+    for (int i = 0; i < ECU_CHANNEL_COUNT; i++) {
+        g_datalog_names[i] = ecu_channel_info(i)->name;
+    }
+    ecu_add_sample_listener(g_ecu_integration.ecu_context, datalog_on_sample, NULL);
+    
     add_log_entry(0, "ECU communication initialized successfully");
     return true;
 }
 
 void cleanup_ecu_communication(void) {
     if (g_ecu_integration.ecu_context) {
+        ecu_remove_sample_listener(g_ecu_integration.ecu_context, datalog_on_sample, NULL);
+        ecu_remove_sample_listener(g_ecu_integration.ecu_context, action_triggers_on_sample, NULL);
+        ecu_remove_sample_listener(g_ecu_integration.ecu_context, alert_rules_on_sample, NULL);
         ecu_cleanup(g_ecu_integration.ecu_context);
         g_ecu_integration.ecu_context = NULL;
     }
@@ -190,10 +244,10 @@ void update_ecu_data(void) {
                 break;
         }
         
-        // Get data
-        const ECUData* data = ecu_get_data(g_ecu_integration.ecu_context);
-        if (data) {
-            g_ecu_integration.ecu_data = *data;
+        // Get data (only when a new frame has been published)
+        static uint32_t last_frame_id = 0;
+        if (ecu_get_frame_id(g_ecu_integration.ecu_context) != last_frame_id) {
+            last_frame_id = ecu_read_frame(g_ecu_integration.ecu_context, &g_ecu_integration.ecu_data);
         }
     }
     
@@ -207,6 +261,10 @@ const ECUData* get_ecu_data(void) {
     return &g_ecu_integration.ecu_data;
 }
 
+ECUContext* get_ecu_context(void) {
+    return g_ecu_integration.ecu_context;
+}
+
 bool is_ecu_connected(void) {
     return g_ecu_integration.ecu_connected;
 }
@@ -1,5 +1,6 @@
 #include "../../include/ui/imgui_communications.h"
 #include "../../include/ui/imgui_file_dialog.h"
+#include "../../include/ui/ecu_integration.h"
 #include "../../include/ecu/ecu_dynamic_protocols.h"
 #include "../../include/ui/imgui_ve_table.h"
 #include "../../external/imgui/imgui.h"
@@ -521,6 +522,7 @@ void imgui_render_connection_dialog(ImGuiCommunications* comms) {
                         
                         // Simulate successful connection
                         connection_success = true;
+                        configure_ecu_datalog_channels(comms->ecu_ctx);
                         
                         printf("[DEBUG] DEMO mode activated successfully\n");
                         if (g_log_callback) {
@@ -568,6 +570,8 @@ void imgui_render_connection_dialog(ImGuiCommunications* comms) {
                     }
                     
                     if (connection_success) {
+                        configure_ecu_datalog_channels(comms->ecu_ctx);
+                        
                         // Add to connection history
                         const char* port_name = comms->detected_ports.ports[comms->selected_port];
                         const char* protocol_name = comms->use_ini_file ? "Auto-detected" : protocol_names[comms->selected_protocol];
@@ -1,10 +1,32 @@
 #include "../../include/ui/imgui_runtime_display.h"
+#include "../../include/automation/alert_rules.h"
 #include "../../external/imgui/imgui.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <SDL2/SDL.h>
 
+// Keep short excursions visible for at least this long after they clear
+#define ALERT_HOLD_MS 2000
+
+// Compile an alert's condition into the alert engine
+static void imgui_compile_alert(AlertConfig* alert) {
+    if (alert->rule_id >= 0) {
+        if (!alert_rules_update(alert->rule_id, alert->condition,
+                                alert->compile_error, sizeof(alert->compile_error))) {
+            return;
+        }
+    } else {
+        alert->rule_id = alert_rules_add(alert->condition, alert->compile_error,
+                                         sizeof(alert->compile_error));
+        if (alert->rule_id < 0) return;
+    }
+    
+    alert_rules_get_threshold(alert->rule_id, &alert->threshold);
+    alert_rules_set_enabled(alert->rule_id, alert->enabled);
+    alert->trigger_count = 0;
+}
+
 // Create ImGui Runtime Display
 ImGuiRuntimeDisplay* imgui_runtime_display_create(ECUContext* ecu_ctx) {
     ImGuiRuntimeDisplay* display = (ImGuiRuntimeDisplay*)malloc(sizeof(ImGuiRuntimeDisplay));
@@ -60,6 +82,10 @@ ImGuiRuntimeDisplay* imgui_runtime_display_create(ECUContext* ecu_ctx) {
     // Initialize alerts
     display->alert_count = 8;
     imgui_load_default_alerts(display->alerts, &display->alert_count);
+    for (int i = 0; i < display->alert_count; i++) {
+        display->alerts[i].rule_id = -1;
+        imgui_compile_alert(&display->alerts[i]);
+    }
     
     // Initialize data history
     imgui_clear_data_series(&display->rpm_history);
@@ -92,6 +118,10 @@ ImGuiRuntimeDisplay* imgui_runtime_display_create(ECUContext* ecu_ctx) {
 void imgui_runtime_display_destroy(ImGuiRuntimeDisplay* display) {
     if (!display) return;
     
+    for (int i = 0; i < display->alert_count; i++) {
+        alert_rules_remove(display->alerts[i].rule_id);
+    }
+    
     free(display);
 }
 
@@ -118,12 +148,8 @@ void imgui_runtime_display_update(ImGuiRuntimeDisplay* display) {
                 data_update_counter = 0;
             }
             
-            // Only check alerts every few updates to reduce CPU usage
-            static int alert_check_counter = 0;
-            if (++alert_check_counter >= 10) { // Reduced frequency for better performance
-                imgui_check_alerts(display->alerts, display->alert_count, data);
-                alert_check_counter = 0;
-            }
+            // Alert rules run on the sample path; this only reads their state
+            imgui_check_alerts(display->alerts, display->alert_count, data);
         } else if (display->demo_mode_enabled) {
             // Demo data - update every frame since it's lightweight
             imgui_update_data_history(display, NULL); // Pass NULL to trigger demo data generation
@@ -664,33 +690,29 @@ void imgui_check_alerts(AlertConfig* alerts, int count, const ECUData* data) {
     if (!alerts || !data) return;
     
     uint32_t current_time = SDL_GetTicks();
+    uint64_t now_us = ecu_get_timestamp_us();
     
     for (int i = 0; i < count; i++) {
         AlertConfig* alert = &alerts[i];
         if (!alert->enabled) continue;
         
-        bool triggered = false;
-        
-        // Check conditions based on alert name
-        if (strstr(alert->name, "RPM") && data->rpm > alert->threshold) {
-            triggered = true;
-        } else if (strstr(alert->name, "TEMP") && data->coolant_temp > alert->threshold) {
-            triggered = true;
-        } else if (strstr(alert->name, "VOLTAGE") && data->battery_voltage < alert->threshold) {
-            triggered = true;
-        } else if (strstr(alert->name, "KNOCK") && data->knock_count > alert->threshold) {
-            triggered = true;
-        } else if (strstr(alert->name, "BOOST") && data->boost > alert->threshold) {
-            triggered = true;
+        AlertRuleState state;
+        if (!alert_rules_get_state(alert->rule_id, &state)) {
+            alert->triggered = false;
+            continue;
         }
         
-        if (triggered && !alert->triggered) {
-            alert->triggered = true;
+        // A trigger that fired and cleared between frames is still reported
+        bool fired = state.trigger_count != alert->trigger_count;
+        bool held = state.trigger_count > 0 &&
+                    (now_us - state.last_clear_us) < (uint64_t)ALERT_HOLD_MS * 1000;
+        bool triggered = state.active || fired || held;
+        
+        if (fired) {
+            alert->trigger_count = state.trigger_count;
             alert->trigger_time = current_time;
-        } else if (!triggered && alert->triggered) {
-            alert->triggered = false;
         }
-        
+        alert->triggered = triggered;
         alert->last_check = current_time;
     }
 }
@@ -871,7 +893,7 @@ void imgui_load_default_alerts(AlertConfig* alerts, int* count) {
     
     // High RPM Alert
     strcpy(alerts[0].name, "High RPM");
-    strcpy(alerts[0].condition, "RPM > 7500");
+    strcpy(alerts[0].condition, "RPM > 7500 hyst 200");
     alerts[0].threshold = 7500.0f;
     alerts[0].enabled = true;
     alerts[0].priority = 2; // Danger
@@ -879,7 +901,7 @@ void imgui_load_default_alerts(AlertConfig* alerts, int* count) {
     
     // High Temperature Alert
     strcpy(alerts[1].name, "High Temperature");
-    strcpy(alerts[1].condition, "Coolant Temp > 110°C");
+    strcpy(alerts[1].condition, "Coolant Temp > 110°C hyst 3");
     alerts[1].threshold = 110.0f;
     alerts[1].enabled = true;
     alerts[1].priority = 2; // Danger
@@ -887,7 +909,7 @@ void imgui_load_default_alerts(AlertConfig* alerts, int* count) {
     
     // Low Voltage Alert
     strcpy(alerts[2].name, "Low Voltage");
-    strcpy(alerts[2].condition, "Battery Voltage < 11.0V");
+    strcpy(alerts[2].condition, "Battery Voltage < 11.0V for 500 ms hyst 0.3");
     alerts[2].threshold = 11.0f;
     alerts[2].enabled = true;
     alerts[2].priority = 2; // Danger
@@ -1048,20 +1070,31 @@ void imgui_render_alert_config_panel(AlertConfig* alerts, int count) {
         
         // Enable/disable checkbox
         ImGui::SameLine();
-        ImGui::Checkbox("Enabled", &alert->enabled);
+        if (ImGui::Checkbox("Enabled", &alert->enabled)) {
+            alert_rules_set_enabled(alert->rule_id, alert->enabled);
+        }
         
         if (alert->enabled) {
-            // Threshold
+            // Threshold (first comparison of the condition)
             ImGui::SetNextItemWidth(100);
-            ImGui::DragFloat("Threshold", &alert->threshold, 1.0f, -1000.0f, 1000.0f, "%.1f");
+            if (ImGui::DragFloat("Threshold", &alert->threshold, 1.0f, -1000.0f, 1000.0f, "%.1f")) {
+                alert_rules_set_threshold(alert->rule_id, alert->threshold);
+            }
             
             // Priority
             ImGui::SetNextItemWidth(100);
             const char* priorities[] = {"Info", "Warning", "Danger", "Critical"};
             ImGui::Combo("Priority", &alert->priority, priorities, IM_ARRAYSIZE(priorities));
             
-            // Condition display
-            ImGui::Text("Condition: %s", alert->condition);
+            // Condition (recompiled when editing finishes)
+            ImGui::SetNextItemWidth(300);
+            ImGui::InputText("Condition", alert->condition, sizeof(alert->condition));
+            if (ImGui::IsItemDeactivatedAfterEdit()) {
+                imgui_compile_alert(alert);
+            }
+            if (alert->compile_error[0]) {
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Error: %s", alert->compile_error);
+            }
             
             // Status
             if (alert->triggered) {
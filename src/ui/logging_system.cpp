@@ -23,12 +23,16 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include <SDL2/SDL.h>
 
 // Local module state
 static bool g_module_initialized = false;
 static LoggingSystemState g_logging_state = {0};
 
+// Plugin init() and other worker threads log too; serialize writers
+static pthread_mutex_t g_log_write_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 // Global state access for compatibility
 LoggingSystemState* g_logging_system_state = &g_logging_state;
 
@@ -50,9 +54,10 @@ void add_log_entry_va(int level, const char* format, va_list args) {
     
     // Create timestamp
     time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
+    struct tm tm_info;
+    localtime_r(&now, &tm_info);
     char time_str[20];
-    strftime(time_str, sizeof(time_str), "%H:%M:%S", tm_info);
+    strftime(time_str, sizeof(time_str), "%H:%M:%S", &tm_info);
     
     // Format the message
     char temp_message[MAX_LOG_LINE_LENGTH];
@@ -64,6 +69,7 @@ void add_log_entry_va(int level, const char* format, va_list args) {
     snprintf(full_message, sizeof(full_message), "[%s] %s: %s", time_str, level_str[level], temp_message);
     
     // Add to circular buffer
+    pthread_mutex_lock(&g_log_write_mutex);
     g_logging_state.entries[g_logging_state.index].timestamp = now;
     g_logging_state.entries[g_logging_state.index].level = level;
     strncpy(g_logging_state.entries[g_logging_state.index].message, full_message, MAX_LOG_LINE_LENGTH - 1);
@@ -76,6 +82,7 @@ void add_log_entry_va(int level, const char* format, va_list args) {
     
     // Update last log time
     g_logging_state.last_log_time = SDL_GetTicks();
+    pthread_mutex_unlock(&g_log_write_mutex);
 }
 
 // ============================================================================